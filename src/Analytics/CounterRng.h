@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace fastquant {
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers:
+// as easy as 1, 2, 3"). Output depends only on (key, counter), so giving every
+// Monte Carlo path its own stream id makes results independent of how paths are
+// scheduled across threads.
+class Philox4x32 {
+public:
+    using Block = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static Block generate(Block counter, Key key) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += kWeyl0;
+                key[1] += kWeyl1;
+            }
+            const uint64_t p0 = static_cast<uint64_t>(kMul0) * counter[0];
+            const uint64_t p1 = static_cast<uint64_t>(kMul1) * counter[2];
+            counter = {
+                static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<uint32_t>(p1),
+                static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<uint32_t>(p0)
+            };
+        }
+        return counter;
+    }
+
+private:
+    static constexpr uint32_t kMul0 = 0xD2511F53u;
+    static constexpr uint32_t kMul1 = 0xCD9E8D57u;
+    static constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+    static constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+};
+
+// CounterRng: sequential draws from one Philox stream, identified by (seed, stream).
+class CounterRng {
+public:
+    CounterRng(uint64_t seed, uint64_t stream)
+        : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          stream_(stream) {}
+
+    uint32_t next() {
+        if (used_ == 4) {
+            block_ = Philox4x32::generate({static_cast<uint32_t>(draw_),
+                                           static_cast<uint32_t>(draw_ >> 32),
+                                           static_cast<uint32_t>(stream_),
+                                           static_cast<uint32_t>(stream_ >> 32)},
+                                          key_);
+            ++draw_;
+            used_ = 0;
+        }
+        return block_[used_++];
+    }
+
+    // Uniform integer in [0, bound) via multiply-shift (bound < 2^32).
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(next()) * bound) >> 32);
+    }
+
+    // Uniform double in [0, 1) with 53 random bits.
+    double uniform() {
+        const uint64_t hi = next();
+        const uint64_t lo = next();
+        return static_cast<double>((hi << 21) ^ (lo >> 11)) * 0x1.0p-53;
+    }
+
+private:
+    Philox4x32::Key key_;
+    uint64_t stream_;
+    uint64_t draw_{0};
+    Philox4x32::Block block_{};
+    int used_{4};
+};
+
+} // namespace fastquant
@@ -0,0 +1,185 @@
+#include "MonteCarlo.h"
+#include "CounterRng.h"
+#include "../BacktestEngine/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+namespace fastquant {
+
+namespace {
+
+constexpr double EPS = 1e-9;
+constexpr size_t kPathsPerTask = 256;
+
+struct PathStats {
+    double finalEquity{0.0};
+    double maxDrawdown{0.0};
+    double winRate{0.0};
+};
+
+// Tracks running peak / deepest drop the same way Reporter::summarize does.
+struct DrawdownTracker {
+    explicit DrawdownTracker(double start) : peak(start) {}
+    void update(double equity) {
+        if (equity > peak) {
+            peak = equity;
+        } else if (peak - equity > maxDd) {
+            maxDd = peak - equity;
+        }
+    }
+    double peak;
+    double maxDd{0.0};
+};
+
+PathStats tradePath(const std::vector<double>& pnl, double initial, CounterRng& rng) {
+    const auto n = static_cast<uint32_t>(pnl.size());
+    double equity = initial;
+    DrawdownTracker dd(initial);
+    size_t wins = 0;
+    size_t losses = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const double draw = pnl[rng.below(n)];
+        equity += draw;
+        dd.update(equity);
+        if (draw > EPS) ++wins;
+        else if (draw < -EPS) ++losses;
+    }
+    PathStats s;
+    s.finalEquity = equity;
+    s.maxDrawdown = dd.maxDd;
+    s.winRate = (wins + losses) ? static_cast<double>(wins) / static_cast<double>(wins + losses) : 0.0;
+    return s;
+}
+
+PathStats blockPath(const std::vector<double>& returns, size_t blockSize, double initial, CounterRng& rng) {
+    const auto n = static_cast<uint32_t>(returns.size());
+    double equity = initial;
+    DrawdownTracker dd(initial);
+    size_t wins = 0;
+    size_t losses = 0;
+    size_t drawn = 0;
+    while (drawn < n) {
+        uint32_t pos = rng.below(n);
+        for (size_t b = 0; b < blockSize && drawn < n; ++b, ++drawn) {
+            const double r = returns[pos];
+            pos = (pos + 1 == n) ? 0 : pos + 1; // circular blocks
+            equity *= 1.0 + r;
+            dd.update(equity);
+            if (r > EPS) ++wins;
+            else if (r < -EPS) ++losses;
+        }
+    }
+    PathStats s;
+    s.finalEquity = equity;
+    s.maxDrawdown = dd.maxDd;
+    s.winRate = (wins + losses) ? static_cast<double>(wins) / static_cast<double>(wins + losses) : 0.0;
+    return s;
+}
+
+} // namespace
+
+std::vector<double> closedTradePnl(const BacktestResult& result) {
+    std::vector<double> pnl;
+    const auto& trips = result.ledger.roundTrips();
+    if (!trips.empty()) {
+        pnl.reserve(trips.size());
+        for (const auto& rt : trips) {
+            pnl.push_back(rt.pnl);
+        }
+        return pnl;
+    }
+    // Hand-built results have no ledger; replay their fills instead.
+    Portfolio replay(result.initialCapital);
+    double prevRealized = 0.0;
+    for (const auto& tr : result.trades) {
+        replay.applyTrade(tr);
+        const double delta = replay.realizedPnl() - prevRealized;
+        prevRealized = replay.realizedPnl();
+        if (std::abs(delta) > EPS) {
+            pnl.push_back(delta);
+        }
+    }
+    return pnl;
+}
+
+QuantileSet computeQuantiles(std::vector<double> samples, const std::vector<double>& levels) {
+    QuantileSet q;
+    q.levels = levels;
+    if (samples.empty()) {
+        q.values.assign(levels.size(), 0.0);
+        return q;
+    }
+    std::sort(samples.begin(), samples.end());
+    q.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    for (double level : levels) {
+        // Linear interpolation between closest ranks.
+        const double clamped = std::clamp(level, 0.0, 1.0);
+        const double rank = clamped * static_cast<double>(samples.size() - 1);
+        const auto lo = static_cast<size_t>(std::floor(rank));
+        const size_t hi = std::min(lo + 1, samples.size() - 1);
+        const double frac = rank - static_cast<double>(lo);
+        q.values.push_back(samples[lo] + (samples[hi] - samples[lo]) * frac);
+    }
+    return q;
+}
+
+BootstrapResult runBootstrap(const BacktestResult& result, const BootstrapConfig& cfg) {
+    BootstrapResult out;
+    out.method = cfg.method;
+    out.paths = cfg.paths;
+
+    std::vector<double> sample;
+    if (cfg.method == BootstrapMethod::TradeReturns) {
+        sample = closedTradePnl(result);
+    } else {
+        const auto& eq = result.equityCurve;
+        sample.reserve(eq.size());
+        for (size_t i = 1; i < eq.size(); ++i) {
+            sample.push_back(eq[i - 1] != 0.0 ? eq[i] / eq[i - 1] - 1.0 : 0.0);
+        }
+    }
+    if (sample.size() > 0xFFFFFFFFull) {
+        throw std::runtime_error("Bootstrap sample too large");
+    }
+    out.sampleSize = sample.size();
+
+    std::vector<double> finals(cfg.paths, result.initialCapital);
+    std::vector<double> drawdowns(cfg.paths, 0.0);
+    std::vector<double> winRates(cfg.paths, 0.0);
+
+    if (!sample.empty() && cfg.paths > 0) {
+        const double initial = result.initialCapital;
+        const size_t blockSize = std::max<size_t>(1, cfg.blockSize);
+        const size_t tasks = (cfg.paths + kPathsPerTask - 1) / kPathsPerTask;
+        auto runChunk = [&](size_t task) {
+            const size_t begin = task * kPathsPerTask;
+            const size_t end = std::min(cfg.paths, begin + kPathsPerTask);
+            for (size_t p = begin; p < end; ++p) {
+                CounterRng rng(cfg.seed, p);
+                const PathStats s = cfg.method == BootstrapMethod::TradeReturns
+                    ? tradePath(sample, initial, rng)
+                    : blockPath(sample, blockSize, initial, rng);
+                finals[p] = s.finalEquity;
+                drawdowns[p] = s.maxDrawdown;
+                winRates[p] = s.winRate;
+            }
+        };
+        if (cfg.threads > 0) {
+            ThreadPool pool(cfg.threads);
+            pool.parallelFor(tasks, runChunk);
+        } else {
+            ThreadPool::shared().parallelFor(tasks, runChunk);
+        }
+    }
+
+    out.finalEquity = computeQuantiles(std::move(finals), cfg.quantiles);
+    out.maxDrawdown = computeQuantiles(std::move(drawdowns), cfg.quantiles);
+    out.winRate = computeQuantiles(std::move(winRates), cfg.quantiles);
+    return out;
+}
+
+} // namespace fastquant
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../BacktestEngine/BacktestEngine.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fastquant {
+
+enum class BootstrapMethod {
+    TradeReturns,  // resample round-trip net PnL with replacement
+    EquityBlocks   // circular block bootstrap of per-candle equity returns
+};
+
+struct BootstrapConfig {
+    BootstrapMethod method = BootstrapMethod::TradeReturns;
+    size_t paths = 10000;
+    size_t blockSize = 20;   // EquityBlocks only
+    uint64_t seed = 42;
+    size_t threads = 0;      // 0 = shared pool
+    std::vector<double> quantiles{0.05, 0.25, 0.5, 0.75, 0.95};
+};
+
+struct QuantileSet {
+    std::vector<double> levels;
+    std::vector<double> values; // values[i] is the levels[i] quantile
+    double mean{0.0};
+};
+
+struct BootstrapResult {
+    BootstrapMethod method = BootstrapMethod::TradeReturns;
+    size_t paths{0};
+    size_t sampleSize{0}; // trades or returns drawn per path
+    QuantileSet finalEquity;
+    QuantileSet maxDrawdown; // absolute, positive (same convention as ReportSummary)
+    QuantileSet winRate;
+};
+
+// Net PnL of every round trip in result.ledger, in close order. Results
+// without retained round trips (hand-built ones) fall back to replaying the
+// fills through a Portfolio: one entry per fill that changed realized PnL.
+std::vector<double> closedTradePnl(const BacktestResult& result);
+
+// Run cfg.paths bootstrap resamples of a finished backtest in parallel.
+// Path p draws from Philox stream (seed, p), so the output is identical for
+// any thread count.
+BootstrapResult runBootstrap(const BacktestResult& result, const BootstrapConfig& cfg);
+
+QuantileSet computeQuantiles(std::vector<double> samples, const std::vector<double>& levels);
+
+} // namespace fastquant
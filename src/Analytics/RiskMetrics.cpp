@@ -0,0 +1,547 @@
+#include "RiskMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FASTQUANT_HAVE_AVX2_KERNEL 1
+#endif
+
+namespace fastquant {
+
+namespace {
+
+using TimePoint = std::chrono::system_clock::time_point;
+
+constexpr double kSecondsPerYear = 365.25 * 86400.0;
+constexpr double kDefaultPeriodsPerYear = 252.0;
+constexpr size_t kLanes = 4;
+constexpr size_t kSamples = 4096;
+constexpr size_t kSampleTailFrom = size_t{1} << 16;
+
+double simpleReturn(const double* e, size_t i) {
+    return e[i + 1] / e[i] - 1.0;
+}
+
+double combine(const double (&lanes)[kLanes]) {
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// Peak-to-trough state over the equity points. A drawdown is closed when a
+// new peak arrives, so the division and duration bookkeeping happen once per
+// drawdown rather than once per point.
+struct Drawdown {
+    double peak{0.0};
+    double trough{0.0};
+    size_t peakAt{0};
+    size_t lastBelow{0};
+    double maxDrawdown{0.0};
+    size_t maxDuration{0};
+    double maxSeconds{0.0};
+
+    void close(std::span<const TimePoint> ts) {
+        if (lastBelow <= peakAt) {
+            return;
+        }
+        if (peak > 0.0) {
+            maxDrawdown = std::max(maxDrawdown, (peak - trough) / peak);
+        }
+        maxDuration = std::max(maxDuration, lastBelow - peakAt);
+        if (!ts.empty()) {
+            maxSeconds = std::max(maxSeconds, std::chrono::duration<double>(ts[lastBelow] - ts[peakAt]).count());
+        }
+    }
+
+    void step(double x, size_t at, std::span<const TimePoint> ts) {
+        if (x >= peak) {
+            close(ts);
+            peak = x;
+            trough = x;
+            peakAt = at;
+        } else {
+            trough = x < trough ? x : trough;
+            lastBelow = at;
+        }
+    }
+};
+
+// Returns at or below a threshold, in index order, up to a fixed capacity.
+// Once full it flags overflow and the caller falls back to all returns.
+struct TailBuffer {
+    double threshold{HUGE_VAL};
+    std::vector<double> values; // capacity + kLanes slack for whole-vector stores
+    size_t size{0};
+    size_t capacity{0};
+    bool overflow{false};
+
+    void reset(size_t cap) {
+        capacity = cap;
+        values.resize(cap + kLanes);
+    }
+    void offer(double x) {
+        if (x <= threshold) {
+            if (size < capacity) {
+                values[size++] = x;
+            } else {
+                overflow = true;
+            }
+        }
+    }
+};
+
+// One fused pass over the equity: returns, power sums of (r - shift), the
+// downside square sum, extremes, tail candidates and drawdown. Return i always lands in lane i % 4 and lanes are
+// combined in a fixed order, so the scalar and AVX2 kernels agree bit for bit.
+struct ReturnPass {
+    double shift{0.0};
+    double s1[kLanes]{};
+    double s2[kLanes]{};
+    double s3[kLanes]{};
+    double s4[kLanes]{};
+    double down[kLanes]{};
+    double lo[kLanes]{HUGE_VAL, HUGE_VAL, HUGE_VAL, HUGE_VAL};
+    double hi[kLanes]{-HUGE_VAL, -HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    TailBuffer tail;
+    Drawdown drawdown;
+};
+
+void returnPassScalar(const double* e, size_t m, ReturnPass& p, std::span<const TimePoint> ts, size_t from = 0) {
+    for (size_t i = from; i < m; ++i) {
+        const size_t l = i % kLanes;
+        const double x = simpleReturn(e, i);
+        const double d = x - p.shift;
+        const double d2 = d * d;
+        p.s1[l] += d;
+        p.s2[l] += d2;
+        p.s3[l] += d2 * d;
+        p.s4[l] += d2 * d2;
+        const double neg = x < 0.0 ? x : 0.0;
+        p.down[l] += neg * neg;
+        p.lo[l] = x < p.lo[l] ? x : p.lo[l];
+        p.hi[l] = x > p.hi[l] ? x : p.hi[l];
+        p.tail.offer(x);
+        p.drawdown.step(e[i + 1], i + 1, ts);
+    }
+}
+
+// Sliding variance of (r - shift) over `window` returns, split into four
+// contiguous runs of window ends, one per lane, so the running sums form four
+// independent chains. Lane 3 finishes the leftover ends on its own. `ring`
+// holds the last `window` deviations of each lane, interleaved.
+struct RollingPass {
+    size_t window{0};
+    size_t run{0};    // window ends per lane before lane 3 continues alone
+    double shift{0.0};
+    double invWindow{0.0};
+    double invWindowMinusOne{0.0};
+    double sum[kLanes]{};
+    double squares[kLanes]{};
+    std::vector<double> ring;
+    double lastVariance{-1.0};
+    double maxVariance{0.0};
+};
+
+// `ring` is t % window, tracked by the callers.
+void rollingStep(const double* e, RollingPass& p, size_t t, size_t lane, size_t ring) {
+    const double d = simpleReturn(e, lane * p.run + t) - p.shift;
+    double& slot = p.ring[ring * kLanes + lane];
+    if (t >= p.window) {
+        p.sum[lane] -= slot;
+        p.squares[lane] -= slot * slot;
+    }
+    p.sum[lane] += d;
+    p.squares[lane] += d * d;
+    slot = d;
+    if (t + 1 >= p.window) {
+        const double v = std::max(0.0, (p.squares[lane] - p.sum[lane] * p.sum[lane] * p.invWindow) * p.invWindowMinusOne);
+        p.maxVariance = v > p.maxVariance ? v : p.maxVariance;
+        if (lane == kLanes - 1) {
+            p.lastVariance = v;
+        }
+    }
+}
+
+// Lane 3 carries on past the lockstep steps to the last return.
+void rollingFinish(const double* e, size_t m, RollingPass& p, size_t t) {
+    for (size_t ring = t % p.window; (kLanes - 1) * p.run + t < m; ++t) {
+        rollingStep(e, p, t, kLanes - 1, ring);
+        if (++ring == p.window) {
+            ring = 0;
+        }
+    }
+}
+
+void rollingPassScalar(const double* e, size_t m, RollingPass& p) {
+    const size_t steps = p.window - 1 + p.run;
+    for (size_t t = 0, ring = 0; t < steps; ++t) {
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            rollingStep(e, p, t, lane, ring);
+        }
+        if (++ring == p.window) {
+            ring = 0;
+        }
+    }
+    rollingFinish(e, m, p, steps);
+}
+
+#ifdef FASTQUANT_HAVE_AVX2_KERNEL
+
+// 32-bit permute indices that move the doubles selected by a 4-bit mask to the front.
+alignas(32) constexpr int32_t kLeftPack[16][8] = {
+    {0, 1, 2, 3, 4, 5, 6, 7}, {0, 1, 2, 3, 4, 5, 6, 7}, {2, 3, 0, 1, 4, 5, 6, 7}, {0, 1, 2, 3, 4, 5, 6, 7},
+    {4, 5, 0, 1, 2, 3, 6, 7}, {0, 1, 4, 5, 2, 3, 6, 7}, {2, 3, 4, 5, 0, 1, 6, 7}, {0, 1, 2, 3, 4, 5, 6, 7},
+    {6, 7, 0, 1, 2, 3, 4, 5}, {0, 1, 6, 7, 2, 3, 4, 5}, {2, 3, 6, 7, 0, 1, 4, 5}, {0, 1, 2, 3, 6, 7, 4, 5},
+    {4, 5, 6, 7, 0, 1, 2, 3}, {0, 1, 4, 5, 6, 7, 2, 3}, {2, 3, 4, 5, 6, 7, 0, 1}, {0, 1, 2, 3, 4, 5, 6, 7},
+};
+
+__attribute__((target("avx2")))
+double horizontalMin(__m256d v) {
+    alignas(32) double lanes[kLanes];
+    _mm256_store_pd(lanes, v);
+    return std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+}
+
+__attribute__((target("avx2")))
+void returnPassAvx2(const double* e, size_t m, ReturnPass& p, std::span<const TimePoint> ts) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d shift = _mm256_set1_pd(p.shift);
+    const __m256d threshold = _mm256_set1_pd(p.tail.threshold);
+    __m256d s1 = _mm256_loadu_pd(p.s1);
+    __m256d s2 = _mm256_loadu_pd(p.s2);
+    __m256d s3 = _mm256_loadu_pd(p.s3);
+    __m256d s4 = _mm256_loadu_pd(p.s4);
+    __m256d down = _mm256_loadu_pd(p.down);
+    __m256d lo = _mm256_loadu_pd(p.lo);
+    __m256d hi = _mm256_loadu_pd(p.hi);
+    __m256d peak = _mm256_set1_pd(p.drawdown.peak);
+    __m256d troughs = _mm256_set1_pd(HUGE_VAL);
+    alignas(32) double lanes[kLanes];
+
+    size_t i = 0;
+    for (; i + kLanes <= m; i += kLanes) {
+        const __m256d next = _mm256_loadu_pd(e + i + 1);
+        const __m256d x = _mm256_sub_pd(_mm256_div_pd(next, _mm256_loadu_pd(e + i)), one);
+        const __m256d d = _mm256_sub_pd(x, shift);
+        const __m256d d2 = _mm256_mul_pd(d, d);
+        s1 = _mm256_add_pd(s1, d);
+        s2 = _mm256_add_pd(s2, d2);
+        s3 = _mm256_add_pd(s3, _mm256_mul_pd(d2, d));
+        s4 = _mm256_add_pd(s4, _mm256_mul_pd(d2, d2));
+        // min/max(x, acc) pick x only when it compares strictly, like the scalar loop.
+        const __m256d neg = _mm256_min_pd(x, zero);
+        down = _mm256_add_pd(down, _mm256_mul_pd(neg, neg));
+        lo = _mm256_min_pd(x, lo);
+        hi = _mm256_max_pd(x, hi);
+
+        // Left-pack the tail candidates with a table permute and store all
+        // four lanes; only popcount(mask) of them are kept.
+        const int inTail = _mm256_movemask_pd(_mm256_cmp_pd(x, threshold, _CMP_LE_OQ));
+        if (p.tail.size + kLanes <= p.tail.capacity) {
+            const __m256i order = _mm256_load_si256(reinterpret_cast<const __m256i*>(kLeftPack[inTail]));
+            const __m256d packed = _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(x), order));
+            _mm256_storeu_pd(p.tail.values.data() + p.tail.size, packed);
+            p.tail.size += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(inTail)));
+        } else if (inTail) {
+            _mm256_store_pd(lanes, x);
+            for (double v : lanes) {
+                p.tail.offer(v);
+            }
+        }
+
+        // Blocks entirely under the peak only lower the trough.
+        if (_mm256_movemask_pd(_mm256_cmp_pd(next, peak, _CMP_GE_OQ)) == 0) {
+            troughs = _mm256_min_pd(next, troughs);
+            p.drawdown.lastBelow = i + kLanes;
+            continue;
+        }
+        p.drawdown.trough = std::min(p.drawdown.trough, horizontalMin(troughs));
+        troughs = _mm256_set1_pd(HUGE_VAL);
+        for (size_t j = 1; j <= kLanes; ++j) {
+            p.drawdown.step(e[i + j], i + j, ts);
+        }
+        peak = _mm256_set1_pd(p.drawdown.peak);
+    }
+    p.drawdown.trough = std::min(p.drawdown.trough, horizontalMin(troughs));
+    _mm256_storeu_pd(p.s1, s1);
+    _mm256_storeu_pd(p.s2, s2);
+    _mm256_storeu_pd(p.s3, s3);
+    _mm256_storeu_pd(p.s4, s4);
+    _mm256_storeu_pd(p.down, down);
+    _mm256_storeu_pd(p.lo, lo);
+    _mm256_storeu_pd(p.hi, hi);
+    returnPassScalar(e, m, p, ts, i);
+}
+
+// Vector form of rollingStep: all four lanes advance one step.
+struct RollingLanesAvx2 {
+    RollingPass& p;
+    __m256d sum;
+    __m256d squares;
+    __m256d variance;
+    __m256d maxVariance;
+    size_t slot{0};
+
+    __attribute__((target("avx2")))
+    void advance(size_t t, __m256d d) {
+        double* ring = p.ring.data() + slot * kLanes;
+        if (t >= p.window) {
+            const __m256d out = _mm256_loadu_pd(ring);
+            sum = _mm256_sub_pd(sum, out);
+            squares = _mm256_sub_pd(squares, _mm256_mul_pd(out, out));
+        }
+        sum = _mm256_add_pd(sum, d);
+        squares = _mm256_add_pd(squares, _mm256_mul_pd(d, d));
+        _mm256_storeu_pd(ring, d);
+        if (++slot == p.window) {
+            slot = 0;
+        }
+        if (t + 1 >= p.window) {
+            const __m256d mean = _mm256_mul_pd(_mm256_mul_pd(sum, sum), _mm256_set1_pd(p.invWindow));
+            variance = _mm256_max_pd(_mm256_mul_pd(_mm256_sub_pd(squares, mean), _mm256_set1_pd(p.invWindowMinusOne)),
+                                     _mm256_setzero_pd());
+            maxVariance = _mm256_max_pd(variance, maxVariance);
+        }
+    }
+};
+
+__attribute__((target("avx2")))
+void rollingPassAvx2(const double* e, size_t m, RollingPass& p) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d shift = _mm256_set1_pd(p.shift);
+    RollingLanesAvx2 state{p, _mm256_loadu_pd(p.sum), _mm256_loadu_pd(p.squares),
+                           _mm256_set1_pd(p.lastVariance), _mm256_set1_pd(p.maxVariance)};
+
+    // Four steps at a time: each lane divides four consecutive closes, then a
+    // 4x4 transpose turns lane rows into per-step vectors.
+    const size_t steps = p.window - 1 + p.run;
+    const double* base[kLanes] = {e, e + p.run, e + 2 * p.run, e + 3 * p.run};
+    size_t t = 0;
+    for (; t + kLanes <= steps; t += kLanes) {
+        __m256d rows[kLanes];
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            const double* at = base[lane] + t;
+            rows[lane] = _mm256_sub_pd(_mm256_div_pd(_mm256_loadu_pd(at + 1), _mm256_loadu_pd(at)), one);
+        }
+        const __m256d lo01 = _mm256_unpacklo_pd(rows[0], rows[1]);
+        const __m256d hi01 = _mm256_unpackhi_pd(rows[0], rows[1]);
+        const __m256d lo23 = _mm256_unpacklo_pd(rows[2], rows[3]);
+        const __m256d hi23 = _mm256_unpackhi_pd(rows[2], rows[3]);
+        state.advance(t, _mm256_sub_pd(_mm256_permute2f128_pd(lo01, lo23, 0x20), shift));
+        state.advance(t + 1, _mm256_sub_pd(_mm256_permute2f128_pd(hi01, hi23, 0x20), shift));
+        state.advance(t + 2, _mm256_sub_pd(_mm256_permute2f128_pd(lo01, lo23, 0x31), shift));
+        state.advance(t + 3, _mm256_sub_pd(_mm256_permute2f128_pd(hi01, hi23, 0x31), shift));
+    }
+    for (; t < steps; ++t) {
+        alignas(32) double d[kLanes];
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            d[lane] = simpleReturn(base[lane], t);
+        }
+        state.advance(t, _mm256_sub_pd(_mm256_load_pd(d), shift));
+    }
+
+    alignas(32) double lanes[kLanes];
+    _mm256_storeu_pd(p.sum, state.sum);
+    _mm256_storeu_pd(p.squares, state.squares);
+    _mm256_store_pd(lanes, state.variance);
+    p.lastVariance = lanes[kLanes - 1];
+    _mm256_store_pd(lanes, state.maxVariance);
+    for (double v : lanes) {
+        p.maxVariance = v > p.maxVariance ? v : p.maxVariance;
+    }
+    rollingFinish(e, m, p, steps);
+}
+
+#endif
+
+// Mean of a strided sample of returns (the shift that keeps the power sums
+// well conditioned) and, for long series, a threshold safely above the
+// tailLevel quantile so the tail selection only sees a few percent of points.
+void sampleReturns(const double* e, size_t m, double level, double& shift, double& threshold) {
+    const size_t count = std::min(m, kSamples);
+    const size_t stride = m / count;
+    std::vector<double> sample(count);
+    double sum = 0.0;
+    for (size_t j = 0; j < count; ++j) {
+        sample[j] = simpleReturn(e, j * stride);
+        sum += sample[j];
+    }
+    shift = std::isfinite(sum) ? sum / static_cast<double>(count) : 0.0;
+    threshold = HUGE_VAL;
+    if (m >= kSampleTailFrom) {
+        const auto q = std::min(count - 1, static_cast<size_t>((level * 1.25 + 0.01) * static_cast<double>(count)));
+        std::nth_element(sample.begin(), sample.begin() + static_cast<std::ptrdiff_t>(q), sample.end());
+        threshold = sample[q];
+    }
+}
+
+} // namespace
+
+bool riskKernelsSimdSupported() {
+#ifdef FASTQUANT_HAVE_AVX2_KERNEL
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+RiskMetrics computeRiskMetrics(std::span<const double> equity,
+                               std::span<const TimePoint> timestamps,
+                               const RiskMetricsConfig& cfg) {
+    if (!timestamps.empty() && timestamps.size() != equity.size()) {
+        throw std::runtime_error("computeRiskMetrics: timestamps and equity differ in length");
+    }
+    const size_t n = equity.size();
+
+    RiskMetrics out;
+    out.periodsPerYear = cfg.periodsPerYear;
+    if (out.periodsPerYear <= 0.0) {
+        out.periodsPerYear = kDefaultPeriodsPerYear;
+        if (!timestamps.empty() && n > 1) {
+            const double span = std::chrono::duration<double>(timestamps.back() - timestamps.front()).count();
+            if (span > 0.0) {
+                out.periodsPerYear = kSecondsPerYear * static_cast<double>(n - 1) / span;
+            }
+        }
+    }
+    if (n < 2) {
+        return out;
+    }
+
+    const size_t m = n - 1;
+    const double* e = equity.data();
+    const bool simd = cfg.allowSimd && riskKernelsSimdSupported();
+    const double level = std::clamp(cfg.tailLevel, 0.0, 1.0);
+
+    ReturnPass pass;
+    sampleReturns(e, m, level, pass.shift, pass.tail.threshold);
+    pass.tail.reset(pass.tail.threshold == HUGE_VAL ? m : static_cast<size_t>(static_cast<double>(m) * (level * 1.5 + 0.02)));
+    pass.drawdown.peak = e[0];
+    pass.drawdown.trough = e[0];
+#ifdef FASTQUANT_HAVE_AVX2_KERNEL
+    if (simd) {
+        returnPassAvx2(e, m, pass, timestamps);
+    } else {
+        returnPassScalar(e, m, pass, timestamps);
+    }
+#else
+    returnPassScalar(e, m, pass, timestamps);
+#endif
+    pass.drawdown.close(timestamps);
+
+    // Central moments from the shifted power sums.
+    const double count = static_cast<double>(m);
+    const double a = combine(pass.s1);
+    const double b = combine(pass.s2);
+    const double c = combine(pass.s3);
+    const double d = combine(pass.s4);
+    const double mu = a / count;
+    const double m2 = std::max(0.0, b / count - mu * mu);
+    const double m3 = c / count - 3.0 * mu * b / count + 2.0 * mu * mu * mu;
+    const double m4 = d / count - 4.0 * mu * c / count + 6.0 * mu * mu * b / count - 3.0 * mu * mu * mu * mu;
+    const double mean = pass.shift + mu;
+
+    out.returns = m;
+    out.meanReturn = mean;
+    out.volatility = m > 1 ? std::sqrt(m2 * count / (count - 1.0)) : 0.0;
+    out.downsideDeviation = std::sqrt(combine(pass.down) / count);
+    out.worstReturn = std::min(std::min(pass.lo[0], pass.lo[1]), std::min(pass.lo[2], pass.lo[3]));
+    out.bestReturn = std::max(std::max(pass.hi[0], pass.hi[1]), std::max(pass.hi[2], pass.hi[3]));
+    if (m2 > 0.0) {
+        out.skewness = m3 / std::pow(m2, 1.5);
+        out.excessKurtosis = m4 / (m2 * m2) - 3.0;
+    }
+
+    const double annualize = std::sqrt(out.periodsPerYear);
+    out.annualizedVolatility = out.volatility * annualize;
+    if (out.volatility > 0.0) {
+        out.sharpe = mean / out.volatility * annualize;
+    }
+    if (out.downsideDeviation > 0.0) {
+        out.sortino = mean / out.downsideDeviation * annualize;
+    }
+    if (e[0] > 0.0 && e[m] > 0.0) {
+        out.annualizedReturn = std::pow(e[m] / e[0], out.periodsPerYear / count) - 1.0;
+    } else if (e[0] > 0.0) {
+        out.annualizedReturn = -1.0;
+    }
+
+    out.maxDrawdown = pass.drawdown.maxDrawdown;
+    out.maxDrawdownDuration = pass.drawdown.maxDuration;
+    out.maxDrawdownDurationSeconds = pass.drawdown.maxSeconds;
+    if (out.maxDrawdown > 0.0) {
+        out.calmar = out.annualizedReturn / out.maxDrawdown;
+    }
+
+    if (cfg.volatilityWindow >= 2 && cfg.volatilityWindow <= m) {
+        RollingPass rolling;
+        rolling.window = cfg.volatilityWindow;
+        rolling.run = (m - rolling.window + 1) / kLanes;
+        rolling.shift = mean;
+        rolling.invWindow = 1.0 / static_cast<double>(rolling.window);
+        rolling.invWindowMinusOne = 1.0 / (static_cast<double>(rolling.window) - 1.0);
+        rolling.ring.assign(rolling.window * kLanes, 0.0);
+#ifdef FASTQUANT_HAVE_AVX2_KERNEL
+        if (simd) {
+            rollingPassAvx2(e, m, rolling);
+        } else {
+            rollingPassScalar(e, m, rolling);
+        }
+#else
+        rollingPassScalar(e, m, rolling);
+#endif
+        out.rollingVolatility = std::sqrt(rolling.lastVariance) * annualize;
+        out.maxRollingVolatility = std::sqrt(rolling.maxVariance) * annualize;
+    }
+
+    // The k-th smallest return is the VaR; everything before it, the shortfall.
+    const auto rank = static_cast<size_t>(std::ceil(level * count));
+    const size_t k = std::min(m - 1, rank > 0 ? rank - 1 : 0);
+    std::vector<double>& tail = pass.tail.values;
+    tail.resize(pass.tail.size);
+    if (pass.tail.overflow || tail.size() <= k) {
+        tail.resize(m);
+        for (size_t i = 0; i < m; ++i) {
+            tail[i] = simpleReturn(e, i);
+        }
+    }
+    const auto kth = tail.begin() + static_cast<std::ptrdiff_t>(k);
+    std::nth_element(tail.begin(), kth, tail.end());
+    double shortfall = 0.0;
+    for (auto it = tail.begin(); it <= kth; ++it) {
+        shortfall += *it;
+    }
+    out.valueAtRisk = -*kth;
+    out.expectedShortfall = -shortfall / static_cast<double>(k + 1);
+    return out;
+}
+
+std::vector<double> rollingVolatility(std::span<const double> returns, size_t window) {
+    std::vector<double> out;
+    if (window < 2 || window > returns.size()) {
+        return out;
+    }
+    out.reserve(returns.size() - window + 1);
+    const double w = static_cast<double>(window);
+    const double shift = returns[0];
+    double sum = 0.0;
+    double squares = 0.0;
+    for (size_t i = 0; i < returns.size(); ++i) {
+        const double d = returns[i] - shift;
+        sum += d;
+        squares += d * d;
+        if (i + 1 < window) {
+            continue;
+        }
+        out.push_back(std::sqrt(std::max(0.0, (squares - sum * sum / w) / (w - 1.0))));
+        const double leaving = returns[i + 1 - window] - shift;
+        sum -= leaving;
+        squares -= leaving * leaving;
+    }
+    return out;
+}
+
+} // namespace fastquant
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace fastquant {
+
+struct RiskMetricsConfig {
+    double periodsPerYear = 0.0;  // 0 = infer from the timestamps' average spacing (252 without timestamps)
+    size_t volatilityWindow = 20; // returns per rolling volatility window
+    double tailLevel = 0.05;      // VaR / expected shortfall quantile
+    bool allowSimd = true;        // false forces the portable kernels (tests compare both)
+};
+
+// Risk figures over simple point-to-point returns r[i] = e[i+1] / e[i] - 1.
+// Ratios and volatilities are annualized with periodsPerYear; drawdowns are
+// fractions of the running peak; tail losses are positive numbers.
+struct RiskMetrics {
+    size_t returns{0};
+    double periodsPerYear{0.0};
+    double meanReturn{0.0};           // per period
+    double volatility{0.0};           // per period, sample standard deviation
+    double downsideDeviation{0.0};    // per period, root mean square of min(r, 0)
+    double annualizedReturn{0.0};     // compound (CAGR)
+    double annualizedVolatility{0.0};
+    double sharpe{0.0};               // zero risk-free rate
+    double sortino{0.0};
+    double calmar{0.0};               // annualized return / max drawdown
+    double maxDrawdown{0.0};          // fraction of the peak
+    size_t maxDrawdownDuration{0};    // points spent below a peak, longest stretch
+    double maxDrawdownDurationSeconds{0.0};
+    double rollingVolatility{0.0};    // annualized, last full window
+    double maxRollingVolatility{0.0}; // annualized, worst full window
+    double valueAtRisk{0.0};          // loss at the tailLevel quantile of returns
+    double expectedShortfall{0.0};    // mean loss at or beyond valueAtRisk
+    double skewness{0.0};
+    double excessKurtosis{0.0};
+    double bestReturn{0.0};
+    double worstReturn{0.0};
+};
+
+// Computes the full set in two passes over the equity without materialising
+// the returns: one fused pass for moments (as power sums around a sampled
+// mean), extremes, drawdown and tail candidates below a sampled threshold,
+// and one for the rolling window. Only the tail candidates are selected
+// over. Both passes use AVX2 when the CPU has it, chosen at runtime, and
+// give bit-identical results to the portable kernels. `timestamps` may be
+// empty; otherwise it must match `equity` in length.
+RiskMetrics computeRiskMetrics(std::span<const double> equity,
+                               std::span<const std::chrono::system_clock::time_point> timestamps,
+                               const RiskMetricsConfig& cfg = {});
+
+// Per-period sample standard deviation of each full `window` of returns;
+// out[i] covers returns[i .. i + window).
+std::vector<double> rollingVolatility(std::span<const double> returns, size_t window);
+
+bool riskKernelsSimdSupported();
+
+} // namespace fastquant
@@ -0,0 +1,61 @@
+#include "DatasetRegistry.h"
+
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace fastquant {
+namespace app {
+
+DatasetHandle DatasetRegistry::publish(std::string name, std::vector<Candle> candles, std::string source) {
+    if (name.empty()) {
+        throw std::runtime_error("Dataset name must not be empty");
+    }
+    auto snapshot = std::make_shared<DatasetSnapshot>();
+    snapshot->name = std::move(name);
+    snapshot->source = std::move(source);
+    snapshot->publishedAt = std::chrono::system_clock::now();
+    snapshot->candles = std::move(candles);
+    snapshot->fingerprint = fingerprintCandles(snapshot->candles);
+
+    DatasetHandle previous; // released outside the lock if this was its last reference
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    snapshot->version = nextVersion_++;
+    DatasetHandle handle = snapshot;
+    auto& slot = datasets_[snapshot->name];
+    previous = std::exchange(slot, handle);
+    lock.unlock();
+    return handle;
+}
+
+DatasetHandle DatasetRegistry::get(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = datasets_.find(name);
+    return it == datasets_.end() ? nullptr : it->second;
+}
+
+bool DatasetRegistry::remove(const std::string& name) {
+    DatasetHandle previous;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = datasets_.find(name);
+    if (it == datasets_.end()) {
+        return false;
+    }
+    previous = std::move(it->second);
+    datasets_.erase(it);
+    lock.unlock();
+    return true;
+}
+
+std::vector<DatasetHandle> DatasetRegistry::list() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<DatasetHandle> out;
+    out.reserve(datasets_.size());
+    for (const auto& [name, handle] : datasets_) {
+        out.push_back(handle);
+    }
+    return out;
+}
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../DataLoader/Candle.h"
+#include "ResultCache.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace fastquant {
+namespace app {
+
+// One published version of a named dataset. Never modified after publish();
+// a new load publishes a new snapshot instead.
+struct DatasetSnapshot {
+    std::string name;
+    uint64_t version{0};        // registry-wide, increases with every publish
+    std::string source;         // where it came from, for listings
+    std::chrono::system_clock::time_point publishedAt;
+    std::vector<Candle> candles;
+    DatasetFingerprint fingerprint; // of the candles, computed once at publish (ResultCache keys)
+};
+
+using DatasetHandle = std::shared_ptr<const DatasetSnapshot>;
+
+// Named, immutable candle datasets shared by every run that needs them.
+// Readers pin a snapshot by copying its handle under a brief shared lock and
+// then run on it without any lock; a concurrent publish() swaps in the new
+// version for later readers while pinned snapshots stay alive until their
+// last run lets go. The candles themselves are never copied.
+class DatasetRegistry {
+public:
+    DatasetHandle publish(std::string name, std::vector<Candle> candles, std::string source = {});
+
+    // Null when nothing has been published under `name`.
+    DatasetHandle get(const std::string& name) const;
+    bool remove(const std::string& name);
+    // Current version of every dataset, by name.
+    std::vector<DatasetHandle> list() const;
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::map<std::string, DatasetHandle> datasets_;
+    uint64_t nextVersion_{1};
+};
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,172 @@
+#include "JobQueue.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace fastquant {
+namespace app {
+
+const char* toString(JobState state) {
+    switch (state) {
+    case JobState::Queued: return "queued";
+    case JobState::Running: return "running";
+    case JobState::Succeeded: return "succeeded";
+    case JobState::Failed: return "failed";
+    case JobState::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+JobQueue::JobQueue(JobQueueConfig cfg)
+    : cfg_(cfg),
+      pool_(std::max<size_t>(1, cfg.workers)) {}
+
+JobQueue::~JobQueue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [id, job] : jobs_) {
+        if (job->status.state == JobState::Queued) {
+            --queued_;
+            finishLocked(*job, JobState::Cancelled);
+        } else if (job->status.state == JobState::Running) {
+            job->control.cancel();
+        }
+    }
+    // pool_ is destroyed next: it runs the (now no-op) queued tasks and joins.
+}
+
+std::optional<uint64_t> JobQueue::submit(std::string label, size_t totalCandles, Task task) {
+    auto job = std::make_shared<Job>();
+    job->status.label = std::move(label);
+    job->status.totalCandles = totalCandles;
+    job->status.submittedAt = std::chrono::system_clock::now();
+    job->task = std::move(task);
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queued_ >= std::max<size_t>(1, cfg_.maxQueued)) {
+            return std::nullopt;
+        }
+        ++queued_;
+        id = nextId_++;
+        job->status.id = id;
+        jobs_.emplace(id, job);
+    }
+    // Admission is bounded by queued_ above, so the pool queue itself is
+    // unbounded. A job cancelled while queued leaves a no-op task behind.
+    pool_.submit([this, job]() { execute(job); });
+    return id;
+}
+
+void JobQueue::execute(const std::shared_ptr<Job>& job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (job->status.state != JobState::Queued) {
+            return; // cancelled while waiting
+        }
+        --queued_;
+        ++running_;
+        job->status.state = JobState::Running;
+        job->status.startedAt = std::chrono::system_clock::now();
+    }
+    try {
+        auto result = std::make_shared<BacktestResult>(job->task(job->control));
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->status.candlesProcessed = result->candlesProcessed;
+        if (result->cancelled) {
+            finishLocked(*job, JobState::Cancelled);
+        } else {
+            job->result = std::move(result);
+            finishLocked(*job, JobState::Succeeded);
+        }
+    } catch (const std::exception& e) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->status.error = e.what();
+        finishLocked(*job, JobState::Failed);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->status.error = "unknown error";
+        finishLocked(*job, JobState::Failed);
+    }
+}
+
+void JobQueue::finishLocked(Job& job, JobState state) {
+    if (job.status.state == JobState::Running) {
+        --running_;
+    }
+    job.status.state = state;
+    job.status.finishedAt = std::chrono::system_clock::now();
+    job.task = nullptr; // release whatever the closure captured
+    retired_.push_back(job.status.id);
+    while (retired_.size() > cfg_.retainFinished) {
+        jobs_.erase(retired_.front());
+        retired_.pop_front();
+    }
+    finished_.notify_all();
+}
+
+JobStatus JobQueue::snapshotLocked(const Job& job) const {
+    JobStatus s = job.status;
+    if (s.state == JobState::Running) {
+        s.candlesProcessed = job.control.candlesProcessed();
+    }
+    if (s.state == JobState::Succeeded) {
+        s.progress = 1.0;
+    } else if (s.totalCandles > 0) {
+        s.progress = std::min(1.0, static_cast<double>(s.candlesProcessed) / static_cast<double>(s.totalCandles));
+    }
+    return s;
+}
+
+std::optional<JobStatus> JobQueue::status(uint64_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) {
+        return std::nullopt;
+    }
+    return snapshotLocked(*it->second);
+}
+
+std::shared_ptr<const BacktestResult> JobQueue::result(uint64_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    return it == jobs_.end() ? nullptr : it->second->result;
+}
+
+bool JobQueue::cancel(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) {
+        return false;
+    }
+    Job& job = *it->second;
+    if (job.status.state == JobState::Queued) {
+        --queued_;
+        finishLocked(job, JobState::Cancelled);
+        return true;
+    }
+    if (job.status.state == JobState::Running) {
+        job.control.cancel();
+        return true;
+    }
+    return false;
+}
+
+std::optional<JobStatus> JobQueue::wait(uint64_t id) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::shared_ptr<Job> job;
+    if (auto it = jobs_.find(id); it != jobs_.end()) {
+        job = it->second;
+    } else {
+        return std::nullopt;
+    }
+    finished_.wait(lock, [&]() { return job->status.finished(); });
+    return snapshotLocked(*job);
+}
+
+JobQueueDepth JobQueue::depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {queued_, running_};
+}
+
+} // namespace app
+} // namespace fastquant
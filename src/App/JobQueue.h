@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../BacktestEngine/BacktestEngine.h"
+#include "../BacktestEngine/RunControl.h"
+#include "../BacktestEngine/ThreadPool.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace fastquant {
+namespace app {
+
+enum class JobState { Queued, Running, Succeeded, Failed, Cancelled };
+
+const char* toString(JobState state);
+
+struct JobStatus {
+    uint64_t id{0};
+    std::string label;
+    JobState state{JobState::Queued};
+    size_t candlesProcessed{0};
+    size_t totalCandles{0};     // 0 when unknown (streamed input)
+    double progress{0.0};       // candlesProcessed / totalCandles, 1 once succeeded
+    std::string error;          // Failed only
+    std::chrono::system_clock::time_point submittedAt;
+    std::chrono::system_clock::time_point startedAt;
+    std::chrono::system_clock::time_point finishedAt;
+
+    bool finished() const { return state != JobState::Queued && state != JobState::Running; }
+};
+
+struct JobQueueDepth {
+    size_t queued{0};
+    size_t running{0};
+};
+
+struct JobQueueConfig {
+    size_t workers = 2;          // backtests running at once
+    size_t maxQueued = 16;       // waiting jobs before submit() rejects
+    size_t retainFinished = 64;  // finished jobs (and results) kept for polling
+};
+
+// Asynchronous backtest jobs on a fixed ThreadPool. submit() applies
+// admission control: when maxQueued jobs are already waiting it returns
+// nullopt instead of queueing (the server answers 429); cancelled jobs stop
+// counting at once. Each job gets its own
+// RunControl, which the task attaches to its engine so that status() can
+// report progress and cancel() can stop it between candles. Only the newest
+// retainFinished finished jobs are kept; older ids are forgotten.
+class JobQueue {
+public:
+    using Task = std::function<BacktestResult(RunControl&)>;
+
+    explicit JobQueue(JobQueueConfig cfg = {});
+    // Cancels everything still queued or running and waits for the workers.
+    ~JobQueue();
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    std::optional<uint64_t> submit(std::string label, size_t totalCandles, Task task);
+
+    std::optional<JobStatus> status(uint64_t id) const;
+    // Null unless the job succeeded.
+    std::shared_ptr<const BacktestResult> result(uint64_t id) const;
+    // Queued jobs are dropped immediately; running ones stop at the next
+    // candle. False for unknown or already finished jobs.
+    bool cancel(uint64_t id);
+    // Blocks until the job has finished; returns its final status.
+    std::optional<JobStatus> wait(uint64_t id) const;
+    // Jobs waiting and running right now (for monitoring).
+    JobQueueDepth depth() const;
+
+    const JobQueueConfig& config() const { return cfg_; }
+
+private:
+    struct Job {
+        JobStatus status;
+        Task task;
+        RunControl control;
+        std::shared_ptr<const BacktestResult> result;
+    };
+
+    void execute(const std::shared_ptr<Job>& job);
+    void finishLocked(Job& job, JobState state);
+    JobStatus snapshotLocked(const Job& job) const;
+
+    JobQueueConfig cfg_;
+    mutable std::mutex mutex_;
+    mutable std::condition_variable finished_;
+    std::map<uint64_t, std::shared_ptr<Job>> jobs_;
+    std::deque<uint64_t> retired_;
+    uint64_t nextId_{1};
+    size_t queued_{0};
+    size_t running_{0};
+    ThreadPool pool_; // last: joined before the job table goes away
+};
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,276 @@
+#include "Metrics.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace fastquant {
+namespace app {
+
+namespace {
+
+size_t threadSlot() {
+    static std::atomic<size_t> next{0};
+    thread_local const size_t slot = next.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return slot;
+}
+
+void appendNumber(std::string& out, double value) {
+    if (std::isnan(value)) {
+        out += "NaN";
+    } else if (std::isinf(value)) {
+        out += value > 0 ? "+Inf" : "-Inf";
+    } else {
+        char buf[32];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, ec == std::errc() ? end : buf);
+    }
+}
+
+void appendEscaped(std::string& out, const std::string& value, bool quoted) {
+    for (char c : value) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '"':
+                out += quoted ? "\\\"" : "\"";
+                break;
+            default: out += c;
+        }
+    }
+}
+
+// name{a="x",b="y"} -- `extra` is appended last (histogram "le").
+void appendSeries(std::string& out, const std::string& name, const MetricLabels& labels,
+                  const std::pair<std::string, std::string>* extra = nullptr) {
+    out += name;
+    if (labels.empty() && !extra) {
+        return;
+    }
+    out += '{';
+    bool first = true;
+    auto add = [&](const std::pair<std::string, std::string>& label) {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+        out += label.first;
+        out += "=\"";
+        appendEscaped(out, label.second, true);
+        out += '"';
+    };
+    for (const auto& label : labels) {
+        add(label);
+    }
+    if (extra) {
+        add(*extra);
+    }
+    out += '}';
+}
+
+const char* typeName(MetricType type) {
+    switch (type) {
+        case MetricType::Counter: return "counter";
+        case MetricType::Gauge: return "gauge";
+        case MetricType::Histogram: return "histogram";
+    }
+    return "untyped";
+}
+
+void appendHistogram(std::string& out, const std::string& name, const MetricLabels& labels, const Histogram::Snapshot& s) {
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < s.counts.size(); ++i) {
+        cumulative += s.counts[i];
+        std::string le;
+        if (i < s.bounds.size()) {
+            appendNumber(le, s.bounds[i]);
+        } else {
+            le = "+Inf";
+        }
+        const std::pair<std::string, std::string> bound{"le", le};
+        appendSeries(out, name + "_bucket", labels, &bound);
+        out += ' ';
+        out += std::to_string(cumulative);
+        out += '\n';
+    }
+    appendSeries(out, name + "_sum", labels);
+    out += ' ';
+    appendNumber(out, s.sum);
+    out += '\n';
+    appendSeries(out, name + "_count", labels);
+    out += ' ';
+    out += std::to_string(s.count);
+    out += '\n';
+}
+
+} // namespace
+
+void Counter::inc(uint64_t n) {
+    slots_[threadSlot()].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& slot : slots_) {
+        total += slot.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Histogram::Histogram(std::vector<double> bounds) : bounds_(std::move(bounds)) {
+    if (!std::is_sorted(bounds_.begin(), bounds_.end())
+        || std::adjacent_find(bounds_.begin(), bounds_.end()) != bounds_.end()) {
+        throw std::runtime_error("Histogram bounds must be strictly increasing");
+    }
+    constexpr size_t kWordsPerLine = 64 / sizeof(uint64_t);
+    stride_ = (bounds_.size() + 2 + kWordsPerLine - 1) / kWordsPerLine * kWordsPerLine;
+    cells_ = std::make_unique<std::atomic<uint64_t>[]>(stride_ * kMetricShards);
+    for (size_t i = 0; i < stride_ * kMetricShards; ++i) {
+        cells_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value) {
+    const size_t bucket = static_cast<size_t>(std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin());
+    std::atomic<uint64_t>* slot = cells_.get() + threadSlot() * stride_;
+    slot[bucket].fetch_add(1, std::memory_order_relaxed);
+    // Only this thread's slot (bar slot sharing past kMetricShards threads), so
+    // the exchange loop practically never retries.
+    auto& sum = slot[bounds_.size() + 1];
+    uint64_t bits = sum.load(std::memory_order_relaxed);
+    while (!sum.compare_exchange_weak(bits, std::bit_cast<uint64_t>(std::bit_cast<double>(bits) + value),
+                                      std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot s;
+    s.bounds = bounds_;
+    s.counts.assign(bounds_.size() + 1, 0);
+    for (size_t shard = 0; shard < kMetricShards; ++shard) {
+        const std::atomic<uint64_t>* slot = cells_.get() + shard * stride_;
+        for (size_t i = 0; i <= bounds_.size(); ++i) {
+            s.counts[i] += slot[i].load(std::memory_order_relaxed);
+        }
+        s.sum += std::bit_cast<double>(slot[bounds_.size() + 1].load(std::memory_order_relaxed));
+    }
+    for (uint64_t c : s.counts) {
+        s.count += c;
+    }
+    return s;
+}
+
+std::vector<double> exponentialBuckets(double start, double factor, size_t count) {
+    if (start <= 0.0 || factor <= 1.0) {
+        throw std::runtime_error("exponentialBuckets needs start > 0 and factor > 1");
+    }
+    std::vector<double> bounds;
+    bounds.reserve(count);
+    for (double b = start; bounds.size() < count; b *= factor) {
+        bounds.push_back(b);
+    }
+    return bounds;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, MetricType type) {
+    for (auto& f : families_) {
+        if (f->name == name) {
+            if (f->type != type) {
+                throw std::runtime_error("Metric '" + name + "' is already registered as a " + typeName(f->type));
+            }
+            return *f;
+        }
+    }
+    auto f = std::make_unique<Family>();
+    f->name = name;
+    f->help = help;
+    f->type = type;
+    families_.push_back(std::move(f));
+    return *families_.back();
+}
+
+MetricsRegistry::Series& MetricsRegistry::series(Family& f, const MetricLabels& labels) {
+    for (auto& s : f.series) {
+        if (s->labels == labels) {
+            return *s;
+        }
+    }
+    auto s = std::make_unique<Series>();
+    s->labels = labels;
+    f.series.push_back(std::move(s));
+    return *f.series.back();
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Series& s = series(family(name, help, MetricType::Counter), labels);
+    if (!s.counter) {
+        s.counter = std::make_unique<Counter>();
+    }
+    return *s.counter;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::vector<double>& bounds, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Family& f = family(name, help, MetricType::Histogram);
+    if (f.series.empty() && f.readers.empty()) {
+        f.bounds = bounds;
+    } else if (f.bounds != bounds) {
+        throw std::runtime_error("Histogram '" + name + "' is already registered with other buckets");
+    }
+    Series& s = series(f, labels);
+    if (!s.histogram) {
+        s.histogram = std::make_unique<Histogram>(bounds);
+    }
+    return *s.histogram;
+}
+
+void MetricsRegistry::sampled(const std::string& name, const std::string& help, MetricType type,
+                              std::function<std::vector<MetricSample>()> read) {
+    if (type == MetricType::Histogram) {
+        throw std::runtime_error("Sampled metric '" + name + "' must be a counter or gauge");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    family(name, help, type).readers.push_back(std::move(read));
+}
+
+std::string MetricsRegistry::scrape() const {
+    std::string out;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& f : families_) {
+        out += "# HELP ";
+        out += f->name;
+        out += ' ';
+        appendEscaped(out, f->help, false);
+        out += "\n# TYPE ";
+        out += f->name;
+        out += ' ';
+        out += typeName(f->type);
+        out += '\n';
+        for (const auto& s : f->series) {
+            if (s->histogram) {
+                appendHistogram(out, f->name, s->labels, s->histogram->snapshot());
+            } else if (s->counter) {
+                appendSeries(out, f->name, s->labels);
+                out += ' ';
+                out += std::to_string(s->counter->value());
+                out += '\n';
+            }
+        }
+        for (const auto& read : f->readers) {
+            for (const auto& sample : read()) {
+                appendSeries(out, f->name, sample.labels);
+                out += ' ';
+                appendNumber(out, sample.value);
+                out += '\n';
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace app
+} // namespace fastquant
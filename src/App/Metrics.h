@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fastquant {
+namespace app {
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+// Writers pick one of kMetricShards cache-line sized slots by a per-thread
+// index, so concurrent updates from different threads never share a line
+// (up to kMetricShards threads) and need no lock; a scrape sums the slots.
+inline constexpr size_t kMetricShards = 32;
+
+// Monotonic count, updated with a relaxed add on the calling thread's slot.
+class Counter {
+public:
+    void inc(uint64_t n = 1);
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Slot, kMetricShards> slots_;
+};
+
+// Fixed buckets chosen at construction (upper bounds, ascending; +Inf is
+// implicit). observe() is a bucket search plus two relaxed updates on the
+// calling thread's slot.
+class Histogram {
+public:
+    struct Snapshot {
+        std::vector<double> bounds;
+        std::vector<uint64_t> counts; // per bucket, bounds.size() + 1 (last is +Inf), not cumulative
+        uint64_t count{0};
+        double sum{0.0};
+    };
+
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double value);
+    Snapshot snapshot() const;
+    const std::vector<double>& bounds() const { return bounds_; }
+
+private:
+    std::vector<double> bounds_;
+    size_t stride_{0}; // words per slot: bucket counts, then the sum's bits, padded to a cache line
+    std::unique_ptr<std::atomic<uint64_t>[]> cells_;
+};
+
+// `count` bounds start, start*factor, ...
+std::vector<double> exponentialBuckets(double start, double factor, size_t count);
+
+enum class MetricType { Counter, Gauge, Histogram };
+
+struct MetricSample {
+    MetricLabels labels;
+    double value{0.0};
+};
+
+// Named metric families rendered in the Prometheus text exposition format
+// (version 0.0.4). counter() and histogram() return a series that stays
+// valid for the registry's lifetime; look it up once and keep the reference,
+// since registration takes a lock. Values owned elsewhere (queue depth,
+// cache statistics, dataset sizes) are registered as callbacks with
+// sampled() and read at scrape time. Families appear in registration order.
+// Registering a name again with a different type or histogram buckets
+// throws std::runtime_error.
+class MetricsRegistry {
+public:
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::vector<double>& bounds, const MetricLabels& labels = {});
+    void sampled(const std::string& name, const std::string& help, MetricType type,
+                 std::function<std::vector<MetricSample>()> read);
+
+    std::string scrape() const;
+
+private:
+    struct Series {
+        MetricLabels labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Histogram> histogram;
+    };
+    struct Family {
+        std::string name;
+        std::string help;
+        MetricType type{MetricType::Counter};
+        std::vector<double> bounds;
+        std::vector<std::unique_ptr<Series>> series;
+        std::vector<std::function<std::vector<MetricSample>()>> readers;
+    };
+
+    Family& family(const std::string& name, const std::string& help, MetricType type);
+    Series& series(Family& family, const MetricLabels& labels);
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Family>> families_;
+};
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,171 @@
+#include "ParameterSweep.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace fastquant {
+namespace app {
+namespace {
+
+size_t toWindow(double value) {
+    if (!(value >= 1.0)) {
+        return 1;
+    }
+    return static_cast<size_t>(std::llround(value));
+}
+
+constexpr std::array<std::string_view, 2> kMovingAverageParameters{"short_window", "long_window"};
+constexpr std::array<std::string_view, 4> kBreakoutParameters{"breakout_lookback", "breakout_buffer",
+                                                              "order_quantity", "allow_short"};
+
+} // namespace
+
+bool isSweepableField(const std::string& field) {
+    return field == "short_window"
+        || field == "long_window"
+        || field == "breakout_lookback"
+        || field == "breakout_buffer"
+        || field == "order_quantity"
+        || field == "allow_short";
+}
+
+void applySweepValue(StrategyConfig& cfg, const std::string& field, double value) {
+    if (field == "short_window") {
+        cfg.shortWindow = toWindow(value);
+    } else if (field == "long_window") {
+        cfg.longWindow = toWindow(value);
+    } else if (field == "breakout_lookback") {
+        cfg.breakoutLookback = toWindow(value);
+    } else if (field == "breakout_buffer") {
+        cfg.breakoutBuffer = value;
+    } else if (field == "order_quantity") {
+        cfg.orderQuantity = value;
+    } else if (field == "allow_short") {
+        cfg.allowShort = value != 0.0;
+    } else {
+        throw std::runtime_error("Unknown sweep parameter: " + field);
+    }
+}
+
+std::span<const std::string_view> strategyParameters(const std::string& type) {
+    if (type == "moving_average") {
+        return kMovingAverageParameters;
+    }
+    if (type == "breakout") {
+        return kBreakoutParameters;
+    }
+    return {};
+}
+
+double strategyParameter(const StrategyConfig& cfg, std::string_view field) {
+    if (field == "short_window") return static_cast<double>(cfg.shortWindow);
+    if (field == "long_window") return static_cast<double>(cfg.longWindow);
+    if (field == "breakout_lookback") return static_cast<double>(cfg.breakoutLookback);
+    if (field == "breakout_buffer") return cfg.breakoutBuffer;
+    if (field == "order_quantity") return cfg.orderQuantity;
+    if (field == "allow_short") return cfg.allowShort ? 1.0 : 0.0;
+    throw std::runtime_error("Unknown sweep parameter: " + std::string(field));
+}
+
+SweepObjective parseSweepObjective(const std::string& name) {
+    if (name == "total_return") return SweepObjective::TotalReturn;
+    if (name == "final_equity") return SweepObjective::FinalEquity;
+    if (name == "realized_pnl") return SweepObjective::RealizedPnl;
+    if (name == "max_drawdown") return SweepObjective::MaxDrawdown;
+    if (name == "win_rate") return SweepObjective::WinRate;
+    throw std::runtime_error("Unknown sweep objective: " + name);
+}
+
+std::string toString(SweepObjective objective) {
+    switch (objective) {
+        case SweepObjective::TotalReturn: return "total_return";
+        case SweepObjective::FinalEquity: return "final_equity";
+        case SweepObjective::RealizedPnl: return "realized_pnl";
+        case SweepObjective::MaxDrawdown: return "max_drawdown";
+        case SweepObjective::WinRate: return "win_rate";
+    }
+    return "total_return";
+}
+
+SweepSearch parseSweepSearch(const std::string& name) {
+    if (name == "grid") return SweepSearch::Grid;
+    if (name == "successive_halving") return SweepSearch::SuccessiveHalving;
+    throw std::runtime_error("Unknown sweep search: " + name);
+}
+
+std::string toString(SweepSearch search) {
+    return search == SweepSearch::SuccessiveHalving ? "successive_halving" : "grid";
+}
+
+SweepKernel parseSweepKernel(const std::string& name) {
+    if (name == "scalar") return SweepKernel::Scalar;
+    if (name == "ma_lanes") return SweepKernel::MovingAverageLanes;
+    if (name == "vectorized") return SweepKernel::Vectorized;
+    throw std::runtime_error("Unknown sweep kernel: " + name);
+}
+
+std::string toString(SweepKernel kernel) {
+    switch (kernel) {
+        case SweepKernel::Scalar: return "scalar";
+        case SweepKernel::MovingAverageLanes: return "ma_lanes";
+        case SweepKernel::Vectorized: return "vectorized";
+    }
+    return "scalar";
+}
+
+ParameterGrid::ParameterGrid(StrategyConfig base, std::vector<SweepAxis> axes)
+    : base_(std::move(base)), axes_(std::move(axes)) {
+    size_ = 1;
+    for (const auto& axis : axes_) {
+        if (!isSweepableField(axis.field)) {
+            throw std::runtime_error("Unknown sweep parameter: " + axis.field);
+        }
+        if (axis.values.empty()) {
+            throw std::runtime_error("Sweep parameter has no values: " + axis.field);
+        }
+        if (size_ > std::numeric_limits<size_t>::max() / axis.values.size()) {
+            throw std::runtime_error("Sweep grid is too large");
+        }
+        size_ *= axis.values.size();
+    }
+}
+
+StrategyConfig ParameterGrid::at(size_t index) const {
+    if (index >= size_) {
+        throw std::out_of_range("ParameterGrid index out of range");
+    }
+    StrategyConfig cfg = base_;
+    std::vector<size_t> digits(axes_.size());
+    for (size_t a = axes_.size(); a-- > 0;) {
+        const size_t radix = axes_[a].values.size();
+        digits[a] = index % radix;
+        index /= radix;
+    }
+
+    std::ostringstream name;
+    name << base_.name << '[';
+    for (size_t a = 0; a < axes_.size(); ++a) {
+        const double value = axes_[a].values[digits[a]];
+        applySweepValue(cfg, axes_[a].field, value);
+        if (a > 0) {
+            name << ',';
+        }
+        name << axes_[a].field << '=' << value;
+    }
+    name << ']';
+    cfg.name = name.str();
+    return cfg;
+}
+
+bool ParameterGrid::isValid(const StrategyConfig& cfg) {
+    if (cfg.type == "moving_average") {
+        return cfg.shortWindow < cfg.longWindow;
+    }
+    return cfg.breakoutLookback > 0 && cfg.orderQuantity > 0.0;
+}
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "StrategyConfig.h"
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fastquant {
+namespace app {
+
+// One swept StrategyConfig field. Ranges are expanded per axis (they are small);
+// the cartesian product across axes is never materialised.
+struct SweepAxis {
+    std::string field;          // config key, e.g. "short_window"
+    std::vector<double> values; // bools are stored as 0 / 1
+};
+
+enum class SweepObjective { TotalReturn, FinalEquity, RealizedPnl, MaxDrawdown, WinRate };
+
+// Grid evaluates every point on the full dataset. SuccessiveHalving scores all
+// points on a short prefix and promotes the best 1/eta to an eta-times longer
+// prefix until the survivors run on the full data.
+enum class SweepSearch { Grid, SuccessiveHalving };
+
+// Scalar evaluates every point as its own strategy instance (broadcast batches).
+// MovingAverageLanes runs moving_average points through the SIMD lane kernel.
+// Vectorized screens moving_average points with runVectorized: crossover
+// signals become a position column, accounted for column-wise. Its summaries
+// carry equity, drawdown, fees and fill counts but no realized PnL or win/loss
+// counts, so it only serves the total_return, final_equity and max_drawdown
+// objectives, and it neither reads nor fills the ResultCache. Both kernels
+// fall back to Scalar on multi-symbol data.
+enum class SweepKernel { Scalar, MovingAverageLanes, Vectorized };
+
+struct SweepConfig {
+    StrategyConfig base;
+    std::vector<SweepAxis> axes;
+    SweepObjective objective = SweepObjective::TotalReturn;
+    size_t topK = 10;
+    size_t threads = 0; // 0 = shared pool; walk-forward always uses the shared pool
+    SweepSearch search = SweepSearch::Grid;
+    double eta = 3.0;           // successive halving: promotion ratio per rung
+    double minBudget = 0.05;    // successive halving: first rung's share of the dataset
+    SweepKernel kernel = SweepKernel::Scalar;
+    std::optional<std::string> leaderboardCsvPath;
+};
+
+// Walk-forward analysis: optimise the sweep on a rolling in-sample window, then
+// trade the winner on the following out-of-sample window. Sizes are in candles.
+struct WalkForwardConfig {
+    size_t inSample = 500;
+    size_t outOfSample = 100;
+    size_t step = 0;        // 0 = advance by outOfSample; runWalkForward accepts no other step
+    bool anchored = false;  // true = in-sample always starts at the first candle
+    std::optional<std::string> equityCsvPath;
+    std::optional<std::string> jsonPath;
+};
+
+// ParameterGrid: lazy view over the cartesian product of the sweep axes.
+// A point is decoded from its flat index (mixed radix, last axis fastest),
+// so a 100k-point grid costs nothing until it is evaluated.
+class ParameterGrid {
+public:
+    ParameterGrid(StrategyConfig base, std::vector<SweepAxis> axes);
+
+    size_t size() const { return size_; }
+    const std::vector<SweepAxis>& axes() const { return axes_; }
+
+    // Build the StrategyConfig for grid point `index` (< size()).
+    StrategyConfig at(size_t index) const;
+
+    // False for points that cannot form a meaningful strategy
+    // (e.g. a moving average whose short window is not below the long one).
+    static bool isValid(const StrategyConfig& cfg);
+
+private:
+    StrategyConfig base_;
+    std::vector<SweepAxis> axes_;
+    size_t size_{0};
+};
+
+// Returns true if `field` names a StrategyConfig key that can be swept.
+bool isSweepableField(const std::string& field);
+
+// Apply a single swept value onto cfg. Throws std::runtime_error for unknown fields.
+void applySweepValue(StrategyConfig& cfg, const std::string& field, double value);
+
+// The sweepable fields buildStrategy reads for a strategy `type` (empty for
+// unknown types). Sweeps only accept these, and result keys hash only these,
+// so two configs differing elsewhere are the same run.
+std::span<const std::string_view> strategyParameters(const std::string& type);
+
+// Current value of a sweepable field, bools as 0 / 1. Throws std::runtime_error
+// for unknown fields.
+double strategyParameter(const StrategyConfig& cfg, std::string_view field);
+
+SweepObjective parseSweepObjective(const std::string& name);
+std::string toString(SweepObjective objective);
+SweepSearch parseSweepSearch(const std::string& name);
+std::string toString(SweepSearch search);
+SweepKernel parseSweepKernel(const std::string& name);
+std::string toString(SweepKernel kernel);
+
+} // namespace app
+} // namespace fastquant
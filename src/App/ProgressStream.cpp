@@ -0,0 +1,122 @@
+#include "ProgressStream.h"
+
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+namespace fastquant {
+namespace app {
+
+using json = nlohmann::json;
+
+ProgressStream::ProgressStream(Writer writer, size_t totalCandles, ProgressStreamConfig cfg,
+                               RunControl* cancelOnClose)
+    : writer_(std::move(writer)),
+      total_(totalCandles),
+      cfg_(cfg),
+      cancelOnClose_(cancelOnClose),
+      formatter_(cfg.timeFormat),
+      started_(std::chrono::steady_clock::now()),
+      lastSent_(started_) {
+    if (cfg_.maxEquityPoints > 0 && total_ > cfg_.maxEquityPoints) {
+        stride_ = (total_ + cfg_.maxEquityPoints - 1) / cfg_.maxEquityPoints;
+    }
+}
+
+void ProgressStream::onEquity(std::span<const std::chrono::system_clock::time_point> timestamps,
+                              std::span<const double> equity) {
+    for (size_t i = 0; i < equity.size(); ++i, ++equitySeen_) {
+        const auto ts = i < timestamps.size() ? timestamps[i] : std::chrono::system_clock::time_point{};
+        lastPoint_ = {ts, equity[i]};
+        lastPointSent_ = equitySeen_ % stride_ == 0;
+        if (lastPointSent_) {
+            pendingEquity_.push_back(lastPoint_);
+        }
+    }
+}
+
+void ProgressStream::onTrades(std::span<const Trade> trades) {
+    tradesSeen_ += trades.size();
+    const size_t keep = cfg_.maxTradesPerEvent;
+    if (trades.size() >= keep) {
+        pendingTrades_.assign(trades.end() - static_cast<std::ptrdiff_t>(keep), trades.end());
+        return;
+    }
+    pendingTrades_.insert(pendingTrades_.end(), trades.begin(), trades.end());
+    if (pendingTrades_.size() > keep) {
+        pendingTrades_.erase(pendingTrades_.begin(), pendingTrades_.end() - static_cast<std::ptrdiff_t>(keep));
+    }
+}
+
+void ProgressStream::onProgress(size_t candlesProcessed, bool finished) {
+    if (!open_) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (finished || now - lastSent_ >= cfg_.interval) {
+        lastSent_ = now;
+        flush(candlesProcessed, finished);
+    }
+}
+
+void ProgressStream::flush(size_t candlesProcessed, bool finished) {
+    if (finished && !lastPointSent_) {
+        // The curve always ends on the run's final equity.
+        pendingEquity_.push_back(lastPoint_);
+        lastPointSent_ = true;
+    }
+    auto stamp = [&](std::chrono::system_clock::time_point tp) -> json {
+        if (formatter_.numeric()) {
+            return formatter_.epoch(tp);
+        }
+        return std::string(formatter_(tp));
+    };
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+
+    json equity = json::array();
+    for (const auto& [ts, value] : pendingEquity_) {
+        equity.push_back({stamp(ts), value});
+    }
+    json trades = json::array();
+    for (auto it = pendingTrades_.rbegin(); it != pendingTrades_.rend(); ++it) {
+        trades.push_back({
+            {"date", stamp(it->timestamp)},
+            {"type", it->side == Side::Buy ? "BUY" : "SELL"},
+            {"price", it->price},
+            {"qty", it->qty}
+        });
+    }
+    json event{
+        {"candlesProcessed", candlesProcessed},
+        {"totalCandles", total_},
+        {"progress", total_ > 0 ? std::min(1.0, static_cast<double>(candlesProcessed) / static_cast<double>(total_)) : 0.0},
+        {"elapsedSeconds", elapsed},
+        {"candlesPerSecond", elapsed > 0.0 ? static_cast<double>(candlesProcessed) / elapsed : 0.0},
+        {"equity", std::move(equity)},
+        {"trades", std::move(trades)},
+        {"tradeCount", tradesSeen_},
+        {"finished", finished}
+    };
+    pendingEquity_.clear();
+    pendingTrades_.clear();
+    send("progress", event.dump());
+}
+
+bool ProgressStream::send(std::string_view event, std::string_view data) {
+    if (!open_) {
+        return false;
+    }
+    buffer_.clear();
+    buffer_.append("event: ").append(event).append("\ndata: ").append(data).append("\n\n");
+    if (!writer_(buffer_)) {
+        open_ = false;
+        if (cancelOnClose_) {
+            cancelOnClose_->cancel();
+        }
+        return false;
+    }
+    ++events_;
+    return true;
+}
+
+} // namespace app
+} // namespace fastquant
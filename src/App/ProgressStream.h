@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../BacktestEngine/RunControl.h"
+#include "../BacktestEngine/RunObserver.h"
+#include "../Reporter/TimestampFormatter.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fastquant {
+namespace app {
+
+struct ProgressStreamConfig {
+    std::chrono::milliseconds interval{250}; // minimum gap between progress events
+    size_t maxEquityPoints = 2000;           // whole run; every k-th point is forwarded
+    size_t maxTradesPerEvent = 50;           // newest kept when more arrive in one interval
+    TimestampFormat timeFormat = TimestampFormat::EpochSeconds;
+};
+
+// RunObserver that turns a run into Server-Sent Events for a chunked
+// response. Equity points are thinned to a stride chosen from the candle
+// count and trades to the newest few, then sent together with the progress
+// figures at most once per interval, so a fast engine is not throttled by the
+// connection. Events are handed to `writer`; once it reports the client gone,
+// nothing more is sent and `cancelOnClose` (if any) is cancelled.
+//
+//   event: progress
+//   data: {"candlesProcessed":..,"totalCandles":..,"progress":..,"candlesPerSecond":..,
+//          "equity":[[time,value],..],"trades":[{..}],"tradeCount":..,"finished":false}
+class ProgressStream : public RunObserver {
+public:
+    using Writer = std::function<bool(std::string_view)>;
+
+    ProgressStream(Writer writer, size_t totalCandles, ProgressStreamConfig cfg = {},
+                   RunControl* cancelOnClose = nullptr);
+
+    void onEquity(std::span<const std::chrono::system_clock::time_point> timestamps,
+                  std::span<const double> equity) override;
+    void onTrades(std::span<const Trade> trades) override;
+    void onProgress(size_t candlesProcessed, bool finished) override;
+
+    // One event with a single-line data payload. False once the client is gone.
+    bool send(std::string_view event, std::string_view data);
+
+    bool open() const { return open_; }
+    size_t eventsSent() const { return events_; }
+    size_t equityStride() const { return stride_; }
+
+private:
+    void flush(size_t candlesProcessed, bool finished);
+
+    Writer writer_;
+    size_t total_;
+    ProgressStreamConfig cfg_;
+    RunControl* cancelOnClose_;
+    TimestampFormatter formatter_;
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::steady_clock::time_point lastSent_;
+    size_t stride_{1};
+    size_t equitySeen_{0};
+    bool lastPointSent_{true};
+    std::pair<std::chrono::system_clock::time_point, double> lastPoint_{};
+    std::vector<std::pair<std::chrono::system_clock::time_point, double>> pendingEquity_;
+    std::vector<Trade> pendingTrades_;
+    size_t tradesSeen_{0};
+    std::string buffer_;
+    size_t events_{0};
+    bool open_{true};
+};
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,313 @@
+#include "ResultCache.h"
+#include "ParameterSweep.h"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace fastquant {
+namespace app {
+
+namespace {
+
+// Bump whenever engine changes alter results for the same inputs, so stale
+// entries (on disk in particular) stop matching.
+constexpr uint64_t kResultFormatVersion = 2;
+
+uint64_t finalize(uint64_t z) {
+    z ^= z >> 30;
+    z *= 0xBF58476D1CE4E5B9ull;
+    z ^= z >> 27;
+    z *= 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+void ContentHasher::add(uint64_t word) {
+    a_ = std::rotl(a_ ^ (word * 0x87C37B91114253D5ull), 31) * 0x9E3779B97F4A7C15ull + 0x52DCE729ull;
+    b_ = std::rotl(b_ ^ (word * 0x4CF5AD432745937Full), 33) * 0xC2B2AE3D27D4EB4Full + 0x38495AB5ull;
+    ++words_;
+}
+
+void ContentHasher::add(double value) {
+    add(std::bit_cast<uint64_t>(value));
+}
+
+void ContentHasher::add(std::string_view bytes) {
+    add(static_cast<uint64_t>(bytes.size()));
+    addBytes(bytes.data(), bytes.size());
+}
+
+void ContentHasher::addBytes(const char* data, size_t size) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        add(word);
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, size - i);
+        add(word);
+    }
+}
+
+uint64_t ContentHasher::hash() const {
+    return finalize(a_ ^ words_);
+}
+
+uint64_t ContentHasher::check() const {
+    return finalize(b_ + words_ * 0x9E3779B97F4A7C15ull);
+}
+
+DatasetFingerprint fingerprintCandles(std::span<const Candle> candles) {
+    ContentHasher h;
+    const std::string* symbol = nullptr;
+    for (size_t i = 0; i < candles.size(); ++i) {
+        const Candle& c = candles[i];
+        h.add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(c.timestamp.time_since_epoch()).count()));
+        h.add(c.open);
+        h.add(c.high);
+        h.add(c.low);
+        h.add(c.close);
+        h.add(c.volume);
+        // Symbols rarely change between rows; hash them only where they do.
+        if (!symbol || c.symbol != *symbol) {
+            h.add(static_cast<uint64_t>(i));
+            h.add(std::string_view(c.symbol));
+            symbol = &c.symbol;
+        }
+    }
+    h.add(static_cast<uint64_t>(candles.size()));
+    return {h.hash(), h.check(), candles.size()};
+}
+
+DatasetFingerprint fingerprintFile(const std::string& path, const CSVDataLoader::Config& cfg) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Unable to open data file for fingerprinting: " + path);
+    }
+    ContentHasher h;
+    std::vector<char> buffer(size_t{1} << 20); // a multiple of 8: chunking does not change the hash
+    uint64_t total = 0;
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const auto got = static_cast<size_t>(in.gcount());
+        h.addBytes(buffer.data(), got);
+        total += got;
+    }
+    if (in.bad()) {
+        throw std::runtime_error("Failed reading data file for fingerprinting: " + path);
+    }
+    h.add(total);
+    h.add(static_cast<uint64_t>(static_cast<unsigned char>(cfg.delimiter)));
+    h.add(static_cast<uint64_t>(cfg.hasHeader));
+    h.add(static_cast<uint64_t>(cfg.strict));
+    h.add(std::string_view(cfg.timestampFormat));
+    return {h.hash(), h.check(), total};
+}
+
+std::string ResultKey::hex() const {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string out(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        out[15 - i] = kDigits[(hash >> (4 * i)) & 0xF];
+        out[31 - i] = kDigits[(check >> (4 * i)) & 0xF];
+    }
+    return out;
+}
+
+ResultKey makeResultKey(const DatasetFingerprint& data,
+                        const StrategyConfig& strategy,
+                        const ExecutionConfig& execution,
+                        double initialCapital,
+                        const RunVariant& variant) {
+    ContentHasher h;
+    h.add(kResultFormatVersion);
+    h.add(data.hash);
+    h.add(data.check);
+    h.add(data.size);
+
+    h.add(std::string_view(strategy.type));
+    for (std::string_view field : strategyParameters(strategy.type)) {
+        h.add(strategyParameter(strategy, field));
+    }
+
+    h.add(execution.defaultSlippageBps);
+    h.add(execution.commissionPerShare);
+    h.add(execution.commissionBps);
+    h.add(initialCapital);
+
+    h.add(static_cast<uint64_t>(variant.summaryOnly));
+    h.add(static_cast<uint64_t>(variant.crossSectional));
+    h.add(static_cast<uint64_t>(variant.candleLimit));
+    // Summary-only runs record no curve, whatever the policy says.
+    if (!variant.summaryOnly) {
+        h.add(static_cast<uint64_t>(variant.equity.policy));
+        if (variant.equity.policy == EquityPolicy::EveryN) {
+            h.add(static_cast<uint64_t>(variant.equity.every));
+        } else if (variant.equity.policy == EquityPolicy::Downsample) {
+            h.add(static_cast<uint64_t>(variant.equity.maxPoints));
+        }
+    }
+
+    ResultKey key;
+    key.hash = h.hash();
+    key.check = h.check();
+    key.summaryOnly = variant.summaryOnly;
+    key.equity = variant.equity;
+    return key;
+}
+
+ResultCache::ResultCache(ResultCacheConfig cfg) {
+    configure(cfg);
+}
+
+ResultCache& ResultCache::shared() {
+    static ResultCache cache;
+    return cache;
+}
+
+void ResultCache::configure(const ResultCacheConfig& cfg) {
+    if (!cfg.directory.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(cfg.directory, ec);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    cfg_ = cfg;
+    evictLocked();
+}
+
+ResultCacheConfig ResultCache::config() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cfg_;
+}
+
+ResultCache::Entry ResultCache::find(const ResultKey& key) {
+    if (auto entry = findInMemory(key)) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return entry;
+    }
+    const std::string directory = config().directory;
+    if (!directory.empty()) {
+        if (auto entry = readFromDisk(key, directory)) {
+            store(key, entry);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            diskHits_.fetch_add(1, std::memory_order_relaxed);
+            return entry;
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+ResultCache::Entry ResultCache::insert(const ResultKey& key, BacktestResult result) {
+    auto entry = std::make_shared<const BacktestResult>(std::move(result));
+    if (entry->cancelled) {
+        return entry;
+    }
+    store(key, entry);
+    insertions_.fetch_add(1, std::memory_order_relaxed);
+    const std::string directory = config().directory;
+    if (!directory.empty() && !entry->equitySpill) {
+        try {
+            writeResultSnapshot(*entry, pathFor(key, directory));
+        } catch (const std::exception&) {
+            // Best effort: the memory entry is still there.
+        }
+    }
+    return entry;
+}
+
+ResultCache::Entry ResultCache::getOrRun(const ResultKey& key, const std::function<BacktestResult()>& run, bool* hit) {
+    auto entry = find(key);
+    if (hit) {
+        *hit = entry != nullptr;
+    }
+    return entry ? entry : insert(key, run());
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+ResultCacheStats ResultCache::stats() const {
+    ResultCacheStats s;
+    s.hits = hits_.load(std::memory_order_relaxed);
+    s.diskHits = diskHits_.load(std::memory_order_relaxed);
+    s.misses = misses_.load(std::memory_order_relaxed);
+    s.insertions = insertions_.load(std::memory_order_relaxed);
+    s.evictions = evictions_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    s.entries = lru_.size();
+    s.bytes = bytes_;
+    return s;
+}
+
+size_t ResultCache::entryBytes(const BacktestResult& result) {
+    return sizeof(BacktestResult)
+        + result.trades.capacity() * sizeof(Trade)
+        + result.equityCurve.capacity() * sizeof(double)
+        + result.equityTimestamps.capacity() * sizeof(std::chrono::system_clock::time_point)
+        + result.ledger.roundTrips().capacity() * sizeof(RoundTrip);
+}
+
+ResultCache::Entry ResultCache::findInMemory(const ResultKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->result;
+}
+
+ResultCache::Entry ResultCache::readFromDisk(const ResultKey& key, const std::string& directory) {
+    const std::string path = pathFor(key, directory);
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return nullptr;
+    }
+    try {
+        return std::make_shared<const BacktestResult>(resultFromSnapshot(readSnapshot(path), key.summaryOnly, key.equity));
+    } catch (const std::exception&) {
+        return nullptr; // torn or from an older build: rewritten on the next insert
+    }
+}
+
+void ResultCache::store(const ResultKey& key, const Entry& result) {
+    const size_t bytes = entryBytes(*result);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = index_.find(key); it != index_.end()) {
+        bytes_ -= it->second->bytes;
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+    lru_.push_front({key, result, bytes});
+    index_.emplace(key, lru_.begin());
+    bytes_ += bytes;
+    evictLocked();
+}
+
+void ResultCache::evictLocked() {
+    while (!lru_.empty() && (lru_.size() > cfg_.maxEntries || bytes_ > cfg_.maxBytes)) {
+        bytes_ -= lru_.back().bytes;
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+std::string ResultCache::pathFor(const ResultKey& key, const std::string& directory) const {
+    return (std::filesystem::path(directory) / (key.hex() + ".fqres")).string();
+}
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "../BacktestEngine/BacktestEngine.h"
+#include "../DataLoader/CSVDataLoader.h"
+#include "StrategyConfig.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace fastquant {
+namespace app {
+
+// Two independent 64-bit lanes over 8-byte words (multiply-rotate rounds and
+// a splitmix finalizer). Not cryptographic: fast enough to fingerprint a
+// dataset in a fraction of a load, wide enough that accidental collisions
+// between cache keys are not a practical concern.
+class ContentHasher {
+public:
+    void add(uint64_t word);
+    void add(double value);
+    void add(std::string_view bytes);  // length-prefixed
+    void addBytes(const char* data, size_t size); // raw, for file contents
+
+    uint64_t hash() const;
+    uint64_t check() const;
+
+private:
+    uint64_t a_{0x9E3779B97F4A7C15ull};
+    uint64_t b_{0xC2B2AE3D27D4EB4Full};
+    uint64_t words_{0};
+};
+
+// Identifies dataset content, not where it came from: republishing the same
+// candles (or rewriting the same CSV) gives the same fingerprint.
+struct DatasetFingerprint {
+    uint64_t hash{0};
+    uint64_t check{0};
+    uint64_t size{0}; // candles, or bytes for fingerprintFile
+
+    bool operator==(const DatasetFingerprint&) const = default;
+};
+
+DatasetFingerprint fingerprintCandles(std::span<const Candle> candles);
+// Raw CSV bytes plus the loader settings that decide how they parse, so the
+// streamed CLI path never has to load the file to key a run. Throws
+// std::runtime_error if the file cannot be read.
+DatasetFingerprint fingerprintFile(const std::string& path, const CSVDataLoader::Config& cfg);
+
+// Engine settings that change what a run produces, beyond the strategy,
+// execution and capital.
+struct RunVariant {
+    bool summaryOnly = false;
+    bool crossSectional = false;
+    size_t candleLimit = 0;
+    EquityRecording equity; // spillDir does not take part in the key
+};
+
+struct ResultKey {
+    uint64_t hash{0};
+    uint64_t check{0};
+    // Carried along to rebuild results read back from disk.
+    bool summaryOnly{false};
+    EquityRecording equity;
+
+    bool operator==(const ResultKey& other) const { return hash == other.hash && check == other.check; }
+    std::string hex() const;
+};
+
+// Only the StrategyConfig fields buildStrategy passes on for its type are
+// hashed (never the name), so e.g. renamed strategies or breakout settings
+// left on a moving-average config still hit.
+ResultKey makeResultKey(const DatasetFingerprint& data,
+                        const StrategyConfig& strategy,
+                        const ExecutionConfig& execution,
+                        double initialCapital,
+                        const RunVariant& variant = {});
+
+struct ResultCacheConfig {
+    size_t maxEntries = 256;
+    size_t maxBytes = size_t{512} << 20; // approximate, see ResultCache::entryBytes
+    std::string directory;               // empty = memory only
+};
+
+struct ResultCacheStats {
+    uint64_t hits{0};       // memory or disk
+    uint64_t diskHits{0};
+    uint64_t misses{0};
+    uint64_t insertions{0};
+    uint64_t evictions{0};
+    size_t entries{0};
+    size_t bytes{0};
+};
+
+// Finished backtests by ResultKey, shared by the server, executeBacktests and
+// the sweep optimizer. Memory holds an LRU of immutable results bounded by
+// entry count and approximate size; with a directory, results are also
+// written there as engine snapshots (<key>.fqres) and looked up on a memory
+// miss, so they survive restarts and are shared between processes.
+// Cancelled runs are never stored, and spilled curves stay in memory only.
+// Concurrent misses on one key are not coalesced: both run, the last insert
+// wins. Disk problems are never fatal; they count as misses.
+class ResultCache {
+public:
+    using Entry = std::shared_ptr<const BacktestResult>;
+
+    explicit ResultCache(ResultCacheConfig cfg = {});
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // Process-wide instance (memory only until configured).
+    static ResultCache& shared();
+
+    // Applies new bounds (evicting down to them) and directory.
+    void configure(const ResultCacheConfig& cfg);
+    ResultCacheConfig config() const;
+
+    // Null on a miss.
+    Entry find(const ResultKey& key);
+    Entry insert(const ResultKey& key, BacktestResult result);
+    // find(), else run() and insert. `hit` reports which happened.
+    Entry getOrRun(const ResultKey& key, const std::function<BacktestResult()>& run, bool* hit = nullptr);
+
+    // Drops the memory entries; files on disk are kept.
+    void clear();
+    ResultCacheStats stats() const;
+
+    static size_t entryBytes(const BacktestResult& result);
+
+private:
+    struct KeyHash {
+        size_t operator()(const ResultKey& key) const { return static_cast<size_t>(key.hash); }
+    };
+    struct Slot {
+        ResultKey key;
+        Entry result;
+        size_t bytes{0};
+    };
+    using Lru = std::list<Slot>; // most recently used first
+
+    Entry findInMemory(const ResultKey& key);
+    Entry readFromDisk(const ResultKey& key, const std::string& directory);
+    void store(const ResultKey& key, const Entry& result);
+    void evictLocked();
+    std::string pathFor(const ResultKey& key, const std::string& directory) const;
+
+    mutable std::mutex mutex_;
+    ResultCacheConfig cfg_;
+    Lru lru_;
+    std::unordered_map<ResultKey, Lru::iterator, KeyHash> index_;
+    size_t bytes_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> diskHits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> insertions_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+} // namespace app
+} // namespace fastquant
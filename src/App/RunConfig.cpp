@@ -1,8 +1,11 @@
 #include "RunConfig.h"
 #include "EnvLoader.h"
+#include "../BacktestEngine/ThreadPool.h"
+#include "../Reporter/ColumnarReport.h"
 #include "../Strategy/BreakoutStrategy.h"
 #include "../Strategy/MovingAverageStrategy.h"
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <memory>
@@ -10,6 +13,7 @@
 #include <stdexcept>
 #include <unordered_map>
 #include <cctype>
+#include <cmath>
 #include <functional>
 
 namespace fastquant {
@@ -74,6 +78,21 @@ ReporterOutputs parseReporterOutputs(const nlohmann::json& reportSection, const
         return outputs;
     }
     outputs.printSummary = reportSection.value("print_summary", outputs.printSummary);
+    const auto jsonStyle = reportSection.value("json_style", std::string("pretty"));
+    if (jsonStyle == "compact") {
+        outputs.jsonStyle = JsonStyle::Compact;
+    } else if (jsonStyle != "pretty") {
+        throw std::runtime_error("Unknown reporter.json_style: " + jsonStyle);
+    }
+    outputs.timestampFormat = parseTimestampFormat(reportSection.value("timestamp_format", std::string("iso8601")));
+    if (auto it = reportSection.find("risk"); it != reportSection.end() && it->is_object()) {
+        outputs.risk.periodsPerYear = it->value("periods_per_year", outputs.risk.periodsPerYear);
+        outputs.risk.volatilityWindow = it->value("volatility_window", outputs.risk.volatilityWindow);
+        outputs.risk.tailLevel = it->value("tail_level", outputs.risk.tailLevel);
+        if (outputs.risk.periodsPerYear < 0.0 || outputs.risk.tailLevel <= 0.0 || outputs.risk.tailLevel >= 1.0) {
+            throw std::runtime_error("reporter.risk needs periods_per_year >= 0 and 0 < tail_level < 1");
+        }
+    }
     if (auto it = reportSection.find("json"); it != reportSection.end() && it->is_string()) {
         outputs.jsonPath = resolvePath(baseDir, it->get<std::string>());
     }
@@ -83,9 +102,40 @@ ReporterOutputs parseReporterOutputs(const nlohmann::json& reportSection, const
     if (auto it = reportSection.find("trades_csv"); it != reportSection.end() && it->is_string()) {
         outputs.tradesCsvPath = resolvePath(baseDir, it->get<std::string>());
     }
+    if (auto it = reportSection.find("round_trips_csv"); it != reportSection.end() && it->is_string()) {
+        outputs.roundTripsCsvPath = resolvePath(baseDir, it->get<std::string>());
+    }
+    if (auto it = reportSection.find("equity_csv"); it != reportSection.end() && it->is_string()) {
+        outputs.equityCsvPath = resolvePath(baseDir, it->get<std::string>());
+    }
+    for (const char* key : {"columnar", "binary"}) {
+        if (auto it = reportSection.find(key); it != reportSection.end() && it->is_string()) {
+            if (outputs.columnarPath) {
+                throw std::runtime_error("reporter.columnar and reporter.binary name the same output; set only one");
+            }
+            outputs.columnarPath = resolvePath(baseDir, it->get<std::string>());
+        }
+    }
     return outputs;
 }
 
+EquityRecording parseEquityRecording(const nlohmann::json& section, const std::filesystem::path& baseDir) {
+    EquityRecording rec;
+    rec.policy = parseEquityPolicy(section.value("policy", std::string("all")));
+    rec.every = section.value("every", rec.every);
+    rec.maxPoints = section.value("max_points", rec.maxPoints);
+    if (auto it = section.find("spill_dir"); it != section.end() && it->is_string()) {
+        rec.spillDir = resolvePath(baseDir, it->get<std::string>());
+    }
+    if (rec.policy == EquityPolicy::EveryN && rec.every == 0) {
+        throw std::runtime_error("engine.equity.every must be positive");
+    }
+    if (rec.policy == EquityPolicy::Downsample && rec.maxPoints < 3) {
+        throw std::runtime_error("engine.equity.max_points must be at least 3");
+    }
+    return rec;
+}
+
 ExecutionConfig parseExecutionConfig(const nlohmann::json& execSection) {
     ExecutionConfig exec;
     if (!execSection.is_object()) {
@@ -142,6 +192,161 @@ APIDataConfig parseApiDataConfig(const nlohmann::json& dataSection) {
     return cfg;
 }
 
+std::vector<double> parseSweepValues(const std::string& field, const nlohmann::json& spec) {
+    std::vector<double> values;
+    if (spec.is_array()) {
+        for (const auto& v : spec) {
+            if (v.is_boolean()) {
+                values.push_back(v.get<bool>() ? 1.0 : 0.0);
+            } else if (v.is_number()) {
+                values.push_back(v.get<double>());
+            } else {
+                throw std::runtime_error("Sweep values for '" + field + "' must be numbers or booleans");
+            }
+        }
+        return values;
+    }
+    if (spec.is_object()) {
+        if (!spec.contains("from") || !spec.contains("to")) {
+            throw std::runtime_error("Sweep range for '" + field + "' requires 'from' and 'to'");
+        }
+        const double from = spec.at("from").get<double>();
+        const double to = spec.at("to").get<double>();
+        const double step = spec.value("step", 1.0);
+        if (step <= 0.0) {
+            throw std::runtime_error("Sweep range for '" + field + "' requires a positive 'step'");
+        }
+        if (to < from) {
+            return values;
+        }
+        // Index-based expansion avoids accumulating floating point error across steps.
+        const auto count = static_cast<size_t>(std::floor((to - from) / step + 1e-9)) + 1;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            values.push_back(from + static_cast<double>(i) * step);
+        }
+        return values;
+    }
+    if (spec.is_number() || spec.is_boolean()) {
+        values.push_back(spec.is_boolean() ? (spec.get<bool>() ? 1.0 : 0.0) : spec.get<double>());
+        return values;
+    }
+    throw std::runtime_error("Invalid sweep specification for '" + field + "'");
+}
+
+SweepConfig parseSweepConfig(const nlohmann::json& sweepSection,
+                             const StrategyConfig& fallbackBase,
+                             const std::filesystem::path& baseDir) {
+    SweepConfig sweep;
+    sweep.base = fallbackBase;
+    if (auto it = sweepSection.find("base"); it != sweepSection.end()) {
+        sweep.base = parseStrategyConfig(*it);
+    } else if (auto typeIt = sweepSection.find("type"); typeIt != sweepSection.end() && typeIt->is_string()) {
+        sweep.base.type = typeIt->get<std::string>();
+    }
+    if (sweep.base.name.empty() || sweep.base.name == "strategy") {
+        sweep.base.name = sweep.base.type;
+    }
+
+    auto params = sweepSection.find("parameters");
+    if (params == sweepSection.end() || !params->is_object() || params->empty()) {
+        throw std::runtime_error("Config 'sweep' requires a non-empty 'parameters' object");
+    }
+    for (auto it = params->begin(); it != params->end(); ++it) {
+        if (!isSweepableField(it.key())) {
+            throw std::runtime_error("Unknown sweep parameter: " + it.key());
+        }
+        // A field buildStrategy ignores would only multiply the grid with identical runs.
+        const auto applicable = strategyParameters(sweep.base.type);
+        if (std::find(applicable.begin(), applicable.end(), it.key()) == applicable.end()) {
+            throw std::runtime_error("Sweep parameter '" + it.key() + "' does not apply to strategy type '" +
+                                     sweep.base.type + "'");
+        }
+        SweepAxis axis;
+        axis.field = it.key();
+        axis.values = parseSweepValues(axis.field, it.value());
+        if (axis.values.empty()) {
+            throw std::runtime_error("Sweep parameter has no values: " + axis.field);
+        }
+        sweep.axes.push_back(std::move(axis));
+    }
+
+    sweep.objective = parseSweepObjective(sweepSection.value("objective", toString(sweep.objective)));
+    sweep.topK = sweepSection.value("top_k", sweep.topK);
+    if (sweep.topK == 0) sweep.topK = 1;
+    sweep.threads = sweepSection.value("threads", sweep.threads);
+    sweep.search = parseSweepSearch(sweepSection.value("search", toString(sweep.search)));
+    sweep.eta = sweepSection.value("eta", sweep.eta);
+    if (sweep.eta < 2.0) {
+        throw std::runtime_error("Sweep 'eta' must be at least 2");
+    }
+    sweep.minBudget = sweepSection.value("min_budget", sweep.minBudget);
+    if (sweep.minBudget <= 0.0 || sweep.minBudget > 1.0) {
+        throw std::runtime_error("Sweep 'min_budget' must be in (0, 1]");
+    }
+    sweep.kernel = parseSweepKernel(sweepSection.value("kernel", toString(sweep.kernel)));
+    if (sweep.kernel == SweepKernel::MovingAverageLanes && sweep.base.type != "moving_average") {
+        throw std::runtime_error("Sweep kernel 'ma_lanes' requires a moving_average base strategy");
+    }
+    if (sweep.kernel == SweepKernel::Vectorized) {
+        if (sweep.base.type != "moving_average") {
+            throw std::runtime_error("Sweep kernel 'vectorized' requires a moving_average base strategy");
+        }
+        if (sweep.objective == SweepObjective::RealizedPnl || sweep.objective == SweepObjective::WinRate) {
+            throw std::runtime_error("Sweep kernel 'vectorized' cannot rank by " + toString(sweep.objective));
+        }
+    }
+    if (auto it = sweepSection.find("leaderboard_csv"); it != sweepSection.end() && it->is_string()) {
+        sweep.leaderboardCsvPath = resolvePath(baseDir, it->get<std::string>());
+    }
+    return sweep;
+}
+
+WalkForwardConfig parseWalkForwardConfig(const nlohmann::json& wfSection, const std::filesystem::path& baseDir) {
+    WalkForwardConfig wf;
+    wf.inSample = wfSection.value("in_sample", wf.inSample);
+    wf.outOfSample = wfSection.value("out_of_sample", wf.outOfSample);
+    wf.step = wfSection.value("step", wf.step);
+    wf.anchored = wfSection.value("anchored", wf.anchored);
+    if (wf.inSample == 0 || wf.outOfSample == 0) {
+        throw std::runtime_error("Config 'walk_forward' requires positive 'in_sample' and 'out_of_sample'");
+    }
+    // Stitching chains the OOS windows end to end; any other step overlaps or gaps them.
+    if (wf.step != 0 && wf.step != wf.outOfSample) {
+        throw std::runtime_error("Config 'walk_forward' requires 'step' to equal 'out_of_sample'");
+    }
+    if (auto it = wfSection.find("equity_csv"); it != wfSection.end() && it->is_string()) {
+        wf.equityCsvPath = resolvePath(baseDir, it->get<std::string>());
+    }
+    if (auto it = wfSection.find("json"); it != wfSection.end() && it->is_string()) {
+        wf.jsonPath = resolvePath(baseDir, it->get<std::string>());
+    }
+    return wf;
+}
+
+BootstrapConfig parseRobustnessConfig(const nlohmann::json& section) {
+    BootstrapConfig bs;
+    auto method = section.value("method", std::string("trades"));
+    if (method == "trades") {
+        bs.method = BootstrapMethod::TradeReturns;
+    } else if (method == "equity_blocks") {
+        bs.method = BootstrapMethod::EquityBlocks;
+    } else {
+        throw std::runtime_error("Unknown robustness method: " + method);
+    }
+    bs.paths = section.value("paths", bs.paths);
+    bs.blockSize = section.value("block_size", bs.blockSize);
+    bs.seed = section.value("seed", bs.seed);
+    bs.threads = section.value("threads", bs.threads);
+    if (auto it = section.find("quantiles"); it != section.end() && it->is_array()) {
+        bs.quantiles = it->get<std::vector<double>>();
+    }
+    if (bs.paths == 0) {
+        throw std::runtime_error("Config 'robustness' requires paths > 0");
+    }
+    return bs;
+}
+
 std::vector<StrategyConfig> parseStrategyList(const nlohmann::json& root) {
     std::vector<StrategyConfig> list;
     auto it = root.find("strategies");
@@ -221,9 +426,57 @@ ReporterOutputs resolveOutputsForStrategy(const ReporterOutputs& base,
     apply(resolved.jsonPath);
     apply(resolved.summaryCsvPath);
     apply(resolved.tradesCsvPath);
+    apply(resolved.roundTripsCsvPath);
+    apply(resolved.equityCsvPath);
+    apply(resolved.columnarPath);
     return resolved;
 }
 
+void ensureParentDirectory(const std::string& path) {
+    if (path.empty()) return;
+    std::filesystem::path p(path);
+    auto parent = p.parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent);
+    }
+}
+
+void ensureOutputDirectories(const ReporterOutputs& outputs) {
+    for (const auto* path : {&outputs.jsonPath, &outputs.summaryCsvPath, &outputs.tradesCsvPath,
+                             &outputs.roundTripsCsvPath, &outputs.equityCsvPath, &outputs.columnarPath}) {
+        if (*path) {
+            ensureParentDirectory(**path);
+        }
+    }
+}
+
+// Summarize one run and write its configured files. Directories must exist
+// already, so concurrent calls never race on create_directories.
+ReportSummary writeRunReports(const Reporter& reporter, const BacktestResult& result, const ReporterOutputs& outputs) {
+    auto summary = reporter.summarize(result);
+    if (outputs.jsonPath) {
+        reporter.writeJson(result, summary, *outputs.jsonPath, outputs.jsonStyle);
+    }
+    if (outputs.summaryCsvPath) {
+        reporter.writeSummaryCsv(summary, *outputs.summaryCsvPath);
+    }
+    if (outputs.tradesCsvPath) {
+        reporter.writeTradesCsv(result, *outputs.tradesCsvPath);
+    }
+    if (outputs.roundTripsCsvPath) {
+        reporter.writeRoundTripsCsv(result, *outputs.roundTripsCsvPath);
+    }
+    if (outputs.equityCsvPath) {
+        reporter.writeEquityCsv(result, *outputs.equityCsvPath);
+    }
+    if (outputs.columnarPath) {
+        writeColumnarReport(result, *outputs.columnarPath);
+    }
+    return summary;
+}
+
+} // namespace
+
 std::unique_ptr<Strategy> buildStrategy(const StrategyConfig& cfg) {
     if (cfg.type == "moving_average") {
         return std::make_unique<MovingAverageStrategy>(cfg.shortWindow, cfg.longWindow);
@@ -236,16 +489,33 @@ std::unique_ptr<Strategy> buildStrategy(const StrategyConfig& cfg) {
     throw std::runtime_error(oss.str());
 }
 
-void ensureParentDirectory(const std::string& path) {
-    if (path.empty()) return;
-    std::filesystem::path p(path);
-    auto parent = p.parent_path();
-    if (!parent.empty()) {
-        std::filesystem::create_directories(parent);
+ResultCache* resultCache(const RunConfig& cfg) {
+    if (!cfg.cache) {
+        return nullptr;
     }
+    ResultCache& cache = ResultCache::shared();
+    cache.configure(*cfg.cache);
+    return &cache;
 }
 
-} // namespace
+std::vector<Candle> loadDataset(const RunConfig& cfg) {
+    if (cfg.dataSource == DataSourceKind::API) {
+        if (!cfg.apiData) {
+            throw std::runtime_error("API data source selected but no configuration provided");
+        }
+        APIDataLoader loader;
+        return loader.fetch(*cfg.apiData);
+    }
+    // Stream rather than load() so the in-memory dataset accepts exactly the rows
+    // (ISO-8601 and epoch timestamps) that a streamed BacktestEngine::run would.
+    std::vector<Candle> candles;
+    CSVDataLoader loader;
+    loader.stream(cfg.dataPath, [&](const Candle& c) {
+        candles.push_back(c);
+        return true;
+    }, cfg.loaderConfig);
+    return candles;
+}
 
 RunConfig loadRunConfig(const std::string& path) {
     std::filesystem::path absPath = std::filesystem::weakly_canonical(std::filesystem::path(path));
@@ -295,13 +565,68 @@ RunConfig loadRunConfig(const std::string& path) {
     const auto& engineSection = j.value("engine", nlohmann::json::object());
     cfg.initialCapital = engineSection.value("initial_capital", cfg.initialCapital);
     cfg.execution = parseExecutionConfig(engineSection.value("execution", nlohmann::json::object()));
+    cfg.crossSectional = engineSection.value("cross_sectional", cfg.crossSectional);
+    cfg.summaryOnly = engineSection.value("summary_only", cfg.summaryOnly);
+    if (auto eqIt = engineSection.find("equity"); eqIt != engineSection.end() && eqIt->is_object()) {
+        cfg.equityRecording = parseEquityRecording(*eqIt, baseDir);
+    }
+    if (auto cpIt = engineSection.find("checkpoint"); cpIt != engineSection.end() && cpIt->is_object()) {
+        CheckpointConfig cp;
+        cp.path = resolvePath(baseDir, cpIt->value("path", std::string("checkpoint.snap")));
+        cp.everyCandles = cpIt->value("every", static_cast<size_t>(0));
+        if (cp.everyCandles == 0) {
+            throw std::runtime_error("engine.checkpoint.every must be positive");
+        }
+        cfg.checkpoint = cp;
+    }
+    if (auto resumeIt = engineSection.find("resume_from"); resumeIt != engineSection.end() && resumeIt->is_string()) {
+        cfg.resumeFrom = resolvePath(baseDir, resumeIt->get<std::string>());
+    }
+    if (auto cacheIt = engineSection.find("cache"); cacheIt != engineSection.end() && cacheIt->is_object()) {
+        ResultCacheConfig cache;
+        cache.maxEntries = cacheIt->value("max_entries", cache.maxEntries);
+        cache.maxBytes = cacheIt->value("max_mb", cache.maxBytes >> 20) << 20;
+        if (auto dirIt = cacheIt->find("dir"); dirIt != cacheIt->end() && dirIt->is_string()) {
+            cache.directory = resolvePath(baseDir, dirIt->get<std::string>());
+        }
+        cfg.cache = cache;
+    }
+    if ((cfg.checkpoint || cfg.resumeFrom) && (cfg.strategies.size() != 1 || cfg.crossSectional)) {
+        throw std::runtime_error("engine.checkpoint/resume_from support a single, non cross-sectional strategy");
+    }
+    if ((cfg.checkpoint || cfg.resumeFrom)
+        && (cfg.equityRecording.policy == EquityPolicy::Downsample || cfg.equityRecording.policy == EquityPolicy::Spill)) {
+        throw std::runtime_error("engine.checkpoint/resume_from cannot be combined with the '"
+                                 + toString(cfg.equityRecording.policy) + "' equity policy");
+    }
     cfg.outputs = parseReporterOutputs(j.value("reporter", nlohmann::json::object()), baseDir);
+    if (auto sweepIt = j.find("sweep"); sweepIt != j.end() && sweepIt->is_object()) {
+        cfg.sweep = parseSweepConfig(*sweepIt, cfg.strategy, baseDir);
+    }
+    if (auto rbIt = j.find("robustness"); rbIt != j.end() && rbIt->is_object()) {
+        cfg.robustness = parseRobustnessConfig(*rbIt);
+    }
+    if (auto wfIt = j.find("walk_forward"); wfIt != j.end() && wfIt->is_object()) {
+        if (!cfg.sweep) {
+            throw std::runtime_error("Config 'walk_forward' requires a 'sweep' section to optimise");
+        }
+        cfg.walkForward = parseWalkForwardConfig(*wfIt, baseDir);
+    }
+    if (cfg.summaryOnly && (cfg.robustness || cfg.outputs.tradesCsvPath || cfg.outputs.roundTripsCsvPath)) {
+        throw std::runtime_error("engine.summary_only keeps no trades; drop 'robustness', reporter.trades_csv and reporter.round_trips_csv");
+    }
+    if (cfg.robustness && cfg.robustness->method == BootstrapMethod::EquityBlocks
+        && cfg.equityRecording.policy != EquityPolicy::All) {
+        throw std::runtime_error("robustness.method 'equity_blocks' needs the full equity curve (engine.equity.policy 'all')");
+    }
     return cfg;
 }
 
 BacktestResult executeBacktest(const RunConfig& cfg) {
     const StrategyConfig& stratCfg = cfg.strategies.empty() ? cfg.strategy : cfg.strategies.front();
     BacktestEngine engine(cfg.execution);
+    engine.setSummaryOnly(cfg.summaryOnly);
+    engine.setEquityRecording(cfg.equityRecording);
     auto strategy = buildStrategy(stratCfg);
     if (cfg.dataSource == DataSourceKind::API) {
         if (!cfg.apiData) {
@@ -321,77 +646,134 @@ std::vector<StrategyRunResult> executeBacktests(const RunConfig& cfg) {
     }
 
     BacktestEngine engine(cfg.execution);
+    engine.setSummaryOnly(cfg.summaryOnly);
+    engine.setEquityRecording(cfg.equityRecording);
+
+    // Cached strategies are filled in up front; only the rest (`pending`) run.
+    std::vector<BacktestResult> cached(strategies.size());
+    std::vector<ResultKey> keys;
+    std::vector<size_t> pending;
+    std::vector<Candle> apiCandles;
+    ResultCache* cache = (cfg.checkpoint || cfg.resumeFrom) ? nullptr : resultCache(cfg);
+    if (cache) {
+        DatasetFingerprint data;
+        if (cfg.dataSource == DataSourceKind::API) {
+            apiCandles = loadDataset(cfg);
+            data = fingerprintCandles(apiCandles);
+        } else {
+            data = fingerprintFile(cfg.dataPath, cfg.loaderConfig);
+        }
+        RunVariant variant;
+        variant.summaryOnly = cfg.summaryOnly;
+        variant.crossSectional = cfg.crossSectional;
+        variant.equity = cfg.equityRecording;
+        for (size_t i = 0; i < strategies.size(); ++i) {
+            keys.push_back(makeResultKey(data, strategies[i], cfg.execution, cfg.initialCapital, variant));
+            if (auto hit = cache->find(keys.back())) {
+                cached[i] = hit->clone();
+            } else {
+                pending.push_back(i);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < strategies.size(); ++i) {
+            pending.push_back(i);
+        }
+    }
+
     std::vector<std::function<std::unique_ptr<Strategy>()>> factories;
-    factories.reserve(strategies.size());
-    for (const auto& stratCfg : strategies) {
-        factories.emplace_back([stratCfg]() {
+    factories.reserve(pending.size());
+    for (size_t i : pending) {
+        factories.emplace_back([stratCfg = strategies[i]]() {
             return buildStrategy(stratCfg);
         });
     }
 
     std::vector<BacktestResult> results;
-    std::vector<Candle> apiCandles;
-    if (cfg.dataSource == DataSourceKind::API) {
+    if (factories.empty()) {
+        // Everything was cached.
+    } else if (cfg.checkpoint || cfg.resumeFrom) {
+        // Checkpointed runs are single-strategy (enforced by loadRunConfig).
+        if (cfg.checkpoint) {
+            engine.setCheckpoint(*cfg.checkpoint);
+        }
+        auto strategy = factories.front()();
+        if (cfg.dataSource == DataSourceKind::API) {
+            apiCandles = loadDataset(cfg);
+        }
+        if (cfg.resumeFrom) {
+            const auto snapshot = readSnapshot(*cfg.resumeFrom);
+            results.push_back(cfg.dataSource == DataSourceKind::API
+                ? engine.resume(snapshot, apiCandles, *strategy)
+                : engine.resume(snapshot, cfg.dataPath, cfg.loaderConfig, *strategy));
+        } else {
+            results.push_back(cfg.dataSource == DataSourceKind::API
+                ? engine.run(apiCandles, *strategy, cfg.initialCapital)
+                : engine.run(cfg.dataPath, cfg.loaderConfig, *strategy, cfg.initialCapital));
+        }
+    } else if (cfg.crossSectional) {
+        // Slices need the whole timestamp group at once, so load fully and share
+        // the candles across strategies. API data may already be in memory for the cache key.
+        const auto candles = apiCandles.empty() ? loadDataset(cfg) : std::move(apiCandles);
+        results.resize(factories.size());
+        ThreadPool::shared().parallelFor(factories.size(), [&](size_t i) {
+            auto strategy = factories[i]();
+            results[i] = engine.runCrossSectional(candles, *strategy, cfg.initialCapital);
+        });
+    } else if (cfg.dataSource == DataSourceKind::API) {
         if (!cfg.apiData) {
             throw std::runtime_error("API data source selected but no configuration provided");
         }
-        APIDataLoader loader;
-        apiCandles = loader.fetch(*cfg.apiData);
+        if (!cache) {
+            APIDataLoader loader;
+            apiCandles = loader.fetch(*cfg.apiData);
+        }
         results = engine.runParallel(apiCandles, factories, cfg.initialCapital);
+    } else if (factories.size() > 1) {
+        // Parse once and share indicators across strategies (broadcast batches).
+        const auto candles = loadDataset(cfg);
+        results = engine.runParallel(candles, factories, cfg.initialCapital);
     } else {
         results = engine.runParallel(cfg.dataPath, cfg.loaderConfig, factories, cfg.initialCapital);
     }
-    if (results.size() != strategies.size()) {
+    if (results.size() != pending.size()) {
         throw std::runtime_error("Mismatch between strategy count and results");
     }
+    for (size_t j = 0; j < pending.size(); ++j) {
+        if (cache) {
+            cache->insert(keys[pending[j]], results[j].clone());
+        }
+        cached[pending[j]] = std::move(results[j]);
+    }
 
     std::vector<StrategyRunResult> runs;
     runs.reserve(strategies.size());
     for (size_t i = 0; i < strategies.size(); ++i) {
-        runs.push_back({strategies[i], std::move(results[i])});
+        runs.push_back({strategies[i], std::move(cached[i])});
     }
     return runs;
 }
 
 ReportSummary generateReports(const RunConfig& cfg, const BacktestResult& result) {
-    StrategyRunResult run;
-    run.config = cfg.strategies.empty() ? cfg.strategy : cfg.strategies.front();
-    run.result = result;
-    auto reports = generateReports(cfg, {run});
-    if (reports.empty()) {
-        Reporter reporter;
-        return reporter.summarize(result);
-    }
-    return reports.front().summary;
+    const auto& config = cfg.strategies.empty() ? cfg.strategy : cfg.strategies.front();
+    auto outputs = resolveOutputsForStrategy(cfg.outputs, config, 0, 1);
+    ensureOutputDirectories(outputs);
+    return writeRunReports(Reporter(cfg.outputs.timestampFormat, cfg.outputs.risk), result, outputs);
 }
 
 std::vector<StrategyReport> generateReports(const RunConfig& cfg, const std::vector<StrategyRunResult>& runs) {
-    Reporter reporter;
-    std::vector<StrategyReport> summaries;
-    if (runs.empty()) {
-        return summaries;
-    }
-    summaries.reserve(runs.size());
+    std::vector<StrategyReport> reports(runs.size());
     for (size_t i = 0; i < runs.size(); ++i) {
-        auto outputs = resolveOutputsForStrategy(cfg.outputs, runs[i].config, i, runs.size());
-        auto summary = reporter.summarize(runs[i].result);
-
-        if (outputs.jsonPath) {
-            ensureParentDirectory(*outputs.jsonPath);
-            reporter.writeJson(runs[i].result, *outputs.jsonPath);
-        }
-        if (outputs.summaryCsvPath) {
-            ensureParentDirectory(*outputs.summaryCsvPath);
-            reporter.writeSummaryCsv(runs[i].result, *outputs.summaryCsvPath);
-        }
-        if (outputs.tradesCsvPath) {
-            ensureParentDirectory(*outputs.tradesCsvPath);
-            reporter.writeTradesCsv(runs[i].result, *outputs.tradesCsvPath);
-        }
-
-        summaries.push_back({runs[i].config, summary, outputs});
-    }
-    return summaries;
+        reports[i].config = runs[i].config;
+        reports[i].outputs = resolveOutputsForStrategy(cfg.outputs, runs[i].config, i, runs.size());
+        ensureOutputDirectories(reports[i].outputs);
+    }
+    // One pool task per strategy; each writes only its own files.
+    const Reporter reporter(cfg.outputs.timestampFormat, cfg.outputs.risk);
+    ThreadPool::shared().parallelFor(runs.size(), [&](size_t i) {
+        reports[i].summary = writeRunReports(reporter, runs[i].result, reports[i].outputs);
+    });
+    return reports;
 }
 
 } // namespace app
@@ -4,6 +4,11 @@
 #include "../DataLoader/APIDataLoader.h"
 #include "../BacktestEngine/BacktestEngine.h"
 #include "../Reporter/Reporter.h"
+#include "../Analytics/MonteCarlo.h"
+#include "ParameterSweep.h"
+#include "ResultCache.h"
+#include "StrategyConfig.h"
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -11,21 +16,16 @@
 namespace fastquant {
 namespace app {
 
-struct StrategyConfig {
-    std::string name = "strategy";
-    std::string type = "moving_average";
-    size_t shortWindow = 5;
-    size_t longWindow = 20;
-    size_t breakoutLookback = 20;
-    double breakoutBuffer = 0.0;
-    double orderQuantity = 1.0;
-    bool allowShort = false;
-};
-
 struct ReporterOutputs {
     std::optional<std::string> jsonPath;
     std::optional<std::string> summaryCsvPath;
     std::optional<std::string> tradesCsvPath;
+    std::optional<std::string> roundTripsCsvPath;
+    std::optional<std::string> equityCsvPath;
+    std::optional<std::string> columnarPath; // binary column blocks, see ColumnarReport.h
+    JsonStyle jsonStyle = JsonStyle::Pretty;
+    TimestampFormat timestampFormat = TimestampFormat::Iso8601;
+    RiskMetricsConfig risk; // reporter.risk: periods_per_year, volatility_window, tail_level
     bool printSummary = true;
 };
 
@@ -42,6 +42,15 @@ struct RunConfig {
     double initialCapital = 100000.0;
     ReporterOutputs outputs;
     ExecutionConfig execution;
+    bool crossSectional = false;  // engine.cross_sectional: run via BarSlice/onBar
+    bool summaryOnly = false;     // engine.summary_only: keep RunMetrics, no trades/curve
+    EquityRecording equityRecording; // engine.equity {policy, every, max_points, spill_dir}
+    std::optional<CheckpointConfig> checkpoint;  // engine.checkpoint {path, every}
+    std::optional<std::string> resumeFrom;       // engine.resume_from: snapshot path
+    std::optional<ResultCacheConfig> cache;      // engine.cache {max_entries, max_mb, dir}
+    std::optional<SweepConfig> sweep;
+    std::optional<WalkForwardConfig> walkForward; // requires sweep
+    std::optional<BootstrapConfig> robustness;
 };
 
 struct StrategyRunResult {
@@ -58,11 +67,25 @@ struct StrategyReport {
 // Load a RunConfig from disk. Throws std::runtime_error on invalid JSON or missing fields.
 RunConfig loadRunConfig(const std::string& path);
 
+// Instantiate the Strategy described by cfg. Throws std::runtime_error for unknown types.
+std::unique_ptr<Strategy> buildStrategy(const StrategyConfig& cfg);
+
+// The shared ResultCache, configured from cfg.cache; null when the config
+// has no engine.cache section.
+ResultCache* resultCache(const RunConfig& cfg);
+
+// Load the configured data source (CSV or API) fully into memory.
+std::vector<Candle> loadDataset(const RunConfig& cfg);
+
 // Execute the backtest described by cfg, returning the BacktestResult produced by BacktestEngine.
 BacktestResult executeBacktest(const RunConfig& cfg);
+// All configured strategies. With engine.cache, strategies whose results are
+// cached are not run again (checkpointed and resumed runs always run).
 std::vector<StrategyRunResult> executeBacktests(const RunConfig& cfg);
 
 // Generate all configured reports (JSON / CSV) and return the computed summary.
+// The multi-run overload writes each strategy's files as one task on the
+// shared ThreadPool; results are only read, never copied.
 ReportSummary generateReports(const RunConfig& cfg, const BacktestResult& result);
 std::vector<StrategyReport> generateReports(const RunConfig& cfg, const std::vector<StrategyRunResult>& runs);
 
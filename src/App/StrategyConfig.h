@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace fastquant {
+namespace app {
+
+struct StrategyConfig {
+    std::string name = "strategy";
+    std::string type = "moving_average";
+    size_t shortWindow = 5;
+    size_t longWindow = 20;
+    size_t breakoutLookback = 20;
+    double breakoutBuffer = 0.0;
+    double orderQuantity = 1.0;
+    bool allowShort = false;
+};
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,417 @@
+#include "StrategyOptimizer.h"
+#include "../BacktestEngine/ThreadPool.h"
+#include "../BacktestEngine/VectorizedBacktest.h"
+#include "../Strategy/MovingAverageLanes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+namespace fastquant {
+namespace app {
+
+double objectiveScore(SweepObjective objective, const ReportSummary& summary) {
+    double score = 0.0;
+    switch (objective) {
+        case SweepObjective::TotalReturn: score = summary.totalReturn; break;
+        case SweepObjective::FinalEquity: score = summary.finalEquity; break;
+        case SweepObjective::RealizedPnl: score = summary.realizedPnl; break;
+        case SweepObjective::MaxDrawdown: score = -summary.maxDrawdown; break;
+        case SweepObjective::WinRate: score = summary.winRate; break;
+    }
+    if (std::isnan(score)) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    return score;
+}
+
+bool TopK::better(const SweepEntry& a, const SweepEntry& b) {
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    return a.gridIndex < b.gridIndex;
+}
+
+bool TopK::admits(double score, size_t gridIndex) const {
+    if (heap_.size() < k_) {
+        return true;
+    }
+    SweepEntry probe;
+    probe.score = score;
+    probe.gridIndex = gridIndex;
+    return better(probe, heap_.front());
+}
+
+bool TopK::offer(SweepEntry entry) {
+    if (heap_.size() < k_) {
+        heap_.push_back(std::move(entry));
+        std::push_heap(heap_.begin(), heap_.end(), better);
+        return true;
+    }
+    if (!better(entry, heap_.front())) {
+        return false;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), better);
+    heap_.back() = std::move(entry);
+    std::push_heap(heap_.begin(), heap_.end(), better);
+    return true;
+}
+
+std::vector<SweepEntry> TopK::sorted() const {
+    std::vector<SweepEntry> out = heap_;
+    std::sort(out.begin(), out.end(), better);
+    return out;
+}
+
+namespace {
+
+struct PointOutcome {
+    ReportSummary summary;
+    size_t candlesProcessed{0};
+    bool cached{false};
+};
+
+// Set when the config has engine.cache; the fingerprint is taken once per sweep.
+struct SweepCache {
+    ResultCache* cache{nullptr};
+    DatasetFingerprint data;
+};
+
+// Upper bound on grid points per broadcast pass.
+constexpr size_t kMaxBroadcastBatch = 64;
+
+struct BatchOutcome {
+    std::vector<size_t> indices;           // grid index per evaluated point
+    std::vector<StrategyConfig> configs;
+    std::vector<PointOutcome> outcomes;
+    size_t skipped{0};                     // invalid points in the batch
+};
+
+// Position column of MovingAverageStrategy(shortWindow, longWindow) for
+// runVectorized. The strategy's market order on candle t fills at that
+// candle's open, which runVectorized reads as the target set on bar t - 1.
+void movingAverageTargets(const CandleFrame& frame, size_t shortWindow, size_t longWindow,
+                          std::vector<double>& targets) {
+    MovingAverageLanes lane({{shortWindow, longWindow}});
+    lane.setSimdEnabled(false); // a single lane gains nothing from AVX2
+    std::vector<uint32_t> fired;
+    std::vector<int8_t> direction;
+    targets.assign(frame.size(), 0.0);
+    double held = 0.0;
+    for (size_t t = 0; t < frame.size(); ++t) {
+        fired.clear();
+        direction.clear();
+        lane.step(frame.close.data(), t, fired, direction);
+        if (!fired.empty()) {
+            held += direction.front(); // one unit per signal, as the strategy orders
+        }
+        if (t > 0) {
+            targets[t - 1] = held;
+        }
+    }
+    if (!targets.empty()) {
+        targets.back() = held;
+    }
+}
+
+// What Reporter::summarize reads from a summary-only run, rebuilt from the
+// vectorized columns. Realized PnL and win/loss counts stay 0.
+ReportSummary vectorizedSummary(const VectorizedResult& r) {
+    RunMetrics metrics;
+    for (size_t t = 0; t < r.equity.size(); ++t) {
+        metrics.onEquity(r.equity[t], r.position[t] != 0.0);
+    }
+    ReportSummary summary;
+    summary.initialCapital = r.initialCapital;
+    summary.finalEquity = r.finalEquity;
+    summary.totalReturn = r.initialCapital > 0.0 ? (r.finalEquity / r.initialCapital) - 1.0 : 0.0;
+    summary.trades = r.fills;
+    summary.ordersFilled = r.fills;
+    summary.totalFees = r.totalFees;
+    summary.totalSlippage = r.totalSlippage;
+    summary.exposure = metrics.exposure();
+    summary.returnStdDev = metrics.returnStdDev();
+    summary.sharpe = metrics.sharpe();
+    summary.peakEquity = metrics.points() ? metrics.peakEquity() : r.initialCapital;
+    summary.troughEquity = metrics.points() ? metrics.troughEquity() : r.initialCapital;
+    summary.maxDrawdown = metrics.maxDrawdown();
+    return summary;
+}
+
+void forEachPoint(const SweepConfig& sweep, size_t count, const std::function<void(size_t)>& fn) {
+    if (sweep.threads > 0) {
+        ThreadPool pool(sweep.threads);
+        pool.parallelFor(count, fn);
+    } else {
+        ThreadPool::shared().parallelFor(count, fn);
+    }
+}
+
+// Evaluate slots [0, count) -- slot s is grid point indexOf(s) -- as broadcast
+// (or moving-average lane / vectorized kernel) passes over contiguous batches, so points
+// sharing indicator windows compute them once. Batches are sized to leave ~4 per worker for load balance.
+// Points found in the cache are summarised from there and left out of the passes.
+// onBatch runs on worker threads; callers serialise it themselves.
+void evaluateInBatches(const RunConfig& cfg,
+                       const ParameterGrid& grid,
+                       std::span<const Candle> candles,
+                       size_t count,
+                       size_t candleLimit,
+                       const SweepCache& cache,
+                       const std::function<size_t(size_t)>& indexOf,
+                       const std::function<void(BatchOutcome&)>& onBatch) {
+    const SweepConfig& sweep = *cfg.sweep;
+    const size_t threads = sweep.threads > 0 ? sweep.threads : ThreadPool::shared().size();
+    const size_t perBatch = std::clamp<size_t>((count + threads * 4 - 1) / (threads * 4), 1, kMaxBroadcastBatch);
+    const size_t batches = (count + perBatch - 1) / perBatch;
+
+    const bool singleSymbol = std::all_of(candles.begin(), candles.end(), [&](const Candle& c) {
+        return c.symbol == candles.front().symbol;
+    });
+    const bool movingAverage = sweep.base.type == "moving_average" && singleSymbol;
+    const bool useLanes = sweep.kernel == SweepKernel::MovingAverageLanes && movingAverage;
+    // The vectorized kernel sees the same prefix the engine's candle limit would.
+    std::optional<CandleFrame> frame;
+    if (sweep.kernel == SweepKernel::Vectorized && movingAverage) {
+        frame = CandleFrame::fromCandles(candleLimit ? candles.first(std::min(candleLimit, candles.size())) : candles);
+    }
+    const bool useCache = cache.cache && !frame;
+
+    RunVariant variant;
+    variant.summaryOnly = true;
+    variant.candleLimit = candleLimit;
+
+    forEachPoint(sweep, batches, [&](size_t b) {
+        BatchOutcome batch;
+        Reporter reporter;
+        std::vector<std::function<std::unique_ptr<Strategy>()>> factories;
+        std::vector<size_t> toRun; // positions in batch that need the engine
+        std::vector<ResultKey> keys;
+        const size_t end = std::min(count, (b + 1) * perBatch);
+        for (size_t slot = b * perBatch; slot < end; ++slot) {
+            const size_t index = indexOf(slot);
+            StrategyConfig pointCfg = grid.at(index);
+            if (!ParameterGrid::isValid(pointCfg)) {
+                ++batch.skipped;
+                continue;
+            }
+            batch.indices.push_back(index);
+            batch.outcomes.emplace_back();
+            if (useCache) {
+                ResultKey key = makeResultKey(cache.data, pointCfg, cfg.execution, cfg.initialCapital, variant);
+                if (auto hit = cache.cache->find(key)) {
+                    batch.outcomes.back() = {reporter.summarize(*hit), hit->candlesProcessed, true};
+                    batch.configs.push_back(std::move(pointCfg));
+                    continue;
+                }
+                keys.push_back(key);
+            }
+            factories.emplace_back([pointCfg]() { return buildStrategy(pointCfg); });
+            toRun.push_back(batch.configs.size());
+            batch.configs.push_back(std::move(pointCfg));
+        }
+        if (!factories.empty() && frame) {
+            VectorizedBacktester screener(*frame, cfg.execution);
+            std::vector<double> targets;
+            for (size_t pos : toRun) {
+                movingAverageTargets(*frame, batch.configs[pos].shortWindow, batch.configs[pos].longWindow, targets);
+                batch.outcomes[pos] = {vectorizedSummary(screener.run(targets, cfg.initialCapital)), frame->size()};
+            }
+        } else if (!factories.empty()) {
+            BacktestEngine engine(cfg.execution);
+            engine.setCandleLimit(candleLimit);
+            engine.setSummaryOnly(true); // only summaries are kept per grid point
+            std::vector<BacktestResult> results;
+            if (useLanes) {
+                std::vector<std::pair<size_t, size_t>> windows;
+                windows.reserve(toRun.size());
+                for (size_t pos : toRun) {
+                    windows.emplace_back(batch.configs[pos].shortWindow, batch.configs[pos].longWindow);
+                }
+                results = engine.runMovingAverageLanes(candles, windows, cfg.initialCapital);
+            } else {
+                results = engine.runBroadcast(candles, factories, cfg.initialCapital);
+            }
+            for (size_t i = 0; i < results.size(); ++i) {
+                batch.outcomes[toRun[i]] = {reporter.summarize(results[i]), results[i].candlesProcessed};
+                if (useCache) {
+                    cache.cache->insert(keys[i], std::move(results[i]));
+                }
+            }
+        }
+        onBatch(batch);
+    });
+}
+
+SweepResult runGridSearch(const RunConfig& cfg, const ParameterGrid& grid, std::span<const Candle> candles,
+                          const SweepCache& cache) {
+    const SweepConfig& sweep = *cfg.sweep;
+    SweepResult out;
+    out.objective = sweep.objective;
+    out.search = SweepSearch::Grid;
+    out.gridSize = grid.size();
+
+    TopK leaderboard(sweep.topK);
+    std::mutex boardMutex;
+
+    auto identity = [](size_t slot) { return slot; };
+    evaluateInBatches(cfg, grid, candles, grid.size(), 0, cache, identity, [&](BatchOutcome& batch) {
+        std::lock_guard<std::mutex> lock(boardMutex);
+        out.skipped += batch.skipped;
+        for (size_t i = 0; i < batch.outcomes.size(); ++i) {
+            const auto& outcome = batch.outcomes[i];
+            const double score = objectiveScore(sweep.objective, outcome.summary);
+            ++out.evaluated;
+            if (outcome.cached) {
+                ++out.cacheHits;
+            } else {
+                out.candlesEvaluated += outcome.candlesProcessed;
+            }
+            if (leaderboard.admits(score, batch.indices[i])) {
+                leaderboard.offer({batch.indices[i], std::move(batch.configs[i]), outcome.summary, score});
+            }
+        }
+    });
+
+    out.fullGridCandles = out.evaluated * candles.size();
+    out.top = leaderboard.sorted();
+    return out;
+}
+
+SweepResult runSuccessiveHalving(const RunConfig& cfg, const ParameterGrid& grid, std::span<const Candle> candles,
+                                 const SweepCache& cache) {
+    const SweepConfig& sweep = *cfg.sweep;
+    SweepResult out;
+    out.objective = sweep.objective;
+    out.search = SweepSearch::SuccessiveHalving;
+    out.gridSize = grid.size();
+
+    const size_t total = candles.size();
+    size_t budget = std::max<size_t>(1, static_cast<size_t>(std::ceil(sweep.minBudget * static_cast<double>(total))));
+    budget = std::min(budget, std::max<size_t>(total, 1));
+
+    // First rung walks the grid directly; later rungs only revisit promoted indices.
+    std::vector<size_t> candidates;
+    bool firstRung = true;
+    size_t candidateCount = grid.size();
+    size_t validPoints = 0;
+
+    for (;;) {
+        const bool finalRung = budget >= total;
+        // Keep at least top_k alive so the final leaderboard is fully populated.
+        const size_t keep = finalRung
+            ? sweep.topK
+            : std::max(sweep.topK, static_cast<size_t>(std::ceil(static_cast<double>(candidateCount) / sweep.eta)));
+
+        TopK board(keep);
+        std::mutex boardMutex;
+        size_t rungCandidates = 0;
+
+        auto indexOf = [&](size_t slot) { return firstRung ? slot : candidates[slot]; };
+        evaluateInBatches(cfg, grid, candles, candidateCount, finalRung ? 0 : budget, cache, indexOf, [&](BatchOutcome& batch) {
+            std::lock_guard<std::mutex> lock(boardMutex);
+            out.skipped += batch.skipped;
+            for (size_t i = 0; i < batch.outcomes.size(); ++i) {
+                const auto& outcome = batch.outcomes[i];
+                const double score = objectiveScore(sweep.objective, outcome.summary);
+                ++out.evaluated;
+                ++rungCandidates;
+                if (outcome.cached) {
+                    ++out.cacheHits;
+                } else {
+                    out.candlesEvaluated += outcome.candlesProcessed;
+                }
+                if (board.admits(score, batch.indices[i])) {
+                    board.offer({batch.indices[i], std::move(batch.configs[i]), outcome.summary, score});
+                }
+            }
+        });
+
+        if (firstRung) {
+            validPoints = rungCandidates;
+            firstRung = false;
+        }
+        auto ranked = board.sorted();
+        out.rungs.push_back({finalRung ? total : budget, rungCandidates, ranked.size()});
+
+        if (finalRung || ranked.empty()) {
+            out.top = std::move(ranked);
+            break;
+        }
+
+        candidates.clear();
+        candidates.reserve(ranked.size());
+        for (const auto& entry : ranked) {
+            candidates.push_back(entry.gridIndex);
+        }
+        // Ascending index order keeps promotion deterministic and cache friendly.
+        std::sort(candidates.begin(), candidates.end());
+        candidateCount = candidates.size();
+        budget = std::min(total, static_cast<size_t>(std::ceil(static_cast<double>(budget) * sweep.eta)));
+    }
+
+    out.fullGridCandles = validPoints * total;
+    return out;
+}
+
+} // namespace
+
+SweepResult runSweep(const RunConfig& cfg, std::span<const Candle> candles) {
+    if (!cfg.sweep) {
+        throw std::runtime_error("Config has no 'sweep' section");
+    }
+    ParameterGrid grid(cfg.sweep->base, cfg.sweep->axes);
+    SweepCache cache;
+    cache.cache = resultCache(cfg);
+    if (cache.cache) {
+        cache.data = fingerprintCandles(candles);
+    }
+    if (cfg.sweep->search == SweepSearch::SuccessiveHalving) {
+        return runSuccessiveHalving(cfg, grid, candles, cache);
+    }
+    return runGridSearch(cfg, grid, candles, cache);
+}
+
+SweepResult runSweep(const RunConfig& cfg) {
+    const auto candles = loadDataset(cfg);
+    return runSweep(cfg, candles);
+}
+
+void writeLeaderboardCsv(const SweepResult& result, const std::string& path) {
+    std::filesystem::path p(path);
+    if (auto parent = p.parent_path(); !parent.empty()) {
+        std::filesystem::create_directories(parent);
+    }
+    std::ofstream ofs(path);
+    ofs << "rank,grid_index,name,type,short_window,long_window,breakout_lookback,breakout_buffer,order_quantity,allow_short,"
+        << "score,total_return,final_equity,max_drawdown,win_rate,trades\n";
+    for (size_t i = 0; i < result.top.size(); ++i) {
+        const auto& e = result.top[i];
+        ofs << (i + 1) << ','
+            << e.gridIndex << ','
+            << '"' << e.config.name << '"' << ','
+            << e.config.type << ','
+            << e.config.shortWindow << ','
+            << e.config.longWindow << ','
+            << e.config.breakoutLookback << ','
+            << e.config.breakoutBuffer << ','
+            << e.config.orderQuantity << ','
+            << (e.config.allowShort ? "true" : "false") << ','
+            << e.score << ','
+            << e.summary.totalReturn << ','
+            << e.summary.finalEquity << ','
+            << e.summary.maxDrawdown << ','
+            << e.summary.winRate << ','
+            << e.summary.trades << '\n';
+    }
+}
+
+} // namespace app
+} // namespace fastquant
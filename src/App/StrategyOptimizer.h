@@ -0,0 +1,85 @@
+#pragma once
+
+#include "RunConfig.h"
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fastquant {
+namespace app {
+
+struct SweepEntry {
+    size_t gridIndex{0};
+    StrategyConfig config;
+    ReportSummary summary;
+    double score{0.0};
+};
+
+// One successive-halving round: `candidates` points ran on the first `budget`
+// candles and the best `promoted` of them moved on to the next round.
+struct SweepRung {
+    size_t budget{0};
+    size_t candidates{0};
+    size_t promoted{0};
+};
+
+struct SweepResult {
+    SweepObjective objective = SweepObjective::TotalReturn;
+    SweepSearch search = SweepSearch::Grid;
+    size_t gridSize{0};
+    size_t evaluated{0};
+    size_t skipped{0};       // invalid grid points (e.g. short >= long window)
+    size_t cacheHits{0};     // evaluated points served by the ResultCache (engine.cache)
+    std::vector<SweepEntry> top; // best first
+    std::vector<SweepRung> rungs; // successive halving only
+
+    // Compute accounting: candles simulated by this search (cache hits
+    // simulate none) vs. the candles an exhaustive grid over the same valid
+    // points would have simulated.
+    size_t candlesEvaluated{0};
+    size_t fullGridCandles{0};
+    double computeSaved() const {
+        return fullGridCandles == 0 ? 0.0
+            : 1.0 - static_cast<double>(candlesEvaluated) / static_cast<double>(fullGridCandles);
+    }
+};
+
+// Score used to rank sweep points; higher is always better
+// (drawdown is negated so that smaller drawdowns win).
+double objectiveScore(SweepObjective objective, const ReportSummary& summary);
+
+// TopK: bounded leaderboard that keeps the k best entries seen so far.
+// Ties are broken by grid index so results do not depend on thread scheduling.
+class TopK {
+public:
+    explicit TopK(size_t k) : k_(k ? k : 1) {}
+
+    // Returns true if the entry was kept.
+    bool offer(SweepEntry entry);
+    // Would an entry with this score / index be kept right now?
+    bool admits(double score, size_t gridIndex) const;
+    size_t size() const { return heap_.size(); }
+    std::vector<SweepEntry> sorted() const;
+
+private:
+    static bool better(const SweepEntry& a, const SweepEntry& b);
+
+    size_t k_;
+    std::vector<SweepEntry> heap_; // min-heap on better(): worst kept entry at front
+};
+
+// Evaluate cfg.sweep over an already loaded dataset. Points are expanded lazily
+// from the grid and run on a thread pool; only the top-K summaries are retained.
+// With SweepSearch::SuccessiveHalving most points only see a prefix of the data.
+// With engine.cache, points (and prefixes) seen before are read from the
+// ResultCache instead of being run.
+SweepResult runSweep(const RunConfig& cfg, std::span<const Candle> candles);
+
+// Convenience overload: loads the configured data source once, then sweeps.
+SweepResult runSweep(const RunConfig& cfg);
+
+void writeLeaderboardCsv(const SweepResult& result, const std::string& path);
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,191 @@
+#include "WalkForward.h"
+#include "../BacktestEngine/ThreadPool.h"
+#include "../Reporter/BufferedFile.h"
+#include "../Reporter/JsonStreamWriter.h"
+#include "../Reporter/TimestampFormatter.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+
+namespace fastquant {
+namespace app {
+namespace {
+
+void ensureParent(const std::string& path) {
+    std::filesystem::path p(path);
+    if (auto parent = p.parent_path(); !parent.empty()) {
+        std::filesystem::create_directories(parent);
+    }
+}
+
+void writeStrategy(JsonStreamWriter& j, const StrategyConfig& cfg) {
+    j.beginObject();
+    j.field("name", cfg.name);
+    j.field("type", cfg.type);
+    j.field("short_window", cfg.shortWindow);
+    j.field("long_window", cfg.longWindow);
+    j.field("breakout_lookback", cfg.breakoutLookback);
+    j.field("breakout_buffer", cfg.breakoutBuffer);
+    j.field("order_quantity", cfg.orderQuantity);
+    j.field("allow_short", cfg.allowShort);
+    j.endObject();
+}
+
+void writeRange(JsonStreamWriter& j, std::string_view name, size_t begin, size_t end) {
+    j.key(name);
+    j.beginArray();
+    j.value(begin);
+    j.value(end);
+    j.endArray();
+}
+
+} // namespace
+
+std::vector<WalkForwardFold> planWalkForward(const WalkForwardConfig& wf, size_t candles) {
+    std::vector<WalkForwardFold> folds;
+    const size_t step = wf.step ? wf.step : wf.outOfSample;
+    for (size_t start = 0; start + wf.inSample + wf.outOfSample <= candles; start += step) {
+        WalkForwardFold fold;
+        fold.index = folds.size();
+        fold.inSampleBegin = wf.anchored ? 0 : start;
+        fold.inSampleEnd = start + wf.inSample;
+        fold.outOfSampleBegin = fold.inSampleEnd;
+        fold.outOfSampleEnd = fold.inSampleEnd + wf.outOfSample;
+        folds.push_back(fold);
+    }
+    return folds;
+}
+
+WalkForwardResult runWalkForward(const RunConfig& cfg, std::span<const Candle> candles) {
+    if (!cfg.sweep || !cfg.walkForward) {
+        throw std::runtime_error("Walk-forward requires 'sweep' and 'walk_forward' sections");
+    }
+    if (cfg.walkForward->step != 0 && cfg.walkForward->step != cfg.walkForward->outOfSample) {
+        throw std::runtime_error("Walk-forward 'step' must equal 'out_of_sample' for a stitched curve");
+    }
+
+    WalkForwardResult out;
+    out.initialCapital = cfg.initialCapital;
+    out.folds = planWalkForward(*cfg.walkForward, candles.size());
+    if (out.folds.empty()) {
+        throw std::runtime_error("Dataset too short for one walk-forward fold");
+    }
+
+    // Inner sweeps only need the winner. They run on the shared pool like the
+    // folds: a private sweep.threads pool per concurrent fold would start
+    // folds x threads workers.
+    RunConfig inner = cfg;
+    inner.sweep->topK = 1;
+    inner.sweep->threads = 0;
+
+    struct FoldCurve {
+        std::vector<std::chrono::system_clock::time_point> timestamps;
+        std::vector<double> equity;
+    };
+    std::vector<FoldCurve> curves(out.folds.size());
+
+    // Folds and the sweeps inside them share one pool; parallelFor lets the
+    // calling thread help, so the nesting cannot starve itself.
+    ThreadPool::shared().parallelFor(out.folds.size(), [&](size_t f) {
+        auto& fold = out.folds[f];
+        auto inSample = candles.subspan(fold.inSampleBegin, fold.inSampleEnd - fold.inSampleBegin);
+        auto sweep = runSweep(inner, inSample);
+        if (sweep.top.empty()) {
+            // No valid configuration: the fold stays in cash and adds nothing to the curve.
+            return;
+        }
+        fold.best = sweep.top.front();
+
+        auto outOfSample = candles.subspan(fold.outOfSampleBegin, fold.outOfSampleEnd - fold.outOfSampleBegin);
+        auto strategy = buildStrategy(fold.best.config);
+        BacktestEngine engine(cfg.execution);
+        // Indicators pick up from the in-sample bars just before the window
+        // instead of spending its first bars warming up.
+        engine.setWarmup(inSample);
+        auto result = engine.run(outOfSample, *strategy, cfg.initialCapital);
+        fold.outOfSample = Reporter(cfg.outputs.timestampFormat, cfg.outputs.risk).summarize(result);
+        curves[f].timestamps = std::move(result.equityTimestamps);
+        curves[f].equity = std::move(result.equityCurve);
+    });
+
+    double running = cfg.initialCapital;
+    for (auto& curve : curves) {
+        if (curve.equity.empty()) {
+            continue;
+        }
+        const double scale = cfg.initialCapital > 0.0 ? running / cfg.initialCapital : 1.0;
+        for (size_t i = 0; i < curve.equity.size(); ++i) {
+            out.stitchedEquity.push_back(curve.equity[i] * scale);
+            out.stitchedTimestamps.push_back(curve.timestamps[i]);
+        }
+        running = out.stitchedEquity.back();
+    }
+    return out;
+}
+
+WalkForwardResult runWalkForward(const RunConfig& cfg) {
+    const auto candles = loadDataset(cfg);
+    return runWalkForward(cfg, candles);
+}
+
+void writeWalkForwardReports(const RunConfig& cfg, const WalkForwardResult& result) {
+    if (!cfg.walkForward) {
+        return;
+    }
+    // Same timestamp format and JSON style as the run's own reports.
+    const Reporter reporter(cfg.outputs.timestampFormat, cfg.outputs.risk);
+    if (cfg.walkForward->equityCsvPath) {
+        ensureParent(*cfg.walkForward->equityCsvPath);
+        reporter.writeEquityCsv(result.stitchedTimestamps, result.stitchedEquity, *cfg.walkForward->equityCsvPath);
+    }
+    if (cfg.walkForward->jsonPath) {
+        ensureParent(*cfg.walkForward->jsonPath);
+        BufferedFile file(*cfg.walkForward->jsonPath);
+        JsonStreamWriter j(file, cfg.outputs.jsonStyle);
+        TimestampFormatter ts(reporter.timestampFormat());
+        j.beginObject();
+        j.field("initial_capital", result.initialCapital);
+        j.field("final_equity", result.finalEquity());
+        j.field("total_return", result.initialCapital > 0.0 ? result.finalEquity() / result.initialCapital - 1.0 : 0.0);
+
+        j.key("folds");
+        j.beginArray();
+        for (const auto& fold : result.folds) {
+            j.beginObject();
+            j.field("fold", fold.index);
+            writeRange(j, "in_sample", fold.inSampleBegin, fold.inSampleEnd);
+            writeRange(j, "out_of_sample", fold.outOfSampleBegin, fold.outOfSampleEnd);
+            j.key("best");
+            writeStrategy(j, fold.best.config);
+            j.field("in_sample_score", fold.best.score);
+            j.field("out_of_sample_return", fold.outOfSample.totalReturn);
+            j.field("out_of_sample_max_drawdown", fold.outOfSample.maxDrawdown);
+            j.field("out_of_sample_trades", fold.outOfSample.trades);
+            j.endObject();
+        }
+        j.endArray();
+
+        j.key("equity_curve");
+        j.beginArray();
+        for (size_t i = 0; i < result.stitchedEquity.size(); ++i) {
+            j.beginObject();
+            j.key("timestamp");
+            if (ts.numeric()) {
+                j.value(ts.epoch(result.stitchedTimestamps[i]));
+            } else {
+                j.value(ts(result.stitchedTimestamps[i]));
+            }
+            j.field("equity", result.stitchedEquity[i]);
+            j.endObject();
+        }
+        j.endArray();
+
+        j.endObject();
+        j.finish();
+        file.close();
+    }
+}
+
+} // namespace app
+} // namespace fastquant
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "StrategyOptimizer.h"
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fastquant {
+namespace app {
+
+// Half-open candle index ranges into the loaded dataset.
+struct WalkForwardFold {
+    size_t index{0};
+    size_t inSampleBegin{0};
+    size_t inSampleEnd{0};
+    size_t outOfSampleBegin{0};
+    size_t outOfSampleEnd{0};
+    SweepEntry best;              // winner of the in-sample sweep
+    ReportSummary outOfSample;    // that winner traded on the OOS window
+};
+
+struct WalkForwardResult {
+    std::vector<WalkForwardFold> folds;
+    // Out-of-sample equity of every fold chained end to end: each fold's curve is
+    // rescaled so that it starts where the previous fold finished.
+    std::vector<std::chrono::system_clock::time_point> stitchedTimestamps;
+    std::vector<double> stitchedEquity;
+    double initialCapital{0.0};
+
+    double finalEquity() const { return stitchedEquity.empty() ? initialCapital : stitchedEquity.back(); }
+};
+
+// Fold layout for a dataset of `candles` rows; exposed for tests and --print-config.
+std::vector<WalkForwardFold> planWalkForward(const WalkForwardConfig& wf, size_t candles);
+
+// Run all folds concurrently over one in-memory dataset. Folds see the data
+// through spans, so nothing is copied per fold or per inner sweep point. Each
+// fold's winner starts its out-of-sample run flat but with indicators warmed
+// on the end of the in-sample window (Strategy::warmUp).
+WalkForwardResult runWalkForward(const RunConfig& cfg, std::span<const Candle> candles);
+WalkForwardResult runWalkForward(const RunConfig& cfg);
+
+// Write the configured walk-forward artifacts (stitched equity CSV, fold JSON).
+// Both honour reporter.timestamp_format; the JSON is streamed in reporter.json_style.
+void writeWalkForwardReports(const RunConfig& cfg, const WalkForwardResult& result);
+
+} // namespace app
+} // namespace fastquant
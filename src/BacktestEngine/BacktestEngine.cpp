@@ -1,10 +1,14 @@
 #include "BacktestEngine.h"
+#include "ThreadPool.h"
+#include "../Strategy/IndicatorRegistry.h"
+#include "../Strategy/MovingAverageLanes.h"
 #include <functional>
 #include <cmath>
 #include <algorithm>
 #include <utility>
 #include <future>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace fastquant {
 
@@ -12,6 +16,40 @@ BacktestResult::BacktestResult() : portfolio(0.0), initialCapital(0.0) {}
 BacktestResult::BacktestResult(double initialCapital)
     : portfolio(initialCapital), initialCapital(initialCapital) {}
 
+size_t BacktestResult::equityPointCount() const {
+    return equitySpill ? equitySpill->size() : equityCurve.size();
+}
+
+void BacktestResult::forEachEquityPoint(const std::function<void(std::chrono::system_clock::time_point, double)>& fn) const {
+    if (equitySpill) {
+        equitySpill->forEach(fn);
+        return;
+    }
+    for (size_t i = 0; i < equityCurve.size(); ++i) {
+        fn(i < equityTimestamps.size() ? equityTimestamps[i] : std::chrono::system_clock::time_point{}, equityCurve[i]);
+    }
+}
+
+BacktestResult BacktestResult::clone() const {
+    BacktestResult copy(initialCapital);
+    copy.candlesProcessed = candlesProcessed;
+    copy.trades = trades;
+    copy.portfolio = portfolio;
+    copy.equityCurve = equityCurve;
+    copy.equityTimestamps = equityTimestamps;
+    copy.totalFees = totalFees;
+    copy.totalSlippage = totalSlippage;
+    copy.ordersFilled = ordersFilled;
+    copy.ordersRejected = ordersRejected;
+    copy.summaryOnly = summaryOnly;
+    copy.cancelled = cancelled;
+    copy.metrics = metrics;
+    copy.ledger = ledger;
+    copy.equityRecording = equityRecording;
+    copy.equitySpill = equitySpill;
+    return copy;
+}
+
 BacktestEngine::BacktestEngine(ExecutionConfig exec)
     : execConfig_(exec) {}
 
@@ -19,14 +57,252 @@ namespace {
 
 struct PendingOrder {
     Order order;
+    int64_t symbolId{-1}; // cross-sectional runs: cached universe index
 };
 
 double fallbackPrice(double candidate, double fallback) {
     return candidate > 0.0 ? candidate : fallback;
 }
 
+std::string normalizeSymbol(const std::string& symbol) {
+    return symbol.empty() ? std::string("DEFAULT") : symbol;
+}
+
+struct EngineSink : public OrderSink {
+    EngineSink(std::vector<PendingOrder>& target, size_t& counter)
+        : pending(target), orderCounter(counter) {}
+
+    void submit(const Order& o) override {
+        if (o.qty <= 0.0) {
+            return;
+        }
+        Order copy = o;
+        copy.symbol = normalizeSymbol(copy.symbol);
+        if (copy.id.empty()) {
+            copy.id = "order-" + std::to_string(orderCounter++);
+        }
+        pending.push_back({copy});
+    }
+
+    std::vector<PendingOrder>& pending;
+    size_t& orderCounter;
+};
+
+void recordFill(BacktestResult& result, const Trade& trade, double slippageValue) {
+    if (!result.summaryOnly) {
+        result.trades.push_back(trade);
+    }
+    result.totalFees += trade.fee;
+    result.totalSlippage += slippageValue;
+    ++result.ordersFilled;
+    result.portfolio.applyTrade(trade);
+    result.metrics.onFill(result.portfolio.realizedPnl());
+    result.ledger.onFill(trade);
+}
+
+// Widen the excursion range of open round trips by the candle's high/low. Runs
+// after matching, so lots entered at this candle's open see its whole range.
+void trackExcursions(BacktestResult& result, const std::string& sym, const Candle& c) {
+    if (!result.ledger.hasOpenLots()) {
+        return;
+    }
+    double open = fallbackPrice(c.open, c.close);
+    double high = fallbackPrice(c.high, std::max(open, c.close));
+    double low = fallbackPrice(c.low, std::min(open, c.close));
+    if (high > 0.0 && low > 0.0) {
+        result.ledger.onCandle(sym, high, low);
+    }
+}
+
+void recordEquity(BacktestResult& result, std::chrono::system_clock::time_point ts, double equity, bool exposed) {
+    result.metrics.onEquity(equity, exposed);
+    if (result.summaryOnly) {
+        return;
+    }
+    if (result.equityRecorder) {
+        result.equityRecorder->record(result.equityTimestamps, result.equityCurve, ts, equity);
+    } else {
+        result.equityTimestamps.push_back(ts);
+        result.equityCurve.push_back(equity);
+    }
+}
+
+void recordEquity(BacktestResult& result, std::chrono::system_clock::time_point ts) {
+    recordEquity(result, ts, result.portfolio.equity(), result.portfolio.hasOpenPosition());
+}
+
+bool expiresUnfilled(const Order& order) {
+    return order.tif == TimeInForce::IOC || order.tif == TimeInForce::FOK;
+}
+
+// Try every resting order against `c`, in submission order. `fill` is the
+// engine's fillOrder.
+template<typename Fill>
+void matchOrders(BacktestResult& result, std::vector<PendingOrder>& pending, const Candle& c, Fill&& fill) {
+    const std::string sym = normalizeSymbol(c.symbol);
+    auto it = pending.begin();
+    while (it != pending.end()) {
+        Trade trade;
+        double slipValue = 0.0;
+        bool filled = it->order.symbol == sym
+            && fill(it->order, c, result.ordersFilled + 1, trade, slipValue);
+        if (filled) {
+            recordFill(result, trade, slipValue);
+            it = pending.erase(it);
+        } else if (expiresUnfilled(it->order)) {
+            ++result.ordersRejected;
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Cancel what is still resting once the data is exhausted, and make sure the
+// curve has at least one point.
+void closeOut(BacktestResult& result, std::vector<PendingOrder>& pending) {
+    if (!pending.empty()) {
+        result.ordersRejected += pending.size();
+        pending.clear();
+    }
+    if (result.metrics.points() == 0) {
+        recordEquity(result, std::chrono::system_clock::now());
+    }
+    if (result.equityRecorder) {
+        result.equityRecorder->finish(result.equityTimestamps, result.equityCurve);
+        result.equitySpill = result.equityRecorder->spill();
+        result.equityRecorder.reset();
+    }
+}
+
+// Per-strategy state of a broadcast run. Not movable: the sink points into it.
+struct BroadcastLane {
+    explicit BroadcastLane(double capital) : result(capital), sink(pendingOrders, orderCounter) {}
+    BroadcastLane(const BroadcastLane&) = delete;
+    BroadcastLane& operator=(const BroadcastLane&) = delete;
+
+    BacktestResult result;
+    std::vector<PendingOrder> pendingOrders;
+    size_t orderCounter{0};
+    EngineSink sink;
+    std::unique_ptr<Strategy> strategy;
+};
+
+// The portfolio's maps flattened into the lists a snapshot stores.
+struct SnapshotBook {
+    std::vector<Position> positions;
+    std::vector<std::pair<std::string, double>> marks;
+};
+
+// Snapshot view of a result's book and history, with no pending orders or
+// strategy state. Only the book is gathered into `book`; the history is
+// serialised where it lives.
+SnapshotView viewResult(const BacktestResult& result, SnapshotBook& book) {
+    for (const auto& [symbol, pos] : result.portfolio.positions()) {
+        book.positions.push_back(pos);
+    }
+    book.marks.assign(result.portfolio.marks().begin(), result.portfolio.marks().end());
+
+    SnapshotView view;
+    view.candlesProcessed = result.candlesProcessed;
+    view.initialCapital = result.initialCapital;
+    view.cash = result.portfolio.cash();
+    view.realizedPnl = result.portfolio.realizedPnl();
+    view.positions = book.positions;
+    view.marks = book.marks;
+    view.trades = result.trades;
+    view.equityTimestamps = result.equityTimestamps;
+    view.equityCurve = result.equityCurve;
+    view.totalFees = result.totalFees;
+    view.totalSlippage = result.totalSlippage;
+    view.ordersFilled = result.ordersFilled;
+    view.ordersRejected = result.ordersRejected;
+    view.metrics = &result.metrics;
+    view.ledger = &result.ledger;
+    return view;
+}
+
+// Book and history of `s` into `result`. The ledger keeps the round-trip
+// retention `result` was prepared with.
+void restoreResult(const EngineSnapshot& s, BacktestResult& result) {
+    std::unordered_map<std::string, Position> positions;
+    for (const auto& pos : s.positions) {
+        positions.emplace(pos.symbol, pos);
+    }
+    std::unordered_map<std::string, double> marks(s.marks.begin(), s.marks.end());
+    result.portfolio.restore(s.cash, s.realizedPnl, std::move(positions), std::move(marks));
+    result.candlesProcessed = s.candlesProcessed;
+    result.trades = s.trades;
+    result.equityTimestamps = s.equityTimestamps;
+    result.equityCurve = s.equityCurve;
+    result.totalFees = s.totalFees;
+    result.totalSlippage = s.totalSlippage;
+    result.ordersFilled = s.ordersFilled;
+    result.ordersRejected = s.ordersRejected;
+    result.metrics = s.metrics;
+    const bool retain = result.ledger.retainsRoundTrips();
+    result.ledger = s.ledger;
+    result.ledger.setRetainRoundTrips(retain);
+}
+
+// Checkpoint straight from the live run: the result view plus the order book
+// and the strategy's own state. Trades and equity are appended to the run's
+// history sidecars rather than rewritten.
+void writeCheckpoint(const BacktestResult& result,
+                     const std::vector<PendingOrder>& pending,
+                     size_t orderCounter,
+                     const Strategy& strategy,
+                     CheckpointHistory& history,
+                     const std::string& path) {
+    SnapshotBook book;
+    SnapshotView view = viewResult(result, book);
+    std::vector<Order> orders;
+    orders.reserve(pending.size());
+    for (const auto& po : pending) {
+        orders.push_back(po.order);
+    }
+    std::string strategyState;
+    view.pendingOrders = orders;
+    view.orderCounter = orderCounter;
+    view.hasStrategyState = strategy.saveState(strategyState);
+    view.strategyState = strategyState;
+    view.history = &history;
+    writeSnapshot(view, path);
+}
+
+void restoreSnapshot(const EngineSnapshot& s,
+                     BacktestResult& result,
+                     std::vector<PendingOrder>& pending,
+                     size_t& orderCounter,
+                     Strategy& strategy) {
+    if (!s.hasStrategyState) {
+        throw std::runtime_error("Snapshot has no strategy state; the strategy does not support checkpoints");
+    }
+    restoreResult(s, result);
+    pending.clear();
+    for (const auto& o : s.pendingOrders) {
+        pending.push_back({o});
+    }
+    orderCounter = s.orderCounter;
+    strategy.loadState(s.strategyState);
+}
+
 } // namespace
 
+void writeResultSnapshot(const BacktestResult& result, const std::string& path) {
+    SnapshotBook book;
+    writeSnapshot(viewResult(result, book), path);
+}
+
+BacktestResult resultFromSnapshot(const EngineSnapshot& s, bool summaryOnly, const EquityRecording& recording) {
+    BacktestResult result(s.initialCapital);
+    result.summaryOnly = summaryOnly;
+    result.equityRecording = recording;
+    result.ledger.setRetainRoundTrips(!summaryOnly);
+    restoreResult(s, result);
+    return result;
+}
+
 BacktestResult BacktestEngine::run(const std::string& csvPath, CSVDataLoader::Config cfg, Strategy& strategy, double initialCapital) {
     CSVDataLoader loader;
     std::function<void(const std::function<bool(const Candle&)>&)> streamer =
@@ -36,7 +312,39 @@ BacktestResult BacktestEngine::run(const std::string& csvPath, CSVDataLoader::Co
     return runWithStreamer(streamer, strategy, initialCapital);
 }
 
+BacktestResult BacktestEngine::resume(const EngineSnapshot& snapshot,
+                                      const std::string& csvPath,
+                                      CSVDataLoader::Config cfg,
+                                      Strategy& strategy) {
+    CSVDataLoader loader;
+    std::function<void(const std::function<bool(const Candle&)>&)> streamer =
+        [&](const std::function<bool(const Candle&)>& callback) {
+            loader.stream(csvPath, callback, cfg);
+        };
+    return runWithStreamer(streamer, strategy, snapshot.initialCapital, &snapshot, snapshot.candlesProcessed);
+}
+
+BacktestResult BacktestEngine::resume(const EngineSnapshot& snapshot,
+                                      std::span<const Candle> candles,
+                                      Strategy& strategy) {
+    const size_t offset = std::min(snapshot.candlesProcessed, candles.size());
+    auto remaining = candles.subspan(offset);
+    std::function<void(const std::function<bool(const Candle&)>&)> streamer =
+        [&](const std::function<bool(const Candle&)>& callback) {
+            for (const auto& candle : remaining) {
+                if (!callback(candle)) {
+                    break;
+                }
+            }
+        };
+    return runWithStreamer(streamer, strategy, snapshot.initialCapital, &snapshot);
+}
+
 BacktestResult BacktestEngine::run(const std::vector<Candle>& candles, Strategy& strategy, double initialCapital) {
+    return run(std::span<const Candle>(candles), strategy, initialCapital);
+}
+
+BacktestResult BacktestEngine::run(std::span<const Candle> candles, Strategy& strategy, double initialCapital) {
     std::function<void(const std::function<bool(const Candle&)>&)> streamer =
         [&](const std::function<bool(const Candle&)>& callback) {
             for (const auto& candle : candles) {
@@ -48,175 +356,487 @@ BacktestResult BacktestEngine::run(const std::vector<Candle>& candles, Strategy&
     return runWithStreamer(streamer, strategy, initialCapital);
 }
 
-BacktestResult BacktestEngine::runWithStreamer(const std::function<void(const std::function<bool(const Candle&)>&)>& streamer,
-                                               Strategy& strategy,
-                                               double initialCapital) {
-    BacktestResult result(initialCapital);
+void BacktestEngine::prepareResult(BacktestResult& result) const {
+    result.summaryOnly = summaryOnly_;
+    result.equityRecording = equityRecording_;
+    result.ledger.setRetainRoundTrips(!summaryOnly_);
+    if (!summaryOnly_ && equityRecording_.policy != EquityPolicy::All) {
+        result.equityRecorder = std::make_shared<EquityRecorder>(equityRecording_);
+    }
+}
 
-    auto normalizeSymbol = [](const std::string& symbol) {
-        return symbol.empty() ? std::string("DEFAULT") : symbol;
-    };
+bool BacktestEngine::keepRunning(size_t processed, RunCursor& cursor, const BacktestResult* observed) const {
+    // Cross-sectional runs advance by whole slices, so compare against the last
+    // published count rather than testing for an exact multiple.
+    if ((control_ || observer_) && processed - cursor.published >= RunControl::kPublishEvery) {
+        cursor.published = processed;
+        if (control_) {
+            control_->publish(processed);
+        }
+        if (observer_) {
+            notifyObserver(processed, cursor, observed, false);
+        }
+    }
+    if (control_ && control_->cancelRequested()) {
+        cursor.cancelled = true;
+        return false;
+    }
+    return candleLimit_ == 0 || processed < candleLimit_;
+}
 
-    std::vector<PendingOrder> pendingOrders;
-    size_t orderCounter = 0;
+void BacktestEngine::finishRun(BacktestResult& result, RunCursor& cursor, bool observed) const {
+    if (control_) {
+        control_->publish(result.candlesProcessed);
+    }
+    // A cancel that arrives after the last candle leaves the result complete.
+    result.cancelled = cursor.cancelled;
+    if (observer_) {
+        notifyObserver(result.candlesProcessed, cursor, observed ? &result : nullptr, true);
+    }
+}
 
-    struct EngineSink : public OrderSink {
-        EngineSink(std::vector<PendingOrder>& target,
-                   std::function<std::string(const std::string&)> normalizer,
-                   size_t& counter)
-            : pending(target), normalize(std::move(normalizer)), orderCounter(counter) {}
+void BacktestEngine::notifyObserver(size_t processed, RunCursor& cursor,
+                                    const BacktestResult* observed, bool finished) const {
+    if (observed && !observed->summaryOnly) {
+        // Slices since the last call for this run.
+        if (!observed->equityRecorder && !observed->equitySpill
+            && observed->equityCurve.size() > cursor.equitySent) {
+            const size_t from = cursor.equitySent;
+            observer_->onEquity(std::span(observed->equityTimestamps).subspan(from),
+                                std::span(observed->equityCurve).subspan(from));
+            cursor.equitySent = observed->equityCurve.size();
+        }
+        if (observed->trades.size() > cursor.tradesSent) {
+            observer_->onTrades(std::span(observed->trades).subspan(cursor.tradesSent));
+            cursor.tradesSent = observed->trades.size();
+        }
+    }
+    observer_->onProgress(processed, finished);
+}
 
-        void submit(const Order& o) override {
-            if (o.qty <= 0.0) {
-                return;
-            }
-            Order copy = o;
-            copy.symbol = normalize(copy.symbol);
-            if (copy.id.empty()) {
-                copy.id = "order-" + std::to_string(orderCounter++);
+bool BacktestEngine::fillOrder(const Order& order, const Candle& candle, size_t tradeSeq,
+                               Trade& outTrade, double& slippageValue) const {
+    double rawPrice = 0.0;
+    bool canFill = false;
+    double open = fallbackPrice(candle.open, candle.close);
+    double high = fallbackPrice(candle.high, std::max(open, candle.close));
+    double low = fallbackPrice(candle.low, std::min(open, candle.close));
+
+    switch (order.type) {
+        case OrderType::Market:
+            rawPrice = fallbackPrice(candle.open, fallbackPrice(candle.close, candle.high));
+            canFill = rawPrice > 0.0;
+            break;
+        case OrderType::Limit:
+            if (order.side == Side::Buy) {
+                if (open <= order.price && open > 0.0) {
+                    rawPrice = open;
+                    canFill = true;
+                } else if (low <= order.price && order.price > 0.0) {
+                    rawPrice = order.price;
+                    canFill = true;
+                }
+            } else {
+                if (open >= order.price && open > 0.0) {
+                    rawPrice = open;
+                    canFill = true;
+                } else if (high >= order.price && order.price > 0.0) {
+                    rawPrice = order.price;
+                    canFill = true;
+                }
             }
-            pending.push_back({copy});
+            break;
+    }
+
+    if (!canFill) {
+        return false;
+    }
+
+    double slippageBps = std::abs(order.slippageBps) > 0.0 ? order.slippageBps : execConfig_.defaultSlippageBps;
+    double slipPct = slippageBps / 10000.0;
+    double finalPrice = rawPrice;
+    slippageValue = 0.0;
+    if (slipPct > 0.0) {
+        if (order.side == Side::Buy) {
+            finalPrice *= (1.0 + slipPct);
+            slippageValue = (finalPrice - rawPrice) * order.qty;
+        } else {
+            finalPrice *= (1.0 - slipPct);
+            slippageValue = (rawPrice - finalPrice) * order.qty;
         }
+    }
+
+    double notional = finalPrice * order.qty;
+    double fee = execConfig_.commissionPerShare * order.qty
+        + execConfig_.commissionBps / 10000.0 * notional;
+
+    outTrade.orderId = order.id;
+    outTrade.id = order.id + "-exec-" + std::to_string(tradeSeq);
+    outTrade.side = order.side;
+    outTrade.type = order.type;
+    outTrade.price = finalPrice;
+    outTrade.qty = order.qty;
+    outTrade.symbol = order.symbol;
+    outTrade.timestamp = candle.timestamp;
+    outTrade.fee = fee;
+    outTrade.slippageBps = slippageBps;
+    return true;
+}
 
-        std::vector<PendingOrder>& pending;
-        std::function<std::string(const std::string&)> normalize;
-        size_t& orderCounter;
-    } sink(pendingOrders, normalizeSymbol, orderCounter);
+BacktestResult BacktestEngine::runWithStreamer(const std::function<void(const std::function<bool(const Candle&)>&)>& streamer,
+                                               Strategy& strategy,
+                                               double initialCapital,
+                                               const EngineSnapshot* resumeFrom,
+                                               size_t skipCandles) {
+    const bool checkpointed = resumeFrom || checkpoint_.everyCandles != 0;
+    if (checkpointed && (equityRecording_.policy == EquityPolicy::Downsample
+                         || equityRecording_.policy == EquityPolicy::Spill)) {
+        throw std::runtime_error("Checkpointed runs cannot record equity with the '"
+                                 + toString(equityRecording_.policy) + "' policy");
+    }
+    BacktestResult result(initialCapital);
+    prepareResult(result);
+    RunCursor cursor;
+
+    std::vector<PendingOrder> pendingOrders;
+    size_t orderCounter = 0;
+    EngineSink sink(pendingOrders, orderCounter);
+    CheckpointHistory history;
 
     strategy.setOrderSink(&sink);
     strategy.onStart();
+    if (resumeFrom) {
+        restoreSnapshot(*resumeFrom, result, pendingOrders, orderCounter, strategy);
+    } else if (!warmup_.empty()) {
+        strategy.warmUp(warmup_);
+    }
 
-    auto marketPrice = [](const Candle& c) {
-        double reference = fallbackPrice(c.open, fallbackPrice(c.close, c.high));
-        return reference;
+    auto fill = [this](const Order& o, const Candle& c, size_t seq, Trade& t, double& slip) {
+        return fillOrder(o, c, seq, t, slip);
     };
 
-    auto tryFill = [&](PendingOrder& po, const Candle& candle, Trade& outTrade, double& slippageValue)->bool {
-        if (po.order.symbol != normalizeSymbol(candle.symbol)) {
-            return false;
+    auto handleCandle = [&](const Candle& c)->bool {
+        if (skipCandles > 0) {
+            --skipCandles;
+            return true;
+        }
+        std::string sym = normalizeSymbol(c.symbol);
+        result.portfolio.markPrice(sym, c.close);
+        strategy.onData(c);
+        matchOrders(result, pendingOrders, c, fill);
+        trackExcursions(result, sym, c);
+        ++result.candlesProcessed;
+        recordEquity(result, c.timestamp);
+        if (checkpoint_.everyCandles != 0 && result.candlesProcessed % checkpoint_.everyCandles == 0) {
+            writeCheckpoint(result, pendingOrders, orderCounter, strategy, history, checkpoint_.path);
         }
+        return keepRunning(result.candlesProcessed, cursor, &result);
+    };
+
+    streamer(handleCandle);
+
+    // cancel remaining pending orders after data exhausts
+    closeOut(result, pendingOrders);
+    finishRun(result, cursor, true);
+    strategy.onFinish();
+    strategy.setOrderSink(nullptr);
+    return result;
+}
+
+std::vector<BacktestResult> BacktestEngine::runBroadcast(const std::string& csvPath,
+                                                         CSVDataLoader::Config cfg,
+                                                         const std::vector<std::function<std::unique_ptr<Strategy>()>>& strategyFactories,
+                                                         double initialCapital,
+                                                         IndicatorRegistry* registry) {
+    CSVDataLoader loader;
+    std::function<void(const std::function<bool(const Candle&)>&)> streamer =
+        [&](const std::function<bool(const Candle&)>& callback) {
+            loader.stream(csvPath, callback, cfg);
+        };
+    return runBroadcastWithStreamer(streamer, strategyFactories, initialCapital, registry);
+}
 
-        double rawPrice = 0.0;
-        bool canFill = false;
-        double open = fallbackPrice(candle.open, candle.close);
-        double high = fallbackPrice(candle.high, std::max(open, candle.close));
-        double low = fallbackPrice(candle.low, std::min(open, candle.close));
-
-        switch (po.order.type) {
-            case OrderType::Market:
-                rawPrice = marketPrice(candle);
-                canFill = rawPrice > 0.0;
-                break;
-            case OrderType::Limit:
-                if (po.order.side == Side::Buy) {
-                    if (open <= po.order.price && open > 0.0) {
-                        rawPrice = open;
-                        canFill = true;
-                    } else if (low <= po.order.price && po.order.price > 0.0) {
-                        rawPrice = po.order.price;
-                        canFill = true;
-                    }
-                } else {
-                    if (open >= po.order.price && open > 0.0) {
-                        rawPrice = open;
-                        canFill = true;
-                    } else if (high >= po.order.price && po.order.price > 0.0) {
-                        rawPrice = po.order.price;
-                        canFill = true;
-                    }
+std::vector<BacktestResult> BacktestEngine::runBroadcast(std::span<const Candle> candles,
+                                                         const std::vector<std::function<std::unique_ptr<Strategy>()>>& strategyFactories,
+                                                         double initialCapital,
+                                                         IndicatorRegistry* registry) {
+    std::function<void(const std::function<bool(const Candle&)>&)> streamer =
+        [&](const std::function<bool(const Candle&)>& callback) {
+            for (const auto& candle : candles) {
+                if (!callback(candle)) {
+                    break;
                 }
-                break;
+            }
+        };
+    return runBroadcastWithStreamer(streamer, strategyFactories, initialCapital, registry);
+}
+
+std::vector<BacktestResult> BacktestEngine::runMovingAverageLanes(std::span<const Candle> candles,
+                                                                  const std::vector<std::pair<size_t, size_t>>& windows,
+                                                                  double initialCapital) {
+    constexpr double kFlat = 1e-9; // Portfolio's zero-position threshold
+    const std::string sym = candles.empty() ? std::string("DEFAULT") : normalizeSymbol(candles.front().symbol);
+    for (const auto& c : candles) {
+        if (c.symbol != candles.front().symbol) {
+            throw std::runtime_error("Moving-average lane kernel needs a single-symbol stream");
         }
+    }
 
-        if (!canFill) {
-            return false;
+    const size_t lanes = windows.size();
+    MovingAverageLanes kernel(windows);
+    std::vector<BacktestResult> results;
+    results.reserve(lanes);
+    for (size_t k = 0; k < lanes; ++k) {
+        results.emplace_back(initialCapital);
+        prepareResult(results.back());
+    }
+
+    // Book state mirrored in SoA form so the per-candle equity pass stays a flat
+    // loop; the lane's Portfolio stays authoritative and is only touched on fills.
+    std::vector<double> cash(lanes, initialCapital);
+    std::vector<double> qty(lanes, 0.0);
+    std::vector<double> mark(lanes, 0.0);
+    std::vector<size_t> signalCount(lanes, 0);
+    std::vector<std::vector<PendingOrder>> pending(lanes);
+    std::vector<uint32_t> pendingLanes;
+    std::vector<uint32_t> fired;
+    std::vector<int8_t> direction;
+
+    std::vector<double> closes;
+    closes.reserve(candles.size());
+    for (const auto& c : candles) {
+        closes.push_back(c.close);
+    }
+
+    auto fill = [this](const Order& o, const Candle& c, size_t seq, Trade& t, double& slip) {
+        return fillOrder(o, c, seq, t, slip);
+    };
+
+    size_t processed = 0;
+    RunCursor cursor;
+    for (size_t t = 0; t < candles.size(); ++t) {
+        const Candle& c = candles[t];
+        if (c.close > 0.0) {
+            std::fill(mark.begin(), mark.end(), c.close);
         }
 
-        double slippageBps = std::abs(po.order.slippageBps) > 0.0 ? po.order.slippageBps : execConfig_.defaultSlippageBps;
-        double slipPct = slippageBps / 10000.0;
-        double finalPrice = rawPrice;
-        slippageValue = 0.0;
-        if (slipPct > 0.0) {
-            if (po.order.side == Side::Buy) {
-                finalPrice *= (1.0 + slipPct);
-                slippageValue = (finalPrice - rawPrice) * po.order.qty;
-            } else {
-                finalPrice *= (1.0 - slipPct);
-                slippageValue = (rawPrice - finalPrice) * po.order.qty;
+        fired.clear();
+        direction.clear();
+        kernel.step(closes.data(), t, fired, direction);
+        for (size_t f = 0; f < fired.size(); ++f) {
+            const uint32_t k = fired[f];
+            // Same order MovingAverageStrategy submits for this signal.
+            Order o;
+            o.side = direction[f] > 0 ? Side::Buy : Side::Sell;
+            o.id = "lane" + std::to_string(k) + (direction[f] > 0 ? "-buy-" : "-sell-") + std::to_string(++signalCount[k]);
+            o.price = c.close;
+            o.qty = 1.0;
+            o.symbol = sym;
+            o.timestamp = c.timestamp;
+            if (pending[k].empty()) {
+                pendingLanes.push_back(k);
+            }
+            pending[k].push_back({o});
+        }
+
+        size_t keep = 0;
+        for (uint32_t k : pendingLanes) {
+            auto& result = results[k];
+            const size_t fillsBefore = result.ordersFilled;
+            matchOrders(result, pending[k], c, fill);
+            if (result.ordersFilled != fillsBefore) {
+                cash[k] = result.portfolio.cash();
+                qty[k] = result.portfolio.positions().at(sym).qty;
+                mark[k] = result.portfolio.lastPrice(sym);
+            }
+            if (!pending[k].empty()) {
+                pendingLanes[keep++] = k;
             }
         }
+        pendingLanes.resize(keep);
+
+        for (size_t k = 0; k < lanes; ++k) {
+            // Portfolio::equity(): cash plus every non-flat position at its mark.
+            const double positionValue = std::abs(qty[k]) < kFlat ? 0.0 : 0.0 + qty[k] * mark[k];
+            auto& result = results[k];
+            if (std::abs(qty[k]) >= kFlat) {
+                trackExcursions(result, sym, c);
+            }
+            ++result.candlesProcessed;
+            recordEquity(result, c.timestamp, cash[k] + positionValue, std::abs(qty[k]) >= kFlat);
+        }
+        ++processed;
+        if (!keepRunning(processed, cursor)) {
+            break;
+        }
+    }
+
+    for (size_t k = 0; k < lanes; ++k) {
+        if (mark[k] > 0.0) {
+            results[k].portfolio.markPrice(sym, mark[k]);
+        }
+        closeOut(results[k], pending[k]);
+        finishRun(results[k], cursor);
+    }
+    return results;
+}
+
+std::vector<BacktestResult> BacktestEngine::runBroadcastWithStreamer(
+        const std::function<void(const std::function<bool(const Candle&)>&)>& streamer,
+        const std::vector<std::function<std::unique_ptr<Strategy>()>>& strategyFactories,
+        double initialCapital,
+        IndicatorRegistry* registry) {
+    IndicatorRegistry localRegistry;
+    IndicatorRegistry& indicators = registry ? *registry : localRegistry;
+
+    std::vector<std::unique_ptr<BroadcastLane>> lanes;
+    lanes.reserve(strategyFactories.size());
+    for (const auto& factory : strategyFactories) {
+        auto lane = std::make_unique<BroadcastLane>(initialCapital);
+        prepareResult(lane->result);
+        lane->strategy = factory();
+        if (!lane->strategy) {
+            throw std::runtime_error("Strategy factory returned null strategy");
+        }
+        lane->strategy->bindIndicators(indicators);
+        lane->strategy->setOrderSink(&lane->sink);
+        lane->strategy->onStart();
+        lanes.push_back(std::move(lane));
+    }
+
+    auto fill = [this](const Order& o, const Candle& c, size_t seq, Trade& t, double& slip) {
+        return fillOrder(o, c, seq, t, slip);
+    };
+
+    size_t processed = 0;
+    RunCursor cursor;
+    auto handleCandle = [&](const Candle& c)->bool {
+        indicators.update(c);
+        const std::string sym = normalizeSymbol(c.symbol);
+        for (auto& lane : lanes) {
+            auto& result = lane->result;
+            result.portfolio.markPrice(sym, c.close);
+            lane->strategy->onData(c);
+            matchOrders(result, lane->pendingOrders, c, fill);
+            trackExcursions(result, sym, c);
+            ++result.candlesProcessed;
+            recordEquity(result, c.timestamp);
+        }
+        ++processed;
+        return keepRunning(processed, cursor);
+    };
+
+    streamer(handleCandle);
 
-        double notional = finalPrice * po.order.qty;
-        double fee = execConfig_.commissionPerShare * po.order.qty
-            + execConfig_.commissionBps / 10000.0 * notional;
-
-        outTrade.orderId = po.order.id;
-        outTrade.id = po.order.id + "-exec-" + std::to_string(result.trades.size() + 1);
-        outTrade.side = po.order.side;
-        outTrade.type = po.order.type;
-        outTrade.price = finalPrice;
-        outTrade.qty = po.order.qty;
-        outTrade.symbol = po.order.symbol;
-        outTrade.timestamp = candle.timestamp;
-        outTrade.fee = fee;
-        outTrade.slippageBps = slippageBps;
-        return true;
+    std::vector<BacktestResult> results;
+    results.reserve(lanes.size());
+    for (auto& lane : lanes) {
+        closeOut(lane->result, lane->pendingOrders);
+        finishRun(lane->result, cursor);
+        lane->strategy->onFinish();
+        lane->strategy->setOrderSink(nullptr);
+        results.push_back(std::move(lane->result));
+    }
+    return results;
+}
+
+BacktestResult BacktestEngine::runCrossSectional(std::span<const Candle> candles, Strategy& strategy, double initialCapital) {
+    // Slices must be contiguous: sort a private copy only if the input is not
+    // already in timestamp order (stable, so per-timestamp row order is kept).
+    std::vector<Candle> sortedCopy;
+    auto byTime = [](const Candle& a, const Candle& b) { return a.timestamp < b.timestamp; };
+    if (!std::is_sorted(candles.begin(), candles.end(), byTime)) {
+        sortedCopy.assign(candles.begin(), candles.end());
+        std::stable_sort(sortedCopy.begin(), sortedCopy.end(), byTime);
+        candles = sortedCopy;
+    }
+
+    BacktestResult result(initialCapital);
+    prepareResult(result);
+    RunCursor cursor;
+
+    std::vector<PendingOrder> pendingOrders;
+    size_t orderCounter = 0;
+    EngineSink sink(pendingOrders, orderCounter);
+
+    strategy.setOrderSink(&sink);
+    strategy.onStart();
+
+    std::vector<std::string> universe;
+    std::unordered_map<std::string, uint32_t> universeIndex;
+    std::vector<int64_t> slotOf;       // symbol id -> row within the current slice, -1 if absent
+    std::vector<uint32_t> sliceIds;
+
+    auto symbolId = [&](const std::string& sym) -> uint32_t {
+        auto [it, inserted] = universeIndex.try_emplace(sym, static_cast<uint32_t>(universe.size()));
+        if (inserted) {
+            universe.push_back(sym);
+            slotOf.push_back(-1);
+        }
+        return it->second;
     };
 
-    auto processOrders = [&](const Candle& c) {
+    size_t begin = 0;
+    while (begin < candles.size()) {
+        size_t end = begin + 1;
+        while (end < candles.size() && candles[end].timestamp == candles[begin].timestamp) {
+            ++end;
+        }
+        auto slice = candles.subspan(begin, end - begin);
+
+        sliceIds.clear();
+        for (size_t i = 0; i < slice.size(); ++i) {
+            const uint32_t id = symbolId(normalizeSymbol(slice[i].symbol));
+            sliceIds.push_back(id);
+            slotOf[id] = static_cast<int64_t>(i);
+            result.portfolio.markPrice(universe[id], slice[i].close);
+        }
+
+        strategy.onBar(BarSlice{slice.front().timestamp, slice, sliceIds, &universe});
+
+        // One pass over the book per slice; each order looks up its symbol's row directly.
         auto it = pendingOrders.begin();
         while (it != pendingOrders.end()) {
+            if (it->symbolId < 0) {
+                if (auto found = universeIndex.find(it->order.symbol); found != universeIndex.end()) {
+                    it->symbolId = found->second;
+                }
+            }
+            const int64_t row = it->symbolId >= 0 ? slotOf[static_cast<size_t>(it->symbolId)] : -1;
             Trade trade;
             double slipValue = 0.0;
-            bool filled = tryFill(*it, c, trade, slipValue);
+            bool filled = row >= 0
+                && fillOrder(it->order, slice[static_cast<size_t>(row)], result.ordersFilled + 1, trade, slipValue);
             if (filled) {
-                result.trades.push_back(trade);
-                result.totalFees += trade.fee;
-                result.totalSlippage += slipValue;
-                ++result.ordersFilled;
-                result.portfolio.applyTrade(trade);
+                recordFill(result, trade, slipValue);
+                it = pendingOrders.erase(it);
+            } else if (expiresUnfilled(it->order)) {
+                ++result.ordersRejected;
                 it = pendingOrders.erase(it);
             } else {
-                bool expire = false;
-                if (it->order.tif == TimeInForce::IOC || it->order.tif == TimeInForce::FOK) {
-                    expire = true;
-                    ++result.ordersRejected;
-                }
-                if (expire) {
-                    it = pendingOrders.erase(it);
-                } else {
-                    ++it;
-                }
+                ++it;
             }
         }
-    };
 
-    auto handleCandle = [&](const Candle& c)->bool {
-        std::string sym = normalizeSymbol(c.symbol);
-        result.portfolio.markPrice(sym, c.close);
-        strategy.onData(c);
-        processOrders(c);
-        ++result.candlesProcessed;
-        result.equityTimestamps.push_back(c.timestamp);
-        result.equityCurve.push_back(result.portfolio.equity());
-        return true;
-    };
-
-    streamer(handleCandle);
+        for (size_t i = 0; i < slice.size(); ++i) {
+            trackExcursions(result, universe[sliceIds[i]], slice[i]);
+        }
+        for (uint32_t id : sliceIds) {
+            slotOf[id] = -1;
+        }
 
-    // cancel remaining pending orders after data exhausts
-    if (!pendingOrders.empty()) {
-        result.ordersRejected += pendingOrders.size();
-        pendingOrders.clear();
+        result.candlesProcessed += slice.size();
+        recordEquity(result, slice.front().timestamp);
+        begin = end;
+        if (!keepRunning(result.candlesProcessed, cursor, &result)) {
+            break;
+        }
     }
 
+    closeOut(result, pendingOrders);
+    finishRun(result, cursor, true);
     strategy.onFinish();
     strategy.setOrderSink(nullptr);
-
-    if (result.equityCurve.empty()) {
-        result.equityTimestamps.push_back(std::chrono::system_clock::now());
-        result.equityCurve.push_back(result.portfolio.equity());
-    }
     return result;
 }
 
@@ -235,6 +855,10 @@ std::vector<BacktestResult> BacktestEngine::runParallel(const std::string& csvPa
             throw std::runtime_error("Strategy factory returned null strategy");
         }
         BacktestEngine worker(execConfig_);
+        worker.setCandleLimit(candleLimit_);
+        worker.setSummaryOnly(summaryOnly_);
+        worker.setEquityRecording(equityRecording_);
+        worker.setRunControl(control_);
         return worker.run(csvPath, cfg, *strategy, initialCapital);
     };
 
@@ -265,30 +889,33 @@ std::vector<BacktestResult> BacktestEngine::runParallel(const std::vector<Candle
         return results;
     }
 
-    auto runSingle = [&](std::function<std::unique_ptr<Strategy>()> factory) {
-        auto strategy = factory();
-        if (!strategy) {
-            throw std::runtime_error("Strategy factory returned null strategy");
+    // Contiguous batches, one broadcast pass each: strategies in a batch share
+    // indicators, and batches spread over the pool.
+    auto& pool = ThreadPool::shared();
+    const size_t batches = std::min(strategyFactories.size(), pool.size());
+    const size_t perBatch = (strategyFactories.size() + batches - 1) / batches;
+    std::vector<std::vector<BacktestResult>> batchResults(batches);
+    pool.parallelFor(batches, [&](size_t b) {
+        const size_t begin = b * perBatch;
+        const size_t end = std::min(strategyFactories.size(), begin + perBatch);
+        if (begin >= end) {
+            return;
         }
+        std::vector<std::function<std::unique_ptr<Strategy>()>> slice(strategyFactories.begin() + static_cast<std::ptrdiff_t>(begin),
+                                                                      strategyFactories.begin() + static_cast<std::ptrdiff_t>(end));
         BacktestEngine worker(execConfig_);
-        return worker.run(candles, *strategy, initialCapital);
-    };
-
-    if (strategyFactories.size() == 1) {
-        results.push_back(runSingle(strategyFactories.front()));
-        return results;
-    }
-
-    std::vector<std::future<BacktestResult>> futures;
-    futures.reserve(strategyFactories.size());
-    for (const auto& factory : strategyFactories) {
-        futures.emplace_back(std::async(std::launch::async, [=]() {
-            return runSingle(factory);
-        }));
-    }
-
-    for (auto& fut : futures) {
-        results.push_back(fut.get());
+        worker.setCandleLimit(candleLimit_);
+        worker.setSummaryOnly(summaryOnly_);
+        worker.setEquityRecording(equityRecording_);
+        worker.setRunControl(control_);
+        batchResults[b] = worker.runBroadcast(candles, slice, initialCapital);
+    });
+
+    results.reserve(strategyFactories.size());
+    for (auto& batch : batchResults) {
+        for (auto& result : batch) {
+            results.push_back(std::move(result));
+        }
     }
     return results;
 }
@@ -7,12 +7,21 @@
 #include "../Model/Trade.h"
 #include "../Model/Order.h"
 #include "../Model/Portfolio.h"
+#include "Checkpoint.h"
+#include "RunMetrics.h"
+#include "TradeLedger.h"
+#include "EquityRecorder.h"
+#include "RunControl.h"
+#include "RunObserver.h"
 #include <vector>
 #include <chrono>
 #include <functional>
+#include <span>
 
 namespace fastquant {
 
+class IndicatorRegistry;
+
 struct ExecutionConfig {
     double defaultSlippageBps{0.0};
     double commissionPerShare{0.0};
@@ -30,11 +39,45 @@ struct BacktestResult {
     double totalSlippage{0.0};
     size_t ordersFilled{0};
     size_t ordersRejected{0};
+    // Summary-only runs leave trades and the equity vectors empty; metrics is
+    // accumulated either way.
+    bool summaryOnly{false};
+    // A RunControl cancel arrived before the run finished; the result covers
+    // candlesProcessed candles only.
+    bool cancelled{false};
+    RunMetrics metrics;
+    // Round trips matched FIFO as fills happen; summary-only runs keep only
+    // its stats and open lots.
+    TradeLedger ledger;
+    // Policy equityCurve was recorded with. Under Spill the curve lives in
+    // equitySpill and the vectors stay empty.
+    EquityRecording equityRecording;
+    std::shared_ptr<EquitySpill> equitySpill;
+    std::shared_ptr<EquityRecorder> equityRecorder; // engine-owned while the run is in progress
 
     BacktestResult();
     explicit BacktestResult(double initialCapital);
+    BacktestResult(BacktestResult&&) = default;
+    BacktestResult& operator=(BacktestResult&&) = default;
+    BacktestResult(const BacktestResult&) = delete;
+    BacktestResult& operator=(const BacktestResult&) = delete;
+
+    // Recorded curve, from the vectors or the spill file.
+    size_t equityPointCount() const;
+    void forEachEquityPoint(const std::function<void(std::chrono::system_clock::time_point, double)>& fn) const;
+
+    // Deep copy of a finished result (copying is otherwise deleted so large
+    // results are never duplicated by accident). A spill file is shared.
+    BacktestResult clone() const;
 };
 
+// A finished result written as a snapshot with no pending orders or strategy
+// state, and read back, for storing completed runs (see app::ResultCache). A
+// spilled curve is not carried. The snapshot does not record how the run was
+// configured, so resultFromSnapshot takes summaryOnly and the equity policy.
+void writeResultSnapshot(const BacktestResult& result, const std::string& path);
+BacktestResult resultFromSnapshot(const EngineSnapshot& snapshot, bool summaryOnly, const EquityRecording& recording);
+
 class BacktestEngine {
 public:
     explicit BacktestEngine(ExecutionConfig exec = ExecutionConfig{});
@@ -42,6 +85,45 @@ public:
     void setExecutionConfig(const ExecutionConfig& cfg) { execConfig_ = cfg; }
     const ExecutionConfig& executionConfig() const { return execConfig_; }
 
+    // Stop after this many candles (0 = run to the end of the data). Uses the
+    // streamers' early-stop path, so CSV input is not read past the limit.
+    void setCandleLimit(size_t limit) { candleLimit_ = limit; }
+    size_t candleLimit() const { return candleLimit_; }
+
+    // Keep only the online RunMetrics: no trade list and no equity curve, so a
+    // run's memory no longer grows with its length. Applies to every run mode.
+    void setSummaryOnly(bool summaryOnly) { summaryOnly_ = summaryOnly; }
+    bool summaryOnly() const { return summaryOnly_; }
+
+    // Equity curve storage for every run mode (see EquityPolicy). Checkpointed
+    // runs reject Downsample and Spill.
+    void setEquityRecording(EquityRecording recording) { equityRecording_ = std::move(recording); }
+    const EquityRecording& equityRecording() const { return equityRecording_; }
+
+    // Write an EngineSnapshot to cfg.path every cfg.everyCandles candles, with
+    // the trade list and equity curve appended to sidecars beside it (see
+    // CheckpointHistory). Applies to run()/resume() only; runParallel workers
+    // never checkpoint. removeSnapshot() deletes a snapshot with its sidecars.
+    void setCheckpoint(CheckpointConfig cfg) { checkpoint_ = std::move(cfg); }
+    const CheckpointConfig& checkpoint() const { return checkpoint_; }
+
+    // Cooperative cancellation and progress for every run mode. runParallel
+    // workers share it, so one cancel stops them all (their published counts
+    // interleave). Not owned: it must outlive the runs it is attached to.
+    void setRunControl(RunControl* control) { control_ = control; }
+    RunControl* runControl() const { return control_; }
+
+    // Progress, equity and trade feed for single-strategy runs; see RunObserver.
+    // Not owned.
+    void setObserver(RunObserver* observer) { observer_ = observer; }
+    RunObserver* observer() const { return observer_; }
+
+    // Candles preceding the data of run(), handed to Strategy::warmUp after
+    // onStart(); they are neither traded nor recorded. Ignored by resume() and
+    // the multi-strategy modes. Not owned: the span must outlive the runs.
+    void setWarmup(std::span<const Candle> history) { warmup_ = history; }
+    std::span<const Candle> warmup() const { return warmup_; }
+
     // Run backtest by streaming CSV into the provided strategy.
     BacktestResult run(const std::string& csvPath,
                        CSVDataLoader::Config cfg,
@@ -52,20 +134,104 @@ public:
                        Strategy& strategy,
                        double initialCapital = 100000.0);
 
+    // Run over a contiguous slice of an in-memory dataset without copying it.
+    BacktestResult run(std::span<const Candle> candles,
+                       Strategy& strategy,
+                       double initialCapital = 100000.0);
+
+    // Continue a checkpointed run. State comes from the snapshot (including the
+    // initial capital); the first snapshot.candlesProcessed candles of the data
+    // are skipped, so passing the original data extended with new rows simulates
+    // only the new rows. In-memory data is sliced; CSV rows before the offset are
+    // still parsed but never reach the strategy. Throws std::runtime_error if the
+    // snapshot carries no strategy state.
+    BacktestResult resume(const EngineSnapshot& snapshot,
+                          const std::string& csvPath,
+                          CSVDataLoader::Config cfg,
+                          Strategy& strategy);
+
+    BacktestResult resume(const EngineSnapshot& snapshot,
+                          std::span<const Candle> candles,
+                          Strategy& strategy);
+
+    // Cross-sectional run: candles sharing a timestamp are grouped into one
+    // BarSlice, delivered through Strategy::onBar, and marked and filled as a
+    // batch. One equity point is recorded per slice rather than per candle.
+    // Input that is not time-ordered is sorted (stably) into a private copy.
+    BacktestResult runCrossSectional(std::span<const Candle> candles,
+                                     Strategy& strategy,
+                                     double initialCapital = 100000.0);
+
+    // Broadcast run: one pass over the data drives every strategy. Strategies
+    // subscribe to one shared IndicatorRegistry (Strategy::bindIndicators), so
+    // identical indicators are computed once per candle for the whole set.
+    // Pass `registry` to inspect de-duplication afterwards.
+    std::vector<BacktestResult> runBroadcast(const std::string& csvPath,
+                                             CSVDataLoader::Config cfg,
+                                             const std::vector<std::function<std::unique_ptr<Strategy>()>>& strategyFactories,
+                                             double initialCapital = 100000.0,
+                                             IndicatorRegistry* registry = nullptr);
+
+    std::vector<BacktestResult> runBroadcast(std::span<const Candle> candles,
+                                             const std::vector<std::function<std::unique_ptr<Strategy>()>>& strategyFactories,
+                                             double initialCapital = 100000.0,
+                                             IndicatorRegistry* registry = nullptr);
+
+    // Sweep kernel for MovingAverageStrategy: every (short, long) pair runs as
+    // one lane of MovingAverageLanes over a single pass of the data, with a
+    // private book per lane. Equity, each fill's side, price, qty, fee and
+    // timestamp, and the run metrics match run() with MovingAverageStrategy bit
+    // for bit; order and trade ids differ ("lane<k>-buy-<n>" instead of the
+    // strategy's). Throws std::runtime_error unless all candles share one symbol.
+    std::vector<BacktestResult> runMovingAverageLanes(std::span<const Candle> candles,
+                                                      const std::vector<std::pair<size_t, size_t>>& windows,
+                                                      double initialCapital = 100000.0);
+
     std::vector<BacktestResult> runParallel(const std::string& csvPath,
                                             CSVDataLoader::Config cfg,
                                             const std::vector<std::function<std::unique_ptr<Strategy>()>>& strategyFactories,
                                             double initialCapital = 100000.0);
 
+    // In-memory variant: strategies are split into contiguous batches that run
+    // as broadcast passes on the shared ThreadPool.
     std::vector<BacktestResult> runParallel(const std::vector<Candle>& candles,
                                             const std::vector<std::function<std::unique_ptr<Strategy>()>>& strategyFactories,
                                             double initialCapital = 100000.0);
 
 private:
     ExecutionConfig execConfig_;
+    size_t candleLimit_{0};
+    bool summaryOnly_{false};
+    EquityRecording equityRecording_;
+    CheckpointConfig checkpoint_;
+    RunControl* control_{nullptr};
+    RunObserver* observer_{nullptr};
+    std::span<const Candle> warmup_;
+    // Progress and observer cursors for one run; owned by the run method so that
+    // concurrent runs on the same engine never share them.
+    struct RunCursor {
+        size_t published{0};
+        size_t equitySent{0};
+        size_t tradesSent{0};
+        bool cancelled{false}; // stopped early on a cancel request
+    };
+    void prepareResult(BacktestResult& result) const;
+    // Per-candle stop check: candle limit, cancellation and progress publishing.
+    // `observed` is the result the observer follows (single-strategy runs only).
+    bool keepRunning(size_t processed, RunCursor& cursor, const BacktestResult* observed = nullptr) const;
+    void finishRun(BacktestResult& result, RunCursor& cursor, bool observed = false) const;
+    void notifyObserver(size_t processed, RunCursor& cursor, const BacktestResult* observed, bool finished) const;
     BacktestResult runWithStreamer(const std::function<void(const std::function<bool(const Candle&)>&)>& streamer,
                                    Strategy& strategy,
-                                   double initialCapital);
+                                   double initialCapital,
+                                   const EngineSnapshot* resumeFrom = nullptr,
+                                   size_t skipCandles = 0);
+    std::vector<BacktestResult> runBroadcastWithStreamer(const std::function<void(const std::function<bool(const Candle&)>&)>& streamer,
+                                                         const std::vector<std::function<std::unique_ptr<Strategy>()>>& strategyFactories,
+                                                         double initialCapital,
+                                                         IndicatorRegistry* registry);
+    bool fillOrder(const Order& order, const Candle& candle, size_t tradeSeq,
+                   Trade& outTrade, double& slippageValue) const;
 };
 
 } // namespace fastquant
@@ -0,0 +1,428 @@
+#include "Checkpoint.h"
+#include "../Model/ByteStream.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace fastquant {
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'Q', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t kVersion = 4; // 2: RunMetrics block, 3: TradeLedger block, 4: history sidecars
+constexpr size_t kGenerationLength = 16;
+constexpr size_t kSidecarChunk = size_t{1} << 20;            // bytes buffered per sidecar write
+constexpr size_t kEquityRecord = sizeof(int64_t) + sizeof(double);
+
+void putOrder(ByteWriter& w, const Order& o) {
+    w.putString(o.id);
+    w.put<uint8_t>(static_cast<uint8_t>(o.side));
+    w.put<uint8_t>(static_cast<uint8_t>(o.type));
+    w.put<uint8_t>(static_cast<uint8_t>(o.tif));
+    w.put(o.price);
+    w.put(o.qty);
+    w.putString(o.symbol);
+    w.putTime(o.timestamp);
+    w.put(o.slippageBps);
+}
+
+Order getOrder(ByteReader& r) {
+    Order o;
+    o.id = r.getString();
+    o.side = static_cast<Side>(r.get<uint8_t>());
+    o.type = static_cast<OrderType>(r.get<uint8_t>());
+    o.tif = static_cast<TimeInForce>(r.get<uint8_t>());
+    o.price = r.get<double>();
+    o.qty = r.get<double>();
+    o.symbol = r.getString();
+    o.timestamp = r.getTime();
+    o.slippageBps = r.get<double>();
+    return o;
+}
+
+void putTrade(ByteWriter& w, const Trade& t) {
+    w.putString(t.id);
+    w.putString(t.orderId);
+    w.put<uint8_t>(static_cast<uint8_t>(t.side));
+    w.put<uint8_t>(static_cast<uint8_t>(t.type));
+    w.put(t.price);
+    w.put(t.qty);
+    w.putString(t.symbol);
+    w.putTime(t.timestamp);
+    w.put(t.fee);
+    w.put(t.slippageBps);
+}
+
+Trade getTrade(ByteReader& r) {
+    Trade t;
+    t.id = r.getString();
+    t.orderId = r.getString();
+    t.side = static_cast<Side>(r.get<uint8_t>());
+    t.type = static_cast<OrderType>(r.get<uint8_t>());
+    t.price = r.get<double>();
+    t.qty = r.get<double>();
+    t.symbol = r.getString();
+    t.timestamp = r.getTime();
+    t.fee = r.get<double>();
+    t.slippageBps = r.get<double>();
+    return t;
+}
+
+std::filesystem::path sidecarPath(const std::filesystem::path& snapshot, const std::string& generation,
+                                  const char* kind) {
+    std::filesystem::path p = snapshot;
+    p += "." + generation + "." + kind;
+    return p;
+}
+
+std::string newGeneration() {
+    std::random_device rd;
+    const uint64_t bits = (uint64_t{rd()} << 32) ^ rd()
+        ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    char text[kGenerationLength + 1];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(bits));
+    return text;
+}
+
+bool isGeneration(const std::string& s) {
+    return s.size() == kGenerationLength
+        && std::all_of(s.begin(), s.end(), [](char c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); });
+}
+
+// History sidecars of `snapshot` from every generation except `keep`.
+std::vector<std::filesystem::path> staleSidecars(const std::filesystem::path& snapshot, const std::string& keep) {
+    std::vector<std::filesystem::path> out;
+    auto dir = snapshot.parent_path();
+    if (dir.empty()) {
+        dir = ".";
+    }
+    const std::string prefix = snapshot.filename().string() + ".";
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() != prefix.size() + kGenerationLength + 7 || name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        const std::string suffix = name.substr(prefix.size() + kGenerationLength);
+        const std::string generation = name.substr(prefix.size(), kGenerationLength);
+        if ((suffix == ".trades" || suffix == ".equity") && isGeneration(generation) && generation != keep) {
+            out.push_back(entry.path());
+        }
+    }
+    return out;
+}
+
+// Append put(w, i) for i in [0, count) to `file` (truncated first when
+// `fresh`), buffering a chunk at a time. Returns the bytes written.
+template<typename Put>
+uint64_t appendSidecar(const std::filesystem::path& file, bool fresh, size_t count, const Put& put) {
+    std::ofstream out(file, std::ios::binary | (fresh ? std::ios::trunc : std::ios::app));
+    if (!out) {
+        throw std::runtime_error("Unable to open checkpoint history: " + file.string());
+    }
+    uint64_t written = 0;
+    ByteWriter w;
+    auto flush = [&] {
+        const std::string chunk = w.release();
+        out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        written += chunk.size();
+        w = ByteWriter();
+    };
+    for (size_t i = 0; i < count; ++i) {
+        put(w, i);
+        if (w.data().size() >= kSidecarChunk) {
+            flush();
+        }
+    }
+    flush();
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Failed writing checkpoint history: " + file.string());
+    }
+    return written;
+}
+
+// Sidecar opened for reading its first `bytes` bytes, which must exist.
+std::ifstream openSidecar(const std::filesystem::path& file, uint64_t bytes) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(file, ec);
+    if (ec) {
+        throw std::runtime_error("Missing snapshot history: " + file.string());
+    }
+    if (size < bytes) {
+        throw std::runtime_error("Truncated snapshot history: " + file.string());
+    }
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Unable to open snapshot history: " + file.string());
+    }
+    return in;
+}
+
+void readChunk(std::ifstream& in, std::string& chunk, size_t bytes, const std::filesystem::path& file) {
+    chunk.resize(bytes);
+    in.read(chunk.data(), static_cast<std::streamsize>(bytes));
+    if (!in) {
+        throw std::runtime_error("Truncated snapshot history: " + file.string());
+    }
+}
+
+// Appends this checkpoint's new trades and equity points to the sidecars and
+// records the covered lengths in `w`. Any failure drops the generation, so the
+// next checkpoint rewrites the history instead of appending after a torn tail.
+void writeHistory(const SnapshotView& s, const std::filesystem::path& target, ByteWriter& w) {
+    CheckpointHistory& h = *s.history;
+    try {
+        if (s.equityTimestamps.size() != s.equityCurve.size()) {
+            throw std::runtime_error("Checkpoint equity timestamps and values differ in length");
+        }
+        const bool fresh = h.generation.empty();
+        if (fresh) {
+            h = CheckpointHistory{};
+            h.generation = newGeneration();
+        }
+        if (s.trades.size() < h.trades || s.equityCurve.size() < h.equity) {
+            throw std::runtime_error("Checkpoint history shrank between checkpoints");
+        }
+        const auto trades = s.trades.subspan(h.trades);
+        h.tradeBytes += appendSidecar(sidecarPath(target, h.generation, "trades"), fresh, trades.size(),
+                                      [&](ByteWriter& out, size_t i) { putTrade(out, trades[i]); });
+        h.trades = s.trades.size();
+        const size_t from = h.equity;
+        appendSidecar(sidecarPath(target, h.generation, "equity"), fresh, s.equityCurve.size() - from,
+                      [&](ByteWriter& out, size_t i) {
+                          out.putTime(s.equityTimestamps[from + i]);
+                          out.put(s.equityCurve[from + i]);
+                      });
+        h.equity = s.equityCurve.size();
+    } catch (...) {
+        h.generation.clear();
+        throw;
+    }
+    w.putString(h.generation);
+    w.put<uint64_t>(h.trades);
+    w.put<uint64_t>(h.tradeBytes);
+    w.put<uint64_t>(h.equity);
+}
+
+void readHistory(ByteReader& r, const std::filesystem::path& snapshot, EngineSnapshot& s) {
+    const auto generation = r.getString();
+    const auto tradeCount = r.get<uint64_t>();
+    const auto tradeBytes = r.get<uint64_t>();
+    const auto equityCount = r.get<uint64_t>();
+    if (!isGeneration(generation) || equityCount > std::numeric_limits<uint64_t>::max() / kEquityRecord) {
+        throw std::runtime_error("Corrupt snapshot history header: " + snapshot.string());
+    }
+
+    const auto tradesFile = sidecarPath(snapshot, generation, "trades");
+    auto tradesIn = openSidecar(tradesFile, tradeBytes);
+    std::string chunk;
+    readChunk(tradesIn, chunk, static_cast<size_t>(tradeBytes), tradesFile);
+    ByteReader tr(chunk);
+    for (uint64_t i = 0; i < tradeCount; ++i) {
+        s.trades.push_back(getTrade(tr));
+    }
+    if (!tr.atEnd()) {
+        throw std::runtime_error("Corrupt snapshot history: " + tradesFile.string());
+    }
+
+    const auto equityFile = sidecarPath(snapshot, generation, "equity");
+    auto equityIn = openSidecar(equityFile, equityCount * kEquityRecord);
+    s.equityTimestamps.reserve(equityCount);
+    s.equityCurve.reserve(equityCount);
+    for (uint64_t done = 0; done < equityCount;) {
+        const size_t n = static_cast<size_t>(std::min<uint64_t>(equityCount - done, kSidecarChunk / kEquityRecord));
+        readChunk(equityIn, chunk, n * kEquityRecord, equityFile);
+        ByteReader er(chunk);
+        for (size_t i = 0; i < n; ++i) {
+            s.equityTimestamps.push_back(er.getTime());
+            s.equityCurve.push_back(er.get<double>());
+        }
+        done += n;
+    }
+}
+
+} // namespace
+
+void writeSnapshot(const SnapshotView& s, const std::string& path) {
+    std::filesystem::path target(path);
+    if (auto parent = target.parent_path(); !parent.empty()) {
+        std::filesystem::create_directories(parent);
+    }
+
+    ByteWriter w;
+    w.put(kMagic);
+    w.put(kVersion);
+    w.put<uint64_t>(s.candlesProcessed);
+    w.put(s.initialCapital);
+    w.put(s.cash);
+    w.put(s.realizedPnl);
+
+    w.put<uint64_t>(s.positions.size());
+    for (const auto& pos : s.positions) {
+        w.putString(pos.symbol);
+        w.put(pos.qty);
+        w.put(pos.avgPrice);
+    }
+    w.put<uint64_t>(s.marks.size());
+    for (const auto& [symbol, price] : s.marks) {
+        w.putString(symbol);
+        w.put(price);
+    }
+    w.put<uint64_t>(s.pendingOrders.size());
+    for (const auto& o : s.pendingOrders) {
+        putOrder(w, o);
+    }
+    w.put<uint64_t>(s.orderCounter);
+    const bool fresh = s.history && s.history->generation.empty();
+    w.put<uint8_t>(s.history ? 1 : 0);
+    if (s.history) {
+        writeHistory(s, target, w);
+    } else {
+        w.put<uint64_t>(s.trades.size());
+        for (const auto& t : s.trades) {
+            putTrade(w, t);
+        }
+        w.put<uint64_t>(s.equityTimestamps.size());
+        for (auto ts : s.equityTimestamps) {
+            w.putTime(ts);
+        }
+        w.putDoubles(s.equityCurve);
+    }
+    w.put(s.totalFees);
+    w.put(s.totalSlippage);
+    w.put<uint64_t>(s.ordersFilled);
+    w.put<uint64_t>(s.ordersRejected);
+    s.metrics->save(w);
+    s.ledger->save(w);
+    w.put<uint8_t>(s.hasStrategyState ? 1 : 0);
+    w.putString(s.strategyState);
+
+    // Write beside the target and rename, so a crash mid-write never leaves a
+    // torn snapshot where the previous good one used to be.
+    std::filesystem::path tmp = target;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Unable to open snapshot for writing: " + tmp.string());
+        }
+        out.write(w.data().data(), static_cast<std::streamsize>(w.data().size()));
+        if (!out) {
+            throw std::runtime_error("Failed writing snapshot: " + tmp.string());
+        }
+    }
+    std::filesystem::rename(tmp, target);
+    if (fresh) {
+        // Nothing points at the previous generation any more.
+        std::error_code ec;
+        for (const auto& stale : staleSidecars(target, s.history->generation)) {
+            std::filesystem::remove(stale, ec);
+        }
+    }
+}
+
+void writeSnapshot(const EngineSnapshot& s, const std::string& path) {
+    SnapshotView view;
+    view.candlesProcessed = s.candlesProcessed;
+    view.initialCapital = s.initialCapital;
+    view.cash = s.cash;
+    view.realizedPnl = s.realizedPnl;
+    view.positions = s.positions;
+    view.marks = s.marks;
+    view.pendingOrders = s.pendingOrders;
+    view.orderCounter = s.orderCounter;
+    view.trades = s.trades;
+    view.equityTimestamps = s.equityTimestamps;
+    view.equityCurve = s.equityCurve;
+    view.totalFees = s.totalFees;
+    view.totalSlippage = s.totalSlippage;
+    view.ordersFilled = s.ordersFilled;
+    view.ordersRejected = s.ordersRejected;
+    view.metrics = &s.metrics;
+    view.ledger = &s.ledger;
+    view.hasStrategyState = s.hasStrategyState;
+    view.strategyState = s.strategyState;
+    writeSnapshot(view, path);
+}
+
+EngineSnapshot readSnapshot(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Unable to open snapshot: " + path);
+    }
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    ByteReader r(bytes);
+
+    char magic[sizeof(kMagic)];
+    for (auto& c : magic) {
+        c = r.get<char>();
+    }
+    if (!std::equal(std::begin(magic), std::end(magic), std::begin(kMagic))) {
+        throw std::runtime_error("Not an engine snapshot: " + path);
+    }
+    if (auto version = r.get<uint32_t>(); version != kVersion) {
+        throw std::runtime_error("Unsupported snapshot version " + std::to_string(version) + ": " + path);
+    }
+
+    EngineSnapshot s;
+    s.candlesProcessed = r.get<uint64_t>();
+    s.initialCapital = r.get<double>();
+    s.cash = r.get<double>();
+    s.realizedPnl = r.get<double>();
+
+    for (auto n = r.get<uint64_t>(); n > 0; --n) {
+        Position pos;
+        pos.symbol = r.getString();
+        pos.qty = r.get<double>();
+        pos.avgPrice = r.get<double>();
+        s.positions.push_back(pos);
+    }
+    for (auto n = r.get<uint64_t>(); n > 0; --n) {
+        auto symbol = r.getString();
+        s.marks.emplace_back(std::move(symbol), r.get<double>());
+    }
+    for (auto n = r.get<uint64_t>(); n > 0; --n) {
+        s.pendingOrders.push_back(getOrder(r));
+    }
+    s.orderCounter = r.get<uint64_t>();
+    if (r.get<uint8_t>() != 0) {
+        readHistory(r, path, s);
+    } else {
+        for (auto n = r.get<uint64_t>(); n > 0; --n) {
+            s.trades.push_back(getTrade(r));
+        }
+        for (auto n = r.get<uint64_t>(); n > 0; --n) {
+            s.equityTimestamps.push_back(r.getTime());
+        }
+        s.equityCurve = r.getDoubles<std::vector<double>>();
+    }
+    s.totalFees = r.get<double>();
+    s.totalSlippage = r.get<double>();
+    s.ordersFilled = r.get<uint64_t>();
+    s.ordersRejected = r.get<uint64_t>();
+    s.metrics.load(r);
+    s.ledger.load(r);
+    s.hasStrategyState = r.get<uint8_t>() != 0;
+    s.strategyState = r.getString();
+    if (s.equityCurve.size() != s.equityTimestamps.size()) {
+        throw std::runtime_error("Corrupt snapshot (equity length mismatch): " + path);
+    }
+    return s;
+}
+
+void removeSnapshot(const std::string& path) {
+    std::error_code ec;
+    for (const auto& sidecar : staleSidecars(path, std::string())) {
+        std::filesystem::remove(sidecar, ec);
+    }
+    std::filesystem::remove(path, ec);
+}
+
+} // namespace fastquant
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../Model/Order.h"
+#include "../Model/Portfolio.h"
+#include "../Model/Trade.h"
+#include "RunMetrics.h"
+#include "TradeLedger.h"
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fastquant {
+
+struct CheckpointConfig {
+    std::string path;          // snapshot file; rewritten atomically on every checkpoint, history sidecars beside it
+    size_t everyCandles{0};    // 0 = never
+};
+
+// Append-only history beside a periodic checkpoint: the trade list goes to
+// <path>.<generation>.trades and the equity curve to <path>.<generation>.equity.
+// Each checkpoint appends only what arrived since the previous one and the
+// snapshot records how much of each file it covers, so a run's checkpoints
+// write its history once instead of once per checkpoint. A run starts a new
+// generation at its first checkpoint; the previous snapshot keeps pointing at
+// the old files until the new one is renamed into place, and the old files are
+// removed after that. The ledger and strategy state stay inline.
+struct CheckpointHistory {
+    std::string generation; // empty until the run's first checkpoint
+    size_t trades{0};       // trades already in the sidecar
+    uint64_t tradeBytes{0};
+    size_t equity{0};       // equity points already in the sidecar
+};
+
+// Everything the engine needs to continue a run after the last processed candle.
+struct EngineSnapshot {
+    size_t candlesProcessed{0}; // data offset: rows consumed before the snapshot
+    double initialCapital{0.0};
+    double cash{0.0};
+    double realizedPnl{0.0};
+    std::vector<Position> positions;
+    std::vector<std::pair<std::string, double>> marks;
+    std::vector<Order> pendingOrders;
+    size_t orderCounter{0};
+    std::vector<Trade> trades;
+    std::vector<std::chrono::system_clock::time_point> equityTimestamps;
+    std::vector<double> equityCurve;
+    double totalFees{0.0};
+    double totalSlippage{0.0};
+    size_t ordersFilled{0};
+    size_t ordersRejected{0};
+    RunMetrics metrics;
+    TradeLedger ledger;
+    bool hasStrategyState{false};
+    std::string strategyState;
+};
+
+// The same fields borrowed from live state, so a periodic checkpoint writes
+// the trade list, equity curve and ledger in place instead of copying them
+// into an EngineSnapshot first. Everything referenced must outlive the write.
+struct SnapshotView {
+    size_t candlesProcessed{0};
+    double initialCapital{0.0};
+    double cash{0.0};
+    double realizedPnl{0.0};
+    std::span<const Position> positions;
+    std::span<const std::pair<std::string, double>> marks;
+    std::span<const Order> pendingOrders;
+    size_t orderCounter{0};
+    std::span<const Trade> trades;
+    std::span<const std::chrono::system_clock::time_point> equityTimestamps;
+    std::span<const double> equityCurve;
+    double totalFees{0.0};
+    double totalSlippage{0.0};
+    size_t ordersFilled{0};
+    size_t ordersRejected{0};
+    const RunMetrics* metrics{nullptr};
+    const TradeLedger* ledger{nullptr};
+    bool hasStrategyState{false};
+    std::string_view strategyState;
+    // Set for a run's periodic checkpoints: trades and equity go to the
+    // sidecars and `history` advances. Null keeps them inline (one file).
+    CheckpointHistory* history{nullptr};
+};
+
+// Binary snapshot I/O. Throws std::runtime_error on I/O failure, bad magic,
+// unsupported version or truncated data (in the snapshot or its sidecars).
+void writeSnapshot(const SnapshotView& snapshot, const std::string& path);
+void writeSnapshot(const EngineSnapshot& snapshot, const std::string& path);
+EngineSnapshot readSnapshot(const std::string& path);
+
+// Delete a snapshot and any history sidecars of it.
+void removeSnapshot(const std::string& path);
+
+} // namespace fastquant
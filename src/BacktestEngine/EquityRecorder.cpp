@@ -0,0 +1,314 @@
+#include "EquityRecorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <numeric>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace fastquant {
+
+namespace {
+
+constexpr size_t kInitialSpillRecords = size_t{1} << 16;
+
+int processId() {
+#if defined(_WIN32)
+    return _getpid();
+#else
+    return static_cast<int>(::getpid());
+#endif
+}
+
+std::string spillFileName(const std::string& dir) {
+    static std::atomic<uint64_t> counter{0};
+    std::filesystem::path base = dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(dir);
+    std::filesystem::create_directories(base);
+    return (base / ("fastquant-equity-" + std::to_string(processId()) + "-" + std::to_string(counter++) + ".bin")).string();
+}
+
+} // namespace
+
+EquityPolicy parseEquityPolicy(const std::string& name) {
+    if (name == "all") return EquityPolicy::All;
+    if (name == "every_n") return EquityPolicy::EveryN;
+    if (name == "on_change") return EquityPolicy::OnChange;
+    if (name == "downsample") return EquityPolicy::Downsample;
+    if (name == "spill") return EquityPolicy::Spill;
+    throw std::runtime_error("Unknown equity recording policy: " + name);
+}
+
+std::string toString(EquityPolicy policy) {
+    switch (policy) {
+        case EquityPolicy::All: return "all";
+        case EquityPolicy::EveryN: return "every_n";
+        case EquityPolicy::OnChange: return "on_change";
+        case EquityPolicy::Downsample: return "downsample";
+        case EquityPolicy::Spill: return "spill";
+    }
+    return "all";
+}
+
+std::vector<size_t> lttbIndices(std::span<const double> x, std::span<const double> y, size_t threshold) {
+    const size_t n = std::min(x.size(), y.size());
+    std::vector<size_t> out;
+    if (n <= threshold || n < 3) {
+        out.resize(n);
+        std::iota(out.begin(), out.end(), size_t{0});
+        return out;
+    }
+    if (threshold < 3) {
+        return {0, n - 1};
+    }
+
+    // Interior points 1..n-2 fall into equal x-spans; start[b] is the first
+    // index of bucket b, start[buckets] the last point.
+    const size_t buckets = threshold - 2;
+    const double x0 = x.front();
+    const double span = x[n - 1] - x0;
+    std::vector<size_t> start(buckets + 1);
+    size_t i = 1;
+    for (size_t b = 0; b < buckets; ++b) {
+        start[b] = i;
+        const double hi = x0 + span * static_cast<double>(b + 1) / static_cast<double>(buckets);
+        while (i < n - 1 && (x[i] < hi || b + 1 == buckets)) {
+            ++i;
+        }
+    }
+    start[buckets] = n - 1;
+
+    out.reserve(threshold);
+    out.push_back(0);
+    size_t a = 0;
+    size_t next = 0; // first non-empty bucket after the current one
+    for (size_t b = 0; b < buckets; ++b) {
+        const size_t lo = start[b];
+        const size_t hi = start[b + 1];
+        if (lo == hi) {
+            continue;
+        }
+        next = std::max(next, b + 1);
+        while (next < buckets && start[next] == start[next + 1]) {
+            ++next;
+        }
+        double cx = x[n - 1];
+        double cy = y[n - 1];
+        if (next < buckets) {
+            cx = 0.0;
+            cy = 0.0;
+            for (size_t k = start[next]; k < start[next + 1]; ++k) {
+                cx += x[k];
+                cy += y[k];
+            }
+            const auto count = static_cast<double>(start[next + 1] - start[next]);
+            cx /= count;
+            cy /= count;
+        }
+        size_t best = lo;
+        double bestArea = -1.0;
+        for (size_t k = lo; k < hi; ++k) {
+            const double area = std::abs((x[a] - cx) * (y[k] - y[a]) - (x[a] - x[k]) * (cy - y[a]));
+            if (area > bestArea) {
+                bestArea = area;
+                best = k;
+            }
+        }
+        out.push_back(best);
+        a = best;
+    }
+    out.push_back(n - 1);
+    return out;
+}
+
+EquitySpill::EquitySpill(const std::string& dir) : path_(spillFileName(dir)) {
+#if defined(_WIN32)
+    file_ = std::fopen(path_.c_str(), "w+b");
+    if (!file_) {
+        throw std::runtime_error("Unable to create equity spill file: " + path_);
+    }
+#else
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd_ < 0) {
+        throw std::runtime_error("Unable to create equity spill file: " + path_);
+    }
+    grow();
+#endif
+}
+
+EquitySpill::~EquitySpill() {
+#if defined(_WIN32)
+    if (file_) {
+        std::fclose(file_);
+    }
+#else
+    if (map_) {
+        ::munmap(map_, capacity_ * sizeof(Record));
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+}
+
+void EquitySpill::grow() {
+#if !defined(_WIN32)
+    const size_t next = capacity_ ? capacity_ * 2 : kInitialSpillRecords;
+    if (map_) {
+        ::munmap(map_, capacity_ * sizeof(Record));
+        map_ = nullptr;
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(next * sizeof(Record))) != 0) {
+        throw std::runtime_error("Unable to grow equity spill file: " + path_);
+    }
+    void* p = ::mmap(nullptr, next * sizeof(Record), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        throw std::runtime_error("Unable to map equity spill file: " + path_);
+    }
+    map_ = static_cast<Record*>(p);
+    capacity_ = next;
+#endif
+}
+
+void EquitySpill::append(std::chrono::system_clock::time_point ts, double equity) {
+    if (sealed_) {
+        throw std::runtime_error("Equity spill is sealed: " + path_);
+    }
+    const Record rec{std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count(), equity};
+#if defined(_WIN32)
+    if (std::fwrite(&rec, sizeof(rec), 1, file_) != 1) {
+        throw std::runtime_error("Failed writing equity spill file: " + path_);
+    }
+#else
+    if (count_ == capacity_) {
+        grow();
+    }
+    map_[count_] = rec;
+#endif
+    ++count_;
+}
+
+void EquitySpill::seal() {
+    if (sealed_) {
+        return;
+    }
+    sealed_ = true;
+#if defined(_WIN32)
+    std::fflush(file_);
+#else
+    // Pages past the new end are never touched again, so the map can stay.
+    if (::ftruncate(fd_, static_cast<off_t>(count_ * sizeof(Record))) != 0) {
+        throw std::runtime_error("Unable to trim equity spill file: " + path_);
+    }
+#endif
+}
+
+void EquitySpill::forEach(const std::function<void(std::chrono::system_clock::time_point, double)>& fn) const {
+    auto emit = [&](const Record& r) {
+        fn(std::chrono::system_clock::time_point{
+               std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds{r.ns})},
+           r.equity);
+    };
+#if defined(_WIN32)
+    std::fflush(file_);
+    std::FILE* in = std::fopen(path_.c_str(), "rb");
+    if (!in) {
+        throw std::runtime_error("Unable to read equity spill file: " + path_);
+    }
+    Record r{};
+    for (size_t i = 0; i < count_ && std::fread(&r, sizeof(r), 1, in) == 1; ++i) {
+        emit(r);
+    }
+    std::fclose(in);
+#else
+    for (size_t i = 0; i < count_; ++i) {
+        emit(map_[i]);
+    }
+#endif
+}
+
+EquityRecorder::EquityRecorder(const EquityRecording& cfg) : cfg_(cfg) {
+    if (cfg_.every == 0) {
+        cfg_.every = 1;
+    }
+    if (cfg_.maxPoints < 3) {
+        cfg_.maxPoints = 3;
+    }
+    if (cfg_.policy == EquityPolicy::Spill) {
+        spill_ = std::make_shared<EquitySpill>(cfg_.spillDir);
+    }
+}
+
+void EquityRecorder::record(std::vector<std::chrono::system_clock::time_point>& timestamps,
+                            std::vector<double>& equity,
+                            std::chrono::system_clock::time_point ts,
+                            double value) {
+    const uint64_t index = seen_++;
+    bool keep = true;
+    switch (cfg_.policy) {
+        case EquityPolicy::All:
+            break;
+        case EquityPolicy::EveryN:
+            keep = index % cfg_.every == 0;
+            break;
+        case EquityPolicy::OnChange:
+            keep = equity.empty() || value != equity.back();
+            break;
+        case EquityPolicy::Downsample:
+            seq_.push_back(static_cast<double>(index));
+            break;
+        case EquityPolicy::Spill:
+            spill_->append(ts, value);
+            return;
+    }
+    if (!keep) {
+        hasTail_ = true;
+        tailTs_ = ts;
+        tail_ = value;
+        return;
+    }
+    hasTail_ = false;
+    timestamps.push_back(ts);
+    equity.push_back(value);
+    if (cfg_.policy == EquityPolicy::Downsample && equity.size() >= 2 * cfg_.maxPoints) {
+        compact(timestamps, equity);
+    }
+}
+
+void EquityRecorder::finish(std::vector<std::chrono::system_clock::time_point>& timestamps, std::vector<double>& equity) {
+    if (hasTail_) {
+        timestamps.push_back(tailTs_);
+        equity.push_back(tail_);
+        hasTail_ = false;
+    }
+    if (cfg_.policy == EquityPolicy::Downsample && equity.size() > cfg_.maxPoints) {
+        compact(timestamps, equity);
+    }
+    if (spill_) {
+        spill_->seal();
+    }
+}
+
+void EquityRecorder::compact(std::vector<std::chrono::system_clock::time_point>& timestamps, std::vector<double>& equity) {
+    const auto keep = lttbIndices(seq_, equity, cfg_.maxPoints);
+    for (size_t k = 0; k < keep.size(); ++k) {
+        timestamps[k] = timestamps[keep[k]];
+        equity[k] = equity[keep[k]];
+        seq_[k] = seq_[keep[k]];
+    }
+    timestamps.resize(keep.size());
+    equity.resize(keep.size());
+    seq_.resize(keep.size());
+}
+
+} // namespace fastquant
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fastquant {
+
+// How a run stores its equity curve. Every policy except All bounds the memory
+// a run's curve can take; the run's first and last points are always kept.
+enum class EquityPolicy {
+    All,        // one point per bar (the default)
+    EveryN,     // every `every`-th bar
+    OnChange,   // only bars whose equity differs from the last stored point
+    Downsample, // LTTB reservoir of at most `maxPoints` points
+    Spill       // every bar, written to a memory-mapped temp file instead of RAM
+};
+
+struct EquityRecording {
+    EquityPolicy policy = EquityPolicy::All;
+    size_t every = 1;          // EveryN
+    size_t maxPoints = 10000;  // Downsample; at least 3
+    std::string spillDir;      // Spill; empty = system temp directory
+};
+
+EquityPolicy parseEquityPolicy(const std::string& name);
+std::string toString(EquityPolicy policy);
+
+// Largest-Triangle-Three-Buckets: indices of at most `threshold` points that
+// keep the visual shape of (x, y). Buckets cover equal spans of x, so uneven
+// sampling does not skew where points are kept. First and last are kept.
+std::vector<size_t> lttbIndices(std::span<const double> x, std::span<const double> y, size_t threshold);
+
+// Disk-backed equity series. Appends go through a growing memory map (plain
+// file I/O on Windows); the file is removed when the last owner releases it.
+class EquitySpill {
+public:
+    explicit EquitySpill(const std::string& dir = std::string());
+    ~EquitySpill();
+    EquitySpill(const EquitySpill&) = delete;
+    EquitySpill& operator=(const EquitySpill&) = delete;
+
+    void append(std::chrono::system_clock::time_point ts, double equity);
+    // Trim the file to its contents. No appends are accepted afterwards.
+    void seal();
+
+    size_t size() const { return count_; }
+    const std::string& path() const { return path_; }
+    void forEach(const std::function<void(std::chrono::system_clock::time_point, double)>& fn) const;
+
+private:
+    struct Record {
+        int64_t ns;
+        double equity;
+    };
+    void grow();
+
+    std::string path_;
+    size_t count_{0};
+    size_t capacity_{0}; // records
+    bool sealed_{false};
+    int fd_{-1};             // POSIX: mapped file
+    Record* map_{nullptr};
+    std::FILE* file_{nullptr}; // Windows: buffered file
+};
+
+// Applies an EquityRecording to a run's equity vectors as points arrive. The
+// engine owns one per result for the duration of a run.
+class EquityRecorder {
+public:
+    explicit EquityRecorder(const EquityRecording& cfg);
+
+    void record(std::vector<std::chrono::system_clock::time_point>& timestamps,
+                std::vector<double>& equity,
+                std::chrono::system_clock::time_point ts,
+                double value);
+    // Flush the pending last point and apply final downsampling.
+    void finish(std::vector<std::chrono::system_clock::time_point>& timestamps, std::vector<double>& equity);
+
+    const std::shared_ptr<EquitySpill>& spill() const { return spill_; }
+
+private:
+    void compact(std::vector<std::chrono::system_clock::time_point>& timestamps, std::vector<double>& equity);
+
+    EquityRecording cfg_;
+    uint64_t seen_{0};
+    bool hasTail_{false};
+    std::chrono::system_clock::time_point tailTs_{};
+    double tail_{0.0};
+    std::vector<double> seq_; // Downsample: bar index of every stored point (LTTB x)
+    std::shared_ptr<EquitySpill> spill_;
+};
+
+} // namespace fastquant
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace fastquant {
+
+// Shared between a running backtest and whoever supervises it (e.g. a job
+// queue). The engine checks cancelRequested() once per candle and stops
+// through the same early-exit path as the candle limit; it publishes its
+// candle count every kPublishEvery candles and when the run ends. All
+// accesses are relaxed atomics, so polling from another thread is cheap and
+// never blocks the run.
+class RunControl {
+public:
+    static constexpr size_t kPublishEvery = 1024;
+
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    bool cancelRequested() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    void publish(size_t candlesProcessed) { processed_.store(candlesProcessed, std::memory_order_relaxed); }
+    size_t candlesProcessed() const { return processed_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled_{false};
+    std::atomic<size_t> processed_{0};
+};
+
+} // namespace fastquant
@@ -0,0 +1,100 @@
+#include "RunMetrics.h"
+
+#include <cmath>
+
+namespace fastquant {
+
+namespace {
+constexpr double EPS = 1e-9;
+}
+
+void RunMetrics::onEquity(double equity, bool exposed) {
+    if (points_ == 0) {
+        peak_ = equity;
+        trough_ = equity;
+    } else if (last_ > 0.0) {
+        // Welford update of the simple-return mean and squared deviations.
+        const double ret = equity / last_ - 1.0;
+        ++returns_;
+        const double delta = ret - meanReturn_;
+        meanReturn_ += delta / static_cast<double>(returns_);
+        m2_ += delta * (ret - meanReturn_);
+    }
+    if (equity > peak_) {
+        peak_ = equity;
+        trough_ = equity;
+    }
+    if (equity < trough_) {
+        trough_ = equity;
+        if (peak_ - trough_ > maxDrawdown_) {
+            maxDrawdown_ = peak_ - trough_;
+        }
+    }
+    ++points_;
+    if (exposed) {
+        ++exposedPoints_;
+    }
+    last_ = equity;
+}
+
+void RunMetrics::onFill(double realizedPnl) {
+    ++fills_;
+    const double delta = realizedPnl - realized_;
+    if (delta > EPS) {
+        ++wins_;
+    } else if (delta < -EPS) {
+        ++losses_;
+    }
+    realized_ = realizedPnl;
+}
+
+double RunMetrics::exposure() const {
+    return points_ ? static_cast<double>(exposedPoints_) / static_cast<double>(points_) : 0.0;
+}
+
+double RunMetrics::returnVariance() const {
+    return returns_ > 1 ? m2_ / static_cast<double>(returns_ - 1) : 0.0;
+}
+
+double RunMetrics::returnStdDev() const {
+    return std::sqrt(returnVariance());
+}
+
+double RunMetrics::sharpe() const {
+    const double sd = returnStdDev();
+    return sd > 0.0 ? meanReturn_ / sd : 0.0;
+}
+
+void RunMetrics::save(ByteWriter& w) const {
+    w.put<uint64_t>(points_);
+    w.put<uint64_t>(exposedPoints_);
+    w.put(last_);
+    w.put(peak_);
+    w.put(trough_);
+    w.put(maxDrawdown_);
+    w.put<uint64_t>(returns_);
+    w.put(meanReturn_);
+    w.put(m2_);
+    w.put<uint64_t>(fills_);
+    w.put<uint64_t>(wins_);
+    w.put<uint64_t>(losses_);
+    w.put(realized_);
+}
+
+void RunMetrics::load(ByteReader& r) {
+    points_ = r.get<uint64_t>();
+    exposedPoints_ = r.get<uint64_t>();
+    last_ = r.get<double>();
+    peak_ = r.get<double>();
+    trough_ = r.get<double>();
+    maxDrawdown_ = r.get<double>();
+    returns_ = r.get<uint64_t>();
+    meanReturn_ = r.get<double>();
+    m2_ = r.get<double>();
+    fills_ = r.get<uint64_t>();
+    wins_ = r.get<uint64_t>();
+    losses_ = r.get<uint64_t>();
+    realized_ = r.get<double>();
+}
+
+} // namespace fastquant
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../Model/ByteStream.h"
+#include <cstddef>
+
+namespace fastquant {
+
+// Online run statistics in O(1) memory. The engine feeds every equity point
+// and fill; summary-only runs keep nothing else, and Reporter::summarize reads
+// drawdown, peak/trough and win/loss counts from here instead of walking the
+// curve and replaying trades. Definitions match Reporter's: the peak starts at
+// the first equity point, and a fill wins or loses by the change it makes to
+// realized PnL.
+class RunMetrics {
+public:
+    // `exposed`: a position was open after this point's fills.
+    void onEquity(double equity, bool exposed);
+    void onFill(double realizedPnl);
+
+    size_t points() const { return points_; }
+    size_t fills() const { return fills_; }
+    size_t winningFills() const { return wins_; }
+    size_t losingFills() const { return losses_; }
+    double lastEquity() const { return last_; }
+    double peakEquity() const { return peak_; }
+    double troughEquity() const { return trough_; }
+    double maxDrawdown() const { return maxDrawdown_; }
+
+    double exposure() const;          // fraction of points with an open position
+    double meanReturn() const { return meanReturn_; }
+    double returnVariance() const;    // sample variance of point-to-point returns
+    double returnStdDev() const;
+    double sharpe() const;            // mean / stddev per point, not annualized
+
+    void save(ByteWriter& w) const;
+    void load(ByteReader& r);
+
+private:
+    size_t points_{0};
+    size_t exposedPoints_{0};
+    double last_{0.0};
+    double peak_{0.0};
+    double trough_{0.0};
+    double maxDrawdown_{0.0};
+
+    size_t returns_{0};
+    double meanReturn_{0.0};
+    double m2_{0.0};
+
+    size_t fills_{0};
+    size_t wins_{0};
+    size_t losses_{0};
+    double realized_{0.0};
+};
+
+} // namespace fastquant
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../Model/Trade.h"
+#include <chrono>
+#include <cstddef>
+#include <span>
+
+namespace fastquant {
+
+// Live view of a single-strategy run (run, resume, runCrossSectional), called
+// on the run's thread every RunControl::kPublishEvery candles and once when it
+// ends. Each call carries only what was produced since the previous one. The
+// engine tests one pointer on that same cadence, so runs without an observer
+// pay nothing extra. Equity arrives incrementally under the "all" policy; a
+// downsampled curve arrives whole with the last call and a spilled one not at
+// all. Trades arrive unless the run is summary-only. Broadcast and lane runs
+// report progress alone (a final call per strategy), and runParallel workers
+// do not inherit the observer.
+class RunObserver {
+public:
+    virtual ~RunObserver() = default;
+
+    virtual void onEquity(std::span<const std::chrono::system_clock::time_point> timestamps,
+                          std::span<const double> equity) {
+        (void)timestamps;
+        (void)equity;
+    }
+    virtual void onTrades(std::span<const Trade> trades) { (void)trades; }
+    // After the slices above; `finished` on the last call of the run.
+    virtual void onProgress(size_t candlesProcessed, bool finished) {
+        (void)candlesProcessed;
+        (void)finished;
+    }
+};
+
+} // namespace fastquant
@@ -0,0 +1,144 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace fastquant {
+
+ThreadPool::ThreadPool(size_t threads, size_t maxQueued)
+    : maxQueued_(maxQueued) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t ThreadPool::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+bool ThreadPool::trySubmit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (maxQueued_ > 0 && queue_.size() >= maxQueued_) {
+            return false;
+        }
+        queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_ && queue_.empty()) {
+                return;
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || workers_.size() <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    // Shared with helper tasks that may only get scheduled after the caller has
+    // already drained the range; those late helpers touch nothing but this state.
+    struct LoopState {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> inFlight{0};
+        size_t count{0};
+        const std::function<void(size_t)>* fn{nullptr};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<LoopState>();
+    state->count = count;
+    state->fn = &fn;
+
+    auto drain = [](LoopState& s) {
+        for (;;) {
+            size_t i = s.next.fetch_add(1);
+            if (i >= s.count) {
+                return;
+            }
+            try {
+                (*s.fn)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (!s.error) {
+                    s.error = std::current_exception();
+                }
+                s.next.store(s.count);
+            }
+        }
+    };
+
+    size_t helpers = std::min(workers_.size(), count - 1);
+    for (size_t h = 0; h < helpers; ++h) {
+        enqueue([state, drain]() {
+            state->inFlight.fetch_add(1);
+            drain(*state);
+            if (state->inFlight.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done.notify_all();
+            }
+        });
+    }
+
+    drain(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&]() { return state->inFlight.load() == 0; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace fastquant
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace fastquant {
+
+// ThreadPool: fixed set of worker threads fed from a FIFO queue.
+// Used for fan-out work (parameter sweeps, report writing) so that
+// thousands of small jobs don't each pay for a std::async thread.
+class ThreadPool {
+public:
+    // threads == 0 picks std::thread::hardware_concurrency().
+    // maxQueued == 0 means trySubmit never rejects work.
+    explicit ThreadPool(size_t threads = 0, size_t maxQueued = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+    size_t queued() const;
+
+    // Enqueue a callable and get a future for its result.
+    template<typename F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        auto fut = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return fut;
+    }
+
+    // Enqueue unless the bounded queue is full. Returns false on rejection.
+    bool trySubmit(std::function<void()> task);
+
+    // Invoke fn(i) for every i in [0, count). The calling thread takes part in the
+    // loop, so nested parallelFor calls from inside pool tasks cannot deadlock.
+    // The first exception thrown by fn is rethrown on the calling thread.
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    // Process-wide pool sized to the hardware.
+    static ThreadPool& shared();
+
+private:
+    void enqueue(std::function<void()> task);
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    size_t maxQueued_;
+    bool stopping_{false};
+};
+
+} // namespace fastquant
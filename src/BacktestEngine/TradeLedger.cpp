@@ -0,0 +1,237 @@
+#include "TradeLedger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace fastquant {
+
+namespace {
+constexpr double EPS = 1e-9; // Portfolio's zero-position threshold
+}
+
+double LedgerStats::winRate() const {
+    return wins + losses ? static_cast<double>(wins) / static_cast<double>(wins + losses) : 0.0;
+}
+
+double LedgerStats::profitFactor() const {
+    return grossLoss > EPS ? grossProfit / grossLoss : 0.0;
+}
+
+double LedgerStats::averageHoldingSeconds() const {
+    return roundTrips ? holdingSeconds / static_cast<double>(roundTrips) : 0.0;
+}
+
+uint32_t TradeLedger::symbolId(const std::string& symbol) {
+    if (!symbols_.empty() && symbols_[lastSymbol_] == symbol) {
+        return lastSymbol_;
+    }
+    auto [it, inserted] = symbolIndex_.try_emplace(symbol, static_cast<uint32_t>(symbols_.size()));
+    if (inserted) {
+        symbols_.push_back(symbol);
+        lots_.emplace_back();
+    }
+    lastSymbol_ = it->second;
+    return lastSymbol_;
+}
+
+void TradeLedger::onFill(const Trade& trade) {
+    if (trade.qty < EPS) {
+        return;
+    }
+    const uint32_t id = symbolId(trade.symbol);
+    auto& queue = lots_[id];
+    const double feePerUnit = trade.fee / trade.qty;
+    double remaining = trade.qty;
+
+    while (remaining >= EPS && !queue.empty() && queue.front().side != trade.side) {
+        Lot& lot = queue.front();
+        const double matched = std::min(lot.qty, remaining);
+        close(id, lot, matched, trade, feePerUnit);
+        remaining -= matched;
+        lot.qty -= matched;
+        if (lot.qty < EPS) {
+            queue.pop_front();
+            --openLots_;
+        }
+    }
+
+    if (remaining >= EPS) {
+        Lot lot;
+        lot.openTime = trade.timestamp;
+        lot.qty = remaining;
+        lot.price = trade.price;
+        lot.feePerUnit = feePerUnit;
+        lot.low = trade.price;
+        lot.high = trade.price;
+        lot.side = trade.side;
+        queue.push_back(lot);
+        ++openLots_;
+    }
+}
+
+void TradeLedger::close(uint32_t symbol, Lot& lot, double qty, const Trade& exit, double exitFeePerUnit) {
+    const double direction = lot.side == Side::Buy ? 1.0 : -1.0;
+    const double low = std::min(lot.low, exit.price);
+    const double high = std::max(lot.high, exit.price);
+
+    RoundTrip rt;
+    rt.entryTime = lot.openTime;
+    rt.exitTime = exit.timestamp;
+    rt.qty = qty;
+    rt.entryPrice = lot.price;
+    rt.exitPrice = exit.price;
+    rt.fees = (lot.feePerUnit + exitFeePerUnit) * qty;
+    rt.pnl = direction * (exit.price - lot.price) * qty - rt.fees;
+    const double worst = direction > 0.0 ? low : high;
+    const double best = direction > 0.0 ? high : low;
+    rt.mae = std::min(0.0, direction * (worst - lot.price) * qty);
+    rt.mfe = std::max(0.0, direction * (best - lot.price) * qty);
+    rt.symbol = symbol;
+    rt.side = lot.side;
+
+    ++stats_.roundTrips;
+    if (rt.pnl > EPS) {
+        ++stats_.wins;
+        stats_.grossProfit += rt.pnl;
+    } else if (rt.pnl < -EPS) {
+        ++stats_.losses;
+        stats_.grossLoss -= rt.pnl;
+    }
+    stats_.holdingSeconds += rt.holdingSeconds();
+    if (retain_) {
+        roundTrips_.push_back(rt);
+    }
+}
+
+std::vector<double> TradeLedger::fillPnl(const std::vector<Trade>& trades) const {
+    std::vector<double> pnl(trades.size(), 0.0);
+    // Round trips are appended in fill order, so one forward pass pairs each
+    // closing fill with the run of round trips it produced.
+    size_t next = 0;
+    for (size_t i = 0; i < trades.size() && next < roundTrips_.size(); ++i) {
+        const Trade& t = trades[i];
+        double closed = 0.0;
+        while (next < roundTrips_.size()) {
+            const RoundTrip& rt = roundTrips_[next];
+            if (rt.exitTime != t.timestamp || rt.exitPrice != t.price || rt.side == t.side ||
+                symbols_[rt.symbol] != t.symbol || closed + rt.qty > t.qty + EPS) {
+                break;
+            }
+            closed += rt.qty;
+            pnl[i] += rt.pnl;
+            ++next;
+        }
+    }
+    return pnl;
+}
+
+void TradeLedger::onCandle(const std::string& symbol, double high, double low) {
+    if (openLots_ == 0) {
+        return;
+    }
+    uint32_t id = lastSymbol_;
+    if (symbols_[id] != symbol) {
+        auto it = symbolIndex_.find(symbol);
+        if (it == symbolIndex_.end()) {
+            return;
+        }
+        id = it->second;
+    }
+    for (auto& lot : lots_[id]) {
+        lot.low = std::min(lot.low, low);
+        lot.high = std::max(lot.high, high);
+    }
+}
+
+void TradeLedger::save(ByteWriter& w) const {
+    w.put<uint64_t>(symbols_.size());
+    for (size_t id = 0; id < symbols_.size(); ++id) {
+        w.putString(symbols_[id]);
+        w.put<uint64_t>(lots_[id].size());
+        for (const auto& lot : lots_[id]) {
+            w.putTime(lot.openTime);
+            w.put(lot.qty);
+            w.put(lot.price);
+            w.put(lot.feePerUnit);
+            w.put(lot.low);
+            w.put(lot.high);
+            w.put<uint8_t>(static_cast<uint8_t>(lot.side));
+        }
+    }
+    w.put<uint64_t>(roundTrips_.size());
+    for (const auto& rt : roundTrips_) {
+        w.putTime(rt.entryTime);
+        w.putTime(rt.exitTime);
+        w.put(rt.qty);
+        w.put(rt.entryPrice);
+        w.put(rt.exitPrice);
+        w.put(rt.pnl);
+        w.put(rt.fees);
+        w.put(rt.mae);
+        w.put(rt.mfe);
+        w.put(rt.symbol);
+        w.put<uint8_t>(static_cast<uint8_t>(rt.side));
+    }
+    w.put<uint64_t>(stats_.roundTrips);
+    w.put<uint64_t>(stats_.wins);
+    w.put<uint64_t>(stats_.losses);
+    w.put(stats_.grossProfit);
+    w.put(stats_.grossLoss);
+    w.put(stats_.holdingSeconds);
+}
+
+void TradeLedger::load(ByteReader& r) {
+    symbols_.clear();
+    symbolIndex_.clear();
+    lots_.clear();
+    openLots_ = 0;
+    lastSymbol_ = 0;
+    const auto symbolCount = r.get<uint64_t>();
+    for (uint64_t id = 0; id < symbolCount; ++id) {
+        symbols_.push_back(r.getString());
+        symbolIndex_.emplace(symbols_.back(), static_cast<uint32_t>(id));
+        auto& queue = lots_.emplace_back();
+        const auto lotCount = r.get<uint64_t>();
+        for (uint64_t i = 0; i < lotCount; ++i) {
+            Lot lot;
+            lot.openTime = r.getTime();
+            lot.qty = r.get<double>();
+            lot.price = r.get<double>();
+            lot.feePerUnit = r.get<double>();
+            lot.low = r.get<double>();
+            lot.high = r.get<double>();
+            lot.side = static_cast<Side>(r.get<uint8_t>());
+            queue.push_back(lot);
+        }
+        openLots_ += queue.size();
+    }
+    roundTrips_.clear();
+    const auto tripCount = r.get<uint64_t>();
+    for (uint64_t i = 0; i < tripCount; ++i) {
+        RoundTrip rt;
+        rt.entryTime = r.getTime();
+        rt.exitTime = r.getTime();
+        rt.qty = r.get<double>();
+        rt.entryPrice = r.get<double>();
+        rt.exitPrice = r.get<double>();
+        rt.pnl = r.get<double>();
+        rt.fees = r.get<double>();
+        rt.mae = r.get<double>();
+        rt.mfe = r.get<double>();
+        rt.symbol = r.get<uint32_t>();
+        if (rt.symbol >= symbolCount) {
+            throw std::runtime_error("Corrupt ledger");
+        }
+        rt.side = static_cast<Side>(r.get<uint8_t>());
+        roundTrips_.push_back(rt);
+    }
+    stats_.roundTrips = r.get<uint64_t>();
+    stats_.wins = r.get<uint64_t>();
+    stats_.losses = r.get<uint64_t>();
+    stats_.grossProfit = r.get<double>();
+    stats_.grossLoss = r.get<double>();
+    stats_.holdingSeconds = r.get<double>();
+}
+
+} // namespace fastquant
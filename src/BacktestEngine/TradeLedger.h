@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../Model/ByteStream.h"
+#include "../Model/Trade.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fastquant {
+
+// One matched entry/exit pair. A fill that closes several open lots produces
+// one RoundTrip per lot, and a partial close splits the lot.
+struct RoundTrip {
+    std::chrono::system_clock::time_point entryTime;
+    std::chrono::system_clock::time_point exitTime;
+    double qty{0.0};        // unsigned
+    double entryPrice{0.0};
+    double exitPrice{0.0};
+    double pnl{0.0};        // net of both legs' fees
+    double fees{0.0};       // entry and exit fees attributed to this qty
+    double mae{0.0};        // worst open PnL while held, before fees (<= 0)
+    double mfe{0.0};        // best open PnL while held, before fees (>= 0)
+    uint32_t symbol{0};     // index into TradeLedger::symbols()
+    Side side{Side::Buy};   // entry side: Buy = long, Sell = short
+
+    double holdingSeconds() const {
+        return std::chrono::duration<double>(exitTime - entryTime).count();
+    }
+};
+
+// Running totals over every closed round trip; kept even when the individual
+// round trips are not.
+struct LedgerStats {
+    size_t roundTrips{0};
+    size_t wins{0};
+    size_t losses{0};
+    double grossProfit{0.0};    // sum of winning net PnL
+    double grossLoss{0.0};      // sum of losing net PnL, as a positive value
+    double holdingSeconds{0.0}; // summed over round trips
+
+    double winRate() const;
+    double profitFactor() const; // grossProfit / grossLoss, 0 when nothing was lost
+    double averageHoldingSeconds() const;
+};
+
+// Round-trip ledger maintained by the engine as fills happen: entry legs are
+// queued per symbol and matched FIFO by opposite fills, so per-trade PnL,
+// holding time and excursions never need a replay of the trade list. Fees are
+// attributed per unit of each leg. Excursions cover the fill prices and the
+// high/low of every candle passed to onCandle while the lot is open.
+class TradeLedger {
+public:
+    // Summary-only runs keep stats and open lots but drop closed round trips.
+    void setRetainRoundTrips(bool retain) { retain_ = retain; }
+    bool retainsRoundTrips() const { return retain_; }
+
+    void onFill(const Trade& trade);
+    // Widen the excursion range of the symbol's open lots; a no-op when flat.
+    void onCandle(const std::string& symbol, double high, double low);
+    bool hasOpenLots() const { return openLots_ != 0; }
+
+    const std::vector<RoundTrip>& roundTrips() const { return roundTrips_; }
+    const LedgerStats& stats() const { return stats_; }
+    const std::vector<std::string>& symbols() const { return symbols_; }
+    const std::string& symbolName(const RoundTrip& rt) const { return symbols_[rt.symbol]; }
+    // Realized PnL per fill of `trades` (the run's fills, in order): the net
+    // PnL of the round trips each fill closed, 0 for fills that only open.
+    // All zeros when round trips are not retained.
+    std::vector<double> fillPnl(const std::vector<Trade>& trades) const;
+
+    void save(ByteWriter& w) const;
+    // Throws std::runtime_error on truncated data or unknown symbol ids.
+    void load(ByteReader& r);
+
+private:
+    struct Lot {
+        std::chrono::system_clock::time_point openTime;
+        double qty{0.0};       // remaining, unsigned
+        double price{0.0};
+        double feePerUnit{0.0};
+        double low{0.0};       // price range seen while open
+        double high{0.0};
+        Side side{Side::Buy};
+    };
+
+    uint32_t symbolId(const std::string& symbol);
+    void close(uint32_t symbol, Lot& lot, double qty, const Trade& exit, double exitFeePerUnit);
+
+    bool retain_{true};
+    std::vector<std::string> symbols_;
+    std::unordered_map<std::string, uint32_t> symbolIndex_;
+    std::vector<std::deque<Lot>> lots_; // per symbol id, oldest first
+    size_t openLots_{0};
+    uint32_t lastSymbol_{0};
+    std::vector<RoundTrip> roundTrips_;
+    LedgerStats stats_;
+};
+
+} // namespace fastquant
@@ -0,0 +1,194 @@
+#include "VectorizedBacktest.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace fastquant {
+
+namespace {
+
+constexpr double EPS = 1e-9; // Portfolio's flat-position threshold
+
+// Market-order reference price per bar: open, else close, else high.
+void marketPrices(const CandleFrame& f, std::vector<double>& out) {
+    const size_t n = f.size();
+    out.resize(n);
+    for (size_t t = 0; t < n; ++t) {
+        const double close = f.close[t] > 0.0 ? f.close[t] : f.high[t];
+        out[t] = f.open[t] > 0.0 ? f.open[t] : close;
+    }
+}
+
+// Position held after each bar and the signed quantity traded to get there.
+void positions(std::span<const double> targets, const std::vector<double>& raw,
+               std::vector<double>& held, std::vector<double>& qty) {
+    const size_t n = raw.size();
+    held.resize(n);
+    qty.resize(n);
+    double pos = 0.0;
+    for (size_t t = 0; t < n; ++t) {
+        const double q = t ? targets[t - 1] - pos : 0.0;
+        if (std::abs(q) >= EPS && raw[t] > 0.0) {
+            qty[t] = q;
+            pos += q;
+            if (std::abs(pos) < EPS) {
+                pos = 0.0;
+            }
+        } else {
+            qty[t] = 0.0;
+        }
+        held[t] = pos;
+    }
+}
+
+// Fill price, fee and slippage value of every bar's order, with the engine's
+// arithmetic. Bars without a fill get zeros.
+void fills(const std::vector<double>& qty, const std::vector<double>& raw, const ExecutionConfig& exec,
+           std::vector<double>& price, std::vector<double>& fee, std::vector<double>& slip) {
+    const size_t n = qty.size();
+    price.resize(n);
+    fee.resize(n);
+    slip.resize(n);
+    const double slipPct = exec.defaultSlippageBps / 10000.0;
+    const double bps = exec.commissionBps / 10000.0;
+    for (size_t t = 0; t < n; ++t) {
+        const double q = qty[t];
+        if (q == 0.0) {
+            price[t] = 0.0;
+            fee[t] = 0.0;
+            slip[t] = 0.0;
+            continue;
+        }
+        const double a = std::abs(q);
+        double p = raw[t];
+        double s = 0.0;
+        if (slipPct > 0.0) {
+            p *= q > 0.0 ? (1.0 + slipPct) : (1.0 - slipPct);
+            s = (q > 0.0 ? p - raw[t] : raw[t] - p) * a;
+        }
+        price[t] = p;
+        fee[t] = exec.commissionPerShare * a + bps * (p * a);
+        slip[t] = s;
+    }
+}
+
+// Cash after each bar: Portfolio::applyTrade's two subtractions, as a prefix scan.
+void cashColumn(double initial, const std::vector<double>& qty, const std::vector<double>& price,
+                const std::vector<double>& fee, std::vector<double>& cash) {
+    const size_t n = qty.size();
+    cash.resize(n);
+    double c = initial;
+    for (size_t t = 0; t < n; ++t) {
+        if (qty[t] != 0.0) {
+            c -= qty[t] * price[t];
+            c -= fee[t];
+        }
+        cash[t] = c;
+    }
+}
+
+// Mark per bar: the fill price on fill bars, else the latest positive close.
+void marks(const CandleFrame& f, const std::vector<double>& qty, const std::vector<double>& price,
+           std::vector<double>& mark) {
+    const size_t n = qty.size();
+    mark.resize(n);
+    double m = 0.0;
+    for (size_t t = 0; t < n; ++t) {
+        if (f.close[t] > 0.0) {
+            m = f.close[t];
+        }
+        if (qty[t] != 0.0) {
+            m = price[t];
+        }
+        mark[t] = m;
+    }
+}
+
+void equityColumn(const std::vector<double>& cash, const std::vector<double>& held,
+                  const std::vector<double>& mark, std::vector<double>& equity) {
+    const size_t n = cash.size();
+    equity.resize(n);
+    for (size_t t = 0; t < n; ++t) {
+        // Portfolio::positionValue() accumulates from 0.0; keep that addition.
+        const double value = std::abs(held[t]) < EPS ? 0.0 : 0.0 + held[t] * mark[t];
+        equity[t] = cash[t] + value;
+    }
+}
+
+// Running-peak drawdown, seeded with the first equity point like Reporter.
+double drawdownColumn(const std::vector<double>& equity, std::vector<double>& dd) {
+    const size_t n = equity.size();
+    dd.resize(n);
+    double peak = n ? equity.front() : 0.0;
+    double maxDd = 0.0;
+    for (size_t t = 0; t < n; ++t) {
+        if (equity[t] > peak) {
+            peak = equity[t];
+        }
+        dd[t] = peak - equity[t];
+        if (dd[t] > maxDd) {
+            maxDd = dd[t];
+        }
+    }
+    return maxDd;
+}
+
+} // namespace
+
+VectorizedBacktester::VectorizedBacktester(const CandleFrame& frame, ExecutionConfig exec)
+    : frame_(frame), exec_(exec) {
+    marketPrices(frame_, raw_);
+}
+
+const VectorizedResult& VectorizedBacktester::run(std::span<const double> targets, double initialCapital) {
+    if (targets.size() != frame_.size()) {
+        throw std::runtime_error("Vectorized backtest needs one target per bar (" + std::to_string(targets.size())
+                                 + " targets for " + std::to_string(frame_.size()) + " bars)");
+    }
+
+    VectorizedResult& r = result_;
+    r.initialCapital = initialCapital;
+    r.fills = 0;
+    r.totalFees = 0.0;
+    r.totalSlippage = 0.0;
+
+    positions(targets, raw_, r.position, r.fillQty);
+    fills(r.fillQty, raw_, exec_, r.fillPrice, fee_, slip_);
+    cashColumn(initialCapital, r.fillQty, r.fillPrice, fee_, r.cash);
+    marks(frame_, r.fillQty, r.fillPrice, mark_);
+    equityColumn(r.cash, r.position, mark_, r.equity);
+    r.maxDrawdown = drawdownColumn(r.equity, r.drawdown);
+
+    // Totals accumulate in fill order, as the engine's per-trade sums do.
+    for (size_t t = 0; t < r.fillQty.size(); ++t) {
+        if (r.fillQty[t] != 0.0) {
+            ++r.fills;
+            r.totalFees += fee_[t];
+            r.totalSlippage += slip_[t];
+        }
+    }
+    r.finalEquity = r.equity.empty() ? initialCapital : r.equity.back();
+    return r;
+}
+
+VectorizedResult runVectorized(const CandleFrame& frame,
+                               std::span<const double> targets,
+                               const ExecutionConfig& exec,
+                               double initialCapital) {
+    VectorizedBacktester backtester(frame, exec);
+    backtester.run(targets, initialCapital);
+    return backtester.release();
+}
+
+std::vector<double> positionsFromSignals(std::span<const double> signals, double qtyPerSignal) {
+    std::vector<double> out(signals.size());
+    double pos = 0.0;
+    for (size_t t = 0; t < signals.size(); ++t) {
+        pos += signals[t] * qtyPerSignal;
+        out[t] = pos;
+    }
+    return out;
+}
+
+} // namespace fastquant
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "BacktestEngine.h"
+#include "../DataLoader/CandleFrame.h"
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace fastquant {
+
+// Outcome of a vectorized run. Every column has one entry per bar.
+struct VectorizedResult {
+    double initialCapital{0.0};
+    double finalEquity{0.0};
+    double maxDrawdown{0.0}; // absolute, positive (same convention as ReportSummary)
+    double totalFees{0.0};
+    double totalSlippage{0.0};
+    size_t fills{0};
+
+    std::vector<double> position;  // held after the bar's fill
+    std::vector<double> fillQty;   // signed quantity traded at the bar's open, 0 if none
+    std::vector<double> fillPrice; // execution price incl. slippage, 0 if no fill
+    std::vector<double> cash;
+    std::vector<double> equity;
+    std::vector<double> drawdown;  // running peak minus equity
+};
+
+// Screening backtest over columns. targets[t] is the signed position wanted
+// after bar t closes; it is reached with one market order at bar t + 1's open
+// (falling back to close, then high, like the engine). Slippage and fees come
+// from `exec`, and positions are marked the way Portfolio does it: at the fill
+// price on fill bars, otherwise at the latest positive close. The run matches
+// BacktestEngine bar for bar when a strategy submits those same market orders
+// on the next candle. A bar with no positive price postpones the rebalance.
+// Throws std::runtime_error if targets and frame differ in length.
+VectorizedResult runVectorized(const CandleFrame& frame,
+                               std::span<const double> targets,
+                               const ExecutionConfig& exec,
+                               double initialCapital = 100000.0);
+
+// Reusable form of runVectorized for screening many candidates over one
+// frame: the market-price column is built once and every buffer is reused,
+// so after the first run() nothing is allocated. The frame must outlive it.
+// Parameter sweeps use it through the "vectorized" sweep kernel.
+class VectorizedBacktester {
+public:
+    VectorizedBacktester(const CandleFrame& frame, ExecutionConfig exec);
+
+    // The returned result is overwritten by the next run().
+    const VectorizedResult& run(std::span<const double> targets, double initialCapital = 100000.0);
+    VectorizedResult release() { return std::move(result_); }
+
+private:
+    const CandleFrame& frame_;
+    ExecutionConfig exec_;
+    std::vector<double> raw_; // market-order reference price per bar
+    std::vector<double> fee_;
+    std::vector<double> slip_;
+    std::vector<double> mark_;
+    VectorizedResult result_;
+};
+
+// Turns an order-signal column (+n buys n units, -n sells n, 0 holds) into the
+// position targets runVectorized expects.
+std::vector<double> positionsFromSignals(std::span<const double> signals, double qtyPerSignal = 1.0);
+
+} // namespace fastquant
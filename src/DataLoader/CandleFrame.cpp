@@ -0,0 +1,33 @@
+#include "CandleFrame.h"
+
+#include <stdexcept>
+
+namespace fastquant {
+
+CandleFrame CandleFrame::fromCandles(std::span<const Candle> candles) {
+    CandleFrame frame;
+    if (!candles.empty()) {
+        frame.symbol = candles.front().symbol;
+    }
+    const size_t n = candles.size();
+    frame.timestamps.reserve(n);
+    frame.open.reserve(n);
+    frame.high.reserve(n);
+    frame.low.reserve(n);
+    frame.close.reserve(n);
+    frame.volume.reserve(n);
+    for (const auto& c : candles) {
+        if (c.symbol != frame.symbol) {
+            throw std::runtime_error("CandleFrame holds a single symbol, got '" + frame.symbol + "' and '" + c.symbol + "'");
+        }
+        frame.timestamps.push_back(c.timestamp);
+        frame.open.push_back(c.open);
+        frame.high.push_back(c.high);
+        frame.low.push_back(c.low);
+        frame.close.push_back(c.close);
+        frame.volume.push_back(c.volume);
+    }
+    return frame;
+}
+
+} // namespace fastquant
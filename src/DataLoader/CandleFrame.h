@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Candle.h"
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fastquant {
+
+// Column-oriented copy of one symbol's candle series, for kernels that sweep
+// a whole field at a time instead of walking Candle structs.
+struct CandleFrame {
+    std::string symbol;
+    std::vector<std::chrono::system_clock::time_point> timestamps;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;
+
+    size_t size() const { return close.size(); }
+    bool empty() const { return close.empty(); }
+
+    // Throws std::runtime_error if the candles span more than one symbol.
+    static CandleFrame fromCandles(std::span<const Candle> candles);
+};
+
+} // namespace fastquant
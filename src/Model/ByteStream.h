@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace fastquant {
+
+// Minimal little-endian-host binary encoding used by engine snapshots and
+// strategy state blobs. Not a portable interchange format: snapshots are meant
+// to be resumed on the same build that wrote them.
+class ByteWriter {
+public:
+    template<typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "ByteWriter::put needs a trivially copyable type");
+        buf_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(std::string_view s) {
+        put<uint64_t>(s.size());
+        buf_.append(s.data(), s.size());
+    }
+
+    void putTime(std::chrono::system_clock::time_point tp) {
+        put<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count());
+    }
+
+    template<typename Container>
+    void putDoubles(const Container& values) {
+        put<uint64_t>(values.size());
+        for (double v : values) {
+            put(v);
+        }
+    }
+
+    const std::string& data() const { return buf_; }
+    std::string release() { return std::move(buf_); }
+
+private:
+    std::string buf_;
+};
+
+class ByteReader {
+public:
+    explicit ByteReader(std::string_view data) : data_(data) {}
+
+    template<typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable_v<T>, "ByteReader::get needs a trivially copyable type");
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    std::string getString() {
+        const auto size = get<uint64_t>();
+        require(size);
+        std::string s(data_.substr(pos_, size));
+        pos_ += size;
+        return s;
+    }
+
+    std::chrono::system_clock::time_point getTime() {
+        const auto ns = std::chrono::nanoseconds(get<int64_t>());
+        return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(ns));
+    }
+
+    template<typename Container>
+    Container getDoubles() {
+        const auto size = get<uint64_t>();
+        // Compared by count so that a corrupt size cannot wrap the byte total.
+        if (size > (data_.size() - pos_) / sizeof(double)) {
+            throw std::runtime_error("Truncated binary data");
+        }
+        Container values;
+        if constexpr (requires { values.reserve(size); }) {
+            values.reserve(size);
+        }
+        for (uint64_t i = 0; i < size; ++i) {
+            values.push_back(get<double>());
+        }
+        return values;
+    }
+
+    bool atEnd() const { return pos_ == data_.size(); }
+
+private:
+    void require(uint64_t bytes) const {
+        if (bytes > data_.size() - pos_) {
+            throw std::runtime_error("Truncated binary data");
+        }
+    }
+
+    std::string_view data_;
+    size_t pos_{0};
+};
+
+} // namespace fastquant
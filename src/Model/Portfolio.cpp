@@ -1,6 +1,7 @@
 #include "Portfolio.h"
 #include <cmath>
 #include <algorithm>
+#include <utility>
 
 namespace fastquant {
 
@@ -10,6 +11,16 @@ constexpr double EPS = 1e-9;
 
 Portfolio::Portfolio(double initialCash) : cash_(initialCash) {}
 
+void Portfolio::restore(double cash,
+                        double realizedPnl,
+                        std::unordered_map<std::string, Position> positions,
+                        std::unordered_map<std::string, double> marks) {
+    cash_ = cash;
+    realizedPnl_ = realizedPnl;
+    positions_ = std::move(positions);
+    marks_ = std::move(marks);
+}
+
 std::string Portfolio::normalizeSymbol(const std::string& symbol) {
     if (!symbol.empty()) return symbol;
     return "DEFAULT";
@@ -90,6 +101,13 @@ double Portfolio::positionValue() const {
     return value;
 }
 
+bool Portfolio::hasOpenPosition() const {
+    for (const auto& [sym, pos] : positions_) {
+        if (std::abs(pos.qty) >= EPS) return true;
+    }
+    return false;
+}
+
 double Portfolio::unrealizedPnl() const {
     double u = 0.0;
     for (const auto& [sym, pos] : positions_) {
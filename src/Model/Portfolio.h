@@ -33,9 +33,17 @@ public:
     double positionValue() const;
     double unrealizedPnl() const;
     double equity() const { return cash_ + positionValue(); }
+    bool hasOpenPosition() const;
 
     const std::unordered_map<std::string, Position>& positions() const { return positions_; }
     double lastPrice(const std::string& symbol) const;
+    const std::unordered_map<std::string, double>& marks() const { return marks_; }
+
+    // Replace the whole book, e.g. when resuming from an engine snapshot.
+    void restore(double cash,
+                 double realizedPnl,
+                 std::unordered_map<std::string, Position> positions,
+                 std::unordered_map<std::string, double> marks);
 
 private:
     static std::string normalizeSymbol(const std::string& symbol);
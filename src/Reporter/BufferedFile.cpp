@@ -0,0 +1,100 @@
+#include "BufferedFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fastquant {
+
+BufferedFile::BufferedFile(const std::string& path, size_t bufferBytes)
+    : path_(path), buffer_(std::max<size_t>(bufferBytes, 4096)) {
+#if defined(_WIN32)
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        throw std::runtime_error("Unable to open report file: " + path);
+    }
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+#else
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Unable to open report file: " + path + " (" + std::strerror(errno) + ")");
+    }
+#endif
+}
+
+BufferedFile::~BufferedFile() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void BufferedFile::write(const char* data, size_t size) {
+    if (size <= buffer_.size() - used_) {
+        std::memcpy(buffer_.data() + used_, data, size);
+        used_ += size;
+        return;
+    }
+    flush();
+    if (size >= buffer_.size()) {
+        writeThrough(data, size);
+        return;
+    }
+    std::memcpy(buffer_.data(), data, size);
+    used_ = size;
+}
+
+void BufferedFile::flush() {
+    if (used_ == 0) {
+        return;
+    }
+    const size_t size = used_;
+    used_ = 0;
+    writeThrough(buffer_.data(), size);
+}
+
+void BufferedFile::writeThrough(const char* data, size_t size) {
+#if defined(_WIN32)
+    if (!file_ || std::fwrite(data, 1, size, file_) != size) {
+        throw std::runtime_error("Failed writing report file: " + path_);
+    }
+#else
+    while (size > 0) {
+        const ssize_t n = fd_ >= 0 ? ::write(fd_, data, size) : -1;
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed writing report file: " + path_ + " (" + std::strerror(errno) + ")");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+#endif
+}
+
+void BufferedFile::close() {
+#if defined(_WIN32)
+    if (!file_) {
+        return;
+    }
+    flush();
+    std::fclose(file_);
+    file_ = nullptr;
+#else
+    if (fd_ < 0) {
+        return;
+    }
+    flush();
+    ::close(fd_);
+    fd_ = -1;
+#endif
+}
+
+} // namespace fastquant
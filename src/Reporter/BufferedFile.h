@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fastquant {
+
+// Write-only file with one large user-space buffer in front of the descriptor,
+// so report writers issue a few big write(2) calls instead of an ofstream's
+// many small ones. Throws std::runtime_error on open/write failure. close()
+// flushes and reports errors; the destructor flushes quietly.
+class BufferedFile {
+public:
+    static constexpr size_t kDefaultBuffer = size_t{1} << 20;
+
+    explicit BufferedFile(const std::string& path, size_t bufferBytes = kDefaultBuffer);
+    ~BufferedFile();
+    BufferedFile(const BufferedFile&) = delete;
+    BufferedFile& operator=(const BufferedFile&) = delete;
+
+    void write(const char* data, size_t size);
+    void write(std::string_view s) { write(s.data(), s.size()); }
+    void put(char c) {
+        if (used_ == buffer_.size()) {
+            flush();
+        }
+        buffer_[used_++] = c;
+    }
+
+    // Reserve `size` contiguous bytes (size <= buffer size) to format into;
+    // commit() the bytes actually used.
+    char* reserve(size_t size) {
+        if (buffer_.size() - used_ < size) {
+            flush();
+        }
+        return buffer_.data() + used_;
+    }
+    void commit(size_t size) { used_ += size; }
+
+    void flush();
+    void close();
+    const std::string& path() const { return path_; }
+
+private:
+    void writeThrough(const char* data, size_t size);
+
+    std::string path_;
+    std::vector<char> buffer_;
+    size_t used_{0};
+    int fd_{-1};               // POSIX
+    std::FILE* file_{nullptr}; // Windows
+};
+
+} // namespace fastquant
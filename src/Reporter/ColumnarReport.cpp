@@ -0,0 +1,319 @@
+#include "ColumnarReport.h"
+#include "BufferedFile.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fastquant {
+
+namespace {
+
+static_assert(std::endian::native == std::endian::little, "columnar reports are written in host byte order");
+
+constexpr char kMagic[8] = {'F', 'Q', 'C', 'O', 'L', 'R', 'P', 'T'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kNameBytes = 40;
+constexpr size_t kHeaderBytes = 8 + 4 + 4 + 8 + 8 + 8;
+constexpr size_t kEntryBytes = kNameBytes + 4 + 4 + 8 + 8 + 8;
+constexpr size_t kAlign = 64;
+
+size_t alignUp(size_t n) {
+    return (n + kAlign - 1) / kAlign * kAlign;
+}
+
+int64_t toNanos(std::chrono::system_clock::time_point tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+template<typename T>
+void put(BufferedFile& out, T value) {
+    std::memcpy(out.reserve(sizeof(T)), &value, sizeof(T));
+    out.commit(sizeof(T));
+}
+
+size_t typeWidth(ColumnType type) {
+    switch (type) {
+        case ColumnType::F64:
+        case ColumnType::I64: return 8;
+        case ColumnType::U32: return 4;
+        case ColumnType::U8: return 1;
+        case ColumnType::Strings: return 0;
+    }
+    return 0;
+}
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+    uint64_t rows;
+    uint64_t bytes;
+    std::function<void(BufferedFile&)> emit;
+};
+
+// One column per member of a row type, e.g. every Trade's price.
+template<typename T, typename Rows, typename Get>
+ColumnSpec rowColumn(std::string name, ColumnType type, const Rows& rows, Get get) {
+    return {std::move(name), type, rows.size(), rows.size() * sizeof(T),
+            [&rows, get](BufferedFile& out) {
+                for (const auto& row : rows) {
+                    put<T>(out, static_cast<T>(get(row)));
+                }
+            }};
+}
+
+} // namespace
+
+void writeColumnarReport(const BacktestResult& result, const std::string& path) {
+    const auto& trades = result.trades;
+    const auto& trips = result.ledger.roundTrips();
+
+    // The ledger's symbol ids are reused as-is; fill symbols are appended.
+    std::vector<std::string> symbols = result.ledger.symbols();
+    std::unordered_map<std::string, uint32_t> symbolIndex;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        symbolIndex.emplace(symbols[i], static_cast<uint32_t>(i));
+    }
+    std::vector<uint32_t> tradeSymbols;
+    tradeSymbols.reserve(trades.size());
+    for (const auto& tr : trades) {
+        auto [it, inserted] = symbolIndex.try_emplace(tr.symbol, static_cast<uint32_t>(symbols.size()));
+        if (inserted) {
+            symbols.push_back(tr.symbol);
+        }
+        tradeSymbols.push_back(it->second);
+    }
+    const std::vector<double> tradePnl = result.ledger.fillPnl(trades);
+    uint64_t symbolBytes = 0;
+    for (const auto& s : symbols) {
+        symbolBytes += 4 + s.size();
+    }
+
+    const uint64_t points = result.equityPointCount();
+    double finalEquity = result.portfolio.equity();
+    std::vector<ColumnSpec> columns;
+    columns.push_back({"equity.timestamp", ColumnType::I64, points, points * 8, [&](BufferedFile& out) {
+        result.forEachEquityPoint([&](std::chrono::system_clock::time_point tp, double) { put(out, toNanos(tp)); });
+    }});
+    columns.push_back({"equity.value", ColumnType::F64, points, points * 8, [&](BufferedFile& out) {
+        if (!result.equitySpill) {
+            out.write(reinterpret_cast<const char*>(result.equityCurve.data()), result.equityCurve.size() * sizeof(double));
+            return;
+        }
+        result.forEachEquityPoint([&](std::chrono::system_clock::time_point, double v) { put(out, v); });
+    }});
+
+    columns.push_back(rowColumn<int64_t>("trades.timestamp", ColumnType::I64, trades, [](const Trade& t) { return toNanos(t.timestamp); }));
+    columns.push_back(rowColumn<uint8_t>("trades.side", ColumnType::U8, trades, [](const Trade& t) { return t.side; }));
+    columns.push_back(rowColumn<uint8_t>("trades.type", ColumnType::U8, trades, [](const Trade& t) { return t.type; }));
+    columns.push_back(rowColumn<double>("trades.price", ColumnType::F64, trades, [](const Trade& t) { return t.price; }));
+    columns.push_back(rowColumn<double>("trades.qty", ColumnType::F64, trades, [](const Trade& t) { return t.qty; }));
+    columns.push_back(rowColumn<double>("trades.fee", ColumnType::F64, trades, [](const Trade& t) { return t.fee; }));
+    columns.push_back(rowColumn<double>("trades.slippage_bps", ColumnType::F64, trades, [](const Trade& t) { return t.slippageBps; }));
+    columns.push_back({"trades.pnl", ColumnType::F64, tradePnl.size(), tradePnl.size() * 8, [&](BufferedFile& out) {
+        out.write(reinterpret_cast<const char*>(tradePnl.data()), tradePnl.size() * sizeof(double));
+    }});
+    columns.push_back({"trades.symbol", ColumnType::U32, tradeSymbols.size(), tradeSymbols.size() * 4, [&](BufferedFile& out) {
+        out.write(reinterpret_cast<const char*>(tradeSymbols.data()), tradeSymbols.size() * sizeof(uint32_t));
+    }});
+
+    columns.push_back(rowColumn<int64_t>("round_trips.entry_time", ColumnType::I64, trips, [](const RoundTrip& r) { return toNanos(r.entryTime); }));
+    columns.push_back(rowColumn<int64_t>("round_trips.exit_time", ColumnType::I64, trips, [](const RoundTrip& r) { return toNanos(r.exitTime); }));
+    columns.push_back(rowColumn<uint8_t>("round_trips.side", ColumnType::U8, trips, [](const RoundTrip& r) { return r.side; }));
+    columns.push_back(rowColumn<double>("round_trips.qty", ColumnType::F64, trips, [](const RoundTrip& r) { return r.qty; }));
+    columns.push_back(rowColumn<double>("round_trips.entry_price", ColumnType::F64, trips, [](const RoundTrip& r) { return r.entryPrice; }));
+    columns.push_back(rowColumn<double>("round_trips.exit_price", ColumnType::F64, trips, [](const RoundTrip& r) { return r.exitPrice; }));
+    columns.push_back(rowColumn<double>("round_trips.pnl", ColumnType::F64, trips, [](const RoundTrip& r) { return r.pnl; }));
+    columns.push_back(rowColumn<double>("round_trips.fees", ColumnType::F64, trips, [](const RoundTrip& r) { return r.fees; }));
+    columns.push_back(rowColumn<double>("round_trips.mae", ColumnType::F64, trips, [](const RoundTrip& r) { return r.mae; }));
+    columns.push_back(rowColumn<double>("round_trips.mfe", ColumnType::F64, trips, [](const RoundTrip& r) { return r.mfe; }));
+    columns.push_back(rowColumn<uint32_t>("round_trips.symbol", ColumnType::U32, trips, [](const RoundTrip& r) { return r.symbol; }));
+
+    columns.push_back({"symbols", ColumnType::Strings, symbols.size(), symbolBytes, [&](BufferedFile& out) {
+        for (const auto& s : symbols) {
+            put(out, static_cast<uint32_t>(s.size()));
+            out.write(s);
+        }
+    }});
+
+    BufferedFile out(path);
+    out.write(kMagic, sizeof(kMagic));
+    put(out, kVersion);
+    put(out, static_cast<uint32_t>(columns.size()));
+    put(out, result.initialCapital);
+    put(out, finalEquity);
+    put(out, static_cast<uint64_t>(result.candlesProcessed));
+
+    size_t offset = alignUp(kHeaderBytes + columns.size() * kEntryBytes);
+    for (const auto& c : columns) {
+        char name[kNameBytes] = {};
+        std::memcpy(name, c.name.data(), std::min(c.name.size(), kNameBytes - 1));
+        out.write(name, kNameBytes);
+        put(out, static_cast<uint32_t>(c.type));
+        put(out, uint32_t{0});
+        put(out, c.rows);
+        put(out, static_cast<uint64_t>(offset));
+        put(out, c.bytes);
+        offset = alignUp(offset + c.bytes);
+    }
+
+    static const char zeros[kAlign] = {};
+    size_t written = kHeaderBytes + columns.size() * kEntryBytes;
+    for (const auto& c : columns) {
+        out.write(zeros, alignUp(written) - written);
+        written = alignUp(written);
+        c.emit(out);
+        written += c.bytes;
+    }
+    out.close();
+}
+
+ColumnarReport::ColumnarReport(const std::string& path) : path_(path) {
+#if defined(_WIN32)
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Unable to open columnar report: " + path);
+    }
+    owned_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = owned_.data();
+    size_ = owned_.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open columnar report: " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to stat columnar report: " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        map_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (map_ == MAP_FAILED || map_ == nullptr) {
+        map_ = nullptr;
+        throw std::runtime_error("Unable to map columnar report: " + path);
+    }
+    data_ = static_cast<const unsigned char*>(map_);
+#endif
+
+    auto fail = [&](const std::string& why) -> void {
+        throw std::runtime_error("Invalid columnar report (" + why + "): " + path_);
+    };
+    auto read = [&](size_t at, auto& value) {
+        std::memcpy(&value, data_ + at, sizeof(value));
+    };
+    try {
+        if (size_ < kHeaderBytes || std::memcmp(data_, kMagic, sizeof(kMagic)) != 0) {
+            fail("bad magic");
+        }
+        uint32_t version = 0;
+        uint32_t count = 0;
+        read(8, version);
+        read(12, count);
+        if (version != kVersion) {
+            fail("unsupported version " + std::to_string(version));
+        }
+        read(16, initialCapital_);
+        read(24, finalEquity_);
+        read(32, candlesProcessed_);
+        if (size_ < kHeaderBytes + static_cast<size_t>(count) * kEntryBytes) {
+            fail("truncated directory");
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            const size_t at = kHeaderBytes + i * kEntryBytes;
+            const char* name = reinterpret_cast<const char*>(data_ + at);
+            Column c;
+            c.name.assign(name, strnlen(name, kNameBytes));
+            uint32_t type = 0;
+            read(at + kNameBytes, type);
+            c.type = static_cast<ColumnType>(type);
+            read(at + kNameBytes + 8, c.rows);
+            read(at + kNameBytes + 16, c.offset);
+            read(at + kNameBytes + 24, c.bytes);
+            const size_t width = typeWidth(c.type);
+            if (c.offset > size_ || c.bytes > size_ - c.offset || (width && (c.rows > c.bytes / width || c.rows * width != c.bytes))) {
+                fail("column " + c.name + " out of bounds");
+            }
+            columns_.push_back(std::move(c));
+        }
+        // Columns of one group (equity.*, trades.*, round_trips.*) are read
+        // side by side, so they must all have the same number of rows.
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            const auto& c = columns_[i];
+            const auto dot = c.name.find('.');
+            if (dot == std::string::npos) {
+                continue;
+            }
+            const std::string_view group(c.name.data(), dot + 1);
+            for (size_t j = 0; j < i; ++j) {
+                if (columns_[j].name.starts_with(group) && columns_[j].rows != c.rows) {
+                    fail("column " + c.name + " has " + std::to_string(c.rows) + " rows, "
+                         + columns_[j].name + " has " + std::to_string(columns_[j].rows));
+                }
+            }
+        }
+        if (const Column* strings = find("symbols")) {
+            size_t at = strings->offset;
+            const size_t end = strings->offset + strings->bytes;
+            for (uint64_t i = 0; i < strings->rows; ++i) {
+                uint32_t length = 0;
+                if (end - at < 4) fail("truncated symbols");
+                read(at, length);
+                at += 4;
+                if (end - at < length) fail("truncated symbols");
+                symbols_.emplace_back(reinterpret_cast<const char*>(data_ + at), length);
+                at += length;
+            }
+        }
+    } catch (...) {
+#if !defined(_WIN32)
+        ::munmap(map_, size_);
+#endif
+        throw;
+    }
+}
+
+ColumnarReport::~ColumnarReport() {
+#if !defined(_WIN32)
+    if (map_) {
+        ::munmap(map_, size_);
+    }
+#endif
+}
+
+const ColumnarReport::Column* ColumnarReport::find(std::string_view name) const {
+    for (const auto& c : columns_) {
+        if (c.name == name) {
+            return &c;
+        }
+    }
+    return nullptr;
+}
+
+const ColumnarReport::Column& ColumnarReport::require(std::string_view name, ColumnType type) const {
+    const Column* c = find(name);
+    if (!c) {
+        throw std::runtime_error("Columnar report has no column '" + std::string(name) + "': " + path_);
+    }
+    if (c->type != type) {
+        throw std::runtime_error("Columnar report column '" + std::string(name) + "' has another type: " + path_);
+    }
+    return *c;
+}
+
+} // namespace fastquant
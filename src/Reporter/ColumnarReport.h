@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../BacktestEngine/BacktestEngine.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fastquant {
+
+// Binary columnar report: the equity curve, fills and round trips as typed,
+// 64-byte aligned column blocks behind a small header and column directory.
+// Readers map the file and use the columns in place; nothing is parsed.
+//
+// Layout (little-endian):
+//   header    magic "FQCOLRPT", u32 version, u32 column count,
+//             f64 initial capital, f64 final equity, u64 candles processed
+//   directory per column: char name[40], u32 type, u32 reserved,
+//             u64 rows, u64 byte offset, u64 byte size
+//   blocks    raw column data, each starting on a 64-byte boundary
+//
+// Columns: equity.{timestamp,value}; trades.{timestamp,side,type,price,qty,
+// fee,slippage_bps,pnl,symbol}; round_trips.{entry_time,exit_time,side,qty,
+// entry_price,exit_price,pnl,fees,mae,mfe,symbol}; symbols (string table:
+// u32 length + bytes per entry). Timestamps are i64 nanoseconds since the
+// epoch, sides/types are the Side/OrderType values, symbol columns are u32
+// indices into the string table.
+enum class ColumnType : uint32_t { F64 = 1, I64 = 2, U32 = 3, U8 = 4, Strings = 5 };
+
+void writeColumnarReport(const BacktestResult& result, const std::string& path);
+
+class ColumnarReport {
+public:
+    struct Column {
+        std::string name;
+        ColumnType type{ColumnType::F64};
+        uint64_t rows{0};
+        uint64_t offset{0};
+        uint64_t bytes{0};
+    };
+
+    // Maps (POSIX) or reads the file. Throws std::runtime_error on I/O failure,
+    // bad magic, unsupported version, a directory that points past the end or
+    // columns of one group with different row counts.
+    explicit ColumnarReport(const std::string& path);
+    ~ColumnarReport();
+    ColumnarReport(const ColumnarReport&) = delete;
+    ColumnarReport& operator=(const ColumnarReport&) = delete;
+
+    double initialCapital() const { return initialCapital_; }
+    double finalEquity() const { return finalEquity_; }
+    uint64_t candlesProcessed() const { return candlesProcessed_; }
+    const std::vector<Column>& columns() const { return columns_; }
+    bool has(std::string_view name) const { return find(name) != nullptr; }
+
+    // Typed view of a column. Throws std::runtime_error if it is missing or
+    // stored with another type.
+    std::span<const double> f64(std::string_view name) const { return view<double>(name, ColumnType::F64); }
+    std::span<const int64_t> i64(std::string_view name) const { return view<int64_t>(name, ColumnType::I64); }
+    std::span<const uint32_t> u32(std::string_view name) const { return view<uint32_t>(name, ColumnType::U32); }
+    std::span<const uint8_t> u8(std::string_view name) const { return view<uint8_t>(name, ColumnType::U8); }
+    const std::vector<std::string>& symbols() const { return symbols_; }
+
+private:
+    const Column* find(std::string_view name) const;
+    const Column& require(std::string_view name, ColumnType type) const;
+    template<typename T>
+    std::span<const T> view(std::string_view name, ColumnType type) const {
+        const Column& c = require(name, type);
+        return {reinterpret_cast<const T*>(data_ + c.offset), static_cast<size_t>(c.rows)};
+    }
+
+    std::string path_;
+    const unsigned char* data_{nullptr};
+    size_t size_{0};
+    void* map_{nullptr};                  // POSIX mapping
+    std::vector<unsigned char> owned_;    // Windows: whole file
+    double initialCapital_{0.0};
+    double finalEquity_{0.0};
+    uint64_t candlesProcessed_{0};
+    std::vector<Column> columns_;
+    std::vector<std::string> symbols_;
+};
+
+} // namespace fastquant
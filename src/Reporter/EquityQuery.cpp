@@ -0,0 +1,51 @@
+#include "EquityQuery.h"
+
+#include "../BacktestEngine/EquityRecorder.h"
+#include <algorithm>
+#include <numeric>
+
+namespace fastquant {
+
+EquitySelection selectEquityPoints(std::span<const std::chrono::system_clock::time_point> timestamps,
+                                   std::span<const double> equity,
+                                   const EquityQuery& query) {
+    size_t begin = 0;
+    size_t end = equity.size();
+    if (timestamps.size() == equity.size()) {
+        if (query.from) {
+            begin = static_cast<size_t>(std::lower_bound(timestamps.begin(), timestamps.end(), *query.from) - timestamps.begin());
+        }
+        if (query.to) {
+            end = static_cast<size_t>(std::upper_bound(timestamps.begin(), timestamps.end(), *query.to) - timestamps.begin());
+        }
+    }
+    EquitySelection out;
+    if (begin >= end) {
+        return out;
+    }
+    out.inRange = end - begin;
+
+    if (query.maxPoints == 0 || out.inRange <= query.maxPoints) {
+        out.indices.resize(out.inRange);
+        std::iota(out.indices.begin(), out.indices.end(), begin);
+        return out;
+    }
+
+    // Seconds relative to the first point keep full double precision for x.
+    std::vector<double> x(out.inRange);
+    if (timestamps.size() == equity.size()) {
+        const auto t0 = timestamps[begin];
+        for (size_t i = 0; i < out.inRange; ++i) {
+            x[i] = std::chrono::duration<double>(timestamps[begin + i] - t0).count();
+        }
+    } else {
+        std::iota(x.begin(), x.end(), 0.0);
+    }
+    out.indices = lttbIndices(x, equity.subspan(begin, out.inRange), std::max<size_t>(3, query.maxPoints));
+    for (auto& i : out.indices) {
+        i += begin;
+    }
+    return out;
+}
+
+} // namespace fastquant
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace fastquant {
+
+// What part of an equity curve a client wants: an optional closed time range
+// and a point budget for it.
+struct EquityQuery {
+    std::optional<std::chrono::system_clock::time_point> from;
+    std::optional<std::chrono::system_clock::time_point> to;
+    size_t maxPoints = 0; // 0 = every point in range; otherwise LTTB, at least 3
+};
+
+struct EquitySelection {
+    std::vector<size_t> indices; // ascending, into the full curve
+    size_t inRange{0};           // points between from and to
+};
+
+// Picks the points to send for `query`. The range is found by binary search
+// on the (ascending) timestamps; a range over the budget is thinned with
+// lttbIndices using time as x, so gaps in the data keep their width. The
+// first and last point of the range are always kept, which lets a zooming
+// client stitch detail into a coarse overview.
+EquitySelection selectEquityPoints(std::span<const std::chrono::system_clock::time_point> timestamps,
+                                   std::span<const double> equity,
+                                   const EquityQuery& query);
+
+} // namespace fastquant
@@ -0,0 +1,180 @@
+#include "JsonStreamWriter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace fastquant {
+
+JsonStreamWriter::JsonStreamWriter(BufferedFile& out, JsonStyle style)
+    : out_(out), style_(style) {}
+
+void JsonStreamWriter::newline() {
+    if (style_ != JsonStyle::Pretty) {
+        return;
+    }
+    const size_t indent = scopes_.size() * 2;
+    char* p = out_.reserve(indent + 1);
+    p[0] = '\n';
+    std::memset(p + 1, ' ', indent);
+    out_.commit(indent + 1);
+}
+
+void JsonStreamWriter::beforeValue() {
+    if (scopes_.empty()) {
+        return;
+    }
+    Scope& top = scopes_.back();
+    if (!top.array) {
+        if (!pendingKey_) {
+            throw std::logic_error("JSON object member written without a key");
+        }
+        pendingKey_ = false;
+        return;
+    }
+    if (top.count++ > 0) {
+        out_.put(',');
+    }
+    newline();
+}
+
+void JsonStreamWriter::key(std::string_view name) {
+    if (scopes_.empty() || scopes_.back().array || pendingKey_) {
+        throw std::logic_error("JSON key written outside an object member position");
+    }
+    if (scopes_.back().count++ > 0) {
+        out_.put(',');
+    }
+    newline();
+    string(name);
+    if (style_ == JsonStyle::Pretty) {
+        out_.write(": ", 2);
+    } else {
+        out_.put(':');
+    }
+    pendingKey_ = true;
+}
+
+void JsonStreamWriter::beginObject() {
+    beforeValue();
+    out_.put('{');
+    scopes_.push_back({false, 0});
+}
+
+void JsonStreamWriter::beginArray() {
+    beforeValue();
+    out_.put('[');
+    scopes_.push_back({true, 0});
+}
+
+void JsonStreamWriter::endObject() {
+    close(false);
+}
+
+void JsonStreamWriter::endArray() {
+    close(true);
+}
+
+void JsonStreamWriter::close(bool array) {
+    if (scopes_.empty() || scopes_.back().array != array || pendingKey_) {
+        throw std::logic_error("Unbalanced JSON end call");
+    }
+    const bool hadMembers = scopes_.back().count > 0;
+    scopes_.pop_back();
+    if (hadMembers) {
+        newline();
+    }
+    out_.put(array ? ']' : '}');
+}
+
+void JsonStreamWriter::value(double v) {
+    if (!std::isfinite(v)) {
+        null();
+        return;
+    }
+    beforeValue();
+    char* p = out_.reserve(32);
+    auto [end, ec] = std::to_chars(p, p + 30, v);
+    (void)ec; // 30 bytes fit any shortest double
+    // Keep doubles recognisable as floating point, as nlohmann prints 1.0.
+    if (std::find_if(p, end, [](char c) { return c == '.' || c == 'e'; }) == end) {
+        *end++ = '.';
+        *end++ = '0';
+    }
+    out_.commit(static_cast<size_t>(end - p));
+}
+
+void JsonStreamWriter::integer(int64_t v) {
+    beforeValue();
+    char* p = out_.reserve(24);
+    auto [end, ec] = std::to_chars(p, p + 24, v);
+    (void)ec;
+    out_.commit(static_cast<size_t>(end - p));
+}
+
+void JsonStreamWriter::unsignedInteger(uint64_t v) {
+    beforeValue();
+    char* p = out_.reserve(24);
+    auto [end, ec] = std::to_chars(p, p + 24, v);
+    (void)ec;
+    out_.commit(static_cast<size_t>(end - p));
+}
+
+void JsonStreamWriter::value(bool v) {
+    beforeValue();
+    if (v) {
+        out_.write("true", 4);
+    } else {
+        out_.write("false", 5);
+    }
+}
+
+void JsonStreamWriter::value(std::string_view v) {
+    beforeValue();
+    string(v);
+}
+
+void JsonStreamWriter::null() {
+    beforeValue();
+    out_.write("null", 4);
+}
+
+void JsonStreamWriter::string(std::string_view s) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    out_.put('"');
+    size_t run = 0; // start of the pending unescaped run
+    for (size_t i = 0; i < s.size(); ++i) {
+        const auto c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out_.write(s.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': out_.write("\\\"", 2); break;
+            case '\\': out_.write("\\\\", 2); break;
+            case '\b': out_.write("\\b", 2); break;
+            case '\f': out_.write("\\f", 2); break;
+            case '\n': out_.write("\\n", 2); break;
+            case '\r': out_.write("\\r", 2); break;
+            case '\t': out_.write("\\t", 2); break;
+            default: {
+                const char esc[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                out_.write(esc, 6);
+            }
+        }
+    }
+    out_.write(s.data() + run, s.size() - run);
+    out_.put('"');
+}
+
+void JsonStreamWriter::finish() {
+    if (!scopes_.empty() || pendingKey_) {
+        throw std::logic_error("JSON document finished with open scopes");
+    }
+    out_.flush();
+}
+
+} // namespace fastquant
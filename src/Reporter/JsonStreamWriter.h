@@ -0,0 +1,73 @@
+#pragma once
+
+#include "BufferedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace fastquant {
+
+enum class JsonStyle { Pretty, Compact };
+
+// Incremental JSON emitter over a BufferedFile: no DOM, so a report's memory
+// stays flat however many trades and equity points it holds. Pretty output is
+// laid out like nlohmann::json's dump(2). Doubles use std::to_chars' shortest
+// round-trip form; non-finite values are written as null, as nlohmann does.
+// Structural misuse (a value without a key inside an object, unbalanced
+// end calls) throws std::logic_error.
+class JsonStreamWriter {
+public:
+    explicit JsonStreamWriter(BufferedFile& out, JsonStyle style = JsonStyle::Pretty);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(std::string_view name);
+
+    void value(double v);
+    void value(bool v);
+    void value(std::string_view v);
+    void value(const char* v) { value(std::string_view(v)); }
+    void value(const std::string& v) { value(std::string_view(v)); }
+    template<typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    void value(T v) {
+        if constexpr (std::is_signed_v<T>) {
+            integer(static_cast<int64_t>(v));
+        } else {
+            unsignedInteger(static_cast<uint64_t>(v));
+        }
+    }
+    void null();
+
+    // key(name) followed by value(v).
+    template<typename T>
+    void field(std::string_view name, const T& v) {
+        key(name);
+        value(v);
+    }
+
+    // Call once the top-level value is complete: checks balance and flushes.
+    void finish();
+
+private:
+    struct Scope {
+        bool array{false};
+        size_t count{0};
+    };
+    void beforeValue();
+    void close(bool array);
+    void newline();
+    void string(std::string_view s);
+    void integer(int64_t v);
+    void unsignedInteger(uint64_t v);
+
+    BufferedFile& out_;
+    JsonStyle style_;
+    std::vector<Scope> scopes_;
+    bool pendingKey_{false};
+};
+
+} // namespace fastquant
@@ -1,23 +1,43 @@
 #include "Reporter.h"
-#include "../Model/Portfolio.h"
-#include <nlohmann/json.hpp>
 #include <fstream>
 #include <iomanip>
-#include <sstream>
-#include <ctime>
+#include <memory>
+#include <stdexcept>
 
 namespace fastquant {
 
 namespace {
-constexpr double EPS = 1e-9;
+
+// ofstream over a BufferedFile-sized buffer rather than filebuf's default
+// few KB, so text writers issue large writes. Throws if the file cannot be
+// opened.
+struct ReportStream {
+    explicit ReportStream(const std::string& path) : buffer(new char[BufferedFile::kDefaultBuffer]) {
+        out.rdbuf()->pubsetbuf(buffer.get(), static_cast<std::streamsize>(BufferedFile::kDefaultBuffer));
+        out.open(path);
+        if (!out) {
+            throw std::runtime_error("Unable to open report file: " + path);
+        }
+    }
+    std::unique_ptr<char[]> buffer; // declared first: must outlive the stream
+    std::ofstream out;
+};
+
+void timestampField(JsonStreamWriter& j, TimestampFormatter& ts, std::string_view name,
+                    std::chrono::system_clock::time_point tp) {
+    j.key(name);
+    if (ts.numeric()) {
+        j.value(ts.epoch(tp));
+    } else {
+        j.value(ts(tp));
+    }
 }
 
+} // namespace
+
 std::string Reporter::formatTimestamp(const std::chrono::system_clock::time_point& tp) {
-    std::time_t tt = std::chrono::system_clock::to_time_t(tp);
-    std::tm tm = *std::gmtime(&tt);
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
-    return oss.str();
+    thread_local TimestampFormatter formatter;
+    return std::string(formatter(tp));
 }
 
 ReportSummary Reporter::summarize(const BacktestResult& result) const {
@@ -29,12 +49,41 @@ ReportSummary Reporter::summarize(const BacktestResult& result) const {
     summary.totalReturn = (summary.initialCapital > 0.0)
         ? ((summary.finalEquity / summary.initialCapital) - 1.0)
         : 0.0;
-    summary.trades = result.trades.size();
+    summary.trades = result.summaryOnly ? result.metrics.fills() : result.trades.size();
     summary.totalFees = result.totalFees;
     summary.totalSlippage = result.totalSlippage;
     summary.ordersFilled = result.ordersFilled;
     summary.ordersRejected = result.ordersRejected;
 
+    summary.exposure = result.metrics.exposure();
+    summary.returnStdDev = result.metrics.returnStdDev();
+    summary.sharpe = result.metrics.sharpe();
+
+    summary.winningTrades = result.metrics.winningFills();
+    summary.losingTrades = result.metrics.losingFills();
+    if (summary.winningTrades + summary.losingTrades > 0) {
+        summary.winRate = static_cast<double>(summary.winningTrades)
+            / static_cast<double>(summary.winningTrades + summary.losingTrades);
+    }
+
+    const LedgerStats& ledger = result.ledger.stats();
+    summary.roundTrips = ledger.roundTrips;
+    summary.roundTripWinRate = ledger.winRate();
+    summary.profitFactor = ledger.profitFactor();
+    summary.avgHoldingSeconds = ledger.averageHoldingSeconds();
+
+    if (!result.summaryOnly && result.equityRecording.policy == EquityPolicy::All) {
+        summary.risk = computeRiskMetrics(result.equityCurve, result.equityTimestamps, risk_);
+    }
+
+    if (result.summaryOnly || result.equityRecording.policy != EquityPolicy::All) {
+        const RunMetrics& m = result.metrics;
+        summary.peakEquity = m.points() ? m.peakEquity() : summary.initialCapital;
+        summary.troughEquity = m.points() ? m.troughEquity() : summary.initialCapital;
+        summary.maxDrawdown = m.maxDrawdown();
+        return summary;
+    }
+
     // compute drawdown from equity curve
     double peak = summary.initialCapital;
     double trough = summary.initialCapital;
@@ -59,87 +108,140 @@ ReportSummary Reporter::summarize(const BacktestResult& result) const {
     summary.peakEquity = peak;
     summary.troughEquity = trough;
     summary.maxDrawdown = maxDd;
-
-    // win/loss counts by replaying realized pnl deltas
-    Portfolio replay(result.initialCapital);
-    double prevRealized = 0.0;
-    for (const auto& tr : result.trades) {
-        replay.applyTrade(tr);
-        double current = replay.realizedPnl();
-        double delta = current - prevRealized;
-        if (delta > EPS) {
-            summary.winningTrades++;
-        } else if (delta < -EPS) {
-            summary.losingTrades++;
-        }
-        prevRealized = current;
-    }
-    if (summary.winningTrades + summary.losingTrades > 0) {
-        summary.winRate = static_cast<double>(summary.winningTrades)
-            / static_cast<double>(summary.winningTrades + summary.losingTrades);
-    }
-
     return summary;
 }
 
-void Reporter::writeJson(const BacktestResult& result, const std::string& path) const {
-    auto summary = summarize(result);
-    nlohmann::json j;
-    j["summary"] = {
-        {"initial_capital", summary.initialCapital},
-        {"final_equity", summary.finalEquity},
-        {"total_return", summary.totalReturn},
-        {"realized_pnl", summary.realizedPnl},
-        {"unrealized_pnl", summary.unrealizedPnl},
-        {"max_drawdown", summary.maxDrawdown},
-        {"peak_equity", summary.peakEquity},
-        {"trough_equity", summary.troughEquity},
-        {"trades", summary.trades},
-        {"winning_trades", summary.winningTrades},
-        {"losing_trades", summary.losingTrades},
-        {"win_rate", summary.winRate},
-        {"total_fees", summary.totalFees},
-        {"total_slippage", summary.totalSlippage},
-        {"orders_filled", summary.ordersFilled},
-        {"orders_rejected", summary.ordersRejected}
-    };
-
-    nlohmann::json tradesJson = nlohmann::json::array();
+void Reporter::writeJson(const BacktestResult& result, const std::string& path, JsonStyle style) const {
+    writeJson(result, summarize(result), path, style);
+}
+
+void Reporter::writeJson(const BacktestResult& result, const ReportSummary& summary, const std::string& path,
+                         JsonStyle style) const {
+    BufferedFile file(path);
+    JsonStreamWriter j(file, style);
+    TimestampFormatter ts(timestamps_);
+    j.beginObject();
+
+    j.key("summary");
+    j.beginObject();
+    j.field("initial_capital", summary.initialCapital);
+    j.field("final_equity", summary.finalEquity);
+    j.field("total_return", summary.totalReturn);
+    j.field("realized_pnl", summary.realizedPnl);
+    j.field("unrealized_pnl", summary.unrealizedPnl);
+    j.field("max_drawdown", summary.maxDrawdown);
+    j.field("peak_equity", summary.peakEquity);
+    j.field("trough_equity", summary.troughEquity);
+    j.field("trades", summary.trades);
+    j.field("winning_trades", summary.winningTrades);
+    j.field("losing_trades", summary.losingTrades);
+    j.field("win_rate", summary.winRate);
+    j.field("total_fees", summary.totalFees);
+    j.field("total_slippage", summary.totalSlippage);
+    j.field("orders_filled", summary.ordersFilled);
+    j.field("orders_rejected", summary.ordersRejected);
+    j.field("exposure", summary.exposure);
+    j.field("return_stddev", summary.returnStdDev);
+    j.field("sharpe", summary.sharpe);
+    j.field("round_trips", summary.roundTrips);
+    j.field("round_trip_win_rate", summary.roundTripWinRate);
+    j.field("profit_factor", summary.profitFactor);
+    j.field("avg_holding_seconds", summary.avgHoldingSeconds);
+    const RiskMetrics& risk = summary.risk;
+    j.key("risk");
+    j.beginObject();
+    j.field("returns", risk.returns);
+    j.field("periods_per_year", risk.periodsPerYear);
+    j.field("mean_return", risk.meanReturn);
+    j.field("volatility", risk.volatility);
+    j.field("downside_deviation", risk.downsideDeviation);
+    j.field("annualized_return", risk.annualizedReturn);
+    j.field("annualized_volatility", risk.annualizedVolatility);
+    j.field("sharpe", risk.sharpe);
+    j.field("sortino", risk.sortino);
+    j.field("calmar", risk.calmar);
+    j.field("max_drawdown", risk.maxDrawdown);
+    j.field("max_drawdown_duration", risk.maxDrawdownDuration);
+    j.field("max_drawdown_duration_seconds", risk.maxDrawdownDurationSeconds);
+    j.field("rolling_volatility", risk.rollingVolatility);
+    j.field("max_rolling_volatility", risk.maxRollingVolatility);
+    j.field("value_at_risk", risk.valueAtRisk);
+    j.field("expected_shortfall", risk.expectedShortfall);
+    j.field("skewness", risk.skewness);
+    j.field("excess_kurtosis", risk.excessKurtosis);
+    j.field("best_return", risk.bestReturn);
+    j.field("worst_return", risk.worstReturn);
+    j.endObject();
+    j.endObject();
+
+    j.key("trades");
+    j.beginArray();
     for (const auto& tr : result.trades) {
-        tradesJson.push_back({
-            {"id", tr.id},
-            {"order_id", tr.orderId},
-            {"side", tr.side == Side::Buy ? "BUY" : "SELL"},
-            {"type", tr.type == OrderType::Market ? "MARKET" : "LIMIT"},
-            {"price", tr.price},
-            {"qty", tr.qty},
-            {"symbol", tr.symbol},
-            {"timestamp", formatTimestamp(tr.timestamp)},
-            {"fee", tr.fee},
-            {"slippage_bps", tr.slippageBps}
-        });
+        j.beginObject();
+        j.field("id", tr.id);
+        j.field("order_id", tr.orderId);
+        j.field("side", tr.side == Side::Buy ? "BUY" : "SELL");
+        j.field("type", tr.type == OrderType::Market ? "MARKET" : "LIMIT");
+        j.field("price", tr.price);
+        j.field("qty", tr.qty);
+        j.field("symbol", tr.symbol);
+        timestampField(j, ts, "timestamp", tr.timestamp);
+        j.field("fee", tr.fee);
+        j.field("slippage_bps", tr.slippageBps);
+        j.endObject();
     }
-    j["trades"] = tradesJson;
-
-    nlohmann::json equityJson = nlohmann::json::array();
-    for (size_t i = 0; i < result.equityCurve.size(); ++i) {
-        nlohmann::json point;
-        point["equity"] = result.equityCurve[i];
-        if (i < result.equityTimestamps.size()) {
-            point["timestamp"] = formatTimestamp(result.equityTimestamps[i]);
-        }
-        equityJson.push_back(point);
+    j.endArray();
+
+    j.key("round_trips");
+    j.beginArray();
+    for (const auto& rt : result.ledger.roundTrips()) {
+        j.beginObject();
+        j.field("symbol", result.ledger.symbolName(rt));
+        j.field("side", rt.side == Side::Buy ? "LONG" : "SHORT");
+        j.field("qty", rt.qty);
+        timestampField(j, ts, "entry_time", rt.entryTime);
+        timestampField(j, ts, "exit_time", rt.exitTime);
+        j.field("entry_price", rt.entryPrice);
+        j.field("exit_price", rt.exitPrice);
+        j.field("pnl", rt.pnl);
+        j.field("fees", rt.fees);
+        j.field("mae", rt.mae);
+        j.field("mfe", rt.mfe);
+        j.field("holding_seconds", rt.holdingSeconds());
+        j.endObject();
     }
-    j["equity_curve"] = equityJson;
+    j.endArray();
+
+    j.key("equity_curve");
+    j.beginArray();
+    result.forEachEquityPoint([&](std::chrono::system_clock::time_point tp, double equity) {
+        j.beginObject();
+        j.field("equity", equity);
+        timestampField(j, ts, "timestamp", tp);
+        j.endObject();
+    });
+    j.endArray();
+
+    j.key("equity_recording");
+    j.beginObject();
+    j.field("policy", toString(result.equityRecording.policy));
+    j.field("points", result.equityPointCount());
+    j.endObject();
 
-    std::ofstream ofs(path);
-    ofs << std::setw(2) << j;
+    j.endObject();
+    j.finish();
+    file.close();
 }
 
 void Reporter::writeSummaryCsv(const BacktestResult& result, const std::string& path) const {
-    auto summary = summarize(result);
-    std::ofstream ofs(path);
-    ofs << "initial_capital,final_equity,total_return,realized_pnl,unrealized_pnl,max_drawdown,win_rate,trades,winning_trades,losing_trades,total_fees,total_slippage,orders_filled,orders_rejected\n";
+    writeSummaryCsv(summarize(result), path);
+}
+
+void Reporter::writeSummaryCsv(const ReportSummary& summary, const std::string& path) const {
+    ReportStream file(path);
+    auto& ofs = file.out;
+    ofs << "initial_capital,final_equity,total_return,realized_pnl,unrealized_pnl,max_drawdown,win_rate,trades,winning_trades,losing_trades,total_fees,total_slippage,orders_filled,orders_rejected,exposure,return_stddev,sharpe,round_trips,round_trip_win_rate,profit_factor,avg_holding_seconds,"
+           "annualized_return,annualized_volatility,sharpe_annualized,sortino,calmar,max_drawdown_pct,max_drawdown_duration,value_at_risk,expected_shortfall\n";
     ofs << summary.initialCapital << ','
         << summary.finalEquity << ','
         << summary.totalReturn << ','
@@ -153,11 +255,29 @@ void Reporter::writeSummaryCsv(const BacktestResult& result, const std::string&
         << summary.totalFees << ','
         << summary.totalSlippage << ','
         << summary.ordersFilled << ','
-        << summary.ordersRejected << '\n';
+        << summary.ordersRejected << ','
+        << summary.exposure << ','
+        << summary.returnStdDev << ','
+        << summary.sharpe << ','
+        << summary.roundTrips << ','
+        << summary.roundTripWinRate << ','
+        << summary.profitFactor << ','
+        << summary.avgHoldingSeconds << ','
+        << summary.risk.annualizedReturn << ','
+        << summary.risk.annualizedVolatility << ','
+        << summary.risk.sharpe << ','
+        << summary.risk.sortino << ','
+        << summary.risk.calmar << ','
+        << summary.risk.maxDrawdown << ','
+        << summary.risk.maxDrawdownDuration << ','
+        << summary.risk.valueAtRisk << ','
+        << summary.risk.expectedShortfall << '\n';
 }
 
 void Reporter::writeTradesCsv(const BacktestResult& result, const std::string& path) const {
-    std::ofstream ofs(path);
+    ReportStream file(path);
+    auto& ofs = file.out;
+    TimestampFormatter ts(timestamps_);
     ofs << "trade_id,order_id,side,type,price,qty,symbol,timestamp,fee,slippage_bps\n";
     for (const auto& tr : result.trades) {
         ofs << tr.id << ','
@@ -167,10 +287,58 @@ void Reporter::writeTradesCsv(const BacktestResult& result, const std::string& p
             << tr.price << ','
             << tr.qty << ','
             << tr.symbol << ','
-            << formatTimestamp(tr.timestamp) << ','
+            << ts(tr.timestamp) << ','
             << tr.fee << ','
             << tr.slippageBps << '\n';
     }
 }
 
+void Reporter::writeRoundTripsCsv(const BacktestResult& result, const std::string& path) const {
+    ReportStream file(path);
+    auto& ofs = file.out;
+    TimestampFormatter ts(timestamps_);
+    ofs << "symbol,side,qty,entry_time,exit_time,entry_price,exit_price,pnl,fees,mae,mfe,holding_seconds\n";
+    for (const auto& rt : result.ledger.roundTrips()) {
+        ofs << result.ledger.symbolName(rt) << ','
+            << (rt.side == Side::Buy ? "LONG" : "SHORT") << ','
+            << rt.qty << ','
+            << ts(rt.entryTime) << ','
+            << ts(rt.exitTime) << ','
+            << rt.entryPrice << ','
+            << rt.exitPrice << ','
+            << rt.pnl << ','
+            << rt.fees << ','
+            << rt.mae << ','
+            << rt.mfe << ','
+            << rt.holdingSeconds() << '\n';
+    }
+}
+
+void Reporter::writeEquityCsv(const BacktestResult& result, const std::string& path) const {
+    ReportStream file(path);
+    auto& ofs = file.out;
+    TimestampFormatter ts(timestamps_);
+    ofs << "timestamp,equity\n";
+    ofs << std::setprecision(12);
+    result.forEachEquityPoint([&](std::chrono::system_clock::time_point tp, double equity) {
+        ofs << ts(tp) << ',' << equity << '\n';
+    });
+}
+
+void Reporter::writeEquityCsv(const std::vector<std::chrono::system_clock::time_point>& timestamps,
+                              const std::vector<double>& equity,
+                              const std::string& path) const {
+    ReportStream file(path);
+    auto& ofs = file.out;
+    TimestampFormatter ts(timestamps_);
+    ofs << "timestamp,equity\n";
+    ofs << std::setprecision(12);
+    for (size_t i = 0; i < equity.size(); ++i) {
+        if (i < timestamps.size()) {
+            ofs << ts(timestamps[i]);
+        }
+        ofs << ',' << equity[i] << '\n';
+    }
+}
+
 } // namespace fastquant
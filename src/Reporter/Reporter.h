@@ -1,7 +1,11 @@
 #pragma once
 
 #include "../BacktestEngine/BacktestEngine.h"
+#include "../Analytics/RiskMetrics.h"
+#include "JsonStreamWriter.h"
+#include "TimestampFormatter.h"
 #include <string>
+#include <vector>
 
 namespace fastquant {
 
@@ -22,18 +26,63 @@ struct ReportSummary {
     double totalSlippage{0.0};
     size_t ordersFilled{0};
     size_t ordersRejected{0};
+    // From the engine's online RunMetrics (0 for hand-built results).
+    double exposure{0.0};      // fraction of equity points with an open position
+    double returnStdDev{0.0};  // per equity point
+    double sharpe{0.0};        // per equity point, not annualized
+    // From the engine's round-trip ledger (0 for hand-built results).
+    size_t roundTrips{0};
+    double roundTripWinRate{0.0};
+    double profitFactor{0.0};
+    double avgHoldingSeconds{0.0};
+    // Over the full in-memory curve (EquityPolicy::All); left at 0 for
+    // summary-only runs, thinned curves and Spill, whose curve would have to
+    // be copied back into RAM.
+    RiskMetrics risk;
 };
 
 class Reporter {
 public:
+    // Timestamps in every writer use `timestamps`; epoch formats are written
+    // as JSON numbers. `risk` configures ReportSummary::risk.
+    explicit Reporter(TimestampFormat timestamps = TimestampFormat::Iso8601, RiskMetricsConfig risk = {})
+        : timestamps_(timestamps), risk_(risk) {}
+    TimestampFormat timestampFormat() const { return timestamps_; }
+    const RiskMetricsConfig& riskConfig() const { return risk_; }
+
+    // Win/loss counts come from result.metrics and round-trip figures from
+    // result.ledger; neither replays the trade list. Summary-only results, and
+    // curves recorded with a policy other than EquityPolicy::All, also take
+    // drawdown from result.metrics.
     ReportSummary summarize(const BacktestResult& result) const;
 
-    void writeJson(const BacktestResult& result, const std::string& path) const;
+    // Streams the report (summary, trades, round trips, equity curve) straight
+    // to the file; memory use does not grow with the result.
+    void writeJson(const BacktestResult& result, const std::string& path,
+                   JsonStyle style = JsonStyle::Pretty) const;
     void writeSummaryCsv(const BacktestResult& result, const std::string& path) const;
+    // As above with a summary already computed by summarize(result), so a
+    // caller writing several files summarizes once.
+    void writeJson(const BacktestResult& result, const ReportSummary& summary, const std::string& path,
+                   JsonStyle style = JsonStyle::Pretty) const;
+    void writeSummaryCsv(const ReportSummary& summary, const std::string& path) const;
     void writeTradesCsv(const BacktestResult& result, const std::string& path) const;
+    void writeRoundTripsCsv(const BacktestResult& result, const std::string& path) const;
 
-private:
+    // Write the run's recorded curve (vectors or spill file) as timestamp,equity.
+    void writeEquityCsv(const BacktestResult& result, const std::string& path) const;
+
+    // Write a timestamp,equity series (e.g. a stitched walk-forward curve).
+    void writeEquityCsv(const std::vector<std::chrono::system_clock::time_point>& timestamps,
+                        const std::vector<double>& equity,
+                        const std::string& path) const;
+
+    // ISO-8601 UTC text, e.g. 2024-01-02T03:04:05Z.
     static std::string formatTimestamp(const std::chrono::system_clock::time_point& tp);
+
+private:
+    TimestampFormat timestamps_;
+    RiskMetricsConfig risk_;
 };
 
 } // namespace fastquant
@@ -0,0 +1,279 @@
+#include "ResponseEncoder.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <type_traits>
+#include <zlib.h>
+
+namespace fastquant {
+
+static_assert(std::endian::native == std::endian::little, "columns frames are written in native byte order");
+
+namespace {
+
+std::string lower(std::string_view s) {
+    std::string out(s);
+    std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+// Splits "a;q=0.5, b" into (token, q) pairs, calling fn for each.
+template<typename Fn>
+void forEachListItem(std::string_view header, Fn&& fn) {
+    while (!header.empty()) {
+        const size_t comma = header.find(',');
+        std::string_view item = header.substr(0, comma);
+        header = comma == std::string_view::npos ? std::string_view{} : header.substr(comma + 1);
+        double q = 1.0;
+        const size_t semi = item.find(';');
+        std::string_view token = trim(item.substr(0, semi));
+        if (semi != std::string_view::npos) {
+            std::string params = lower(item.substr(semi + 1));
+            if (const size_t at = params.find("q="); at != std::string::npos) {
+                q = std::atof(params.c_str() + at + 2);
+            }
+        }
+        if (!token.empty()) {
+            fn(lower(token), q);
+        }
+    }
+}
+
+template<typename T>
+void appendRaw(std::string& out, T v) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &v, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void padTo8(std::string& out) {
+    out.append((8 - out.size() % 8) % 8, '\0');
+}
+
+// Appends everything written through it to `out`, so the public operator<<
+// serializes into a string that keeps its capacity between calls.
+class AppendBuf : public std::streambuf {
+public:
+    explicit AppendBuf(std::string& out) : out_(out) {}
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        out_.append(s, static_cast<size_t>(n));
+        return n;
+    }
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            out_.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+private:
+    std::string& out_;
+};
+
+// Compact JSON appended to `out`. operator<< rejects invalid UTF-8, so such
+// bodies fall back to dump() with U+FFFD replacement.
+void appendJson(const nlohmann::json& value, std::string& out) {
+    const size_t start = out.size();
+    try {
+        AppendBuf buf(out);
+        std::ostream os(&buf);
+        os << value;
+    } catch (const nlohmann::json::type_error&) {
+        out.resize(start);
+        out += value.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+    }
+}
+
+} // namespace
+
+ResponseFormat parseResponseFormat(const std::string& name) {
+    const std::string n = lower(name);
+    if (n == "json") return ResponseFormat::Json;
+    if (n == "msgpack") return ResponseFormat::MsgPack;
+    if (n == "cbor") return ResponseFormat::Cbor;
+    if (n == "columns") return ResponseFormat::Columns;
+    throw std::runtime_error("Unknown response format: " + name);
+}
+
+std::string toString(ResponseFormat format) {
+    switch (format) {
+    case ResponseFormat::Json: return "json";
+    case ResponseFormat::MsgPack: return "msgpack";
+    case ResponseFormat::Cbor: return "cbor";
+    case ResponseFormat::Columns: return "columns";
+    }
+    return "json";
+}
+
+const char* contentType(ResponseFormat format) {
+    switch (format) {
+    case ResponseFormat::Json: return "application/json";
+    case ResponseFormat::MsgPack: return "application/msgpack";
+    case ResponseFormat::Cbor: return "application/cbor";
+    case ResponseFormat::Columns: return "application/x-fastquant-columns";
+    }
+    return "application/json";
+}
+
+const char* contentEncoding(ContentCoding coding) {
+    switch (coding) {
+    case ContentCoding::Gzip: return "gzip";
+    case ContentCoding::Deflate: return "deflate";
+    case ContentCoding::Identity: return nullptr;
+    }
+    return nullptr;
+}
+
+ResponseFormat negotiateResponseFormat(std::string_view accept, std::string_view format) {
+    if (!format.empty()) {
+        return parseResponseFormat(std::string(format));
+    }
+    ResponseFormat best = ResponseFormat::Json;
+    double bestQ = 0.0;
+    forEachListItem(accept, [&](const std::string& type, double q) {
+        ResponseFormat f;
+        if (type == "application/msgpack" || type == "application/x-msgpack") f = ResponseFormat::MsgPack;
+        else if (type == "application/cbor") f = ResponseFormat::Cbor;
+        else if (type == "application/x-fastquant-columns") f = ResponseFormat::Columns;
+        else if (type == "application/json") f = ResponseFormat::Json;
+        else return;
+        if (q > bestQ) {
+            best = f;
+            bestQ = q;
+        }
+    });
+    return best;
+}
+
+ContentCoding negotiateContentCoding(std::string_view acceptEncoding) {
+    double gzip = 0.0;
+    double deflate = 0.0;
+    forEachListItem(acceptEncoding, [&](const std::string& coding, double q) {
+        if (coding == "gzip" || coding == "x-gzip") gzip = q;
+        else if (coding == "deflate") deflate = q;
+        else if (coding == "*") {
+            gzip = gzip > 0.0 ? gzip : q;
+            deflate = deflate > 0.0 ? deflate : q;
+        }
+    });
+    if (gzip <= 0.0 && deflate <= 0.0) {
+        return ContentCoding::Identity;
+    }
+    return gzip >= deflate ? ContentCoding::Gzip : ContentCoding::Deflate;
+}
+
+ResponseEncoder::ResponseEncoder(size_t compressThreshold, int level)
+    : threshold_(compressThreshold), level_(level) {}
+
+ResponseEncoder& ResponseEncoder::threadLocal() {
+    thread_local ResponseEncoder encoder;
+    return encoder;
+}
+
+ResponseEncoder::Encoded ResponseEncoder::encode(const nlohmann::json& body, ResponseFormat format, ContentCoding coding,
+                                                 const ResponseColumns* columns) {
+    serialize(body, format, columns);
+    if (coding == ContentCoding::Identity || buffer_.size() < threshold_) {
+        return {buffer_, contentType(format), nullptr};
+    }
+    compress(coding);
+    return {compressed_, contentType(format), contentEncoding(coding)};
+}
+
+void ResponseEncoder::serialize(const nlohmann::json& body, ResponseFormat format, const ResponseColumns* columns) {
+    buffer_.clear();
+    switch (format) {
+    case ResponseFormat::Json:
+        appendJson(body, buffer_);
+        return;
+    case ResponseFormat::MsgPack:
+        nlohmann::json::to_msgpack(body, buffer_);
+        return;
+    case ResponseFormat::Cbor:
+        nlohmann::json::to_cbor(body, buffer_);
+        return;
+    case ResponseFormat::Columns:
+        break;
+    }
+
+    if (!body.is_null() && (!body.is_object() || body.contains("columns"))) {
+        throw std::invalid_argument("Columns responses need an object body without a 'columns' key");
+    }
+    nlohmann::json dir = nlohmann::json::array();
+    uint64_t offset = 0;
+    if (columns) {
+        for (const auto& c : columns->columns()) {
+            std::visit([&](const auto& values) {
+                using T = typename std::decay_t<decltype(values)>::value_type;
+                const char* type = std::is_same_v<T, double> ? "f64" : std::is_same_v<T, int64_t> ? "i64" : "u8";
+                const uint64_t bytes = values.size() * sizeof(T);
+                dir.push_back({{"name", c.name}, {"type", type}, {"rows", values.size()}, {"offset", offset}, {"bytes", bytes}});
+                offset += (bytes + 7) / 8 * 8;
+            }, c.values);
+        }
+    }
+
+    // The header is the body with "columns" appended: the body is written in
+    // place and its closing brace reopened, so it is never copied.
+    buffer_.append("FQRC", 4);
+    appendRaw(buffer_, kColumnsVersion);
+    const size_t sizeAt = buffer_.size();
+    appendRaw(buffer_, uint32_t{0});
+    const size_t headerStart = buffer_.size();
+    if (body.is_object() && !body.empty()) {
+        appendJson(body, buffer_);
+        buffer_.back() = ',';
+    } else {
+        buffer_.push_back('{');
+    }
+    buffer_.append("\"columns\":");
+    appendJson(dir, buffer_);
+    buffer_.push_back('}');
+    const auto headerBytes = static_cast<uint32_t>(buffer_.size() - headerStart);
+    std::memcpy(buffer_.data() + sizeAt, &headerBytes, sizeof(headerBytes));
+    padTo8(buffer_);
+    if (columns) {
+        for (const auto& c : columns->columns()) {
+            std::visit([&](const auto& values) {
+                buffer_.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(values[0]));
+                padTo8(buffer_);
+            }, c.values);
+        }
+    }
+}
+
+void ResponseEncoder::compress(ContentCoding coding) {
+    z_stream zs{};
+    // 15 window bits give a zlib stream ("deflate" in HTTP); +16 a gzip one.
+    const int windowBits = coding == ContentCoding::Gzip ? 15 + 16 : 15;
+    if (deflateInit2(&zs, level_, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("deflateInit2 failed");
+    }
+    compressed_.resize(deflateBound(&zs, static_cast<uLong>(buffer_.size())) + 32);
+    zs.next_in = reinterpret_cast<Bytef*>(buffer_.data());
+    zs.avail_in = static_cast<uInt>(buffer_.size());
+    zs.next_out = reinterpret_cast<Bytef*>(compressed_.data());
+    zs.avail_out = static_cast<uInt>(compressed_.size());
+    const int rc = deflate(&zs, Z_FINISH);
+    const size_t produced = zs.total_out;
+    deflateEnd(&zs);
+    if (rc != Z_STREAM_END) {
+        throw std::runtime_error("deflate failed");
+    }
+    compressed_.resize(produced);
+}
+
+} // namespace fastquant
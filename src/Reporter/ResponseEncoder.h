@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace fastquant {
+
+enum class ResponseFormat { Json, MsgPack, Cbor, Columns };
+enum class ContentCoding { Identity, Gzip, Deflate };
+
+// Accepts "json", "msgpack", "cbor" and "columns". Throws std::runtime_error otherwise.
+ResponseFormat parseResponseFormat(const std::string& name);
+std::string toString(ResponseFormat format);
+const char* contentType(ResponseFormat format);
+// Content-Encoding header value; nullptr for Identity.
+const char* contentEncoding(ContentCoding coding);
+
+// An explicit `format` name wins; otherwise the first media type in `accept`
+// that we produce; otherwise JSON.
+ResponseFormat negotiateResponseFormat(std::string_view accept, std::string_view format = {});
+// gzip or deflate when Accept-Encoding allows it (q > 0), gzip preferred on a tie.
+ContentCoding negotiateContentCoding(std::string_view acceptEncoding);
+
+// Typed arrays shipped beside the body in the Columns format.
+class ResponseColumns {
+public:
+    void add(std::string name, std::vector<double> values) { columns_.push_back({std::move(name), std::move(values)}); }
+    void add(std::string name, std::vector<int64_t> values) { columns_.push_back({std::move(name), std::move(values)}); }
+    void add(std::string name, std::vector<uint8_t> values) { columns_.push_back({std::move(name), std::move(values)}); }
+
+    struct Column {
+        std::string name;
+        std::variant<std::vector<double>, std::vector<int64_t>, std::vector<uint8_t>> values;
+    };
+    const std::vector<Column>& columns() const { return columns_; }
+
+private:
+    std::vector<Column> columns_;
+};
+
+// Serializes response bodies into buffers it keeps between calls, then
+// compresses them when they are at least `compressThreshold` bytes and the
+// client accepts a coding. Use threadLocal() from request handlers: each
+// server thread then reuses its own buffers and nothing is shared.
+//
+// Columns frame (application/x-fastquant-columns, little-endian):
+//   magic "FQRC", u32 version, u32 header bytes, header JSON padded to 8,
+//   then each column's raw values, every block starting on an 8-byte boundary.
+// The header is the body plus "columns": [{name, type, rows, offset, bytes}],
+// offsets counted from the first block; types use ColumnType names
+// ("f64", "i64", "u8") as in ColumnarReport. The body must be an object (or
+// null) without its own "columns" key; encode() throws std::invalid_argument
+// otherwise.
+class ResponseEncoder {
+public:
+    static constexpr size_t kDefaultThreshold = 8 * 1024;
+    static constexpr uint32_t kColumnsVersion = 1;
+
+    // zlib level 1: numeric JSON still shrinks several-fold at a fraction of
+    // the CPU of the default level.
+    explicit ResponseEncoder(size_t compressThreshold = kDefaultThreshold, int level = 1);
+
+    static ResponseEncoder& threadLocal();
+
+    struct Encoded {
+        std::string_view body;          // valid until the next encode() on this encoder
+        const char* contentType;
+        const char* contentEncoding;    // nullptr when sent as is
+    };
+
+    // `columns` is only used by the Columns format.
+    Encoded encode(const nlohmann::json& body, ResponseFormat format, ContentCoding coding,
+                   const ResponseColumns* columns = nullptr);
+
+    size_t compressThreshold() const { return threshold_; }
+
+private:
+    void serialize(const nlohmann::json& body, ResponseFormat format, const ResponseColumns* columns);
+    void compress(ContentCoding coding);
+
+    size_t threshold_;
+    int level_;
+    std::string buffer_;
+    std::string compressed_;
+};
+
+} // namespace fastquant
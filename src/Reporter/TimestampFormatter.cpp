@@ -0,0 +1,89 @@
+#include "TimestampFormatter.h"
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace fastquant {
+
+namespace {
+
+constexpr int64_t kSecondsPerDay = 86400;
+
+int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+void twoDigits(char* out, unsigned value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+}
+
+} // namespace
+
+TimestampFormat parseTimestampFormat(const std::string& name) {
+    if (name == "iso8601") return TimestampFormat::Iso8601;
+    if (name == "epoch_ms") return TimestampFormat::EpochMillis;
+    if (name == "epoch_s") return TimestampFormat::EpochSeconds;
+    throw std::runtime_error("Unknown timestamp format: " + name);
+}
+
+std::string toString(TimestampFormat format) {
+    switch (format) {
+        case TimestampFormat::Iso8601: return "iso8601";
+        case TimestampFormat::EpochMillis: return "epoch_ms";
+        case TimestampFormat::EpochSeconds: return "epoch_s";
+    }
+    return "iso8601";
+}
+
+int64_t TimestampFormatter::epoch(std::chrono::system_clock::time_point tp) const {
+    if (format_ == TimestampFormat::EpochMillis) {
+        return std::chrono::floor<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+    }
+    return std::chrono::floor<std::chrono::seconds>(tp.time_since_epoch()).count();
+}
+
+size_t TimestampFormatter::write(std::chrono::system_clock::time_point tp, char* out) {
+    const int64_t seconds = epoch(tp);
+    if (numeric()) {
+        auto [end, ec] = std::to_chars(out, out + kMaxLength, seconds);
+        (void)ec;
+        return static_cast<size_t>(end - out);
+    }
+
+    const int64_t day = floorDiv(seconds, kSecondsPerDay);
+    if (day != cachedDay_) {
+        const std::chrono::year_month_day ymd{std::chrono::sys_days{std::chrono::days{day}}};
+        const int year = static_cast<int>(ymd.year());
+        char* p = prefix_;
+        if (year >= 0 && year <= 9999) {
+            twoDigits(p, static_cast<unsigned>(year / 100));
+            twoDigits(p + 2, static_cast<unsigned>(year % 100));
+            p += 4;
+        } else {
+            p = std::to_chars(p, prefix_ + 7, year).ptr;
+        }
+        *p++ = '-';
+        twoDigits(p, static_cast<unsigned>(ymd.month()));
+        p[2] = '-';
+        twoDigits(p + 3, static_cast<unsigned>(ymd.day()));
+        p[5] = 'T';
+        prefixLength_ = static_cast<size_t>(p + 6 - prefix_);
+        cachedDay_ = day;
+    }
+
+    const auto secondOfDay = static_cast<unsigned>(seconds - day * kSecondsPerDay);
+    std::memcpy(out, prefix_, prefixLength_);
+    char* p = out + prefixLength_;
+    twoDigits(p, secondOfDay / 3600);
+    p[2] = ':';
+    twoDigits(p + 3, secondOfDay / 60 % 60);
+    p[5] = ':';
+    twoDigits(p + 6, secondOfDay % 60);
+    p[8] = 'Z';
+    return prefixLength_ + 9;
+}
+
+} // namespace fastquant
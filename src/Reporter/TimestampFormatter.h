@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace fastquant {
+
+enum class TimestampFormat {
+    Iso8601,      // 2024-01-02T03:04:05Z (UTC, whole seconds)
+    EpochMillis,  // milliseconds since the Unix epoch
+    EpochSeconds  // seconds since the Unix epoch
+};
+
+// Accepts "iso8601", "epoch_ms" and "epoch_s". Throws std::runtime_error otherwise.
+TimestampFormat parseTimestampFormat(const std::string& name);
+std::string toString(TimestampFormat format);
+
+// Formats report timestamps without gmtime or streams. The Y-m-d prefix is
+// cached per UTC day and H:M:S is computed arithmetically, so consecutive bars
+// of intraday data cost a few divisions each. Not thread-safe: use one
+// formatter per writer/thread.
+class TimestampFormatter {
+public:
+    static constexpr size_t kMaxLength = 32;
+
+    explicit TimestampFormatter(TimestampFormat format = TimestampFormat::Iso8601) : format_(format) {}
+
+    TimestampFormat format() const { return format_; }
+    bool numeric() const { return format_ != TimestampFormat::Iso8601; }
+
+    // Whole milliseconds or seconds since the epoch (seconds for Iso8601),
+    // rounded toward negative infinity.
+    int64_t epoch(std::chrono::system_clock::time_point tp) const;
+
+    // Text form into `out` (at least kMaxLength bytes); returns its length.
+    size_t write(std::chrono::system_clock::time_point tp, char* out);
+
+    // Text form in an internal buffer, valid until the next call.
+    std::string_view operator()(std::chrono::system_clock::time_point tp) {
+        return {buffer_, write(tp, buffer_)};
+    }
+
+private:
+    TimestampFormat format_;
+    int64_t cachedDay_{std::numeric_limits<int64_t>::min()};
+    char prefix_[16]{};   // "YYYY-MM-DDT"
+    size_t prefixLength_{0};
+    char buffer_[kMaxLength]{};
+};
+
+} // namespace fastquant
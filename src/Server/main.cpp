@@ -1,10 +1,17 @@
 #include "../DataLoader/CSVDataLoader.h"
 #include "../DataLoader/APIDataLoader.h"
 #include "../BacktestEngine/BacktestEngine.h"
-#include "../Strategy/MovingAverageStrategy.h"
-#include "../Strategy/BreakoutStrategy.h"
 #include "../Reporter/Reporter.h"
+#include "../Reporter/ColumnarReport.h"
+#include "../Reporter/EquityQuery.h"
+#include "../Reporter/ResponseEncoder.h"
+#include "../DataLoader/TimestampParser.h"
 #include "../App/RunConfig.h"
+#include "../App/JobQueue.h"
+#include "../App/DatasetRegistry.h"
+#include "../App/ProgressStream.h"
+#include "../App/ResultCache.h"
+#include "../App/Metrics.h"
 
 // #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include "httplib.h"
@@ -12,24 +19,472 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <mutex>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <span>
 
 using json = nlohmann::json;
 using namespace fastquant;
 
-// Global state for the session
-// In a real production server, this would be per-session or in a database.
-// For this local tool, a global variable is acceptable.
-std::vector<Candle> g_loadedCandles;
-std::mutex g_dataMutex;
+// Pins the snapshot named by "dataset" (default "default") for one run.
+static app::DatasetHandle requestedDataset(const app::DatasetRegistry& datasets, const json& j) {
+    const std::string name = j.value("dataset", std::string("default"));
+    auto data = datasets.get(name);
+    if (!data || data->candles.empty()) {
+        throw std::runtime_error("No data loaded for dataset '" + name + "'. Please call /load-data first.");
+    }
+    return data;
+}
+
+static json datasetJson(const app::DatasetSnapshot& d) {
+    json out{{"name", d.name}, {"version", d.version}, {"rows", d.candles.size()}, {"source", d.source}};
+    if (!d.candles.empty()) {
+        out["symbol"] = d.candles.front().symbol;
+    }
+    return out;
+}
+
+// Strategy from the request body: "Breakout" (lookback, threshold), else MA
+// (period). As a StrategyConfig so that runs can be keyed for the ResultCache.
+static app::StrategyConfig requestedStrategy(const json& j) {
+    app::StrategyConfig cfg;
+    std::string strategyType = j.value("strategyType", "MA");
+    cfg.name = strategyType;
+    if (strategyType == "Breakout") {
+        cfg.type = "breakout";
+        cfg.breakoutLookback = j.value("lookback", 20);
+        cfg.breakoutBuffer = j.value("threshold", 0.0);
+        return cfg;
+    }
+    int period = j.value("period", 20);
+    cfg.type = "moving_average";
+    cfg.longWindow = period;
+    cfg.shortWindow = std::max(1, period / 4);
+    return cfg;
+}
+
+static ExecutionConfig serverExecutionConfig() {
+    // Configure engine (simplified)
+    ExecutionConfig execCfg;
+    execCfg.defaultSlippageBps = 5; // Example default
+    return execCfg;
+}
+
+static constexpr double kServerCapital = 100000.0;
+
+static app::ResultKey serverResultKey(const app::DatasetSnapshot& data, const app::StrategyConfig& strategy) {
+    return app::makeResultKey(data.fingerprint, strategy, serverExecutionConfig(), kServerCapital);
+}
+
+// Latency buckets, 1 ms to ~65 s.
+static const std::vector<double> kSecondsBuckets = app::exponentialBuckets(0.001, 2.0, 17);
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Engine runs behind one route ("mode"): wall time, candles simulated and
+// per-run throughput. Cached answers never get here.
+struct BacktestMetrics {
+    app::Histogram& duration;
+    app::Histogram& throughput;
+    app::Counter& candles;
+
+    BacktestMetrics(app::MetricsRegistry& metrics, const std::string& mode)
+        : duration(metrics.histogram("fastquant_backtest_duration_seconds", "Engine run wall time.",
+                                     kSecondsBuckets, {{"mode", mode}})),
+          throughput(metrics.histogram("fastquant_engine_candles_per_second", "Candles per second of each engine run.",
+                                       app::exponentialBuckets(1e4, 2.0, 15), {{"mode", mode}})),
+          candles(metrics.counter("fastquant_engine_candles_total", "Candles simulated by the engine.", {{"mode", mode}})) {}
+};
+
+// /load-data per "source" label: load or fetch wall time and candles loaded.
+struct LoaderMetrics {
+    app::Histogram& duration;
+    app::Counter& rows;
+
+    LoaderMetrics(app::MetricsRegistry& metrics, const std::string& source)
+        : duration(metrics.histogram("fastquant_loader_duration_seconds", "Time to load or fetch a dataset.",
+                                     kSecondsBuckets, {{"source", source}})),
+          rows(metrics.counter("fastquant_loader_rows_total", "Candles loaded.", {{"source", source}})) {}
+};
+
+// Full run of `strategy` over the pinned dataset, with optional control/observer.
+static BacktestResult runServerBacktest(const app::DatasetSnapshot& data, const app::StrategyConfig& strategy,
+                                        const BacktestMetrics& metrics,
+                                        RunControl* control = nullptr, RunObserver* observer = nullptr) {
+    auto instance = app::buildStrategy(strategy);
+    BacktestEngine engine;
+    engine.setExecutionConfig(serverExecutionConfig());
+    engine.setRunControl(control);
+    engine.setObserver(observer);
+    const auto start = std::chrono::steady_clock::now();
+    BacktestResult result = engine.run(std::span<const Candle>(data.candles), *instance, kServerCapital);
+    const double seconds = secondsSince(start);
+    metrics.duration.observe(seconds);
+    metrics.candles.inc(result.candlesProcessed);
+    if (seconds > 0.0) {
+        metrics.throughput.observe(static_cast<double>(result.candlesProcessed) / seconds);
+    }
+    return result;
+}
+
+// Resident set size from /proc (Linux); nothing elsewhere.
+static std::vector<app::MetricSample> residentMemory() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return {{{}, std::stod(line.substr(6)) * 1024.0}};
+        }
+    }
+    return {};
+}
+
+// Gauges and counters read from the server's components at scrape time.
+static void registerSampledMetrics(app::MetricsRegistry& metrics, const app::DatasetRegistry& datasets,
+                                   const app::JobQueue& jobs, const app::ResultCache& cache) {
+    metrics.sampled("fastquant_dataset_rows", "Candles in the current version of each dataset.", app::MetricType::Gauge, [&datasets] {
+        std::vector<app::MetricSample> out;
+        for (const auto& d : datasets.list()) {
+            out.push_back({{{"dataset", d->name}}, static_cast<double>(d->candles.size())});
+        }
+        return out;
+    });
+    metrics.sampled("fastquant_dataset_bytes", "Approximate memory held by each dataset's candles.", app::MetricType::Gauge, [&datasets] {
+        std::vector<app::MetricSample> out;
+        for (const auto& d : datasets.list()) {
+            out.push_back({{{"dataset", d->name}}, static_cast<double>(d->candles.capacity() * sizeof(Candle))});
+        }
+        return out;
+    });
+    metrics.sampled("fastquant_jobs", "Background jobs by state.", app::MetricType::Gauge, [&jobs] {
+        const auto depth = jobs.depth();
+        return std::vector<app::MetricSample>{
+            {{{"state", "queued"}}, static_cast<double>(depth.queued)},
+            {{{"state", "running"}}, static_cast<double>(depth.running)}
+        };
+    });
+    metrics.sampled("fastquant_result_cache_hits_total", "Result cache hits by tier.", app::MetricType::Counter, [&cache] {
+        const auto s = cache.stats();
+        return std::vector<app::MetricSample>{
+            {{{"tier", "memory"}}, static_cast<double>(s.hits - s.diskHits)},
+            {{{"tier", "disk"}}, static_cast<double>(s.diskHits)}
+        };
+    });
+    metrics.sampled("fastquant_result_cache_misses_total", "Result cache misses.", app::MetricType::Counter, [&cache] {
+        return std::vector<app::MetricSample>{{{}, static_cast<double>(cache.stats().misses)}};
+    });
+    metrics.sampled("fastquant_result_cache_evictions_total", "Results evicted from memory.", app::MetricType::Counter, [&cache] {
+        return std::vector<app::MetricSample>{{{}, static_cast<double>(cache.stats().evictions)}};
+    });
+    metrics.sampled("fastquant_result_cache_hit_ratio", "Hits over lookups since start.", app::MetricType::Gauge, [&cache] {
+        const auto s = cache.stats();
+        const uint64_t lookups = s.hits + s.misses;
+        return std::vector<app::MetricSample>{{{}, lookups ? static_cast<double>(s.hits) / static_cast<double>(lookups) : 0.0}};
+    });
+    metrics.sampled("fastquant_result_cache_entries", "Results held in memory.", app::MetricType::Gauge, [&cache] {
+        return std::vector<app::MetricSample>{{{}, static_cast<double>(cache.stats().entries)}};
+    });
+    metrics.sampled("fastquant_result_cache_bytes", "Approximate memory held by cached results.", app::MetricType::Gauge, [&cache] {
+        return std::vector<app::MetricSample>{{{}, static_cast<double>(cache.stats().bytes)}};
+    });
+    metrics.sampled("process_resident_memory_bytes", "Resident memory size in bytes.", app::MetricType::Gauge, residentMemory);
+}
+
+// Timestamps: epoch seconds by default, "epoch_ms" or "iso8601" on request
+static TimestampFormat requestedTimeFormat(const std::string& value) {
+    return parseTimestampFormat(value.empty() ? std::string("epoch_s") : value);
+}
+
+// Range bounds accept epoch seconds, epoch milliseconds or ISO-8601, like the CSV loader.
+static std::optional<std::chrono::system_clock::time_point> parseRangeBound(const std::string& value, const char* name) {
+    if (value.empty()) {
+        return std::nullopt;
+    }
+    std::chrono::system_clock::time_point tp;
+    if (!parseTimestamp(value, tp)) {
+        throw std::runtime_error(std::string("Invalid '") + name + "' bound: " + value);
+    }
+    return tp;
+}
+
+// "max_points", "from" and "to" from a JSON body.
+static EquityQuery equityQueryFromJson(const json& j) {
+    auto bound = [&](const char* key) -> std::string {
+        if (!j.contains(key) || j[key].is_null()) {
+            return {};
+        }
+        return j[key].is_string() ? j[key].get<std::string>() : j[key].dump();
+    };
+    EquityQuery query;
+    query.maxPoints = j.value("max_points", size_t{0});
+    query.from = parseRangeBound(bound("from"), "from");
+    query.to = parseRangeBound(bound("to"), "to");
+    return query;
+}
+
+// The same fields as query parameters, for GET /jobs/{id}/result.
+static EquityQuery equityQueryFromParams(const httplib::Request& req) {
+    auto param = [&](const char* key) {
+        return req.has_param(key) ? req.get_param_value(key) : std::string();
+    };
+    EquityQuery query;
+    if (auto maxPoints = param("max_points"); !maxPoints.empty()) {
+        query.maxPoints = std::stoull(maxPoints);
+    }
+    query.from = parseRangeBound(param("from"), "from");
+    query.to = parseRangeBound(param("to"), "to");
+    return query;
+}
+
+// ?format= (or "format" in a JSON body) wins over the Accept header.
+static ResponseFormat requestedFormat(const httplib::Request& req, const json* body = nullptr) {
+    std::string name = req.has_param("format") ? req.get_param_value("format") : std::string();
+    if (name.empty() && body) {
+        name = body->value("format", std::string());
+    }
+    return negotiateResponseFormat(req.get_header_value("Accept"), name);
+}
+
+// Serializes into this thread's reusable buffers, compressed when large
+// enough and the client accepts gzip or deflate.
+static void sendEncoded(const httplib::Request& req, httplib::Response& res, const json& body,
+                        ResponseFormat format, const ResponseColumns* columns = nullptr) {
+    auto encoded = ResponseEncoder::threadLocal().encode(
+        body, format, negotiateContentCoding(req.get_header_value("Accept-Encoding")), columns);
+    if (encoded.contentEncoding) {
+        res.set_header("Content-Encoding", encoded.contentEncoding);
+    }
+    res.set_header("Vary", "Accept, Accept-Encoding");
+    res.set_content(encoded.body.data(), encoded.body.size(), encoded.contentType);
+}
+
+// Shared by /run-backtest, /jobs/{id}/result and the final event of
+// /run-backtest/stream, which leaves out the series it already streamed.
+// `equity` picks the curve points to send (range and LTTB point budget).
+// With `columns`, equityCurve and recentTrades go there as typed arrays
+// (times as epoch numbers, milliseconds for iso8601) instead of JSON.
+static json backtestResponse(const BacktestResult& result, const std::string& strategyType, TimestampFormatter& formatter,
+                             bool includeSeries = true, const EquityQuery& equity = {},
+                             ResponseColumns* columns = nullptr) {
+    json response;
+    response["strategy"] = strategyType;
+    response["trades"] = result.trades.size();
+    
+    // Win rate over round trips from the engine's ledger
+    const auto& ledger = result.ledger;
+    response["roundTrips"] = ledger.stats().roundTrips;
+    response["winRate"] = ledger.stats().winRate();
+    response["profitFactor"] = ledger.stats().profitFactor();
+    
+    // Total Profit (Realized + Unrealized usually, but let's use realized for simplicity or portfolio equity)
+    // BacktestResult has equityCurve, let's use the final equity - initial capital
+    if (!result.equityCurve.empty()) {
+        response["totalProfit"] = result.equityCurve.back() - result.initialCapital;
+    } else {
+        response["totalProfit"] = 0.0;
+    }
+
+    // Risk metrics over the full curve; maxDrawdown is a fraction of the peak
+    const RiskMetrics risk = computeRiskMetrics(result.equityCurve, result.equityTimestamps);
+    response["maxDrawdown"] = risk.maxDrawdown;
+    response["risk"] = {
+        {"periodsPerYear", risk.periodsPerYear},
+        {"annualizedReturn", risk.annualizedReturn},
+        {"annualizedVolatility", risk.annualizedVolatility},
+        {"sharpe", risk.sharpe},
+        {"sortino", risk.sortino},
+        {"calmar", risk.calmar},
+        {"maxDrawdownDuration", risk.maxDrawdownDuration},
+        {"maxDrawdownDurationSeconds", risk.maxDrawdownDurationSeconds},
+        {"rollingVolatility", risk.rollingVolatility},
+        {"maxRollingVolatility", risk.maxRollingVolatility},
+        {"valueAtRisk", risk.valueAtRisk},
+        {"expectedShortfall", risk.expectedShortfall},
+        {"skewness", risk.skewness},
+        {"excessKurtosis", risk.excessKurtosis},
+        {"bestReturn", risk.bestReturn},
+        {"worstReturn", risk.worstReturn}
+    };
+
+    auto stamp = [&](std::chrono::system_clock::time_point tp) -> json {
+        if (formatter.numeric()) {
+            return formatter.epoch(tp);
+        }
+        return std::string(formatter(tp));
+    };
+
+    auto epoch = [&](std::chrono::system_clock::time_point tp) -> int64_t {
+        return formatter.numeric()
+            ? formatter.epoch(tp)
+            : std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+    };
+
+    if (includeSeries && columns) {
+        const EquitySelection selection = selectEquityPoints(result.equityTimestamps, result.equityCurve, equity);
+        std::vector<int64_t> times;
+        std::vector<double> values;
+        times.reserve(selection.indices.size());
+        values.reserve(selection.indices.size());
+        for (size_t i : selection.indices) {
+            times.push_back(i < result.equityTimestamps.size() ? epoch(result.equityTimestamps[i]) : 0);
+            values.push_back(result.equityCurve[i]);
+        }
+        response["equityPoints"] = {
+            {"total", result.equityCurve.size()},
+            {"inRange", selection.inRange},
+            {"returned", values.size()}
+        };
+        columns->add("equityCurve.time", std::move(times));
+        columns->add("equityCurve.value", std::move(values));
+
+        // Newest first, as in the JSON list; side is 0 for BUY, 1 for SELL
+        std::vector<int64_t> dates;
+        std::vector<uint8_t> sides;
+        std::vector<double> prices, qtys, pnls;
+        const auto fillPnl = ledger.fillPnl(result.trades);
+        const size_t tradeCount = result.trades.size();
+        const size_t startIdx = tradeCount > 50 ? tradeCount - 50 : 0;
+        for (size_t i = tradeCount; i-- > startIdx;) {
+            const auto& t = result.trades[i];
+            dates.push_back(epoch(t.timestamp));
+            sides.push_back(t.side == Side::Buy ? 0 : 1);
+            prices.push_back(t.price);
+            qtys.push_back(t.qty);
+            pnls.push_back(fillPnl[i]);
+        }
+        columns->add("recentTrades.date", std::move(dates));
+        columns->add("recentTrades.side", std::move(sides));
+        columns->add("recentTrades.price", std::move(prices));
+        columns->add("recentTrades.qty", std::move(qtys));
+        columns->add("recentTrades.pnl", std::move(pnls));
+    } else if (includeSeries) {
+        // Equity Curve for Chart
+        const EquitySelection selection = selectEquityPoints(result.equityTimestamps, result.equityCurve, equity);
+        std::vector<json> equityData;
+        equityData.reserve(selection.indices.size());
+        for (size_t i : selection.indices) {
+            json ts = 0;
+            if (i < result.equityTimestamps.size()) {
+                ts = stamp(result.equityTimestamps[i]);
+            }
+            equityData.push_back({{"time", std::move(ts)}, {"value", result.equityCurve[i]}});
+        }
+        response["equityCurve"] = equityData;
+        response["equityPoints"] = {
+            {"total", result.equityCurve.size()},
+            {"inRange", selection.inRange},
+            {"returned", equityData.size()}
+        };
+
+        // Recent Trades List (Last 50); pnl is what the fill realized, 0 for openings
+        std::vector<json> recentTrades;
+        const auto fillPnl = ledger.fillPnl(result.trades);
+        size_t tradeCount = result.trades.size();
+        size_t startIdx = tradeCount > 50 ? tradeCount - 50 : 0;
+        
+        for (size_t i = startIdx; i < tradeCount; ++i) {
+            const auto& t = result.trades[i];
+            recentTrades.push_back({
+                {"date", stamp(t.timestamp)},
+                {"type", t.side == Side::Buy ? "BUY" : "SELL"},
+                {"price", t.price},
+                {"qty", t.qty},
+                {"pnl", fillPnl[i]}
+            });
+        }
+        // Reverse to show newest first
+        std::reverse(recentTrades.begin(), recentTrades.end());
+        response["recentTrades"] = recentTrades;
+    }
+
+    // Recent Round Trips (Last 50), with PnL attributed by the ledger
+    std::vector<json> recentRoundTrips;
+    const auto& trips = ledger.roundTrips();
+    size_t tripStart = trips.size() > 50 ? trips.size() - 50 : 0;
+    for (size_t i = trips.size(); i-- > tripStart;) {
+        const auto& rt = trips[i];
+        recentRoundTrips.push_back({
+            {"side", rt.side == Side::Buy ? "LONG" : "SHORT"},
+            {"entryDate", stamp(rt.entryTime)},
+            {"exitDate", stamp(rt.exitTime)},
+            {"entryPrice", rt.entryPrice},
+            {"exitPrice", rt.exitPrice},
+            {"qty", rt.qty},
+            {"pnl", rt.pnl},
+            {"mae", rt.mae},
+            {"mfe", rt.mfe},
+            {"holdingSeconds", rt.holdingSeconds()}
+        });
+    }
+    response["recentRoundTrips"] = recentRoundTrips;
+    return response;
+}
+
+static json jobStatusJson(const app::JobStatus& s) {
+    json out{
+        {"id", s.id},
+        {"strategy", s.label},
+        {"status", app::toString(s.state)},
+        {"candlesProcessed", s.candlesProcessed},
+        {"totalCandles", s.totalCandles},
+        {"progress", s.progress}
+    };
+    if (s.state == app::JobState::Failed) {
+        out["error"] = s.error;
+    }
+    return out;
+}
 
 int main() {
+    // Loaded datasets; runs pin a snapshot and never copy the candles.
+    app::DatasetRegistry datasets;
+    // Served on /metrics. Handlers only touch per-thread counter slots;
+    // a scrape sums them and samples the components registered below.
+    // Declared before the job queue, whose workers record into it.
+    app::MetricsRegistry metrics;
+    const BacktestMetrics syncRuns(metrics, "sync");
+    const BacktestMetrics streamRuns(metrics, "stream");
+    const BacktestMetrics jobRuns(metrics, "job");
+    const LoaderMetrics csvLoads(metrics, "csv");
+    const LoaderMetrics apiLoads(metrics, "api");
+    // Background runs for /jobs: two at a time, up to 16 waiting.
+    app::JobQueue jobs;
+    // Finished runs by dataset content and parameters, shared by every route;
+    // FASTQUANT_RESULT_CACHE_DIR also keeps them on disk across restarts.
+    app::ResultCache& resultCache = app::ResultCache::shared();
+    if (const char* dir = std::getenv("FASTQUANT_RESULT_CACHE_DIR"); dir && *dir) {
+        app::ResultCacheConfig cacheCfg = resultCache.config();
+        cacheCfg.directory = dir;
+        resultCache.configure(cacheCfg);
+    }
+    registerSampledMetrics(metrics, datasets, jobs, resultCache);
     httplib::Server svr;
 
+    // Latency and 5xx count per route, recorded around each handler. Streaming
+    // responses are timed up to the start of the stream.
+    auto timed = [&metrics](const std::string& method, const std::string& route, httplib::Server::Handler handler) {
+        const app::MetricLabels labels{{"method", method}, {"route", route}};
+        auto& latency = metrics.histogram("fastquant_http_request_duration_seconds", "Request handling time by route.",
+                                          kSecondsBuckets, labels);
+        auto& errors = metrics.counter("fastquant_http_request_errors_total", "Requests answered with a 5xx status.", labels);
+        return [&latency, &errors, handler = std::move(handler)](const httplib::Request& req, httplib::Response& res) {
+            const auto start = std::chrono::steady_clock::now();
+            handler(req, res);
+            latency.observe(secondsSince(start));
+            if (res.status >= 500) {
+                errors.inc();
+            }
+        };
+    };
+
     // CORS headers to allow browser fetch
     auto set_cors = [](httplib::Response& res) {
         res.set_header("Access-Control-Allow-Origin", "*");
-        res.set_header("Access-Control-Allow-Methods", "POST, GET, OPTIONS");
+        res.set_header("Access-Control-Allow-Methods", "POST, GET, DELETE, OPTIONS");
         res.set_header("Access-Control-Allow-Headers", "Content-Type");
     };
 
@@ -48,7 +503,7 @@ int main() {
     });
 
     // Endpoint: /list-examples
-    svr.Get("/list-examples", [&](const httplib::Request&, httplib::Response& res) {
+    svr.Get("/list-examples", timed("GET", "/list-examples", [&](const httplib::Request&, httplib::Response& res) {
         set_cors(res);
         // Hardcoded list for now since we can't easily scan directories cross-platform without std::filesystem (C++17)
         // or platform specific code. Assuming standard examples folder structure.
@@ -58,15 +513,20 @@ int main() {
         };
         json response = files;
         res.set_content(response.dump(), "application/json");
-    });
+    }));
 
     // Endpoint: /load-data
-    svr.Post("/load-data", [&](const httplib::Request& req, httplib::Response& res) {
+    // Publishes the loaded candles as a new version of "name" (default
+    // "default"). Runs already using the previous version keep it.
+    svr.Post("/load-data", timed("POST", "/load-data", [&](const httplib::Request& req, httplib::Response& res) {
         set_cors(res);
         try {
             auto j = json::parse(req.body);
             std::string source = j.value("source", "csv");
+            std::string name = j.value("name", std::string("default"));
             std::vector<Candle> newCandles;
+            std::string origin;
+            const auto loadStart = std::chrono::steady_clock::now();
 
             if (source == "api") {
                 std::string symbol = j.value("symbol", "BTCUSDT");
@@ -93,6 +553,7 @@ int main() {
 
                 APIDataLoader loader(std::make_unique<CurlHttpClient>());
                 newCandles = loader.fetch(cfg);
+                origin = "api:" + symbol + ":" + interval;
             } else {
                 std::string path = j.value("path", "");
                 if (path.empty()) {
@@ -100,139 +561,294 @@ int main() {
                 }
                 CSVDataLoader loader;
                 newCandles = loader.load(path);
+                origin = path;
             }
 
-            // Load all data into memory for the server session
-            std::lock_guard<std::mutex> lock(g_dataMutex);
-            g_loadedCandles = newCandles; 
-
-            json response;
-            response["rows"] = g_loadedCandles.size();
-            if (!g_loadedCandles.empty()) {
-                // Simple timestamp formatting or just raw count
-                // Assuming Candle has a timestamp field which is a time_point
-                // We can just return the count and maybe the symbol of the first candle
-                response["symbol"] = g_loadedCandles.front().symbol;
-                // TODO: Format dates if needed, for now just returning basic info
-            }
-            
-            res.set_content(response.dump(), "application/json");
+            const LoaderMetrics& loads = source == "api" ? apiLoads : csvLoads;
+            loads.duration.observe(secondsSince(loadStart));
+            loads.rows.inc(newCandles.size());
+            auto published = datasets.publish(std::move(name), std::move(newCandles), std::move(origin));
+            res.set_content(datasetJson(*published).dump(), "application/json");
         } catch (const std::exception& e) {
             res.status = 500;
             res.set_content(json{{"error", e.what()}}.dump(), "application/json");
         }
-    });
+    }));
+
+    // Endpoint: GET /datasets
+    svr.Get("/datasets", timed("GET", "/datasets", [&](const httplib::Request&, httplib::Response& res) {
+        set_cors(res);
+        json response = json::array();
+        for (const auto& d : datasets.list()) {
+            response.push_back(datasetJson(*d));
+        }
+        res.set_content(response.dump(), "application/json");
+    }));
+
+    // Endpoint: DELETE /datasets/{name}
+    // Drops the name; runs that pinned it finish on their snapshot.
+    svr.Delete(R"(/datasets/([^/]+))", timed("DELETE", "/datasets/{name}", [&](const httplib::Request& req, httplib::Response& res) {
+        set_cors(res);
+        if (!datasets.remove(req.matches[1])) {
+            res.status = 404;
+            res.set_content(json{{"error", "Unknown dataset"}}.dump(), "application/json");
+            return;
+        }
+        res.status = 204;
+    }));
 
     // Endpoint: /run-backtest
-    svr.Post("/run-backtest", [&](const httplib::Request& req, httplib::Response& res) {
+    // Optional "max_points" (LTTB) and "from"/"to" bound the equity curve
+    // returned; zooming clients re-query a range at full detail.
+    svr.Post("/run-backtest", timed("POST", "/run-backtest", [&](const httplib::Request& req, httplib::Response& res) {
         set_cors(res);
         try {
             auto j = json::parse(req.body);
-            std::vector<Candle> candles;
-            {
-                std::lock_guard<std::mutex> lock(g_dataMutex);
-                if (g_loadedCandles.empty()) {
-                    throw std::runtime_error("No data loaded. Please call /load-data first.");
-                }
-                candles = g_loadedCandles; // Copy for thread safety during run if we were async
-            }
+            // Pinned for the whole run; /load-data may publish a newer version meanwhile.
+            app::DatasetHandle data = requestedDataset(datasets, j);
 
-            // Setup Strategy
-            std::unique_ptr<Strategy> strategy;
             std::string strategyType = j.value("strategyType", "MA");
+            const app::StrategyConfig strategy = requestedStrategy(j);
 
-            if (strategyType == "Breakout") {
-                int lookback = j.value("lookback", 20);
-                double threshold = j.value("threshold", 0.0);
-                strategy = std::make_unique<BreakoutStrategy>(lookback, threshold);
-            } else {
-                int period = j.value("period", 20);
-                int longWindow = period;
-                int shortWindow = std::max(1, period / 4);
-                strategy = std::make_unique<MovingAverageStrategy>(shortWindow, longWindow);
+            bool cached = false;
+            auto result = resultCache.getOrRun(serverResultKey(*data, strategy), [&] {
+                return runServerBacktest(*data, strategy, syncRuns);
+            }, &cached);
+
+            TimestampFormatter formatter(requestedTimeFormat(j.value("timeFormat", std::string())));
+            const ResponseFormat format = requestedFormat(req, &j);
+            ResponseColumns columns;
+            json response = backtestResponse(*result, strategyType, formatter, true, equityQueryFromJson(j),
+                                             format == ResponseFormat::Columns ? &columns : nullptr);
+            response["dataset"] = data->name;
+            response["datasetVersion"] = data->version;
+            response["cached"] = cached;
+            sendEncoded(req, res, response, format, &columns);
+        } catch (const std::exception& e) {
+            res.status = 500;
+            res.set_content(json{{"error", e.what()}}.dump(), "application/json");
+        }
+    }));
+
+    // Endpoint: /run-backtest/stream
+    // Same body as /run-backtest, answered as Server-Sent Events: "progress"
+    // events with thinned equity points and recent trades while the engine
+    // runs, then one "result" event with the summary (no curve or trade list).
+    // The run is cancelled if the client disconnects. A cached result is sent
+    // as the "result" event straight away, without progress events.
+    svr.Post("/run-backtest/stream", timed("POST", "/run-backtest/stream", [&](const httplib::Request& req, httplib::Response& res) {
+        set_cors(res);
+        try {
+            auto j = json::parse(req.body);
+            app::DatasetHandle data = requestedDataset(datasets, j);
+            std::string strategyType = j.value("strategyType", "MA");
+            const app::StrategyConfig strategy = requestedStrategy(j);
+            app::ProgressStreamConfig streamCfg;
+            streamCfg.timeFormat = requestedTimeFormat(j.value("timeFormat", std::string()));
+            streamCfg.maxEquityPoints = j.value("max_points", streamCfg.maxEquityPoints);
+
+            res.set_header("Cache-Control", "no-cache");
+            res.set_chunked_content_provider("text/event-stream",
+                [data, strategy, strategyType, streamCfg, streamRuns](size_t, httplib::DataSink& sink) {
+                    RunControl control;
+                    app::ProgressStream stream(
+                        [&sink](std::string_view chunk) { return sink.write(chunk.data(), chunk.size()); },
+                        data->candles.size(), streamCfg, &control);
+                    try {
+                        auto& cache = app::ResultCache::shared();
+                        const app::ResultKey key = serverResultKey(*data, strategy);
+                        auto result = cache.find(key);
+                        const bool cached = result != nullptr;
+                        if (!cached) {
+                            result = cache.insert(key, runServerBacktest(*data, strategy, streamRuns, &control, &stream));
+                        }
+                        if (!result->cancelled) {
+                            TimestampFormatter formatter(streamCfg.timeFormat);
+                            json response = backtestResponse(*result, strategyType, formatter, false);
+                            response["dataset"] = data->name;
+                            response["datasetVersion"] = data->version;
+                            response["cached"] = cached;
+                            stream.send("result", response.dump());
+                        }
+                    } catch (const std::exception& e) {
+                        stream.send("error", json{{"error", e.what()}}.dump());
+                    }
+                    sink.done();
+                    return true;
+                });
+        } catch (const std::exception& e) {
+            res.status = 500;
+            res.set_content(json{{"error", e.what()}}.dump(), "application/json");
+        }
+    }));
+
+    // Endpoint: POST /jobs
+    // Same body as /run-backtest; the run happens on the job queue and the
+    // response carries the id to poll. 429 when the queue is full. Cached
+    // results still go through the queue but finish without running.
+    svr.Post("/jobs", timed("POST", "/jobs", [&](const httplib::Request& req, httplib::Response& res) {
+        set_cors(res);
+        try {
+            auto j = json::parse(req.body);
+            app::DatasetHandle data = requestedDataset(datasets, j);
+            std::string strategyType = j.value("strategyType", "MA");
+            const app::StrategyConfig strategy = requestedStrategy(j);
+            auto id = jobs.submit(strategyType, data->candles.size(),
+                [data, strategy, &resultCache, &jobRuns](RunControl& control) {
+                    const app::ResultKey key = serverResultKey(*data, strategy);
+                    if (auto hit = resultCache.find(key)) {
+                        return hit->clone();
+                    }
+                    return resultCache.insert(key, runServerBacktest(*data, strategy, jobRuns, &control))->clone();
+                });
+            if (!id) {
+                res.status = 429;
+                res.set_header("Retry-After", "1");
+                res.set_content(json{{"error", "Job queue is full"}}.dump(), "application/json");
+                return;
             }
-            
-            // Setup Engine
-            BacktestEngine engine;
-            // Configure engine (simplified)
-            ExecutionConfig execCfg; 
-            execCfg.defaultSlippageBps = 5; // Example default
-            engine.setExecutionConfig(execCfg);
-
-            // Run
-            BacktestResult result = engine.run(candles, *strategy);
-            
-            json response;
-            response["strategy"] = strategyType;
-            response["trades"] = result.trades.size();
-            
-            // Calculate win rate (Simplified: we don't track round-trip trades yet)
-            // int wins = 0;
-            // for (const auto& t : result.trades) {
-            //     if (t.realizedPnL > 0) wins++;
-            // }
-            // response["winRate"] = result.trades.empty() ? 0.0 : (double)wins / result.trades.size();
-            response["winRate"] = 0.0; 
-            
-            // Total Profit (Realized + Unrealized usually, but let's use realized for simplicity or portfolio equity)
-            // BacktestResult has equityCurve, let's use the final equity - initial capital
-            if (!result.equityCurve.empty()) {
-                response["totalProfit"] = result.equityCurve.back() - result.initialCapital;
-            } else {
-                response["totalProfit"] = 0.0;
+            auto status = jobs.status(*id);
+            res.status = 202;
+            res.set_content((status ? jobStatusJson(*status) : json{{"id", *id}}).dump(), "application/json");
+        } catch (const std::exception& e) {
+            res.status = 500;
+            res.set_content(json{{"error", e.what()}}.dump(), "application/json");
+        }
+    }));
+
+    // Endpoint: GET /jobs/{id}
+    svr.Get(R"(/jobs/(\d+))", timed("GET", "/jobs/{id}", [&](const httplib::Request& req, httplib::Response& res) {
+        set_cors(res);
+        auto status = jobs.status(std::stoull(req.matches[1]));
+        if (!status) {
+            res.status = 404;
+            res.set_content(json{{"error", "Unknown job"}}.dump(), "application/json");
+            return;
+        }
+        res.set_content(jobStatusJson(*status).dump(), "application/json");
+    }));
+
+    // Endpoint: GET /jobs/{id}/result
+    // The /run-backtest response once the job succeeded; 409 while it is still
+    // pending or if it was cancelled, 500 with the error if it failed.
+    // ?max_points=&from=&to= select the equity points as for /run-backtest.
+    svr.Get(R"(/jobs/(\d+)/result)", timed("GET", "/jobs/{id}/result", [&](const httplib::Request& req, httplib::Response& res) {
+        set_cors(res);
+        try {
+            const uint64_t id = std::stoull(req.matches[1]);
+            auto status = jobs.status(id);
+            if (!status) {
+                res.status = 404;
+                res.set_content(json{{"error", "Unknown job"}}.dump(), "application/json");
+                return;
             }
+            if (status->state == app::JobState::Failed) {
+                res.status = 500;
+                res.set_content(json{{"error", status->error}}.dump(), "application/json");
+                return;
+            }
+            auto result = jobs.result(id);
+            if (!result) {
+                res.status = 409;
+                res.set_content(jobStatusJson(*status).dump(), "application/json");
+                return;
+            }
+            TimestampFormatter formatter(requestedTimeFormat(req.has_param("timeFormat") ? req.get_param_value("timeFormat") : std::string()));
+            const ResponseFormat format = requestedFormat(req);
+            ResponseColumns columns;
+            json response = backtestResponse(*result, status->label, formatter, true, equityQueryFromParams(req),
+                                             format == ResponseFormat::Columns ? &columns : nullptr);
+            response["jobId"] = id;
+            sendEncoded(req, res, response, format, &columns);
+        } catch (const std::exception& e) {
+            res.status = 500;
+            res.set_content(json{{"error", e.what()}}.dump(), "application/json");
+        }
+    }));
+
+    // Endpoint: DELETE /jobs/{id}
+    // Cooperative: a running job stops at its next candle and ends "cancelled".
+    svr.Delete(R"(/jobs/(\d+))", timed("DELETE", "/jobs/{id}", [&](const httplib::Request& req, httplib::Response& res) {
+        set_cors(res);
+        const uint64_t id = std::stoull(req.matches[1]);
+        if (!jobs.cancel(id)) {
+            auto status = jobs.status(id);
+            res.status = status ? 409 : 404;
+            res.set_content(status ? jobStatusJson(*status).dump() : json{{"error", "Unknown job"}}.dump(), "application/json");
+            return;
+        }
+        auto status = jobs.status(id);
+        res.status = 202;
+        res.set_content((status ? jobStatusJson(*status) : json{{"id", id}}).dump(), "application/json");
+    }));
 
-            // Max Drawdown calculation (simplified)
-            double maxPeak = -1e9;
-            double maxDD = 0.0;
-            for (double equity : result.equityCurve) {
-                if (equity > maxPeak) maxPeak = equity;
-                double dd = (maxPeak - equity) / maxPeak;
-                if (dd > maxDD) maxDD = dd;
+    // Endpoint: /load-report
+    // Serves a columnar report written by the CLI straight from the mapped file.
+    svr.Post("/load-report", timed("POST", "/load-report", [&](const httplib::Request& req, httplib::Response& res) {
+        set_cors(res);
+        try {
+            auto j = json::parse(req.body);
+            std::string path = j.value("path", "");
+            if (path.empty()) {
+                throw std::runtime_error("Missing 'path' in request body");
             }
-            response["maxDrawdown"] = maxDD;
+            ColumnarReport report(path);
+            TimestampFormatter formatter(parseTimestampFormat(j.value("timeFormat", std::string("epoch_s"))));
+            auto stamp = [&](int64_t nanos) -> json {
+                std::chrono::system_clock::time_point tp{
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanos))};
+                if (formatter.numeric()) {
+                    return formatter.epoch(tp);
+                }
+                return std::string(formatter(tp));
+            };
 
-            // Equity Curve for Chart
+            json response;
+            response["initialCapital"] = report.initialCapital();
+            response["finalEquity"] = report.finalEquity();
+            response["candlesProcessed"] = report.candlesProcessed();
+            response["totalProfit"] = report.finalEquity() - report.initialCapital();
+
+            const auto times = report.i64("equity.timestamp");
+            const auto values = report.f64("equity.value");
             std::vector<json> equityData;
-            for (size_t i = 0; i < result.equityCurve.size(); ++i) {
-                long long ts = 0;
-                if (i < result.equityTimestamps.size()) {
-                    ts = std::chrono::duration_cast<std::chrono::seconds>(
-                        result.equityTimestamps[i].time_since_epoch()
-                    ).count();
-                }
-                equityData.push_back({{"time", ts}, {"value", result.equityCurve[i]}});
+            equityData.reserve(values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                equityData.push_back({{"time", stamp(times[i])}, {"value", values[i]}});
             }
             response["equityCurve"] = equityData;
 
-            // Recent Trades List (Last 50)
+            const auto tradeTimes = report.i64("trades.timestamp");
+            const auto sides = report.u8("trades.side");
+            const auto prices = report.f64("trades.price");
+            const auto qtys = report.f64("trades.qty");
+            // Reports written before trades.pnl existed have no per-fill PnL
+            const auto pnls = report.has("trades.pnl") ? report.f64("trades.pnl") : std::span<const double>{};
+            response["trades"] = tradeTimes.size();
             std::vector<json> recentTrades;
-            size_t tradeCount = result.trades.size();
-            size_t startIdx = tradeCount > 50 ? tradeCount - 50 : 0;
-            
-            for (size_t i = startIdx; i < tradeCount; ++i) {
-                const auto& t = result.trades[i];
-                long long ts = std::chrono::duration_cast<std::chrono::seconds>(
-                    t.timestamp.time_since_epoch()
-                ).count();
-                
+            size_t startIdx = tradeTimes.size() > 50 ? tradeTimes.size() - 50 : 0;
+            for (size_t i = tradeTimes.size(); i-- > startIdx;) {
                 recentTrades.push_back({
-                    {"date", ts},
-                    {"type", t.side == Side::Buy ? "BUY" : "SELL"},
-                    {"price", t.price},
-                    {"qty", t.qty},
-                    {"pnl", 0.0} // Individual trade PnL not tracked in Trade struct yet
+                    {"date", stamp(tradeTimes[i])},
+                    {"type", static_cast<Side>(sides[i]) == Side::Buy ? "BUY" : "SELL"},
+                    {"price", prices[i]},
+                    {"qty", qtys[i]},
+                    {"pnl", i < pnls.size() ? pnls[i] : 0.0}
                 });
             }
-            // Reverse to show newest first
-            std::reverse(recentTrades.begin(), recentTrades.end());
             response["recentTrades"] = recentTrades;
+            response["roundTrips"] = report.f64("round_trips.pnl").size();
 
-            res.set_content(response.dump(), "application/json");
+            sendEncoded(req, res, response, requestedFormat(req, &j));
         } catch (const std::exception& e) {
             res.status = 500;
             res.set_content(json{{"error", e.what()}}.dump(), "application/json");
         }
+    }));
+
+    // Endpoint: GET /metrics (Prometheus text format)
+    svr.Get("/metrics", [&](const httplib::Request&, httplib::Response& res) {
+        res.set_content(metrics.scrape(), "text/plain; version=0.0.4; charset=utf-8");
     });
 
     std::cout << "Server started at http://localhost:8080" << std::endl;
@@ -1,4 +1,5 @@
 #include "BreakoutStrategy.h"
+#include "../Model/ByteStream.h"
 
 #include <algorithm>
 #include <limits>
@@ -9,16 +10,33 @@ BreakoutStrategy::BreakoutStrategy(size_t lookback, double buffer, double orderQ
         : lookback_(lookback ? lookback : 1),
             buffer_(buffer),
             orderQty_(orderQty > 0 ? orderQty : 1.0),
-            allowShort_(allowShort) {}
+            allowShort_(allowShort),
+            highest_(lookback_),
+            lowest_(lookback_) {}
+
+void BreakoutStrategy::bindIndicators(IndicatorRegistry& registry) {
+    sharedHigh_ = registry.subscribe({IndicatorKind::RollingMax, lookback_, PriceField::High});
+    sharedLow_ = registry.subscribe({IndicatorKind::RollingMin, lookback_, PriceField::Low});
+}
 
 void BreakoutStrategy::onStart() {
-    highs_.clear();
-    lows_.clear();
+    highest_.reset();
+    lowest_.reset();
     position_ = PositionState::Flat;
     signals_.clear();
     orderCounter_ = 0;
 }
 
+void BreakoutStrategy::warmUp(std::span<const Candle> history) {
+    if (sharedHigh_) {
+        return;
+    }
+    for (const auto& candle : history.last(std::min(history.size(), lookback_))) {
+        highest_.update(candle.high);
+        lowest_.update(candle.low);
+    }
+}
+
 void BreakoutStrategy::onData(const Candle& candle) {
     if (!candle.symbol.empty()) {
         lastSymbol_ = candle.symbol;
@@ -26,15 +44,26 @@ void BreakoutStrategy::onData(const Candle& candle) {
         lastSymbol_ = "DEFAULT";
     }
 
-    if (highs_.size() < lookback_ || lows_.size() < lookback_) {
-        // Need historical context first; store candle and wait.
-        highs_.push_back(candle.high);
-        lows_.push_back(candle.low);
-        return;
+    // Extremes of the previous `lookback_` candles, excluding this one.
+    double highestHigh = 0.0;
+    double lowestLow = 0.0;
+    if (sharedHigh_) {
+        // The registry has already absorbed this candle; use its prior state.
+        if (!sharedHigh_.previousReady() || !sharedLow_.previousReady()) {
+            return;
+        }
+        highestHigh = sharedHigh_.previous();
+        lowestLow = sharedLow_.previous();
+    } else {
+        if (!highest_.ready() || !lowest_.ready()) {
+            // Need historical context first; store candle and wait.
+            highest_.update(candle.high);
+            lowest_.update(candle.low);
+            return;
+        }
+        highestHigh = highest_.value();
+        lowestLow = lowest_.value();
     }
-
-    const double highestHigh = *std::max_element(highs_.begin(), highs_.end());
-    const double lowestLow = *std::min_element(lows_.begin(), lows_.end());
     const double price = candle.close;
 
     bool handled = false;
@@ -65,13 +94,43 @@ void BreakoutStrategy::onData(const Candle& candle) {
         position_ = PositionState::Short;
     }
 
-    highs_.push_back(candle.high);
-    lows_.push_back(candle.low);
-    if (highs_.size() > lookback_) {
-        highs_.pop_front();
+    if (!sharedHigh_) {
+        highest_.update(candle.high);
+        lowest_.update(candle.low);
+    }
+}
+
+bool BreakoutStrategy::saveState(std::string& out) const {
+    ByteWriter w;
+    highest_.save(w);
+    lowest_.save(w);
+    w.put<uint8_t>(static_cast<uint8_t>(position_));
+    w.putString(lastSymbol_);
+    w.put<uint64_t>(orderCounter_);
+    w.put<uint64_t>(signals_.size());
+    for (const auto& s : signals_) {
+        w.putTime(s.timestamp);
+        w.put<uint8_t>(static_cast<uint8_t>(s.type));
+        w.put(s.price);
     }
-    if (lows_.size() > lookback_) {
-        lows_.pop_front();
+    out += w.data();
+    return true;
+}
+
+void BreakoutStrategy::loadState(const std::string& state) {
+    ByteReader r(state);
+    highest_.load(r);
+    lowest_.load(r);
+    position_ = static_cast<PositionState>(r.get<uint8_t>());
+    lastSymbol_ = r.getString();
+    orderCounter_ = r.get<uint64_t>();
+    signals_.clear();
+    for (auto n = r.get<uint64_t>(); n > 0; --n) {
+        BreakoutSignal s;
+        s.timestamp = r.getTime();
+        s.type = static_cast<BreakoutSignalType>(r.get<uint8_t>());
+        s.price = r.get<double>();
+        signals_.push_back(s);
     }
 }
 
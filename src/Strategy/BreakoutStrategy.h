@@ -1,8 +1,9 @@
 #pragma once
 
 #include "Strategy.h"
+#include "Indicators.h"
+#include "IndicatorRegistry.h"
 #include <chrono>
-#include <deque>
 #include <string>
 #include <vector>
 
@@ -23,9 +24,13 @@ public:
                      double orderQty = 1.0,
                      bool allowShort = false);
 
+    void bindIndicators(IndicatorRegistry& registry) override;
     void onStart() override;
+    void warmUp(std::span<const Candle> history) override;
     void onData(const Candle& candle) override;
     void onFinish() override {}
+    bool saveState(std::string& out) const override;
+    void loadState(const std::string& state) override;
 
     const std::vector<BreakoutSignal>& signals() const { return signals_; }
 
@@ -40,8 +45,11 @@ private:
     double orderQty_;
     bool allowShort_;
 
-    std::deque<double> highs_;
-    std::deque<double> lows_;
+    RollingMax highest_;
+    RollingMin lowest_;
+    // Set by bindIndicators: shared extrema, read through their pre-candle state.
+    IndicatorRef sharedHigh_;
+    IndicatorRef sharedLow_;
 
     PositionState position_{PositionState::Flat};
     std::string lastSymbol_;
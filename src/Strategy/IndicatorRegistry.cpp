@@ -0,0 +1,70 @@
+#include "IndicatorRegistry.h"
+
+#include <type_traits>
+
+namespace fastquant {
+
+namespace {
+
+double fieldValue(const Candle& c, PriceField field) {
+    switch (field) {
+        case PriceField::Open: return c.open;
+        case PriceField::High: return c.high;
+        case PriceField::Low: return c.low;
+        case PriceField::Close: return c.close;
+        case PriceField::Volume: return c.volume;
+    }
+    return c.close;
+}
+
+} // namespace
+
+IndicatorRef IndicatorRegistry::subscribe(const IndicatorSpec& spec) {
+    ++subscriptions_;
+    for (const auto& node : nodes_) {
+        if (node.spec == spec) {
+            return IndicatorRef(&node.slot);
+        }
+    }
+
+    const size_t w = spec.window ? spec.window : 1;
+    Impl impl = RollingMean(w);
+    switch (spec.kind) {
+        case IndicatorKind::Sma: impl = RollingMean(w); break;
+        case IndicatorKind::Ema: impl = Ema(w); break;
+        case IndicatorKind::StdDev: impl = RollingVariance(w); break;
+        case IndicatorKind::Rsi: impl = Rsi(w); break;
+        case IndicatorKind::Atr: impl = Atr(w); break;
+        case IndicatorKind::RollingMax: impl = RollingMax(w); break;
+        case IndicatorKind::RollingMin: impl = RollingMin(w); break;
+    }
+    nodes_.push_back({spec, std::move(impl), {}});
+    return IndicatorRef(&nodes_.back().slot);
+}
+
+void IndicatorRegistry::update(const Candle& candle) {
+    for (auto& node : nodes_) {
+        auto& slot = node.slot;
+        slot.previous = slot.value;
+        slot.previousReady = slot.ready;
+        const double x = fieldValue(candle, node.spec.field);
+        std::visit([&](auto& ind) {
+            using T = std::decay_t<decltype(ind)>;
+            if constexpr (std::is_same_v<T, Atr>) {
+                ind.update(candle.high, candle.low, candle.close);
+            } else {
+                ind.update(x);
+            }
+            if constexpr (std::is_same_v<T, RollingVariance>) {
+                slot.value = ind.stddev();
+            } else {
+                slot.value = ind.value();
+            }
+            slot.ready = ind.ready();
+        }, node.impl);
+    }
+    updatesPerformed_ += nodes_.size();
+    updatesRequested_ += subscriptions_;
+}
+
+} // namespace fastquant
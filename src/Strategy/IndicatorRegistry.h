@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Indicators.h"
+#include "../DataLoader/Candle.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <variant>
+
+namespace fastquant {
+
+enum class IndicatorKind { Sma, Ema, StdDev, Rsi, Atr, RollingMax, RollingMin };
+enum class PriceField { Open, High, Low, Close, Volume };
+
+// Identity of a shared indicator: two subscriptions with equal specs read the
+// same node. Atr ignores `field` (it always uses high/low/close).
+struct IndicatorSpec {
+    IndicatorKind kind = IndicatorKind::Sma;
+    size_t window = 1;
+    PriceField field = PriceField::Close;
+
+    bool operator==(const IndicatorSpec&) const = default;
+};
+
+// Read-only view of a registry node. `value`/`ready` include the latest
+// candle; `previous`/`previousReady` are the state just before it, for
+// strategies that compare the current bar against a trailing window.
+class IndicatorRef {
+public:
+    IndicatorRef() = default;
+
+    explicit operator bool() const { return node_ != nullptr; }
+    double value() const { return node_->value; }
+    bool ready() const { return node_->ready; }
+    double previous() const { return node_->previous; }
+    bool previousReady() const { return node_->previousReady; }
+
+private:
+    friend class IndicatorRegistry;
+    struct Slot {
+        double value{0.0};
+        bool ready{false};
+        double previous{0.0};
+        bool previousReady{false};
+    };
+    explicit IndicatorRef(const Slot* node) : node_(node) {}
+
+    const Slot* node_ = nullptr;
+};
+
+// Indicator graph shared by every strategy on one data stream. Strategies
+// subscribe in Strategy::bindIndicators; the engine calls update() once per
+// candle before any strategy sees it, so each distinct indicator is computed
+// exactly once however many strategies read it.
+class IndicatorRegistry {
+public:
+    IndicatorRef subscribe(const IndicatorSpec& spec);
+    void update(const Candle& candle);
+
+    size_t nodeCount() const { return nodes_.size(); }
+    size_t subscriptionCount() const { return subscriptions_; }
+    // Indicator updates performed vs. what independent per-strategy copies would have done.
+    uint64_t updatesPerformed() const { return updatesPerformed_; }
+    uint64_t updatesRequested() const { return updatesRequested_; }
+
+private:
+    using Impl = std::variant<RollingMean, Ema, RollingVariance, Rsi, Atr, RollingMax, RollingMin>;
+
+    struct Node {
+        IndicatorSpec spec;
+        Impl impl;
+        IndicatorRef::Slot slot;
+    };
+
+    std::deque<Node> nodes_; // deque: slots must not move once handed out
+    size_t subscriptions_{0};
+    uint64_t updatesPerformed_{0};
+    uint64_t updatesRequested_{0};
+};
+
+} // namespace fastquant
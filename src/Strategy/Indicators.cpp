@@ -0,0 +1,225 @@
+#include "Indicators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace fastquant {
+
+namespace {
+
+void saveRing(ByteWriter& w, const RingBuffer<double>& ring) {
+    w.put<uint64_t>(ring.size());
+    for (size_t i = 0; i < ring.size(); ++i) {
+        w.put(ring[i]);
+    }
+}
+
+void loadRing(ByteReader& r, RingBuffer<double>& ring) {
+    ring.clear();
+    const auto n = r.get<uint64_t>();
+    if (n > ring.capacity()) {
+        throw std::runtime_error("Indicator state larger than its window");
+    }
+    for (uint64_t i = 0; i < n; ++i) {
+        ring.push(r.get<double>());
+    }
+}
+
+} // namespace
+
+void RollingSum::update(double x) {
+    double evicted = 0.0;
+    const bool full = values_.push(x, &evicted);
+    // Same operation order as a push-then-pop deque window, so sums are
+    // bit-identical to the previous per-strategy implementation.
+    sum_ += x;
+    if (full) {
+        sum_ -= evicted;
+    }
+}
+
+void RollingSum::reset() {
+    values_.clear();
+    sum_ = 0.0;
+}
+
+void RollingSum::save(ByteWriter& w) const {
+    saveRing(w, values_);
+    w.put(sum_);
+}
+
+void RollingSum::load(ByteReader& r) {
+    loadRing(r, values_);
+    sum_ = r.get<double>();
+}
+
+void RollingVariance::update(double x) {
+    double evicted = 0.0;
+    if (values_.push(x, &evicted)) {
+        const double n = static_cast<double>(values_.size());
+        const double oldMean = mean_;
+        mean_ += (x - evicted) / n;
+        m2_ += (x - evicted) * (x - mean_ + evicted - oldMean);
+    } else {
+        const double n = static_cast<double>(values_.size());
+        const double delta = x - mean_;
+        mean_ += delta / n;
+        m2_ += delta * (x - mean_);
+    }
+    // Cancellation can leave a tiny negative residue on constant input.
+    m2_ = std::max(m2_, 0.0);
+}
+
+void RollingVariance::reset() {
+    values_.clear();
+    mean_ = 0.0;
+    m2_ = 0.0;
+}
+
+double RollingVariance::variance() const {
+    return values_.empty() ? 0.0 : m2_ / static_cast<double>(values_.size());
+}
+
+double RollingVariance::sampleVariance() const {
+    return values_.size() < 2 ? 0.0 : m2_ / static_cast<double>(values_.size() - 1);
+}
+
+double RollingVariance::stddev() const {
+    return std::sqrt(variance());
+}
+
+void RollingVariance::save(ByteWriter& w) const {
+    saveRing(w, values_);
+    w.put(mean_);
+    w.put(m2_);
+}
+
+void RollingVariance::load(ByteReader& r) {
+    loadRing(r, values_);
+    mean_ = r.get<double>();
+    m2_ = r.get<double>();
+}
+
+Ema::Ema(size_t period)
+    : period_(period ? period : 1),
+      alpha_(2.0 / (static_cast<double>(period_) + 1.0)) {}
+
+void Ema::update(double x) {
+    if (seen_ < period_) {
+        // Seed phase: running simple mean of the first `period` samples.
+        ++seen_;
+        value_ += (x - value_) / static_cast<double>(seen_);
+        return;
+    }
+    value_ += alpha_ * (x - value_);
+}
+
+void Ema::reset() {
+    seen_ = 0;
+    value_ = 0.0;
+}
+
+void Ema::save(ByteWriter& w) const {
+    w.put<uint64_t>(seen_);
+    w.put(value_);
+}
+
+void Ema::load(ByteReader& r) {
+    seen_ = r.get<uint64_t>();
+    value_ = r.get<double>();
+}
+
+void Rsi::update(double close) {
+    if (!havePrev_) {
+        havePrev_ = true;
+        prevClose_ = close;
+        return;
+    }
+    const double change = close - prevClose_;
+    prevClose_ = close;
+    const double gain = change > 0.0 ? change : 0.0;
+    const double loss = change < 0.0 ? -change : 0.0;
+    const double n = static_cast<double>(period_);
+    if (changes_ < period_) {
+        ++changes_;
+        avgGain_ += (gain - avgGain_) / static_cast<double>(changes_);
+        avgLoss_ += (loss - avgLoss_) / static_cast<double>(changes_);
+        return;
+    }
+    avgGain_ = (avgGain_ * (n - 1.0) + gain) / n;
+    avgLoss_ = (avgLoss_ * (n - 1.0) + loss) / n;
+}
+
+void Rsi::reset() {
+    changes_ = 0;
+    havePrev_ = false;
+    prevClose_ = 0.0;
+    avgGain_ = 0.0;
+    avgLoss_ = 0.0;
+}
+
+double Rsi::value() const {
+    if (changes_ == 0) {
+        return 0.0;
+    }
+    if (avgLoss_ == 0.0) {
+        return avgGain_ == 0.0 ? 50.0 : 100.0;
+    }
+    return 100.0 - 100.0 / (1.0 + avgGain_ / avgLoss_);
+}
+
+void Rsi::save(ByteWriter& w) const {
+    w.put<uint64_t>(changes_);
+    w.put<uint8_t>(havePrev_ ? 1 : 0);
+    w.put(prevClose_);
+    w.put(avgGain_);
+    w.put(avgLoss_);
+}
+
+void Rsi::load(ByteReader& r) {
+    changes_ = r.get<uint64_t>();
+    havePrev_ = r.get<uint8_t>() != 0;
+    prevClose_ = r.get<double>();
+    avgGain_ = r.get<double>();
+    avgLoss_ = r.get<double>();
+}
+
+void Atr::update(double high, double low, double close) {
+    double tr = high - low;
+    if (havePrev_) {
+        tr = std::max({tr, std::abs(high - prevClose_), std::abs(low - prevClose_)});
+    }
+    havePrev_ = true;
+    prevClose_ = close;
+    if (seen_ < period_) {
+        ++seen_;
+        value_ += (tr - value_) / static_cast<double>(seen_);
+        return;
+    }
+    const double n = static_cast<double>(period_);
+    value_ = (value_ * (n - 1.0) + tr) / n;
+}
+
+void Atr::reset() {
+    seen_ = 0;
+    havePrev_ = false;
+    prevClose_ = 0.0;
+    value_ = 0.0;
+}
+
+void Atr::save(ByteWriter& w) const {
+    w.put<uint64_t>(seen_);
+    w.put<uint8_t>(havePrev_ ? 1 : 0);
+    w.put(prevClose_);
+    w.put(value_);
+}
+
+void Atr::load(ByteReader& r) {
+    seen_ = r.get<uint64_t>();
+    havePrev_ = r.get<uint8_t>() != 0;
+    prevClose_ = r.get<double>();
+    value_ = r.get<double>();
+}
+
+} // namespace fastquant
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "../Model/ByteStream.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace fastquant {
+
+// Streaming indicators: every update is O(1) amortized and allocation-free
+// after construction. Each indicator reports ready() once it has seen enough
+// input for value() to be meaningful; before that value() returns the partial
+// state (0 for most). save()/load() round-trip the full state for engine
+// checkpoints.
+
+// Fixed-capacity ring buffer. push() overwrites the oldest element when full.
+template<typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 1) : data_(capacity ? capacity : 1) {}
+
+    // Returns true and stores the overwritten element in `evicted` when full.
+    bool push(const T& value, T* evicted = nullptr) {
+        const size_t slot = (head_ + size_) % data_.size();
+        if (size_ == data_.size()) {
+            if (evicted) {
+                *evicted = data_[head_];
+            }
+            data_[head_] = value;
+            head_ = (head_ + 1) % data_.size();
+            return true;
+        }
+        data_[slot] = value;
+        ++size_;
+        return false;
+    }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return data_.size(); }
+    bool full() const { return size_ == data_.size(); }
+    bool empty() const { return size_ == 0; }
+
+    // i = 0 is the oldest element.
+    const T& operator[](size_t i) const { return data_[(head_ + i) % data_.size()]; }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+private:
+    std::vector<T> data_;
+    size_t head_{0};
+    size_t size_{0};
+};
+
+class RollingSum {
+public:
+    explicit RollingSum(size_t window = 1) : values_(window) {}
+
+    void update(double x);
+    void reset();
+
+    bool ready() const { return values_.full(); }
+    size_t count() const { return values_.size(); }
+    size_t window() const { return values_.capacity(); }
+    double value() const { return sum_; }
+
+    void save(ByteWriter& w) const;
+    void load(ByteReader& r);
+
+private:
+    RingBuffer<double> values_;
+    double sum_{0.0};
+};
+
+class RollingMean {
+public:
+    explicit RollingMean(size_t window = 1) : sum_(window) {}
+
+    void update(double x) { sum_.update(x); }
+    void reset() { sum_.reset(); }
+
+    bool ready() const { return sum_.ready(); }
+    size_t window() const { return sum_.window(); }
+    double value() const { return sum_.count() ? sum_.value() / static_cast<double>(sum_.count()) : 0.0; }
+
+    void save(ByteWriter& w) const { sum_.save(w); }
+    void load(ByteReader& r) { sum_.load(r); }
+
+private:
+    RollingSum sum_;
+};
+
+// Sliding-window Welford: mean and sum of squared deviations are adjusted
+// for the entering and leaving sample together.
+class RollingVariance {
+public:
+    explicit RollingVariance(size_t window = 2) : values_(window) {}
+
+    void update(double x);
+    void reset();
+
+    bool ready() const { return values_.full(); }
+    double mean() const { return mean_; }
+    double variance() const;        // population
+    double sampleVariance() const;  // n - 1
+    double stddev() const;
+
+    void save(ByteWriter& w) const;
+    void load(ByteReader& r);
+
+private:
+    RingBuffer<double> values_;
+    double mean_{0.0};
+    double m2_{0.0};
+};
+
+// Exponential moving average with alpha = 2 / (period + 1), seeded with the
+// simple mean of the first `period` samples.
+class Ema {
+public:
+    explicit Ema(size_t period = 1);
+
+    void update(double x);
+    void reset();
+
+    bool ready() const { return seen_ >= period_; }
+    double value() const { return value_; }
+
+    void save(ByteWriter& w) const;
+    void load(ByteReader& r);
+
+private:
+    size_t period_;
+    double alpha_;
+    size_t seen_{0};
+    double value_{0.0};
+};
+
+// Wilder's RSI over closing prices; ready after period + 1 closes.
+class Rsi {
+public:
+    explicit Rsi(size_t period = 14) : period_(period ? period : 1) {}
+
+    void update(double close);
+    void reset();
+
+    bool ready() const { return changes_ >= period_; }
+    double value() const;
+
+    void save(ByteWriter& w) const;
+    void load(ByteReader& r);
+
+private:
+    size_t period_;
+    size_t changes_{0};
+    bool havePrev_{false};
+    double prevClose_{0.0};
+    double avgGain_{0.0};
+    double avgLoss_{0.0};
+};
+
+// Wilder's average true range; the first bar's true range is high - low.
+class Atr {
+public:
+    explicit Atr(size_t period = 14) : period_(period ? period : 1) {}
+
+    void update(double high, double low, double close);
+    void reset();
+
+    bool ready() const { return seen_ >= period_; }
+    double value() const { return value_; }
+
+    void save(ByteWriter& w) const;
+    void load(ByteReader& r);
+
+private:
+    size_t period_;
+    size_t seen_{0};
+    bool havePrev_{false};
+    double prevClose_{0.0};
+    double value_{0.0};
+};
+
+// Rolling max (Better = std::greater_equal) or min (std::less_equal) over the
+// last `window` samples using a monotonic deque: each sample is pushed and
+// popped at most once, so updates are O(1) amortized regardless of window.
+template<typename Better>
+class RollingExtremum {
+public:
+    explicit RollingExtremum(size_t window = 1) : window_(window ? window : 1), deque_(window_) {}
+
+    void update(double x) {
+        // Expire the sample that x pushes out of the window, then drop samples
+        // that x dominates: they can never be the extremum again.
+        if (size_ && seq_ - front().seq >= window_) {
+            popFront();
+        }
+        while (size_ && Better{}(x, back().value)) {
+            popBack();
+        }
+        pushBack({seq_, x});
+        ++seq_;
+    }
+
+    void reset() {
+        head_ = 0;
+        size_ = 0;
+        seq_ = 0;
+    }
+
+    bool ready() const { return seq_ >= window_; }
+    size_t count() const { return seq_ < window_ ? static_cast<size_t>(seq_) : window_; }
+    double value() const { return size_ ? front().value : 0.0; }
+
+    void save(ByteWriter& w) const {
+        w.put<uint64_t>(seq_);
+        w.put<uint64_t>(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            const auto& e = at(i);
+            w.put<uint64_t>(e.seq);
+            w.put(e.value);
+        }
+    }
+
+    void load(ByteReader& r) {
+        reset();
+        seq_ = r.get<uint64_t>();
+        auto n = r.get<uint64_t>();
+        if (n > window_) {
+            throw std::runtime_error("Rolling extremum state larger than its window");
+        }
+        for (; n > 0; --n) {
+            Entry e;
+            e.seq = r.get<uint64_t>();
+            e.value = r.get<double>();
+            pushBack(e);
+        }
+    }
+
+private:
+    struct Entry {
+        uint64_t seq{0};
+        double value{0.0};
+    };
+
+    // The deque never holds more than `window_` entries, so it lives in a
+    // fixed ring instead of std::deque's chunked storage.
+    const Entry& at(size_t i) const { return deque_[(head_ + i) % window_]; }
+    const Entry& front() const { return at(0); }
+    const Entry& back() const { return at(size_ - 1); }
+    void pushBack(const Entry& e) {
+        deque_[(head_ + size_) % window_] = e;
+        ++size_;
+    }
+    void popBack() { --size_; }
+    void popFront() {
+        head_ = (head_ + 1) % window_;
+        --size_;
+    }
+
+    size_t window_;
+    std::vector<Entry> deque_;
+    size_t head_{0};
+    size_t size_{0};
+    uint64_t seq_{0};
+};
+
+using RollingMax = RollingExtremum<std::greater_equal<double>>;
+using RollingMin = RollingExtremum<std::less_equal<double>>;
+
+} // namespace fastquant
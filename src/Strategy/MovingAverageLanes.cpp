@@ -0,0 +1,150 @@
+#include "MovingAverageLanes.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FASTQUANT_HAVE_AVX2_KERNEL 1
+#endif
+
+namespace fastquant {
+
+namespace {
+// Padding lanes get a window no stream can fill, so they never become ready.
+constexpr int64_t kNeverReady = std::numeric_limits<int64_t>::max() / 2;
+}
+
+MovingAverageLanes::MovingAverageLanes(const std::vector<std::pair<size_t, size_t>>& windows)
+    : lanes_(windows.size()),
+      padded_((windows.size() + kLaneWidth - 1) / kLaneWidth * kLaneWidth) {
+    shortW_.assign(padded_, kNeverReady);
+    longW_.assign(padded_, kNeverReady);
+    shortWd_.assign(padded_, 1.0);
+    longWd_.assign(padded_, 1.0);
+    for (size_t i = 0; i < lanes_; ++i) {
+        size_t s = windows[i].first ? windows[i].first : 1;
+        size_t l = windows[i].second ? windows[i].second : 1;
+        if (s > l) {
+            std::swap(s, l);
+        }
+        shortW_[i] = static_cast<int64_t>(s);
+        longW_[i] = static_cast<int64_t>(l);
+        shortWd_[i] = static_cast<double>(s);
+        longWd_[i] = static_cast<double>(l);
+    }
+    reset();
+    simd_ = simdSupported();
+}
+
+void MovingAverageLanes::reset() {
+    shortSum_.assign(padded_, 0.0);
+    longSum_.assign(padded_, 0.0);
+    above_.assign(padded_, 0.0);
+}
+
+bool MovingAverageLanes::simdSupported() {
+#ifdef FASTQUANT_HAVE_AVX2_KERNEL
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+void MovingAverageLanes::step(const double* closes, size_t t, std::vector<uint32_t>& fired, std::vector<int8_t>& direction) {
+    if (simd_) {
+        stepAvx2(closes, t, fired, direction);
+    } else {
+        stepScalar(closes, t, fired, direction);
+    }
+}
+
+void MovingAverageLanes::stepScalar(const double* closes, size_t t,
+                                    std::vector<uint32_t>& fired, std::vector<int8_t>& direction) {
+    const double price = closes[t];
+    const auto now = static_cast<int64_t>(t);
+    for (size_t i = 0; i < lanes_; ++i) {
+        shortSum_[i] += price;
+        if (now >= shortW_[i]) {
+            shortSum_[i] -= closes[now - shortW_[i]];
+        }
+        longSum_[i] += price;
+        if (now >= longW_[i]) {
+            longSum_[i] -= closes[now - longW_[i]];
+        }
+        if (now + 1 < longW_[i]) {
+            continue;
+        }
+        const double shortMa = shortSum_[i] / shortWd_[i];
+        const double longMa = longSum_[i] / longWd_[i];
+        const double isAbove = shortMa > longMa ? 1.0 : 0.0;
+        if (isAbove != above_[i]) {
+            fired.push_back(static_cast<uint32_t>(i));
+            direction.push_back(isAbove != 0.0 ? 1 : -1);
+        }
+        above_[i] = isAbove;
+    }
+}
+
+#ifdef FASTQUANT_HAVE_AVX2_KERNEL
+
+__attribute__((target("avx2")))
+void MovingAverageLanes::stepAvx2(const double* closes, size_t t,
+                                  std::vector<uint32_t>& fired, std::vector<int8_t>& direction) {
+    const __m256d price = _mm256_set1_pd(closes[t]);
+    const __m256i now = _mm256_set1_epi64x(static_cast<long long>(t));
+    const __m256i allOnes = _mm256_set1_epi64x(-1);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+
+    for (size_t i = 0; i < padded_; i += kLaneWidth) {
+        const __m256i sw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&shortW_[i]));
+        const __m256i lw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&longW_[i]));
+
+        // Lanes whose window is full subtract the close leaving it; the others
+        // gather 0.0, and x - 0.0 == x exactly, so no blend is needed.
+        const __m256i shortFull = _mm256_xor_si256(_mm256_cmpgt_epi64(sw, now), allOnes);
+        const __m256i longFull = _mm256_xor_si256(_mm256_cmpgt_epi64(lw, now), allOnes);
+        const __m256d shortOut = _mm256_mask_i64gather_pd(zero, closes, _mm256_sub_epi64(now, sw),
+                                                          _mm256_castsi256_pd(shortFull), 8);
+        const __m256d longOut = _mm256_mask_i64gather_pd(zero, closes, _mm256_sub_epi64(now, lw),
+                                                         _mm256_castsi256_pd(longFull), 8);
+
+        __m256d ss = _mm256_add_pd(_mm256_loadu_pd(&shortSum_[i]), price);
+        __m256d ls = _mm256_add_pd(_mm256_loadu_pd(&longSum_[i]), price);
+        ss = _mm256_sub_pd(ss, shortOut);
+        ls = _mm256_sub_pd(ls, longOut);
+        _mm256_storeu_pd(&shortSum_[i], ss);
+        _mm256_storeu_pd(&longSum_[i], ls);
+
+        // ready: t + 1 >= long window, i.e. the long window is full after this step.
+        const __m256d ready = _mm256_castsi256_pd(
+            _mm256_xor_si256(_mm256_cmpgt_epi64(lw, _mm256_add_epi64(now, _mm256_set1_epi64x(1))), allOnes));
+        const __m256d shortMa = _mm256_div_pd(ss, _mm256_loadu_pd(&shortWd_[i]));
+        const __m256d longMa = _mm256_div_pd(ls, _mm256_loadu_pd(&longWd_[i]));
+        const __m256d isAbove = _mm256_and_pd(_mm256_cmp_pd(shortMa, longMa, _CMP_GT_OQ), one);
+        const __m256d prev = _mm256_loadu_pd(&above_[i]);
+        const __m256d changed = _mm256_and_pd(_mm256_cmp_pd(isAbove, prev, _CMP_NEQ_OQ), ready);
+        _mm256_storeu_pd(&above_[i], _mm256_blendv_pd(prev, isAbove, ready));
+
+        int mask = _mm256_movemask_pd(changed);
+        while (mask) {
+            const int bit = __builtin_ctz(static_cast<unsigned>(mask));
+            mask &= mask - 1;
+            const size_t lane = i + static_cast<size_t>(bit);
+            fired.push_back(static_cast<uint32_t>(lane));
+            direction.push_back(above_[lane] != 0.0 ? 1 : -1);
+        }
+    }
+}
+
+#else
+
+void MovingAverageLanes::stepAvx2(const double* closes, size_t t,
+                                  std::vector<uint32_t>& fired, std::vector<int8_t>& direction) {
+    stepScalar(closes, t, fired, direction);
+}
+
+#endif
+
+} // namespace fastquant
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace fastquant {
+
+// Lockstep SMA-crossover kernel: advances many (short, long) window pairs of
+// MovingAverageStrategy over one close-price stream, one parameter set per SIMD
+// lane, in structure-of-arrays form. Window sums are updated with the same
+// operation order as RollingSum (add the new close, then subtract the one
+// leaving the window), so every lane's signals match the scalar strategy bit
+// for bit. The AVX2 path is chosen at runtime; other CPUs use the scalar loop.
+class MovingAverageLanes {
+public:
+    static constexpr size_t kLaneWidth = 4; // doubles per AVX2 register
+
+    // Windows are normalised like MovingAverageStrategy (0 -> 1, short <= long).
+    explicit MovingAverageLanes(const std::vector<std::pair<size_t, size_t>>& windows);
+
+    size_t lanes() const { return lanes_; }
+    size_t shortWindow(size_t lane) const { return static_cast<size_t>(shortW_[lane]); }
+    size_t longWindow(size_t lane) const { return static_cast<size_t>(longW_[lane]); }
+
+    // Feed closes[t]; closes[0..t] must be the whole history so far. Lanes whose
+    // crossover fired are appended to `fired`, with +1 (buy) / -1 (sell) in `direction`.
+    void step(const double* closes, size_t t, std::vector<uint32_t>& fired, std::vector<int8_t>& direction);
+
+    void reset();
+
+    // Force the portable loop (tests compare both paths).
+    void setSimdEnabled(bool enabled) { simd_ = enabled && simdSupported(); }
+    bool simdEnabled() const { return simd_; }
+    static bool simdSupported();
+
+private:
+    void stepScalar(const double* closes, size_t t, std::vector<uint32_t>& fired, std::vector<int8_t>& direction);
+    void stepAvx2(const double* closes, size_t t, std::vector<uint32_t>& fired, std::vector<int8_t>& direction);
+
+    size_t lanes_{0};
+    size_t padded_{0};
+    // SoA state, padded to a multiple of kLaneWidth; padding lanes never fire.
+    std::vector<int64_t> shortW_;
+    std::vector<int64_t> longW_;
+    std::vector<double> shortWd_;
+    std::vector<double> longWd_;
+    std::vector<double> shortSum_;
+    std::vector<double> longSum_;
+    std::vector<double> above_; // 1.0 when short MA was above long MA last step
+    bool simd_{false};
+};
+
+} // namespace fastquant
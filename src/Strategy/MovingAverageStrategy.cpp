@@ -1,4 +1,7 @@
 #include "MovingAverageStrategy.h"
+#include "../Model/ByteStream.h"
+
+#include <algorithm>
 
 namespace fastquant {
 
@@ -7,18 +10,35 @@ MovingAverageStrategy::MovingAverageStrategy(size_t shortWindow, size_t longWind
     if (shortWindow_ == 0) shortWindow_ = 1;
     if (longWindow_ == 0) longWindow_ = 1;
     if (shortWindow_ > longWindow_) std::swap(shortWindow_, longWindow_);
+    shortMa_ = RollingMean(shortWindow_);
+    longMa_ = RollingMean(longWindow_);
+}
+
+void MovingAverageStrategy::bindIndicators(IndicatorRegistry& registry) {
+    sharedShort_ = registry.subscribe({IndicatorKind::Sma, shortWindow_});
+    sharedLong_ = registry.subscribe({IndicatorKind::Sma, longWindow_});
 }
 
 void MovingAverageStrategy::onStart() {
-    shortBuf_.clear();
-    longBuf_.clear();
-    shortSum_ = 0.0;
-    longSum_ = 0.0;
+    shortMa_.reset();
+    longMa_.reset();
     lastShortAboveLong_ = false;
     signals_.clear();
     lastSymbol_.clear();
 }
 
+void MovingAverageStrategy::warmUp(std::span<const Candle> history) {
+    if (sharedShort_) {
+        return;
+    }
+    // Only the long window's worth matters; the crossover state stays as onStart
+    // left it, so the first ready bar can still enter.
+    for (const auto& candle : history.last(std::min(history.size(), longWindow_))) {
+        shortMa_.update(candle.close);
+        longMa_.update(candle.close);
+    }
+}
+
 void MovingAverageStrategy::onData(const Candle& candle) {
     double price = candle.close;
     if (!candle.symbol.empty()) {
@@ -27,23 +47,22 @@ void MovingAverageStrategy::onData(const Candle& candle) {
         lastSymbol_ = "DEFAULT";
     }
 
-    shortBuf_.push_back(price);
-    shortSum_ += price;
-    if (shortBuf_.size() > shortWindow_) {
-        shortSum_ -= shortBuf_.front();
-        shortBuf_.pop_front();
-    }
-
-    longBuf_.push_back(price);
-    longSum_ += price;
-    if (longBuf_.size() > longWindow_) {
-        longSum_ -= longBuf_.front();
-        longBuf_.pop_front();
+    bool ready = false;
+    double shortMA = 0.0;
+    double longMA = 0.0;
+    if (sharedShort_) {
+        ready = sharedShort_.ready() && sharedLong_.ready();
+        shortMA = sharedShort_.value();
+        longMA = sharedLong_.value();
+    } else {
+        shortMa_.update(price);
+        longMa_.update(price);
+        ready = shortMa_.ready() && longMa_.ready();
+        shortMA = shortMa_.value();
+        longMA = longMa_.value();
     }
 
-    if (shortBuf_.size() == shortWindow_ && longBuf_.size() == longWindow_) {
-        double shortMA = shortSum_ / static_cast<double>(shortWindow_);
-        double longMA = longSum_ / static_cast<double>(longWindow_);
+    if (ready) {
 
         bool nowShortAbove = (shortMA > longMA);
         if (!lastShortAboveLong_ && nowShortAbove) {
@@ -81,4 +100,36 @@ void MovingAverageStrategy::onFinish() {
     // no-op for now
 }
 
+bool MovingAverageStrategy::saveState(std::string& out) const {
+    ByteWriter w;
+    shortMa_.save(w);
+    longMa_.save(w);
+    w.put<uint8_t>(lastShortAboveLong_ ? 1 : 0);
+    w.putString(lastSymbol_);
+    w.put<uint64_t>(signals_.size());
+    for (const auto& s : signals_) {
+        w.putTime(s.timestamp);
+        w.put<uint8_t>(static_cast<uint8_t>(s.type));
+        w.put(s.price);
+    }
+    out += w.data();
+    return true;
+}
+
+void MovingAverageStrategy::loadState(const std::string& state) {
+    ByteReader r(state);
+    shortMa_.load(r);
+    longMa_.load(r);
+    lastShortAboveLong_ = r.get<uint8_t>() != 0;
+    lastSymbol_ = r.getString();
+    signals_.clear();
+    for (auto n = r.get<uint64_t>(); n > 0; --n) {
+        Signal s;
+        s.timestamp = r.getTime();
+        s.type = static_cast<SignalType>(r.get<uint8_t>());
+        s.price = r.get<double>();
+        signals_.push_back(s);
+    }
+}
+
 } // namespace fastquant
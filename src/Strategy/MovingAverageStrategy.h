@@ -2,7 +2,8 @@
 
 #include "Strategy.h"
 #include "../DataLoader/Candle.h"
-#include <deque>
+#include "Indicators.h"
+#include "IndicatorRegistry.h"
 #include <vector>
 #include <chrono>
 #include <string>
@@ -21,19 +22,24 @@ class MovingAverageStrategy : public Strategy {
 public:
     MovingAverageStrategy(size_t shortWindow = 5, size_t longWindow = 20);
 
+    void bindIndicators(IndicatorRegistry& registry) override;
     void onStart() override;
+    void warmUp(std::span<const Candle> history) override;
     void onData(const Candle& candle) override;
     void onFinish() override;
+    bool saveState(std::string& out) const override;
+    void loadState(const std::string& state) override;
 
     const std::vector<Signal>& signals() const { return signals_; }
 
 private:
     size_t shortWindow_;
     size_t longWindow_;
-    std::deque<double> shortBuf_;
-    std::deque<double> longBuf_;
-    double shortSum_ = 0.0;
-    double longSum_ = 0.0;
+    RollingMean shortMa_;
+    RollingMean longMa_;
+    // Set by bindIndicators: read shared SMAs instead of updating the private ones.
+    IndicatorRef sharedShort_;
+    IndicatorRef sharedLong_;
     // whether short MA was above long MA in previous step (to detect crossings)
     bool lastShortAboveLong_ = false;
 
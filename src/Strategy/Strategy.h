@@ -1,28 +1,77 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 #include "../DataLoader/Candle.h"
 #include "../Model/Order.h"
 
 namespace fastquant {
 
+class IndicatorRegistry;
+
+// BarSlice: every candle that shares one timestamp, delivered together by
+// BacktestEngine::runCrossSectional. symbolIds[i] indexes `universe` for candles[i];
+// ids are stable for the whole run, so strategies can keep per-symbol state in
+// flat vectors instead of maps keyed by string.
+struct BarSlice {
+    std::chrono::system_clock::time_point timestamp;
+    std::span<const Candle> candles;
+    std::span<const uint32_t> symbolIds;
+    const std::vector<std::string>* universe = nullptr;
+
+    size_t size() const { return candles.size(); }
+    const std::string& symbol(size_t i) const { return (*universe)[symbolIds[i]]; }
+};
+
 // Strategy: abstract base class for trading strategies.
 // Implementations should be inexpensive in onData since they run in the backtest loop.
 class Strategy {
 public:
     virtual ~Strategy() = default;
 
+    // Optional: subscribe to indicators shared with the other strategies of a
+    // broadcast run instead of computing private copies. Called before onStart.
+    virtual void bindIndicators(IndicatorRegistry& registry) { (void)registry; }
+
     // Called once before backtest starts.
     virtual void onStart() {}
 
+    // Prime private indicators with the candles just before the run's first
+    // one, so a run that starts mid-series does not spend its first bars on
+    // cold windows. Called after onStart(); emits no orders or signals and
+    // leaves the strategy flat. Strategies bound to shared indicators ignore it.
+    virtual void warmUp(std::span<const Candle> history) { (void)history; }
+
     // Called for every incoming candle. Implementations may emit orders via a callback
     // or update internal state.
     virtual void onData(const Candle& candle) = 0;
 
+    // Called once per timestamp in cross-sectional runs. The default forwards each
+    // candle to onData, so single-symbol strategies work unchanged; portfolio
+    // strategies override this to rank or rebalance across the whole slice.
+    virtual void onBar(const BarSlice& slice) {
+        for (const auto& candle : slice.candles) {
+            onData(candle);
+        }
+    }
+
     // Called once after backtest ends.
     virtual void onFinish() {}
 
+    // Optional checkpoint support: append internal state to `out` and return true.
+    // Engine snapshots taken with a strategy that returns false cannot be resumed.
+    virtual bool saveState(std::string& out) const {
+        (void)out;
+        return false;
+    }
+
+    // Restore what saveState wrote. Called after onStart() when a run resumes.
+    virtual void loadState(const std::string& state) { (void)state; }
+
     // Optional: connect an OrderSink so the strategy can submit orders to the engine.
     void setOrderSink(OrderSink* sink) { orderSink_ = sink; }
 
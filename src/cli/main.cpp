@@ -1,5 +1,9 @@
 #include "../App/RunConfig.h"
 #include "../App/EnvLoader.h"
+#include "../App/StrategyOptimizer.h"
+#include "../App/WalkForward.h"
+#include "../Reporter/ColumnarReport.h"
+#include <algorithm>
 #include <cstdlib>
 #include <filesystem>
 #include <iomanip>
@@ -22,6 +26,7 @@ struct CliOptions {
     bool showSummary = true;
     bool validateOnly = false;
     bool printResolved = false;
+    std::string inspectPath;
 };
 
 void printUsage() {
@@ -31,6 +36,7 @@ void printUsage() {
               << "      --no-summary      Skip printing summary to stdout\n"
               << "      --validate        Only validate the config and exit\n"
               << "      --print-config    Print resolved config details after loading\n"
+              << "      --inspect <path>  Describe a columnar report file and exit\n"
               << "      --version         Print CLI version\n"
               << "  -h, --help           Show this help text\n";
 }
@@ -53,6 +59,23 @@ void printSummary(const ReportSummary& summary, const fastquant::BacktestResult&
               << summary.losingTrades << " losers, win rate "
               << std::setprecision(2) << std::fixed << (summary.winRate * 100.0)
               << "%)\n";
+    std::cout << "Round trips      : " << summary.roundTrips
+              << " (win rate " << (summary.roundTripWinRate * 100.0)
+              << "%, profit factor " << summary.profitFactor << ")\n";
+    std::cout << "Exposure         : " << (summary.exposure * 100.0) << "%\n";
+    std::cout << "Sharpe (per bar) : " << std::setprecision(4) << summary.sharpe
+              << std::setprecision(2) << '\n';
+    if (summary.risk.returns > 0) {
+        const auto& risk = summary.risk;
+        std::cout << "Sharpe / Sortino : " << std::setprecision(4) << risk.sharpe << " / " << risk.sortino
+                  << " (annualized, " << std::setprecision(0) << risk.periodsPerYear << " periods/yr)\n"
+                  << std::setprecision(4);
+        std::cout << "Calmar           : " << risk.calmar << '\n';
+        std::cout << "Max DD (pct/bars): " << std::setprecision(2) << (risk.maxDrawdown * 100.0) << "% / "
+                  << risk.maxDrawdownDuration << '\n';
+        std::cout << "VaR / ES         : " << std::setprecision(4) << (risk.valueAtRisk * 100.0) << "% / "
+                  << (risk.expectedShortfall * 100.0) << "%\n" << std::setprecision(2);
+    }
     std::cout << "Total fees       : " << summary.totalFees << '\n';
     std::cout << "Total slippage   : " << summary.totalSlippage << '\n';
     std::cout << "Orders filled    : " << summary.ordersFilled
@@ -82,6 +105,11 @@ CliOptions parseArgs(int argc, char** argv) {
             opts.validateOnly = true;
         } else if (arg == "--print-config") {
             opts.printResolved = true;
+        } else if (arg == "--inspect") {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for --inspect");
+            }
+            opts.inspectPath = argv[++i];
         } else if (!arg.empty() && arg[0] == '-') {
             std::ostringstream oss;
             oss << "Unknown option: " << arg;
@@ -96,6 +124,26 @@ CliOptions parseArgs(int argc, char** argv) {
     return opts;
 }
 
+void inspectColumnarReport(const std::string& path) {
+    fastquant::ColumnarReport report(path);
+    std::cout << "Columnar report : " << path << '\n';
+    std::cout << "Initial capital : " << report.initialCapital() << '\n';
+    std::cout << "Final equity    : " << report.finalEquity() << '\n';
+    std::cout << "Candles         : " << report.candlesProcessed() << '\n';
+    std::cout << "Symbols         : " << report.symbols().size() << '\n';
+    std::cout << "Columns:\n";
+    for (const auto& column : report.columns()) {
+        std::cout << "  " << std::left << std::setw(26) << column.name << std::right
+                  << std::setw(12) << column.rows << " rows " << std::setw(14) << column.bytes
+                  << " bytes @ " << column.offset << '\n';
+    }
+    const auto equity = report.f64("equity.value");
+    if (!equity.empty()) {
+        const auto [lo, hi] = std::minmax_element(equity.begin(), equity.end());
+        std::cout << "Equity range    : " << *lo << " .. " << *hi << '\n';
+    }
+}
+
 void describeStrategy(const StrategyConfig& strat) {
     std::cout << "    - " << strat.name << " [" << strat.type << "]";
     if (strat.type == "moving_average") {
@@ -109,6 +157,65 @@ void describeStrategy(const StrategyConfig& strat) {
     std::cout << '\n';
 }
 
+void printLeaderboard(const fastquant::app::SweepResult& sweep) {
+    std::cout << "\n=== FastQuant Sweep (" << fastquant::app::toString(sweep.objective) << ") ===\n";
+    std::cout << "Grid points     : " << sweep.gridSize << '\n';
+    std::cout << "Evaluated       : " << sweep.evaluated << " (skipped " << sweep.skipped << " invalid)\n";
+    if (sweep.cacheHits > 0) {
+        std::cout << "Cached          : " << sweep.cacheHits << " points from the result cache\n";
+    }
+    if (sweep.search == fastquant::app::SweepSearch::SuccessiveHalving) {
+        for (const auto& rung : sweep.rungs) {
+            std::cout << "  rung: " << rung.candidates << " configs x " << rung.budget
+                      << " candles -> " << rung.promoted << " promoted\n";
+        }
+        std::cout << "Candles simulated: " << sweep.candlesEvaluated << " of " << sweep.fullGridCandles
+                  << " for the full grid (" << std::fixed << std::setprecision(1)
+                  << (sweep.computeSaved() * 100.0) << "% saved)\n" << std::defaultfloat;
+    }
+    for (size_t i = 0; i < sweep.top.size(); ++i) {
+        const auto& entry = sweep.top[i];
+        std::cout << std::setw(3) << (i + 1) << ". " << entry.config.name
+                  << "  score=" << std::setprecision(6) << std::defaultfloat << entry.score
+                  << "  return=" << std::fixed << std::setprecision(2) << (entry.summary.totalReturn * 100.0) << '%'
+                  << "  max_dd=" << entry.summary.maxDrawdown
+                  << "  trades=" << entry.summary.trades << '\n';
+        std::cout << std::defaultfloat;
+    }
+}
+
+void printWalkForward(const fastquant::app::WalkForwardResult& wf) {
+    std::cout << "\n=== FastQuant Walk-Forward (" << wf.folds.size() << " folds) ===\n";
+    for (const auto& fold : wf.folds) {
+        std::cout << "  fold " << std::setw(3) << fold.index
+                  << "  IS [" << fold.inSampleBegin << ", " << fold.inSampleEnd << ")"
+                  << "  OOS [" << fold.outOfSampleBegin << ", " << fold.outOfSampleEnd << ")  "
+                  << (fold.best.config.name.empty() ? std::string("<no valid config>") : fold.best.config.name)
+                  << "  oos_return=" << std::fixed << std::setprecision(2)
+                  << (fold.outOfSample.totalReturn * 100.0) << "%\n" << std::defaultfloat;
+    }
+    std::cout << "Stitched OOS equity: " << wf.initialCapital << " -> " << wf.finalEquity()
+              << " over " << wf.stitchedEquity.size() << " candles\n";
+}
+
+void printQuantiles(const char* label, const fastquant::QuantileSet& q, double scale) {
+    std::cout << label;
+    for (size_t i = 0; i < q.levels.size(); ++i) {
+        std::cout << "  p" << std::setprecision(0) << std::fixed << (q.levels[i] * 100.0)
+                  << "=" << std::setprecision(2) << (q.values[i] * scale);
+    }
+    std::cout << "  mean=" << std::setprecision(2) << (q.mean * scale) << '\n' << std::defaultfloat;
+}
+
+void printBootstrap(const fastquant::BootstrapResult& bs, const std::string& label) {
+    std::cout << "\n=== Robustness (" << label << ", "
+              << (bs.method == fastquant::BootstrapMethod::TradeReturns ? "trade bootstrap" : "equity block bootstrap")
+              << ", " << bs.paths << " paths x " << bs.sampleSize << " draws) ===\n";
+    printQuantiles("Final equity    :", bs.finalEquity, 1.0);
+    printQuantiles("Max drawdown    :", bs.maxDrawdown, 1.0);
+    printQuantiles("Win rate (%)    :", bs.winRate, 100.0);
+}
+
 void printResolved(const fastquant::app::RunConfig& cfg) {
     std::cout << "\nResolved config:\n";
     std::cout << "  Source file   : " << cfg.sourceConfigPath << '\n';
@@ -134,9 +241,19 @@ void printResolved(const fastquant::app::RunConfig& cfg) {
     for (const auto& strat : cfg.strategies) {
         describeStrategy(strat);
     }
+    if (cfg.sweep) {
+        fastquant::app::ParameterGrid grid(cfg.sweep->base, cfg.sweep->axes);
+        std::cout << "  Sweep         : " << grid.size() << " points over " << cfg.sweep->axes.size()
+                  << " parameters, objective=" << fastquant::app::toString(cfg.sweep->objective)
+                  << ", top_k=" << cfg.sweep->topK
+                  << ", search=" << fastquant::app::toString(cfg.sweep->search)
+                  << ", kernel=" << fastquant::app::toString(cfg.sweep->kernel) << '\n';
+    }
     std::cout << "  Execution     : slippage=" << cfg.execution.defaultSlippageBps
               << " bps, per-share fee=" << cfg.execution.commissionPerShare
-              << ", bps fee=" << cfg.execution.commissionBps << '\n';
+              << ", bps fee=" << cfg.execution.commissionBps
+              << (cfg.summaryOnly ? ", summary only" : "")
+              << ", equity=" << fastquant::toString(cfg.equityRecording.policy) << '\n';
     std::cout << "  Reporter paths: JSON="
               << (cfg.outputs.jsonPath ? *cfg.outputs.jsonPath : "-")
               << ", summary="
@@ -151,6 +268,10 @@ void printResolved(const fastquant::app::RunConfig& cfg) {
 int main(int argc, char** argv) {
     try {
         auto opts = parseArgs(argc, argv);
+        if (!opts.inspectPath.empty()) {
+            inspectColumnarReport(opts.inspectPath);
+            return 0;
+        }
         fastquant::app::loadEnvFile(".env");
         fastquant::app::loadEnvFile(".env.local");
         std::filesystem::path cfgPathCandidate = opts.configPath;
@@ -167,6 +288,33 @@ int main(int argc, char** argv) {
             return 0;
         }
 
+        if (cfg.walkForward) {
+            auto wf = fastquant::app::runWalkForward(cfg);
+            if (opts.showSummary) {
+                printWalkForward(wf);
+            }
+            fastquant::app::writeWalkForwardReports(cfg, wf);
+            if (cfg.walkForward->equityCsvPath) {
+                std::cout << "Stitched OOS equity written to: " << *cfg.walkForward->equityCsvPath << '\n';
+            }
+            if (cfg.walkForward->jsonPath) {
+                std::cout << "Walk-forward report written to: " << *cfg.walkForward->jsonPath << '\n';
+            }
+            return 0;
+        }
+
+        if (cfg.sweep) {
+            auto sweep = fastquant::app::runSweep(cfg);
+            if (opts.showSummary) {
+                printLeaderboard(sweep);
+            }
+            if (cfg.sweep->leaderboardCsvPath) {
+                fastquant::app::writeLeaderboardCsv(sweep, *cfg.sweep->leaderboardCsvPath);
+                std::cout << "Sweep leaderboard written to: " << *cfg.sweep->leaderboardCsvPath << '\n';
+            }
+            return 0;
+        }
+
         auto runs = fastquant::app::executeBacktests(cfg);
         auto reports = fastquant::app::generateReports(cfg, runs);
 
@@ -192,6 +340,24 @@ int main(int argc, char** argv) {
                 std::cout << "[" << label << "] Trades CSV written to     : " << *outputs.tradesCsvPath << '\n';
                 wroteArtifacts = true;
             }
+            if (outputs.roundTripsCsvPath) {
+                std::cout << "[" << label << "] Round trips CSV written to: " << *outputs.roundTripsCsvPath << '\n';
+                wroteArtifacts = true;
+            }
+            if (outputs.equityCsvPath) {
+                std::cout << "[" << label << "] Equity CSV written to     : " << *outputs.equityCsvPath << '\n';
+                wroteArtifacts = true;
+            }
+            if (outputs.columnarPath) {
+                std::cout << "[" << label << "] Columnar report written to: " << *outputs.columnarPath << '\n';
+                wroteArtifacts = true;
+            }
+        }
+
+        if (cfg.robustness) {
+            for (size_t i = 0; i < runs.size(); ++i) {
+                printBootstrap(fastquant::runBootstrap(runs[i].result, *cfg.robustness), runs[i].config.name);
+            }
         }
 
         if (!wroteArtifacts) {
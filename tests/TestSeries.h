@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../src/DataLoader/Candle.h"
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fastquant {
+namespace test {
+
+// Shape of a deterministic test series: close = base + amplitude * sin(i / period)
+// + amplitude2 * sin(i / period2) + drift * i, one bar every `spacing` from the epoch.
+struct SeriesSpec {
+    double base{100.0};
+    double amplitude{5.0};
+    double period{9.0};
+    double amplitude2{0.0}; // optional second harmonic, off by default
+    double period2{1.0};
+    double drift{0.0};
+    double spread{0.0};     // high/low = close -/+ spread
+    double openOffset{0.0}; // open = close - openOffset
+    double volume{0.0};
+    std::string symbol{"TEST"};
+    std::chrono::minutes spacing{1};
+};
+
+inline std::vector<Candle> makeSeries(size_t count, const SeriesSpec& spec = {}) {
+    std::vector<Candle> candles;
+    candles.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const double x = static_cast<double>(i);
+        const double price = spec.base + spec.amplitude * std::sin(x / spec.period) +
+                             spec.amplitude2 * std::sin(x / spec.period2) + spec.drift * x;
+        Candle c;
+        c.timestamp = std::chrono::system_clock::time_point{spec.spacing * static_cast<int64_t>(i)};
+        c.open = price - spec.openOffset;
+        c.high = price + spec.spread;
+        c.low = price - spec.spread;
+        c.close = price;
+        c.volume = spec.volume;
+        c.symbol = spec.symbol;
+        candles.push_back(c);
+    }
+    return candles;
+}
+
+} // namespace test
+} // namespace fastquant
@@ -0,0 +1,162 @@
+#include <catch2/catch.hpp>
+#include "../src/BacktestEngine/BacktestEngine.h"
+#include "../src/Strategy/BreakoutStrategy.h"
+#include "../src/Strategy/MovingAverageStrategy.h"
+#include "TestSeries.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace fastquant;
+
+namespace {
+
+const test::SeriesSpec kSeries{.base = 50.0, .amplitude = 6.0, .period = 4.0, .drift = 0.05, .spread = 0.5,
+                               .openOffset = 0.2, .symbol = "CK"};
+
+std::string snapshotPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("fastquant_" + name + ".snap")).string();
+}
+
+void requireSameRun(const BacktestResult& a, const BacktestResult& b) {
+    REQUIRE(a.candlesProcessed == b.candlesProcessed);
+    REQUIRE(a.trades.size() == b.trades.size());
+    for (size_t i = 0; i < a.trades.size(); ++i) {
+        REQUIRE(a.trades[i].price == b.trades[i].price);
+        REQUIRE(a.trades[i].timestamp == b.trades[i].timestamp);
+    }
+    REQUIRE(a.equityCurve == b.equityCurve);
+    REQUIRE(a.equityTimestamps == b.equityTimestamps);
+    REQUIRE(a.portfolio.cash() == b.portfolio.cash());
+    REQUIRE(a.portfolio.realizedPnl() == b.portfolio.realizedPnl());
+    REQUIRE(a.ordersFilled == b.ordersFilled);
+    REQUIRE(a.ordersRejected == b.ordersRejected);
+    const auto& ta = a.ledger.roundTrips();
+    const auto& tb = b.ledger.roundTrips();
+    REQUIRE(ta.size() == tb.size());
+    for (size_t i = 0; i < ta.size(); ++i) {
+        REQUIRE(ta[i].pnl == tb[i].pnl);
+        REQUIRE(ta[i].mae == tb[i].mae);
+        REQUIRE(ta[i].mfe == tb[i].mfe);
+        REQUIRE(ta[i].entryTime == tb[i].entryTime);
+    }
+    REQUIRE(a.ledger.stats().wins == b.ledger.stats().wins);
+}
+
+} // namespace
+
+TEST_CASE("Resuming from a mid-run snapshot reproduces the full run", "[checkpoint]") {
+    const auto candles = test::makeSeries(300, kSeries);
+    const auto path = snapshotPath("midrun");
+
+    MovingAverageStrategy reference(3, 8);
+    BacktestEngine plain;
+    auto full = plain.run(candles, reference, 5000.0);
+
+    // Simulate a crash: stop at 170 candles, with snapshots every 50.
+    MovingAverageStrategy crashed(3, 8);
+    BacktestEngine first;
+    first.setCheckpoint({path, 50});
+    first.setCandleLimit(170);
+    first.run(candles, crashed, 5000.0);
+
+    auto snapshot = readSnapshot(path);
+    REQUIRE(snapshot.candlesProcessed == 150);
+    REQUIRE(snapshot.hasStrategyState);
+
+    MovingAverageStrategy resumed(3, 8);
+    BacktestEngine second;
+    auto rest = second.resume(snapshot, candles, resumed);
+    requireSameRun(full, rest);
+    REQUIRE(resumed.signals().size() == reference.signals().size());
+    REQUIRE(rest.metrics.points() == full.metrics.points());
+    REQUIRE(rest.metrics.maxDrawdown() == full.metrics.maxDrawdown());
+    REQUIRE(rest.metrics.sharpe() == full.metrics.sharpe());
+    REQUIRE(rest.metrics.winningFills() == full.metrics.winningFills());
+
+    // The history went to one generation of sidecars, appended checkpoint by
+    // checkpoint: it holds exactly the 150 candles the snapshot covers.
+    const auto dir = std::filesystem::path(path).parent_path();
+    const auto prefix = std::filesystem::path(path).filename().string() + ".";
+    std::vector<std::filesystem::path> sidecars;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().filename().string().rfind(prefix, 0) == 0) {
+            sidecars.push_back(entry.path());
+        }
+    }
+    REQUIRE(sidecars.size() == 2);
+    for (const auto& sidecar : sidecars) {
+        if (sidecar.extension() == ".equity") {
+            REQUIRE(std::filesystem::file_size(sidecar) == 150 * 16);
+        }
+    }
+    REQUIRE(std::filesystem::file_size(path) < 4096);
+
+    // A resumed run that checkpoints to the same path starts a new generation
+    // and drops the old one once its snapshot is in place.
+    MovingAverageStrategy again(3, 8);
+    BacktestEngine third;
+    third.setCheckpoint({path, 50});
+    requireSameRun(full, third.resume(readSnapshot(path), candles, again));
+    for (const auto& sidecar : sidecars) {
+        REQUIRE_FALSE(std::filesystem::exists(sidecar));
+    }
+    MovingAverageStrategy tail(3, 8);
+    requireSameRun(full, BacktestEngine().resume(readSnapshot(path), candles, tail));
+
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().filename().string().rfind(prefix, 0) == 0 && entry.path().extension() == ".equity") {
+            std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) - 1);
+        }
+    }
+    REQUIRE_THROWS_WITH(readSnapshot(path), Catch::Contains("Truncated snapshot history"));
+
+    removeSnapshot(path);
+    REQUIRE_FALSE(std::filesystem::exists(path));
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        REQUIRE(entry.path().filename().string().rfind(prefix, 0) != 0);
+    }
+}
+
+TEST_CASE("Snapshot at the end of a run extends to new data", "[checkpoint]") {
+    const auto candles = test::makeSeries(260, kSeries);
+    const auto path = snapshotPath("extend");
+    std::span<const Candle> all(candles);
+
+    BreakoutStrategy reference(10, 0.0, 1.0, true);
+    auto full = BacktestEngine().run(all, reference, 5000.0);
+
+    BreakoutStrategy day1(10, 0.0, 1.0, true);
+    BacktestEngine engine;
+    engine.setCheckpoint({path, 200});
+    engine.run(all.first(200), day1, 5000.0);
+
+    BreakoutStrategy day2(10, 0.0, 1.0, true);
+    auto extended = BacktestEngine().resume(readSnapshot(path), all, day2);
+    requireSameRun(full, extended);
+    removeSnapshot(path);
+}
+
+TEST_CASE("Snapshot reader rejects foreign and truncated files", "[checkpoint]") {
+    const auto path = snapshotPath("bad");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a snapshot at all";
+    }
+    REQUIRE_THROWS_AS(readSnapshot(path), std::runtime_error);
+
+    EngineSnapshot s;
+    s.hasStrategyState = true;
+    s.strategyState = "x";
+    writeSnapshot(s, path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+    REQUIRE_THROWS_AS(readSnapshot(path), std::runtime_error);
+    std::filesystem::remove(path);
+
+    // A double count whose byte size wraps to something small.
+    ByteWriter w;
+    w.put<uint64_t>((uint64_t{1} << 61) + 1);
+    w.put(1.0);
+    ByteReader r(w.data());
+    REQUIRE_THROWS_AS(r.getDoubles<std::vector<double>>(), std::runtime_error);
+}
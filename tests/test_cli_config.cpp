@@ -1,12 +1,14 @@
 #include <catch2/catch.hpp>
 #include "../src/App/RunConfig.h"
 #include "../src/App/EnvLoader.h"
+#include "../src/Reporter/ColumnarReport.h"
 #include <filesystem>
 #include <fstream>
 #include <cstdlib>
 #include <iterator>
 #include <string>
 #include <system_error>
+#include <type_traits>
 
 using fastquant::app::RunConfig;
 
@@ -53,6 +55,8 @@ void writeConfig(const std::filesystem::path& path) {
     "json": "reports/out.json",
     "summary_csv": "reports/summary.csv",
     "trades_csv": "reports/trades.csv",
+    "json_style": "compact",
+    "timestamp_format": "epoch_ms",
     "print_summary": false
   }
 })";
@@ -134,6 +138,8 @@ TEST_CASE("RunConfig drives CLI pipeline", "[cli][config]") {
     auto cfg = fastquant::app::loadRunConfig(cfgPath.string());
     REQUIRE(std::filesystem::path(cfg.dataPath) == std::filesystem::weakly_canonical(csv));
     REQUIRE(cfg.initialCapital == Approx(50000));
+    REQUIRE(cfg.outputs.jsonStyle == fastquant::JsonStyle::Compact);
+    REQUIRE(cfg.outputs.timestampFormat == fastquant::TimestampFormat::EpochMillis);
 
     auto result = fastquant::app::executeBacktest(cfg);
     REQUIRE(result.candlesProcessed == 5);
@@ -152,11 +158,90 @@ TEST_CASE("RunConfig drives CLI pipeline", "[cli][config]") {
     std::ifstream ifs(jsonReport);
     std::string contents((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
     REQUIRE(contents.find("summary") != std::string::npos);
+    REQUIRE(contents.find('\n') == std::string::npos);
+    REQUIRE(contents.find("\"timestamp\":1") != std::string::npos);
 
   std::error_code ec;
   std::filesystem::remove_all(tmp, ec);
 }
 
+TEST_CASE("engine.summary_only runs without trade or equity storage", "[cli][config]") {
+    auto tmp = makeTempDir();
+    writeSampleCsv(tmp / "data.csv");
+    auto cfgPath = tmp / "config.json";
+    {
+        std::ofstream ofs(cfgPath);
+        ofs << R"({
+  "data": {"path": "data.csv", "has_header": true},
+  "strategy": {"type": "moving_average", "short_window": 2, "long_window": 3},
+  "engine": {"initial_capital": 50000, "summary_only": true},
+  "reporter": {"summary_csv": "reports/summary.csv", "print_summary": false}
+})";
+    }
+    auto cfg = fastquant::app::loadRunConfig(cfgPath.string());
+    REQUIRE(cfg.summaryOnly);
+    auto runs = fastquant::app::executeBacktests(cfg);
+    REQUIRE(runs.size() == 1);
+    REQUIRE(runs[0].result.equityCurve.empty());
+    REQUIRE(runs[0].result.metrics.points() == 5);
+    auto reports = fastquant::app::generateReports(cfg, runs);
+    REQUIRE(reports.front().summary.peakEquity > 0.0);
+
+    {
+        std::ofstream ofs(cfgPath);
+        ofs << R"({
+  "data": {"path": "data.csv", "has_header": true},
+  "engine": {"summary_only": true},
+  "reporter": {"trades_csv": "reports/trades.csv"}
+})";
+    }
+    REQUIRE_THROWS_AS(fastquant::app::loadRunConfig(cfgPath.string()), std::runtime_error);
+
+    std::error_code ec;
+    std::filesystem::remove_all(tmp, ec);
+}
+
+TEST_CASE("engine.equity selects the recording policy and equity_csv writes it", "[cli][config]") {
+    auto tmp = makeTempDir();
+    writeSampleCsv(tmp / "data.csv");
+    auto cfgPath = tmp / "config.json";
+    {
+        std::ofstream ofs(cfgPath);
+        ofs << R"({
+  "data": {"path": "data.csv", "has_header": true},
+  "strategy": {"type": "moving_average", "short_window": 2, "long_window": 3},
+  "engine": {"equity": {"policy": "every_n", "every": 2}},
+  "reporter": {"equity_csv": "reports/equity.csv", "binary": "reports/run.fqc", "print_summary": false}
+})";
+    }
+    auto cfg = fastquant::app::loadRunConfig(cfgPath.string());
+    REQUIRE(cfg.outputs.columnarPath);
+    REQUIRE(cfg.equityRecording.policy == fastquant::EquityPolicy::EveryN);
+    REQUIRE(cfg.equityRecording.every == 2);
+    auto runs = fastquant::app::executeBacktests(cfg);
+    REQUIRE(runs[0].result.equityCurve.size() == 3);
+    fastquant::app::generateReports(cfg, runs);
+    std::ifstream in(tmp / "reports" / "equity.csv");
+    size_t lines = 0;
+    for (std::string line; std::getline(in, line);) ++lines;
+    REQUIRE(lines == 4);
+    fastquant::ColumnarReport columnar((tmp / "reports" / "run.fqc").string());
+    REQUIRE(columnar.f64("equity.value").size() == 3);
+    REQUIRE(columnar.f64("equity.value").back() == runs[0].result.equityCurve.back());
+
+    {
+        std::ofstream ofs(cfgPath);
+        ofs << R"({
+  "data": {"path": "data.csv", "has_header": true},
+  "engine": {"equity": {"policy": "sometimes"}}
+})";
+    }
+    REQUIRE_THROWS_AS(fastquant::app::loadRunConfig(cfgPath.string()), std::runtime_error);
+
+    std::error_code ec;
+    std::filesystem::remove_all(tmp, ec);
+}
+
 TEST_CASE("Parallel strategy configs run and produce suffixed reports", "[cli][config][parallel]") {
     auto tmp = makeTempDir();
     auto csv = tmp / "data.csv";
@@ -185,6 +270,15 @@ TEST_CASE("Parallel strategy configs run and produce suffixed reports", "[cli][c
     REQUIRE(std::filesystem::exists(expectJson1));
     REQUIRE(std::filesystem::exists(expectJson2));
 
+    // Reports are written concurrently; each summary still belongs to its own run.
+    for (size_t i = 0; i < runs.size(); ++i) {
+        REQUIRE(reports[i].config.name == runs[i].config.name);
+        const auto direct = fastquant::Reporter().summarize(runs[i].result);
+        REQUIRE(reports[i].summary.finalEquity == direct.finalEquity);
+        REQUIRE(reports[i].summary.trades == direct.trades);
+    }
+    static_assert(!std::is_copy_constructible_v<fastquant::BacktestResult>);
+
     std::error_code ec;
     std::filesystem::remove_all(tmp, ec);
 }
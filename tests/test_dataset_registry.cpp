@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+#include "../src/App/DatasetRegistry.h"
+#include "../src/BacktestEngine/BacktestEngine.h"
+#include "../src/Strategy/MovingAverageStrategy.h"
+#include "TestSeries.h"
+#include <atomic>
+#include <thread>
+
+using namespace fastquant;
+using namespace fastquant::app;
+
+namespace {
+
+test::SeriesSpec registrySeries(double base) {
+    return {.base = base, .amplitude = 3.0, .period = 6.0, .symbol = "DS"};
+}
+
+} // namespace
+
+TEST_CASE("Dataset registry publishes immutable versions that runs can pin", "[datasets]") {
+    DatasetRegistry registry;
+    REQUIRE(registry.get("default") == nullptr);
+    REQUIRE_THROWS_AS(registry.publish("", {}), std::runtime_error);
+
+    auto candles = test::makeSeries(300, registrySeries(40.0));
+    const Candle* storage = candles.data();
+    auto v1 = registry.publish("default", std::move(candles), "first.csv");
+    REQUIRE(v1->version == 1);
+    REQUIRE(v1->candles.data() == storage); // moved in, not copied
+    REQUIRE(registry.get("default") == v1);
+
+    // A run pins v1; publishing v2 does not disturb it.
+    auto pinned = registry.get("default");
+    auto v2 = registry.publish("default", test::makeSeries(200, registrySeries(90.0)), "second.csv");
+    REQUIRE(v2->version == 2);
+    REQUIRE(registry.get("default") == v2);
+    REQUIRE(pinned->candles.size() == 300);
+    REQUIRE(pinned->source == "first.csv");
+
+    BacktestEngine engine;
+    MovingAverageStrategy strat(3, 10);
+    auto result = engine.run(std::span<const Candle>(pinned->candles), strat, 1000.0);
+    REQUIRE(result.candlesProcessed == 300);
+
+    registry.publish("other", test::makeSeries(10, registrySeries(5.0)));
+    auto all = registry.list();
+    REQUIRE(all.size() == 2);
+    REQUIRE(all[0]->name == "default");
+    REQUIRE(all[1]->version == 3);
+
+    REQUIRE(registry.remove("default"));
+    REQUIRE_FALSE(registry.remove("default"));
+    REQUIRE(registry.get("default") == nullptr);
+    REQUIRE(v2->candles.size() == 200); // still alive through its handle
+}
+
+TEST_CASE("Dataset registry readers see whole snapshots during concurrent publishes", "[datasets]") {
+    DatasetRegistry registry;
+    registry.publish("live", test::makeSeries(64, registrySeries(10.0)));
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> torn{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&]() {
+            while (!stop) {
+                auto snap = registry.get("live");
+                // Every version has uniform size derived from its number.
+                if (snap->candles.size() != 64 + (snap->version - 1) % 4) {
+                    ++torn;
+                }
+            }
+        });
+    }
+    for (size_t v = 2; v <= 200; ++v) {
+        registry.publish("live", test::makeSeries(64 + (v - 1) % 4, registrySeries(10.0)));
+    }
+    stop = true;
+    for (auto& r : readers) {
+        r.join();
+    }
+    REQUIRE(torn == 0);
+    REQUIRE(registry.get("live")->version == 200);
+}
@@ -1,11 +1,66 @@
 #include <catch2/catch.hpp>
 #include "../src/BacktestEngine/BacktestEngine.h"
 #include "../src/Strategy/MovingAverageStrategy.h"
+#include "../src/Strategy/BreakoutStrategy.h"
+#include "../src/Strategy/IndicatorRegistry.h"
+#include "TestSeries.h"
 #include <filesystem>
 #include <functional>
+#include <map>
 
 using namespace fastquant;
 
+namespace {
+
+Candle makeBar(int minute, const std::string& symbol, double price) {
+    Candle c;
+    c.timestamp = std::chrono::system_clock::time_point{std::chrono::minutes{minute}};
+    c.open = c.high = c.low = c.close = price;
+    c.symbol = symbol;
+    return c;
+}
+
+// Holds one unit of whichever symbol closed highest in the previous slice.
+class TopRankStrategy : public Strategy {
+public:
+    void onData(const Candle&) override { ++onDataCalls; }
+
+    void onBar(const BarSlice& slice) override {
+        ++bars;
+        sliceSizes.push_back(slice.size());
+        size_t best = 0;
+        for (size_t i = 1; i < slice.size(); ++i) {
+            if (slice.candles[i].close > slice.candles[best].close) {
+                best = i;
+            }
+        }
+        const std::string& winner = slice.symbol(best);
+        if (winner == held) {
+            return;
+        }
+        if (!held.empty()) {
+            submit(held, Side::Sell);
+        }
+        submit(winner, Side::Buy);
+        held = winner;
+    }
+
+    void submit(const std::string& symbol, Side side) {
+        Order o;
+        o.symbol = symbol;
+        o.side = side;
+        o.qty = 1.0;
+        orderSink_->submit(o);
+    }
+
+    size_t bars{0};
+    size_t onDataCalls{0};
+    std::vector<size_t> sliceSizes;
+    std::string held;
+};
+
+} // namespace
+
 TEST_CASE("BacktestEngine runs strategy and captures trades", "engine") {
     MovingAverageStrategy strat(3,5);
     BacktestEngine engine;
@@ -52,3 +107,78 @@ TEST_CASE("BacktestEngine runs multiple strategies in parallel", "engine") {
         REQUIRE(result.ordersFilled == result.trades.size());
     }
 }
+
+TEST_CASE("Cross-sectional run delivers one slice per timestamp", "engine") {
+    // Deliberately out of time order: the engine sorts before slicing.
+    std::vector<Candle> candles{
+        makeBar(1, "B", 12.0), makeBar(0, "A", 10.0), makeBar(0, "B", 11.0), makeBar(0, "C", 9.0),
+        makeBar(1, "A", 10.0), makeBar(2, "A", 13.0), makeBar(2, "C", 9.5), makeBar(1, "C", 9.0),
+    };
+
+    TopRankStrategy strat;
+    BacktestEngine engine;
+    auto result = engine.runCrossSectional(candles, strat, 1000.0);
+
+    REQUIRE(strat.bars == 3);
+    REQUIRE(strat.onDataCalls == 0);
+    REQUIRE(strat.sliceSizes == std::vector<size_t>{3, 3, 2});
+    REQUIRE(result.candlesProcessed == candles.size());
+    REQUIRE(result.equityCurve.size() == 3);
+
+    // t0: B leads, buy B @11. t1: B still leads, hold. t2: B has no bar and A
+    // leads, so buy A @13 fills while the B sell waits for a B candle.
+    std::map<std::string, double> bought;
+    for (const auto& tr : result.trades) {
+        if (tr.side == Side::Buy) {
+            bought[tr.symbol] = tr.price;
+        }
+    }
+    REQUIRE(bought.at("B") == Approx(11.0));
+    REQUIRE(bought.at("A") == Approx(13.0));
+    REQUIRE(result.ordersRejected == 1); // the B sell never found a B candle
+}
+
+TEST_CASE("Cross-sectional default onBar forwards to onData", "engine") {
+    std::vector<Candle> candles;
+    for (int i = 0; i < 40; ++i) {
+        candles.push_back(makeBar(i, "X", 100.0 + (i % 7)));
+    }
+    MovingAverageStrategy perCandle(3, 5);
+    MovingAverageStrategy sliced(3, 5);
+    BacktestEngine engine;
+    auto a = engine.run(candles, perCandle, 1000.0);
+    auto b = engine.runCrossSectional(candles, sliced, 1000.0);
+    REQUIRE(a.trades.size() == b.trades.size());
+    REQUIRE(a.equityCurve == b.equityCurve);
+}
+
+TEST_CASE("Broadcast run matches independent runs and shares indicators", "engine") {
+    const auto candles = test::makeSeries(400, {.base = 100.0, .amplitude = 5.0, .period = 6.0, .amplitude2 = 2.0,
+                                                .period2 = 17.0, .spread = 0.4, .symbol = "BC"});
+
+    std::vector<std::function<std::unique_ptr<Strategy>()>> factories;
+    for (size_t s = 2; s <= 6; ++s) {
+        for (size_t l : {10u, 20u, 30u}) {
+            factories.emplace_back([s, l]() { return std::make_unique<MovingAverageStrategy>(s, l); });
+        }
+    }
+    factories.emplace_back([]() { return std::make_unique<BreakoutStrategy>(12, 0.0, 1.0, true); });
+    factories.emplace_back([]() { return std::make_unique<BreakoutStrategy>(12, 0.1, 2.0, false); });
+
+    BacktestEngine engine;
+    IndicatorRegistry registry;
+    auto shared = engine.runBroadcast(candles, factories, 5000.0, &registry);
+    REQUIRE(shared.size() == factories.size());
+    // 5 short + 3 long SMAs, plus one max/min pair for both breakouts.
+    REQUIRE(registry.nodeCount() == 10);
+    REQUIRE(registry.subscriptionCount() == 34);
+
+    auto parallel = engine.runParallel(candles, factories, 5000.0);
+    for (size_t i = 0; i < factories.size(); ++i) {
+        auto strategy = factories[i]();
+        auto alone = engine.run(candles, *strategy, 5000.0);
+        REQUIRE(shared[i].trades.size() == alone.trades.size());
+        REQUIRE(shared[i].equityCurve == alone.equityCurve);
+        REQUIRE(parallel[i].equityCurve == alone.equityCurve);
+    }
+}
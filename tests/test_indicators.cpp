@@ -0,0 +1,149 @@
+#include <catch2/catch.hpp>
+#include "../src/Strategy/Indicators.h"
+#include "../src/Strategy/IndicatorRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace fastquant;
+
+namespace {
+
+std::vector<double> noisySeries(size_t count) {
+    std::vector<double> xs;
+    uint64_t s = 7;
+    for (size_t i = 0; i < count; ++i) {
+        s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+        xs.push_back(100.0 + static_cast<double>(s >> 40) / 1e5 - 80.0 + std::sin(static_cast<double>(i) / 9.0));
+    }
+    return xs;
+}
+
+} // namespace
+
+TEST_CASE("RingBuffer overwrites the oldest element", "[indicators]") {
+    RingBuffer<int> ring(3);
+    int evicted = -1;
+    REQUIRE_FALSE(ring.push(1, &evicted));
+    ring.push(2);
+    ring.push(3);
+    REQUIRE(ring.full());
+    REQUIRE(ring.push(4, &evicted));
+    REQUIRE(evicted == 1);
+    REQUIRE(ring.front() == 2);
+    REQUIRE(ring.back() == 4);
+    REQUIRE(ring[1] == 3);
+}
+
+TEST_CASE("Rolling extrema and moments match brute force", "[indicators]") {
+    const auto xs = noisySeries(500);
+    for (size_t window : {1u, 2u, 7u, 64u}) {
+        RollingMax hi(window);
+        RollingMin lo(window);
+        RollingMean mean(window);
+        RollingVariance var(window);
+        for (size_t i = 0; i < xs.size(); ++i) {
+            hi.update(xs[i]);
+            lo.update(xs[i]);
+            mean.update(xs[i]);
+            var.update(xs[i]);
+            const size_t begin = i + 1 >= window ? i + 1 - window : 0;
+            const auto first = xs.begin() + static_cast<std::ptrdiff_t>(begin);
+            const auto last = xs.begin() + static_cast<std::ptrdiff_t>(i + 1);
+            REQUIRE(hi.value() == *std::max_element(first, last));
+            REQUIRE(lo.value() == *std::min_element(first, last));
+            REQUIRE(hi.ready() == (i + 1 >= window));
+
+            const double n = static_cast<double>(last - first);
+            const double m = std::accumulate(first, last, 0.0) / n;
+            REQUIRE(mean.value() == Approx(m));
+            if (window > 1) {
+                double ss = 0.0;
+                for (auto it = first; it != last; ++it) {
+                    ss += (*it - m) * (*it - m);
+                }
+                REQUIRE(var.variance() == Approx(ss / n).margin(1e-9));
+            }
+        }
+    }
+}
+
+TEST_CASE("EMA, RSI and ATR follow their textbook recurrences", "[indicators]") {
+    Ema ema(3);
+    for (double x : {1.0, 2.0, 3.0}) {
+        ema.update(x);
+    }
+    REQUIRE(ema.ready());
+    REQUIRE(ema.value() == Approx(2.0));
+    ema.update(6.0);
+    REQUIRE(ema.value() == Approx(4.0));
+
+    Rsi rsi(2);
+    rsi.update(10.0);
+    rsi.update(11.0);
+    REQUIRE_FALSE(rsi.ready());
+    rsi.update(10.0);
+    REQUIRE(rsi.ready());
+    REQUIRE(rsi.value() == Approx(50.0));
+    rsi.update(12.0); // avgGain = (0.5 + 2) / 2, avgLoss = 0.5 / 2
+    REQUIRE(rsi.value() == Approx(100.0 - 100.0 / (1.0 + 1.25 / 0.25)));
+
+    Atr atr(2);
+    atr.update(11.0, 9.0, 10.0);  // TR 2
+    atr.update(14.0, 12.0, 13.0); // TR max(2, 4, 2) = 4
+    REQUIRE(atr.value() == Approx(3.0));
+    atr.update(13.0, 12.0, 12.5); // TR 1
+    REQUIRE(atr.value() == Approx(2.0));
+}
+
+TEST_CASE("Indicator state survives save and load", "[indicators]") {
+    const auto xs = noisySeries(200);
+    RollingMax hi(16);
+    RollingMean mean(16);
+    for (size_t i = 0; i < 100; ++i) {
+        hi.update(xs[i]);
+        mean.update(xs[i]);
+    }
+    ByteWriter w;
+    hi.save(w);
+    mean.save(w);
+
+    RollingMax hi2(16);
+    RollingMean mean2(16);
+    ByteReader r(w.data());
+    hi2.load(r);
+    mean2.load(r);
+    REQUIRE(r.atEnd());
+    for (size_t i = 100; i < xs.size(); ++i) {
+        hi.update(xs[i]);
+        hi2.update(xs[i]);
+        mean.update(xs[i]);
+        mean2.update(xs[i]);
+        REQUIRE(hi.value() == hi2.value());
+        REQUIRE(mean.value() == mean2.value());
+    }
+}
+
+TEST_CASE("IndicatorRegistry de-duplicates identical specs", "[indicators]") {
+    IndicatorRegistry registry;
+    auto a = registry.subscribe({IndicatorKind::Sma, 5});
+    auto b = registry.subscribe({IndicatorKind::Sma, 5});
+    auto c = registry.subscribe({IndicatorKind::Sma, 5, PriceField::High});
+    auto d = registry.subscribe({IndicatorKind::RollingMax, 3, PriceField::High});
+    REQUIRE(registry.nodeCount() == 3);
+    REQUIRE(registry.subscriptionCount() == 4);
+
+    Candle candle;
+    for (int i = 1; i <= 6; ++i) {
+        candle.close = i;
+        candle.high = i + 0.5;
+        registry.update(candle);
+    }
+    REQUIRE(a.value() == b.value());
+    REQUIRE(a.value() == Approx(4.0));
+    REQUIRE(c.value() == Approx(4.5));
+    REQUIRE(d.value() == Approx(6.5));
+    REQUIRE(d.previous() == Approx(5.5));
+    REQUIRE(registry.updatesPerformed() == 18);
+    REQUIRE(registry.updatesRequested() == 24);
+}
@@ -0,0 +1,182 @@
+#include <catch2/catch.hpp>
+#include "../src/App/JobQueue.h"
+#include "../src/BacktestEngine/BacktestEngine.h"
+#include "../src/Strategy/MovingAverageStrategy.h"
+#include "TestSeries.h"
+#include <atomic>
+#include <future>
+#include <thread>
+
+using namespace fastquant;
+using namespace fastquant::app;
+
+namespace {
+
+const test::SeriesSpec kSeries{.base = 80.0, .amplitude = 5.0, .period = 9.0, .symbol = "JQ"};
+
+// Parks the run on candle `at` until the control is cancelled.
+class ParkingStrategy : public Strategy {
+public:
+    ParkingStrategy(RunControl& control, size_t at) : control_(control), at_(at) {}
+    void onData(const Candle&) override {
+        if (++seen_ == at_) {
+            parked = true;
+            while (!control_.cancelRequested()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+    std::atomic<bool> parked{false};
+
+private:
+    RunControl& control_;
+    size_t at_;
+    size_t seen_{0};
+};
+
+template<typename Pred>
+void waitUntil(Pred pred) {
+    for (int i = 0; i < 5000 && !pred(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(pred());
+}
+
+} // namespace
+
+TEST_CASE("Run control stops an engine run at the next candle", "[jobs][engine]") {
+    const auto candles = test::makeSeries(5000, kSeries);
+
+    RunControl control;
+    control.cancel();
+    BacktestEngine engine;
+    engine.setRunControl(&control);
+    MovingAverageStrategy strat(3, 12);
+    auto result = engine.run(candles, strat, 10000.0);
+    REQUIRE(result.cancelled);
+    REQUIRE(result.candlesProcessed == 1);
+    REQUIRE(control.candlesProcessed() == 1);
+
+    RunControl idle;
+    BacktestEngine full;
+    full.setRunControl(&idle);
+    MovingAverageStrategy again(3, 12);
+    auto complete = full.run(candles, again, 10000.0);
+    REQUIRE_FALSE(complete.cancelled);
+    REQUIRE(complete.candlesProcessed == candles.size());
+    REQUIRE(idle.candlesProcessed() == candles.size());
+}
+
+TEST_CASE("A cancel after the last candle leaves the result complete", "[jobs][engine]") {
+    const auto candles = test::makeSeries(3000, kSeries);
+
+    // Lane runs finish one result after another, so a cancel from the first
+    // final progress call lands after the data ran out for every lane.
+    struct CancelOnFinish : RunObserver {
+        RunControl* control{nullptr};
+        void onProgress(size_t, bool finished) override {
+            if (finished) {
+                control->cancel();
+            }
+        }
+    };
+    RunControl control;
+    CancelOnFinish observer;
+    observer.control = &control;
+    BacktestEngine engine;
+    engine.setRunControl(&control);
+    engine.setObserver(&observer);
+    auto results = engine.runMovingAverageLanes(candles, {{3, 12}, {5, 20}});
+    REQUIRE(control.cancelRequested());
+    REQUIRE(results.size() == 2);
+    for (const auto& result : results) {
+        REQUIRE_FALSE(result.cancelled);
+        REQUIRE(result.candlesProcessed == candles.size());
+    }
+}
+
+TEST_CASE("Job queue reports progress and cancels running jobs", "[jobs]") {
+    const auto candles = test::makeSeries(5000, kSeries);
+    JobQueue queue;
+    std::atomic<ParkingStrategy*> parking{nullptr};
+
+    auto id = queue.submit("park", candles.size(), [&](RunControl& control) {
+        ParkingStrategy strat(control, 2500);
+        parking = &strat;
+        BacktestEngine engine;
+        engine.setRunControl(&control);
+        auto result = engine.run(candles, strat, 10000.0);
+        parking = nullptr;
+        return result;
+    });
+    REQUIRE(id);
+    waitUntil([&]() { auto* p = parking.load(); return p && p->parked.load(); });
+
+    auto running = queue.status(*id);
+    REQUIRE(running->state == JobState::Running);
+    REQUIRE(running->candlesProcessed == 2048); // last publish before candle 2500
+    REQUIRE(running->progress == Approx(2048.0 / 5000.0));
+    REQUIRE(queue.result(*id) == nullptr);
+
+    REQUIRE(queue.cancel(*id));
+    auto done = queue.wait(*id);
+    REQUIRE(done->state == JobState::Cancelled);
+    REQUIRE(done->candlesProcessed == 2500);
+    REQUIRE(queue.result(*id) == nullptr);
+    REQUIRE_FALSE(queue.cancel(*id));
+    REQUIRE_FALSE(queue.status(12345));
+}
+
+TEST_CASE("Job queue applies admission control and drops cancelled queued jobs", "[jobs]") {
+    const auto candles = test::makeSeries(400, kSeries);
+    JobQueueConfig cfg;
+    cfg.workers = 1;
+    cfg.maxQueued = 1;
+    cfg.retainFinished = 2;
+    JobQueue queue(cfg);
+
+    std::promise<void> gate;
+    std::shared_future<void> open = gate.get_future().share();
+    auto run = [&](RunControl& control) {
+        open.wait();
+        MovingAverageStrategy strat(3, 12);
+        BacktestEngine engine;
+        engine.setRunControl(&control);
+        return engine.run(candles, strat, 10000.0);
+    };
+
+    auto first = queue.submit("first", candles.size(), run);
+    REQUIRE(first);
+    waitUntil([&]() { return queue.status(*first)->state == JobState::Running; });
+    auto second = queue.submit("second", candles.size(), run);
+    REQUIRE(second);
+    REQUIRE(queue.status(*second)->state == JobState::Queued);
+    REQUIRE_FALSE(queue.submit("third", candles.size(), run)); // queue full -> 429
+    REQUIRE(queue.depth().queued == 1);
+    REQUIRE(queue.depth().running == 1);
+
+    REQUIRE(queue.cancel(*second));
+    REQUIRE(queue.status(*second)->state == JobState::Cancelled);
+    REQUIRE(queue.depth().queued == 0);
+
+    gate.set_value();
+    auto done = queue.wait(*first);
+    REQUIRE(done->state == JobState::Succeeded);
+    REQUIRE(done->progress == 1.0);
+    REQUIRE(queue.depth().running == 0);
+    auto result = queue.result(*first);
+    REQUIRE(result);
+    REQUIRE(result->candlesProcessed == candles.size());
+    REQUIRE(queue.result(*second) == nullptr);
+
+    auto failing = queue.submit("bad", 0, [](RunControl&) -> BacktestResult {
+        throw std::runtime_error("strategy exploded");
+    });
+    REQUIRE(failing);
+    auto failed = queue.wait(*failing);
+    REQUIRE(failed->state == JobState::Failed);
+    REQUIRE(failed->error == "strategy exploded");
+    // Only the two newest finished jobs are retained.
+    REQUIRE_FALSE(queue.status(*second));
+    REQUIRE(queue.status(*first));
+}
@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+#include "../src/App/Metrics.h"
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace fastquant::app;
+
+TEST_CASE("Counters and histograms aggregate per-thread slots on read", "[metrics]") {
+    Counter counter;
+    Histogram histogram({1.0, 10.0, 100.0});
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                counter.inc();
+                histogram.observe(static_cast<double>(i % 200)); // 0..199
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    REQUIRE(counter.value() == 80000);
+
+    const auto s = histogram.snapshot();
+    REQUIRE(s.count == 80000);
+    REQUIRE(s.counts.size() == 4);
+    // Per 200 values: <=1 has 2, (1,10] has 9, (10,100] has 90, the rest 99.
+    REQUIRE(s.counts[0] == 8 * 50 * 2);
+    REQUIRE(s.counts[1] == 8 * 50 * 9);
+    REQUIRE(s.counts[2] == 8 * 50 * 90);
+    REQUIRE(s.counts[3] == 8 * 50 * 99);
+    REQUIRE(s.sum == Approx(8.0 * 50.0 * 19900.0));
+
+    REQUIRE_THROWS_AS(Histogram({2.0, 1.0}), std::runtime_error);
+    const auto buckets = exponentialBuckets(0.5, 2.0, 4);
+    REQUIRE(buckets == std::vector<double>{0.5, 1.0, 2.0, 4.0});
+}
+
+TEST_CASE("Metrics registry renders the Prometheus text format", "[metrics]") {
+    MetricsRegistry registry;
+    auto& ok = registry.counter("requests_total", "Requests served.", {{"route", "/a"}});
+    ok.inc(3);
+    REQUIRE(&registry.counter("requests_total", "Requests served.", {{"route", "/a"}}) == &ok);
+    registry.counter("requests_total", "Requests served.", {{"route", "/b\"q\\"}}).inc();
+    auto& latency = registry.histogram("latency_seconds", "Latency.", {0.1, 1.0});
+    latency.observe(0.05);
+    latency.observe(0.5);
+    latency.observe(5.0);
+    registry.sampled("queue_depth", "Jobs waiting.", MetricType::Gauge, [] {
+        return std::vector<MetricSample>{{{{"state", "queued"}}, 2.0}, {{}, 0.25}};
+    });
+
+    const std::string text = registry.scrape();
+    const std::string expected =
+        "# HELP requests_total Requests served.\n"
+        "# TYPE requests_total counter\n"
+        "requests_total{route=\"/a\"} 3\n"
+        "requests_total{route=\"/b\\\"q\\\\\"} 1\n"
+        "# HELP latency_seconds Latency.\n"
+        "# TYPE latency_seconds histogram\n"
+        "latency_seconds_bucket{le=\"0.1\"} 1\n"
+        "latency_seconds_bucket{le=\"1\"} 2\n"
+        "latency_seconds_bucket{le=\"+Inf\"} 3\n"
+        "latency_seconds_sum 5.55\n"
+        "latency_seconds_count 3\n"
+        "# HELP queue_depth Jobs waiting.\n"
+        "# TYPE queue_depth gauge\n"
+        "queue_depth{state=\"queued\"} 2\n"
+        "queue_depth 0.25\n";
+    REQUIRE(text == expected);
+
+    REQUIRE_THROWS_AS(registry.histogram("requests_total", "x", {1.0}), std::runtime_error);
+    REQUIRE_THROWS_AS(registry.histogram("latency_seconds", "Latency.", {0.2}, {{"route", "/a"}}), std::runtime_error);
+    REQUIRE_THROWS_AS(registry.sampled("h", "x", MetricType::Histogram, [] { return std::vector<MetricSample>{}; }),
+                      std::runtime_error);
+}
@@ -0,0 +1,88 @@
+#include <catch2/catch.hpp>
+#include "../src/Analytics/CounterRng.h"
+#include "../src/Analytics/MonteCarlo.h"
+#include "../src/Strategy/MovingAverageStrategy.h"
+#include "TestSeries.h"
+
+using namespace fastquant;
+
+namespace {
+
+BacktestResult runWave(size_t count) {
+    const auto candles =
+        test::makeSeries(count, {.base = 100.0, .amplitude = 8.0, .period = 5.0, .drift = 0.02, .symbol = "MC"});
+    MovingAverageStrategy strat(3, 8);
+    BacktestEngine engine;
+    return engine.run(candles, strat, 10000.0);
+}
+
+} // namespace
+
+TEST_CASE("Philox4x32-10 matches the Random123 known-answer vector", "[montecarlo]") {
+    auto out = Philox4x32::generate({0, 0, 0, 0}, {0, 0});
+    REQUIRE(out[0] == 0x6627e8d5u);
+    REQUIRE(out[1] == 0xe169c58du);
+    REQUIRE(out[2] == 0xbc57ac4cu);
+    REQUIRE(out[3] == 0x9b00dbd8u);
+}
+
+TEST_CASE("Bootstrap quantiles are reproducible for any thread count", "[montecarlo]") {
+    auto result = runWave(600);
+    const auto tradePnl = closedTradePnl(result);
+    REQUIRE(tradePnl.size() > 5);
+    REQUIRE(tradePnl.size() == result.ledger.roundTrips().size());
+    for (size_t i = 0; i < tradePnl.size(); ++i) {
+        REQUIRE(tradePnl[i] == result.ledger.roundTrips()[i].pnl);
+    }
+
+    for (auto method : {BootstrapMethod::TradeReturns, BootstrapMethod::EquityBlocks}) {
+        BootstrapConfig cfg;
+        cfg.method = method;
+        cfg.paths = 2000;
+        cfg.blockSize = 10;
+        cfg.threads = 1;
+        auto single = runBootstrap(result, cfg);
+        cfg.threads = 4;
+        auto multi = runBootstrap(result, cfg);
+
+        REQUIRE(single.paths == 2000);
+        REQUIRE(single.finalEquity.values == multi.finalEquity.values);
+        REQUIRE(single.maxDrawdown.values == multi.maxDrawdown.values);
+        REQUIRE(single.winRate.values == multi.winRate.values);
+        REQUIRE(single.finalEquity.values.front() <= single.finalEquity.values.back());
+        REQUIRE(single.maxDrawdown.values.front() >= 0.0);
+    }
+}
+
+TEST_CASE("Trade bootstrap of uniformly winning trades never loses", "[montecarlo]") {
+    BacktestResult result(1000.0);
+    Trade buy;
+    buy.side = Side::Buy;
+    buy.qty = 1.0;
+    buy.symbol = "X";
+    Trade sell = buy;
+    sell.side = Side::Sell;
+    for (int i = 0; i < 10; ++i) {
+        buy.price = 100.0;
+        sell.price = 105.0;
+        result.trades.push_back(buy);
+        result.trades.push_back(sell);
+    }
+
+    BootstrapConfig cfg;
+    cfg.paths = 500;
+    auto bs = runBootstrap(result, cfg);
+    REQUIRE(bs.sampleSize == 10);
+    REQUIRE(bs.winRate.values.front() == Approx(1.0));
+    REQUIRE(bs.maxDrawdown.values.back() == Approx(0.0));
+    REQUIRE(bs.finalEquity.mean == Approx(1050.0));
+}
+
+TEST_CASE("computeQuantiles interpolates between ranks", "[montecarlo]") {
+    auto q = computeQuantiles({4.0, 1.0, 3.0, 2.0, 5.0}, {0.0, 0.5, 0.25, 1.0});
+    REQUIRE(q.values[0] == Approx(1.0));
+    REQUIRE(q.values[1] == Approx(3.0));
+    REQUIRE(q.values[2] == Approx(2.0));
+    REQUIRE(q.values[3] == Approx(5.0));
+    REQUIRE(q.mean == Approx(3.0));
+}
@@ -1,6 +1,8 @@
 #include <catch2/catch.hpp>
 #include "../src/Strategy/MovingAverageStrategy.h"
 #include "../src/DataLoader/Candle.h"
+#include "../src/Strategy/MovingAverageLanes.h"
+#include "../src/BacktestEngine/BacktestEngine.h"
 
 using namespace fastquant;
 
@@ -34,3 +36,103 @@ TEST_CASE("MovingAverageStrategy generates buy and sell signals", "ma") {
     REQUIRE(sigs.front().type == SignalType::Buy);
     REQUIRE(sigs.back().type == SignalType::Sell);
 }
+
+TEST_CASE("Engine warm-up primes the windows without trading", "ma") {
+    // Flat history, then a rise the 2/4 crossover can only see with warm windows.
+    std::vector<Candle> history;
+    for (std::time_t t = 0; t < 6; ++t) {
+        history.push_back(make_candle(10.0, t));
+    }
+    const std::vector<Candle> data{make_candle(12.0, 6), make_candle(14.0, 7)};
+
+    BacktestEngine engine;
+    MovingAverageStrategy cold(2, 4);
+    auto coldRun = engine.run(data, cold, 1000.0);
+    REQUIRE(cold.signals().empty());
+    REQUIRE(coldRun.trades.empty());
+
+    engine.setWarmup(history);
+    MovingAverageStrategy warm(2, 4);
+    auto warmRun = engine.run(data, warm, 1000.0);
+    REQUIRE(warm.signals().size() == 1);
+    REQUIRE(warm.signals().front().type == SignalType::Buy);
+    REQUIRE(warm.signals().front().timestamp == data[0].timestamp);
+    REQUIRE(warmRun.trades.size() == 1);
+    REQUIRE(warmRun.equityCurve.size() == data.size());
+}
+
+TEST_CASE("MovingAverageLanes matches MovingAverageStrategy's fills, equity and metrics", "ma") {
+    std::vector<Candle> candles;
+    uint64_t s = 99;
+    double price = 50.0;
+    for (int i = 0; i < 3000; ++i) {
+        s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+        price *= 1.0 + (static_cast<double>(s >> 11) / 9007199254740992.0 - 0.5) * 0.03;
+        Candle c = make_candle(price, i);
+        c.open = price * 1.001;
+        c.symbol = "LN";
+        candles.push_back(c);
+    }
+
+    std::vector<std::pair<size_t, size_t>> windows;
+    for (size_t sw : {1u, 2u, 3u, 5u, 8u, 13u}) {
+        for (size_t lw : {4u, 9u, 21u, 55u, 144u}) {
+            windows.emplace_back(sw, lw);
+        }
+    }
+    windows.emplace_back(30, 10); // swapped like the scalar constructor
+    windows.emplace_back(0, 0);
+
+    ExecutionConfig exec;
+    exec.defaultSlippageBps = 4.0;
+    exec.commissionPerShare = 0.01;
+    BacktestEngine engine(exec);
+    auto lanes = engine.runMovingAverageLanes(candles, windows, 10000.0);
+    REQUIRE(lanes.size() == windows.size());
+
+    for (size_t k = 0; k < windows.size(); ++k) {
+        MovingAverageStrategy scalar(windows[k].first, windows[k].second);
+        auto expected = engine.run(candles, scalar, 10000.0);
+        REQUIRE(lanes[k].trades.size() == expected.trades.size());
+        // Ids are lane-generated, everything else about a fill is identical.
+        for (size_t i = 0; i < expected.trades.size(); ++i) {
+            REQUIRE(lanes[k].trades[i].side == expected.trades[i].side);
+            REQUIRE(lanes[k].trades[i].price == expected.trades[i].price);
+            REQUIRE(lanes[k].trades[i].qty == expected.trades[i].qty);
+            REQUIRE(lanes[k].trades[i].fee == expected.trades[i].fee);
+            REQUIRE(lanes[k].trades[i].timestamp == expected.trades[i].timestamp);
+        }
+        REQUIRE(lanes[k].equityCurve == expected.equityCurve);
+        REQUIRE(lanes[k].portfolio.equity() == expected.portfolio.equity());
+        REQUIRE(lanes[k].portfolio.realizedPnl() == expected.portfolio.realizedPnl());
+        REQUIRE(lanes[k].totalFees == expected.totalFees);
+        REQUIRE(lanes[k].totalSlippage == expected.totalSlippage);
+        REQUIRE(lanes[k].ordersFilled == expected.ordersFilled);
+        const auto& m = lanes[k].metrics;
+        const auto& e = expected.metrics;
+        REQUIRE(m.points() == e.points());
+        REQUIRE(m.fills() == e.fills());
+        REQUIRE(m.winningFills() == e.winningFills());
+        REQUIRE(m.losingFills() == e.losingFills());
+        REQUIRE(m.maxDrawdown() == e.maxDrawdown());
+        REQUIRE(m.exposure() == e.exposure());
+        REQUIRE(m.sharpe() == e.sharpe());
+    }
+
+    // The portable loop and the SIMD path fire identically.
+    MovingAverageLanes simd(windows);
+    MovingAverageLanes portable(windows);
+    portable.setSimdEnabled(false);
+    std::vector<double> closes;
+    for (const auto& c : candles) {
+        closes.push_back(c.close);
+    }
+    std::vector<uint32_t> firedA, firedB;
+    std::vector<int8_t> dirA, dirB;
+    for (size_t t = 0; t < closes.size(); ++t) {
+        simd.step(closes.data(), t, firedA, dirA);
+        portable.step(closes.data(), t, firedB, dirB);
+    }
+    REQUIRE(firedA == firedB);
+    REQUIRE(dirA == dirB);
+}
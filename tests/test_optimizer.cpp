@@ -0,0 +1,329 @@
+#include <catch2/catch.hpp>
+#include "../src/App/RunConfig.h"
+#include "../src/App/StrategyOptimizer.h"
+#include "../src/App/WalkForward.h"
+#include "../src/Strategy/MovingAverageStrategy.h"
+#include "TestSeries.h"
+#include <nlohmann/json.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+using namespace fastquant;
+using namespace fastquant::app;
+
+namespace {
+
+const test::SeriesSpec kSeries{.base = 100.0, .amplitude = 10.0, .period = 7.0, .drift = 0.05, .spread = 0.5,
+                               .volume = 1.0, .symbol = "WAVE", .spacing = std::chrono::hours{1}};
+
+RunConfig makeSweepConfig(size_t threads) {
+    RunConfig cfg;
+    SweepConfig sweep;
+    sweep.base.name = "ma";
+    sweep.base.type = "moving_average";
+    sweep.axes.push_back({"short_window", {2, 3, 4, 5, 6}});
+    sweep.axes.push_back({"long_window", {5, 10, 15, 20}});
+    sweep.topK = 3;
+    sweep.threads = threads;
+    cfg.sweep = sweep;
+    return cfg;
+}
+
+} // namespace
+
+TEST_CASE("ParameterGrid decodes points lazily in mixed radix order", "[optimizer]") {
+    StrategyConfig base;
+    base.name = "grid";
+    ParameterGrid grid(base, {{"short_window", {2, 3}}, {"long_window", {10, 20, 30}}});
+    REQUIRE(grid.size() == 6);
+
+    auto first = grid.at(0);
+    REQUIRE(first.shortWindow == 2);
+    REQUIRE(first.longWindow == 10);
+
+    auto last = grid.at(5);
+    REQUIRE(last.shortWindow == 3);
+    REQUIRE(last.longWindow == 30);
+    REQUIRE(last.name == "grid[short_window=3,long_window=30]");
+
+    REQUIRE_THROWS(ParameterGrid(base, {{"not_a_field", {1}}}));
+}
+
+TEST_CASE("TopK keeps the best entries with deterministic tie breaks", "[optimizer]") {
+    TopK top(2);
+    top.offer({5, {}, {}, 1.0});
+    top.offer({1, {}, {}, 3.0});
+    top.offer({2, {}, {}, 2.0});
+    top.offer({0, {}, {}, 2.0});
+
+    auto sorted = top.sorted();
+    REQUIRE(sorted.size() == 2);
+    REQUIRE(sorted[0].gridIndex == 1);
+    REQUIRE(sorted[1].gridIndex == 0);
+}
+
+TEST_CASE("runSweep ranks the grid identically regardless of thread count", "[optimizer]") {
+    auto candles = test::makeSeries(400, kSeries);
+
+    auto single = runSweep(makeSweepConfig(1), candles);
+    auto multi = runSweep(makeSweepConfig(4), candles);
+
+    REQUIRE(single.gridSize == 20);
+    REQUIRE(single.evaluated + single.skipped == single.gridSize);
+    REQUIRE(single.skipped == 2); // short=5/6 with long=5
+    REQUIRE(single.top.size() == 3);
+    REQUIRE(multi.top.size() == single.top.size());
+    for (size_t i = 0; i < single.top.size(); ++i) {
+        REQUIRE(single.top[i].gridIndex == multi.top[i].gridIndex);
+        REQUIRE(single.top[i].score == multi.top[i].score);
+    }
+    REQUIRE(single.top[0].score >= single.top[1].score);
+
+    // The winner must match a standalone run of the same configuration.
+    auto strategy = buildStrategy(single.top[0].config);
+    BacktestEngine engine;
+    auto direct = Reporter().summarize(engine.run(candles, *strategy, 100000.0));
+    REQUIRE(direct.totalReturn == single.top[0].summary.totalReturn);
+}
+
+TEST_CASE("Moving-average lane kernel ranks the sweep exactly like scalar runs", "[optimizer][lanes]") {
+    auto candles = test::makeSeries(500, kSeries);
+    auto scalarCfg = makeSweepConfig(2);
+    scalarCfg.sweep->topK = 20;
+    scalarCfg.execution.defaultSlippageBps = 7.0;
+    scalarCfg.execution.commissionBps = 3.0;
+    auto lanesCfg = scalarCfg;
+    lanesCfg.sweep->kernel = SweepKernel::MovingAverageLanes;
+
+    auto scalar = runSweep(scalarCfg, candles);
+    auto lanes = runSweep(lanesCfg, candles);
+    REQUIRE(lanes.evaluated == scalar.evaluated);
+    REQUIRE(lanes.top.size() == scalar.top.size());
+    for (size_t i = 0; i < scalar.top.size(); ++i) {
+        REQUIRE(lanes.top[i].gridIndex == scalar.top[i].gridIndex);
+        REQUIRE(lanes.top[i].summary.finalEquity == scalar.top[i].summary.finalEquity);
+        REQUIRE(lanes.top[i].summary.maxDrawdown == scalar.top[i].summary.maxDrawdown);
+        REQUIRE(lanes.top[i].summary.trades == scalar.top[i].summary.trades);
+    }
+}
+
+TEST_CASE("Vectorized kernel screens moving-average sweeps like scalar runs", "[optimizer][vectorized]") {
+    auto candles = test::makeSeries(500, kSeries);
+    auto scalarCfg = makeSweepConfig(2);
+    scalarCfg.sweep->topK = 20;
+    scalarCfg.execution.defaultSlippageBps = 7.0;
+    scalarCfg.execution.commissionBps = 3.0;
+    auto vecCfg = scalarCfg;
+    vecCfg.sweep->kernel = SweepKernel::Vectorized;
+
+    auto scalar = runSweep(scalarCfg, candles);
+    auto vec = runSweep(vecCfg, candles);
+    REQUIRE(vec.evaluated == scalar.evaluated);
+    REQUIRE(vec.candlesEvaluated == scalar.candlesEvaluated);
+    REQUIRE(vec.top.size() == scalar.top.size());
+    for (size_t i = 0; i < scalar.top.size(); ++i) {
+        REQUIRE(vec.top[i].gridIndex == scalar.top[i].gridIndex);
+        REQUIRE(vec.top[i].summary.finalEquity == scalar.top[i].summary.finalEquity);
+        REQUIRE(vec.top[i].summary.maxDrawdown == scalar.top[i].summary.maxDrawdown);
+        REQUIRE(vec.top[i].summary.trades == scalar.top[i].summary.trades);
+        REQUIRE(vec.top[i].summary.totalFees == scalar.top[i].summary.totalFees);
+    }
+
+    // Prefix rungs of successive halving go through the same kernel.
+    scalarCfg.sweep->search = SweepSearch::SuccessiveHalving;
+    vecCfg.sweep->search = SweepSearch::SuccessiveHalving;
+    auto scalarSh = runSweep(scalarCfg, candles);
+    auto vecSh = runSweep(vecCfg, candles);
+    REQUIRE(vecSh.rungs.size() == scalarSh.rungs.size());
+    REQUIRE(vecSh.top.size() == scalarSh.top.size());
+    for (size_t i = 0; i < scalarSh.top.size(); ++i) {
+        REQUIRE(vecSh.top[i].gridIndex == scalarSh.top[i].gridIndex);
+        REQUIRE(vecSh.top[i].summary.finalEquity == scalarSh.top[i].summary.finalEquity);
+    }
+}
+
+TEST_CASE("RunConfig parses sweep ranges and lists", "[optimizer][config]") {
+    auto tmp = std::filesystem::temp_directory_path() / ("fqbt-sweep-" + std::to_string(std::rand()));
+    std::filesystem::create_directories(tmp);
+    {
+        std::ofstream csv(tmp / "data.csv");
+        csv << "timestamp,open,high,low,close,volume,symbol\n";
+        csv << "2024-01-01T00:00:00Z,100,101,99,100,1000,TEST\n";
+    }
+    {
+        std::ofstream ofs(tmp / "sweep.json");
+        ofs << R"({
+  "data": { "path": "data.csv" },
+  "sweep": {
+    "base": { "name": "brk", "type": "breakout", "order_quantity": 2 },
+    "parameters": {
+      "breakout_lookback": { "from": 10, "to": 30, "step": 10 },
+      "breakout_buffer": [0.0, 0.5],
+      "allow_short": [false, true]
+    },
+    "objective": "max_drawdown",
+    "top_k": 4
+  }
+})";
+    }
+
+    auto cfg = loadRunConfig((tmp / "sweep.json").string());
+    REQUIRE(cfg.sweep);
+    REQUIRE(cfg.sweep->base.type == "breakout");
+    REQUIRE(cfg.sweep->objective == SweepObjective::MaxDrawdown);
+    REQUIRE(cfg.sweep->topK == 4);
+    ParameterGrid grid(cfg.sweep->base, cfg.sweep->axes);
+    REQUIRE(grid.size() == 12);
+    REQUIRE(grid.at(11).breakoutLookback == 30);
+    REQUIRE(grid.at(11).allowShort);
+    REQUIRE(grid.at(11).orderQuantity == Approx(2.0));
+    StrategyConfig noLookback = grid.at(0);
+    noLookback.breakoutLookback = 0;
+    REQUIRE_FALSE(ParameterGrid::isValid(noLookback));
+
+    // Fields the base strategy type never reads are rejected rather than swept.
+    {
+        std::ofstream ofs(tmp / "ignored.json");
+        ofs << R"({
+  "data": { "path": "data.csv" },
+  "sweep": {
+    "base": { "type": "moving_average" },
+    "parameters": { "short_window": [2, 3], "order_quantity": [1, 2] }
+  }
+})";
+    }
+    REQUIRE_THROWS_WITH(loadRunConfig((tmp / "ignored.json").string()),
+                        Catch::Contains("'order_quantity' does not apply to strategy type 'moving_average'"));
+
+    std::error_code ec;
+    std::filesystem::remove_all(tmp, ec);
+}
+
+TEST_CASE("Successive halving prunes on prefixes and reports compute saved", "[optimizer][halving]") {
+    auto candles = test::makeSeries(900, kSeries);
+
+    RunConfig cfg;
+    SweepConfig sweep;
+    sweep.base.name = "ma";
+    sweep.base.type = "moving_average";
+    sweep.axes.push_back({"short_window", {2, 3, 4, 5, 6, 7, 8}});
+    sweep.axes.push_back({"long_window", {10, 15, 20, 25, 30, 35, 40, 45, 50}});
+    sweep.topK = 2;
+    sweep.search = SweepSearch::SuccessiveHalving;
+    sweep.eta = 3.0;
+    sweep.minBudget = 1.0 / 9.0;
+    cfg.sweep = sweep;
+
+    auto halving = runSweep(cfg, candles);
+    REQUIRE(halving.rungs.size() == 3);
+    REQUIRE(halving.rungs.front().candidates == 63);
+    REQUIRE(halving.rungs.front().budget == 100);
+    REQUIRE(halving.rungs.back().budget == candles.size());
+    REQUIRE(halving.top.size() == 2);
+    REQUIRE(halving.fullGridCandles == 63 * candles.size());
+    REQUIRE(halving.candlesEvaluated < halving.fullGridCandles / 2);
+    REQUIRE(halving.computeSaved() > 0.5);
+
+    // Survivors are scored on the full dataset, so their summaries match a standalone run.
+    auto strategy = buildStrategy(halving.top[0].config);
+    BacktestEngine engine;
+    auto direct = Reporter().summarize(engine.run(candles, *strategy, 100000.0));
+    REQUIRE(direct.totalReturn == halving.top[0].summary.totalReturn);
+}
+
+TEST_CASE("BacktestEngine candle limit stops the run early", "[engine]") {
+    auto candles = test::makeSeries(50, kSeries);
+    MovingAverageStrategy strat(2, 5);
+    BacktestEngine engine;
+    engine.setCandleLimit(20);
+    auto result = engine.run(candles, strat, 100000.0);
+    REQUIRE(result.candlesProcessed == 20);
+    REQUIRE(result.equityCurve.size() == 20);
+}
+
+TEST_CASE("Walk-forward folds optimise in-sample and stitch out-of-sample equity", "[optimizer][walkforward]") {
+    auto candles = test::makeSeries(600, kSeries);
+
+    RunConfig cfg = makeSweepConfig(0);
+    WalkForwardConfig wf;
+    wf.inSample = 200;
+    wf.outOfSample = 100;
+    cfg.walkForward = wf;
+
+    auto plan = planWalkForward(wf, candles.size());
+    REQUIRE(plan.size() == 4);
+    REQUIRE(plan[1].inSampleBegin == 100);
+    REQUIRE(plan[3].outOfSampleEnd == 600);
+
+    auto result = runWalkForward(cfg, candles);
+    REQUIRE(result.folds.size() == 4);
+    REQUIRE(result.stitchedEquity.size() == 400);
+    REQUIRE(result.stitchedTimestamps.front() == candles[200].timestamp);
+
+    // Each fold's OOS winner replayed on its own slice must reproduce the fold summary.
+    const auto& fold = result.folds[2];
+    auto strategy = buildStrategy(fold.best.config);
+    BacktestEngine engine;
+    std::span<const Candle> oos(candles.data() + fold.outOfSampleBegin, fold.outOfSampleEnd - fold.outOfSampleBegin);
+    engine.setWarmup(std::span<const Candle>(candles.data() + fold.inSampleBegin, fold.inSampleEnd - fold.inSampleBegin));
+    auto direct = Reporter().summarize(engine.run(oos, *strategy, 100000.0));
+    REQUIRE(direct.totalReturn == fold.outOfSample.totalReturn);
+
+    // Chained compounding: the stitched curve ends at the product of fold returns.
+    double expected = 100000.0;
+    for (const auto& f : result.folds) {
+        expected *= 1.0 + f.outOfSample.totalReturn;
+    }
+    REQUIRE(result.finalEquity() == Approx(expected));
+
+    // Reports follow the configured reporter: epoch-ms stamps, compact streamed JSON.
+    auto reportDir = std::filesystem::temp_directory_path() / ("fqbt-wf-report-" + std::to_string(std::rand()));
+    cfg.outputs.timestampFormat = TimestampFormat::EpochMillis;
+    cfg.outputs.jsonStyle = JsonStyle::Compact;
+    cfg.walkForward->jsonPath = (reportDir / "wf.json").string();
+    cfg.walkForward->equityCsvPath = (reportDir / "wf.csv").string();
+    writeWalkForwardReports(cfg, result);
+    std::ifstream jsonIn(*cfg.walkForward->jsonPath);
+    std::string text((std::istreambuf_iterator<char>(jsonIn)), std::istreambuf_iterator<char>());
+    REQUIRE(text.find('\n') == std::string::npos);
+    auto report = nlohmann::json::parse(text);
+    REQUIRE(report["folds"].size() == 4);
+    REQUIRE(report["folds"][2]["best"]["short_window"].get<size_t>() == fold.best.config.shortWindow);
+    REQUIRE(report["folds"][2]["out_of_sample"][0].get<size_t>() == fold.outOfSampleBegin);
+    REQUIRE(report["final_equity"].get<double>() == result.finalEquity());
+    REQUIRE(report["equity_curve"].size() == 400);
+    REQUIRE(report["equity_curve"][0]["timestamp"].get<int64_t>() ==
+            std::chrono::duration_cast<std::chrono::milliseconds>(candles[200].timestamp.time_since_epoch()).count());
+    std::ifstream csvIn(*cfg.walkForward->equityCsvPath);
+    std::string header, first;
+    std::getline(csvIn, header);
+    std::getline(csvIn, first);
+    REQUIRE(first.substr(0, first.find(',')) == std::to_string(report["equity_curve"][0]["timestamp"].get<int64_t>()));
+    std::error_code reportEc;
+    std::filesystem::remove_all(reportDir, reportEc);
+
+    // Overlapping or gapped OOS windows cannot be stitched.
+    cfg.walkForward->step = 50;
+    REQUIRE_THROWS_WITH(runWalkForward(cfg, candles), Catch::Contains("step"));
+
+    auto tmp = std::filesystem::temp_directory_path() / ("fqbt-wf-" + std::to_string(std::rand()));
+    std::filesystem::create_directories(tmp);
+    std::ofstream(tmp / "data.csv") << "timestamp,open,high,low,close,volume,symbol\n";
+    auto writeConfig = [&](int step) {
+        std::ofstream ofs(tmp / "wf.json");
+        ofs << R"({
+  "data": { "path": "data.csv" },
+  "sweep": { "base": { "type": "breakout" }, "parameters": { "breakout_lookback": [10, 20] } },
+  "walk_forward": { "in_sample": 200, "out_of_sample": 100, "step": )" << step << "} }";
+    };
+    writeConfig(150);
+    REQUIRE_THROWS_WITH(loadRunConfig((tmp / "wf.json").string()), Catch::Contains("'step' to equal 'out_of_sample'"));
+    writeConfig(100);
+    REQUIRE(loadRunConfig((tmp / "wf.json").string()).walkForward->step == 100);
+
+    std::error_code ec;
+    std::filesystem::remove_all(tmp, ec);
+}
@@ -0,0 +1,153 @@
+#include <catch2/catch.hpp>
+#include "../src/App/ProgressStream.h"
+#include "../src/BacktestEngine/BacktestEngine.h"
+#include "../src/Strategy/MovingAverageStrategy.h"
+#include "TestSeries.h"
+#include <nlohmann/json.hpp>
+
+using namespace fastquant;
+using namespace fastquant::app;
+
+namespace {
+
+const test::SeriesSpec kSeries{.base = 70.0, .amplitude = 6.0, .period = 15.0, .drift = 0.001, .symbol = "PS"};
+
+struct Recorder : RunObserver {
+    std::vector<double> equity;
+    std::vector<std::chrono::system_clock::time_point> timestamps;
+    std::vector<Trade> trades;
+    std::vector<size_t> progress;
+    size_t finishedCalls{0};
+
+    void onEquity(std::span<const std::chrono::system_clock::time_point> ts, std::span<const double> e) override {
+        timestamps.insert(timestamps.end(), ts.begin(), ts.end());
+        equity.insert(equity.end(), e.begin(), e.end());
+    }
+    void onTrades(std::span<const Trade> t) override { trades.insert(trades.end(), t.begin(), t.end()); }
+    void onProgress(size_t candles, bool finished) override {
+        progress.push_back(candles);
+        finishedCalls += finished ? 1 : 0;
+    }
+};
+
+// SSE chunks -> (event, parsed data)
+std::vector<std::pair<std::string, nlohmann::json>> parseEvents(const std::vector<std::string>& chunks) {
+    std::vector<std::pair<std::string, nlohmann::json>> out;
+    for (const auto& c : chunks) {
+        REQUIRE(c.rfind("event: ", 0) == 0);
+        REQUIRE(c.size() > 2);
+        REQUIRE(c.substr(c.size() - 2) == "\n\n");
+        const auto nl = c.find('\n');
+        const auto data = c.find("data: ");
+        out.emplace_back(c.substr(7, nl - 7), nlohmann::json::parse(c.substr(data + 6, c.size() - data - 8)));
+    }
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("Run observers see every equity point and trade exactly once", "[observer][engine]") {
+    const auto candles = test::makeSeries(5000, kSeries);
+    Recorder rec;
+    BacktestEngine engine;
+    engine.setObserver(&rec);
+    MovingAverageStrategy strat(4, 16);
+    auto result = engine.run(candles, strat, 10000.0);
+
+    REQUIRE(result.trades.size() > 10);
+    REQUIRE(rec.equity == result.equityCurve);
+    REQUIRE(rec.timestamps == result.equityTimestamps);
+    REQUIRE(rec.trades.size() == result.trades.size());
+    REQUIRE(rec.trades.back().id == result.trades.back().id);
+    REQUIRE(rec.progress == std::vector<size_t>{1024, 2048, 3072, 4096, 5000});
+    REQUIRE(rec.finishedCalls == 1);
+
+    // Cursors restart with the next run on the same engine.
+    Recorder second;
+    engine.setObserver(&second);
+    MovingAverageStrategy again(4, 16);
+    engine.run(candles, again, 10000.0);
+    REQUIRE(second.equity.size() == result.equityCurve.size());
+
+    // Summary-only runs report progress alone.
+    Recorder quiet;
+    BacktestEngine summary;
+    summary.setSummaryOnly(true);
+    summary.setObserver(&quiet);
+    MovingAverageStrategy third(4, 16);
+    summary.run(candles, third, 10000.0);
+    REQUIRE(quiet.equity.empty());
+    REQUIRE(quiet.trades.empty());
+    REQUIRE(quiet.progress.back() == candles.size());
+}
+
+TEST_CASE("Cross-sectional runs publish progress although slices skip multiples", "[observer][engine]") {
+    // Three rows per timestamp: the count moves in steps of 3 and only meets a
+    // multiple of kPublishEvery every 3072 candles.
+    std::vector<Candle> candles;
+    for (const auto& c : test::makeSeries(2000, kSeries)) {
+        for (const char* sym : {"AA", "BB", "CC"}) {
+            Candle row = c;
+            row.symbol = sym;
+            candles.push_back(row);
+        }
+    }
+    Recorder rec;
+    BacktestEngine engine;
+    engine.setObserver(&rec);
+    MovingAverageStrategy strat(4, 16);
+    engine.runCrossSectional(candles, strat, 10000.0);
+    REQUIRE(rec.progress == std::vector<size_t>{1026, 2052, 3078, 4104, 5130, 6000});
+    REQUIRE(rec.finishedCalls == 1);
+}
+
+TEST_CASE("Progress stream emits thinned SSE events and stops with the client", "[observer][server]") {
+    const auto candles = test::makeSeries(5000, kSeries);
+    std::vector<std::string> chunks;
+    ProgressStreamConfig cfg;
+    cfg.interval = std::chrono::milliseconds(0);
+    cfg.maxEquityPoints = 500;
+    cfg.maxTradesPerEvent = 5;
+    ProgressStream stream([&](std::string_view c) { chunks.emplace_back(c); return true; }, candles.size(), cfg);
+    REQUIRE(stream.equityStride() == 10);
+
+    BacktestEngine engine;
+    engine.setObserver(&stream);
+    MovingAverageStrategy strat(4, 16);
+    auto result = engine.run(candles, strat, 10000.0);
+    REQUIRE(stream.send("result", "{}"));
+
+    auto events = parseEvents(chunks);
+    REQUIRE(events.size() == 6);
+    REQUIRE(events.back().first == "result");
+    size_t points = 0;
+    for (size_t i = 0; i < 5; ++i) {
+        const auto& [name, data] = events[i];
+        REQUIRE(name == "progress");
+        REQUIRE(data["trades"].size() <= 5);
+        points += data["equity"].size();
+    }
+    const auto& last = events[4].second;
+    REQUIRE(last["finished"] == true);
+    REQUIRE(last["candlesProcessed"] == candles.size());
+    REQUIRE(last["progress"] == 1.0);
+    REQUIRE(last["tradeCount"] == result.trades.size());
+    REQUIRE(last["equity"].back()[1] == result.equityCurve.back());
+    REQUIRE(last["equity"].back()[0] == 299940); // epoch seconds of candle 4999
+    REQUIRE(points == 501); // every 10th point plus the final one
+    REQUIRE(last["trades"][0]["price"] == result.trades.back().price); // newest first
+
+    // A client that goes away cancels the run.
+    RunControl control;
+    size_t accepted = 0;
+    ProgressStream closing([&](std::string_view) { return ++accepted <= 2; }, candles.size(), cfg, &control);
+    BacktestEngine stopped;
+    stopped.setRunControl(&control);
+    stopped.setObserver(&closing);
+    MovingAverageStrategy again(4, 16);
+    auto partial = stopped.run(candles, again, 10000.0);
+    REQUIRE_FALSE(closing.open());
+    REQUIRE(closing.eventsSent() == 2);
+    REQUIRE(partial.cancelled);
+    REQUIRE(partial.candlesProcessed == 3072);
+}
@@ -2,8 +2,19 @@
 #include "../src/BacktestEngine/BacktestEngine.h"
 #include "../src/Strategy/MovingAverageStrategy.h"
 #include "../src/Reporter/Reporter.h"
+#include "../src/Reporter/ColumnarReport.h"
+#include "../src/Reporter/EquityQuery.h"
+#include "TestSeries.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
 
 using namespace fastquant;
 
@@ -46,3 +57,461 @@ TEST_CASE("Reporter generates summaries and files", "reporter") {
     std::filesystem::remove(csvPath);
     std::filesystem::remove(tradesCsv);
 }
+
+TEST_CASE("Cached timestamp formatter matches gmtime across days and epochs", "reporter") {
+    auto reference = [](std::chrono::system_clock::time_point tp) {
+        std::time_t tt = std::chrono::system_clock::to_time_t(std::chrono::floor<std::chrono::seconds>(tp));
+        std::tm tm = *std::gmtime(&tt);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        return std::string(buf);
+    };
+    TimestampFormatter iso;
+    const std::chrono::system_clock::time_point base{std::chrono::seconds{1700000000}};
+    // Minute bars across several midnights, then scattered points both sides of 1970.
+    for (int i = 0; i < 5000; ++i) {
+        auto tp = base + std::chrono::minutes{i} + std::chrono::milliseconds{i % 1000};
+        REQUIRE(iso(tp) == reference(tp));
+    }
+    for (int64_t s : {int64_t{0}, int64_t{-1}, int64_t{-86400}, int64_t{-86401}, int64_t{951782400}, int64_t{4102444799}}) {
+        std::chrono::system_clock::time_point tp{std::chrono::seconds{s}};
+        REQUIRE(iso(tp) == reference(tp));
+    }
+    REQUIRE(iso(base) == Reporter::formatTimestamp(base));
+
+    TimestampFormatter ms(TimestampFormat::EpochMillis);
+    REQUIRE(ms(base + std::chrono::milliseconds{1234}) == "1700000001234");
+    REQUIRE(ms.epoch(std::chrono::system_clock::time_point{std::chrono::microseconds{-1}}) == -1);
+    TimestampFormatter sec(TimestampFormat::EpochSeconds);
+    REQUIRE(sec(base) == "1700000000");
+    REQUIRE(parseTimestampFormat("epoch_ms") == TimestampFormat::EpochMillis);
+    REQUIRE_THROWS(parseTimestampFormat("rfc2822"));
+}
+
+TEST_CASE("Streamed JSON reports parse back to the run in both styles", "reporter") {
+    const auto candles = test::makeSeries(400, {.base = 50.0, .amplitude = 5.0, .period = 7.0, .spread = 0.5,
+                                                .openOffset = 0.2, .symbol = "Q\"1\\\n",
+                                                .spacing = std::chrono::hours{1}});
+    ExecutionConfig exec;
+    exec.commissionBps = 3.0;
+    BacktestEngine engine(exec);
+    MovingAverageStrategy strat(3, 12);
+    auto result = engine.run(candles, strat, 25000.0);
+    REQUIRE_FALSE(result.trades.empty());
+
+    Reporter reporter;
+    const auto summary = reporter.summarize(result);
+    auto tmpdir = std::filesystem::temp_directory_path();
+    auto prettyPath = tmpdir / "report_stream_pretty.json";
+    auto compactPath = tmpdir / "report_stream_compact.json";
+    reporter.writeJson(result, prettyPath.string(), JsonStyle::Pretty);
+    reporter.writeJson(result, compactPath.string(), JsonStyle::Compact);
+
+    auto load = [](const std::filesystem::path& p) {
+        std::ifstream in(p);
+        return nlohmann::json::parse(in);
+    };
+    const auto pretty = load(prettyPath);
+    const auto compact = load(compactPath);
+    REQUIRE(pretty == compact);
+    REQUIRE(std::filesystem::file_size(compactPath) < std::filesystem::file_size(prettyPath));
+
+    // Pretty output is laid out like nlohmann's own dump(2).
+    std::ifstream prettyIn(prettyPath);
+    std::string prettyText((std::istreambuf_iterator<char>(prettyIn)), std::istreambuf_iterator<char>());
+    REQUIRE(prettyText.substr(0, 15) == "{\n  \"summary\": ");
+
+    REQUIRE(pretty["summary"]["final_equity"].get<double>() == summary.finalEquity);
+    REQUIRE(pretty["summary"]["trades"].get<size_t>() == result.trades.size());
+    REQUIRE(pretty["summary"]["sharpe"].is_number_float());
+    REQUIRE(pretty["trades"].size() == result.trades.size());
+    REQUIRE(pretty["trades"][0]["symbol"].get<std::string>() == candles[0].symbol);
+    REQUIRE(pretty["trades"][0]["price"].get<double>() == result.trades[0].price);
+    REQUIRE(pretty["round_trips"].size() == result.ledger.roundTrips().size());
+    REQUIRE(pretty["equity_curve"].size() == result.equityCurve.size());
+    REQUIRE(pretty["equity_curve"].back()["equity"].get<double>() == result.equityCurve.back());
+    REQUIRE(pretty["equity_curve"][0]["timestamp"].get<std::string>() == Reporter::formatTimestamp(candles[0].timestamp));
+    REQUIRE(pretty["equity_recording"]["points"].get<size_t>() == result.equityCurve.size());
+
+    // Epoch-ms reports carry numbers instead of strings.
+    Reporter(TimestampFormat::EpochMillis).writeJson(result, compactPath.string(), JsonStyle::Compact);
+    const auto epochJson = load(compactPath);
+    REQUIRE(epochJson["trades"][0]["timestamp"].get<int64_t>()
+            == std::chrono::duration_cast<std::chrono::milliseconds>(result.trades[0].timestamp.time_since_epoch()).count());
+    REQUIRE(epochJson["equity_curve"][1]["timestamp"].get<int64_t>() == 3600000);
+
+    std::filesystem::remove(prettyPath);
+    std::filesystem::remove(compactPath);
+}
+
+TEST_CASE("Summary-only runs report the same summary without trades or curve", "reporter") {
+    const auto candles = test::makeSeries(600, {.base = 100.0, .amplitude = 8.0, .period = 9.0, .amplitude2 = 3.0,
+                                                .period2 = 2.3, .spread = 1.0, .openOffset = 0.3, .symbol = "SO"});
+
+    ExecutionConfig exec;
+    exec.commissionBps = 2.0;
+    BacktestEngine fullEngine(exec);
+    BacktestEngine lightEngine(exec);
+    lightEngine.setSummaryOnly(true);
+
+    MovingAverageStrategy a(3, 11);
+    MovingAverageStrategy b(3, 11);
+    auto full = fullEngine.run(candles, a, 50000.0);
+    auto light = lightEngine.run(candles, b, 50000.0);
+
+    REQUIRE(light.summaryOnly);
+    REQUIRE(light.trades.empty());
+    REQUIRE(light.equityCurve.empty());
+    REQUIRE(light.equityTimestamps.empty());
+    REQUIRE(light.metrics.points() == candles.size());
+
+    Reporter reporter;
+    auto fs = reporter.summarize(full);
+    auto ls = reporter.summarize(light);
+    REQUIRE(fs.trades > 10);
+    REQUIRE(ls.trades == fs.trades);
+    REQUIRE(ls.finalEquity == fs.finalEquity);
+    REQUIRE(ls.maxDrawdown == fs.maxDrawdown);
+    REQUIRE(ls.peakEquity == fs.peakEquity);
+    REQUIRE(ls.troughEquity == fs.troughEquity);
+    REQUIRE(ls.winningTrades == fs.winningTrades);
+    REQUIRE(ls.losingTrades == fs.losingTrades);
+    REQUIRE(ls.winRate == fs.winRate);
+    REQUIRE(ls.sharpe == fs.sharpe);
+
+    // Online moments agree with a two-pass computation over the stored curve.
+    std::vector<double> returns;
+    for (size_t i = 1; i < full.equityCurve.size(); ++i) {
+        returns.push_back(full.equityCurve[i] / full.equityCurve[i - 1] - 1.0);
+    }
+    double mean = 0.0;
+    for (double r : returns) mean += r;
+    mean /= static_cast<double>(returns.size());
+    double ss = 0.0;
+    for (double r : returns) ss += (r - mean) * (r - mean);
+    const double sd = std::sqrt(ss / static_cast<double>(returns.size() - 1));
+    REQUIRE(ls.returnStdDev == Approx(sd).epsilon(1e-9));
+    REQUIRE(ls.sharpe == Approx(mean / sd).epsilon(1e-6));
+
+    size_t exposed = 0;
+    Portfolio replay(50000.0);
+    size_t next = 0;
+    for (const auto& c : candles) {
+        while (next < full.trades.size() && full.trades[next].timestamp == c.timestamp) {
+            replay.applyTrade(full.trades[next++]);
+        }
+        exposed += replay.hasOpenPosition() ? 1 : 0;
+    }
+    REQUIRE(ls.exposure == Approx(static_cast<double>(exposed) / static_cast<double>(candles.size())));
+
+    // Broadcast and lane runs honour the flag too.
+    std::vector<std::function<std::unique_ptr<Strategy>()>> factories{
+        [] { return std::make_unique<MovingAverageStrategy>(3, 11); }};
+    auto broadcast = lightEngine.runBroadcast(candles, factories, 50000.0);
+    auto lanes = lightEngine.runMovingAverageLanes(candles, {{3, 11}}, 50000.0);
+    REQUIRE(broadcast[0].trades.empty());
+    REQUIRE(lanes[0].equityCurve.empty());
+    REQUIRE(reporter.summarize(broadcast[0]).maxDrawdown == fs.maxDrawdown);
+    REQUIRE(reporter.summarize(lanes[0]).maxDrawdown == fs.maxDrawdown);
+    REQUIRE(reporter.summarize(lanes[0]).exposure == ls.exposure);
+}
+
+TEST_CASE("Equity recording policies bound the stored curve", "reporter") {
+    const auto candles = test::makeSeries(
+        5000, {.base = 100.0, .amplitude = 10.0, .period = 40.0, .amplitude2 = 2.0, .period2 = 3.0, .symbol = "EQ"});
+
+    BacktestEngine plain;
+    MovingAverageStrategy reference(5, 30);
+    auto full = plain.run(candles, reference, 10000.0);
+    Reporter reporter;
+    const auto expected = reporter.summarize(full);
+
+    auto runWith = [&](EquityRecording rec) {
+        BacktestEngine engine;
+        engine.setEquityRecording(rec);
+        MovingAverageStrategy strat(5, 30);
+        return engine.run(candles, strat, 10000.0);
+    };
+    auto requireSameSummary = [&](const BacktestResult& r) {
+        auto s = reporter.summarize(r);
+        REQUIRE(s.maxDrawdown == expected.maxDrawdown);
+        REQUIRE(s.peakEquity == expected.peakEquity);
+        REQUIRE(s.winningTrades == expected.winningTrades);
+        REQUIRE(s.finalEquity == expected.finalEquity);
+    };
+
+    SECTION("every N keeps the phase and the final bar") {
+        EquityRecording rec;
+        rec.policy = EquityPolicy::EveryN;
+        rec.every = 100;
+        auto r = runWith(rec);
+        REQUIRE(r.equityCurve.size() == 51);
+        REQUIRE(r.equityCurve[1] == full.equityCurve[100]);
+        REQUIRE(r.equityTimestamps.back() == full.equityTimestamps.back());
+        requireSameSummary(r);
+    }
+
+    SECTION("on change drops flat stretches only") {
+        EquityRecording rec;
+        rec.policy = EquityPolicy::OnChange;
+        auto r = runWith(rec);
+        REQUIRE(r.equityCurve.size() < full.equityCurve.size());
+        REQUIRE(r.equityCurve.back() == full.equityCurve.back());
+        for (size_t i = 1; i + 1 < r.equityCurve.size(); ++i) {
+            REQUIRE(r.equityCurve[i] != r.equityCurve[i - 1]);
+        }
+        requireSameSummary(r);
+    }
+
+    SECTION("downsampling keeps at most max_points, ends included") {
+        EquityRecording rec;
+        rec.policy = EquityPolicy::Downsample;
+        rec.maxPoints = 200;
+        auto r = runWith(rec);
+        REQUIRE(r.equityCurve.size() <= 200);
+        REQUIRE(r.equityCurve.size() > 100);
+        REQUIRE(r.equityTimestamps.front() == full.equityTimestamps.front());
+        REQUIRE(r.equityTimestamps.back() == full.equityTimestamps.back());
+        REQUIRE(std::is_sorted(r.equityTimestamps.begin(), r.equityTimestamps.end()));
+        requireSameSummary(r);
+    }
+
+    SECTION("spill moves the curve to a temp file and back") {
+        auto dir = std::filesystem::temp_directory_path() / "fastquant-spill-test";
+        EquityRecording rec;
+        rec.policy = EquityPolicy::Spill;
+        rec.spillDir = dir.string();
+        std::string spillPath;
+        {
+            auto r = runWith(rec);
+            REQUIRE(r.equityCurve.empty());
+            REQUIRE(r.equitySpill);
+            REQUIRE(r.equityPointCount() == full.equityCurve.size());
+            spillPath = r.equitySpill->path();
+            REQUIRE(std::filesystem::file_size(spillPath) == full.equityCurve.size() * 16);
+            size_t i = 0;
+            bool same = true;
+            r.forEachEquityPoint([&](std::chrono::system_clock::time_point ts, double e) {
+                same = same && ts == full.equityTimestamps[i] && e == full.equityCurve[i];
+                ++i;
+            });
+            REQUIRE(same);
+            requireSameSummary(r);
+            // Risk metrics would need the curve back in RAM; spilled runs skip them.
+            REQUIRE(reporter.summarize(r).risk.returns == 0);
+
+            auto csv = dir / "equity.csv";
+            reporter.writeEquityCsv(r, csv.string());
+            std::ifstream in(csv);
+            size_t lines = 0;
+            for (std::string line; std::getline(in, line);) ++lines;
+            REQUIRE(lines == full.equityCurve.size() + 1);
+        }
+        REQUIRE_FALSE(std::filesystem::exists(spillPath));
+        std::filesystem::remove_all(dir);
+    }
+}
+
+TEST_CASE("LTTB keeps the extremes of a spiky series", "reporter") {
+    std::vector<double> x, y;
+    for (int i = 0; i < 1000; ++i) {
+        x.push_back(i);
+        y.push_back(i == 321 ? 50.0 : (i == 777 ? -40.0 : std::sin(i / 50.0)));
+    }
+    auto idx = lttbIndices(x, y, 50);
+    REQUIRE(idx.size() <= 50);
+    REQUIRE(idx.front() == 0);
+    REQUIRE(idx.back() == 999);
+    REQUIRE(std::find(idx.begin(), idx.end(), size_t{321}) != idx.end());
+    REQUIRE(std::find(idx.begin(), idx.end(), size_t{777}) != idx.end());
+    REQUIRE(lttbIndices(x, y, 5000).size() == 1000);
+}
+
+TEST_CASE("Equity queries select a time range and thin it to a point budget", "reporter") {
+    using std::chrono::system_clock;
+    std::vector<system_clock::time_point> ts;
+    std::vector<double> equity;
+    for (int i = 0; i < 10000; ++i) {
+        // A weekend-sized gap halfway through: LTTB buckets follow time, not index.
+        const int minute = i < 5000 ? i : i + 3000;
+        ts.push_back(system_clock::time_point{std::chrono::minutes{minute}});
+        equity.push_back(1000.0 + std::sin(i / 40.0) + (i == 2500 ? 30.0 : 0.0));
+    }
+
+    auto all = selectEquityPoints(ts, equity, {});
+    REQUIRE(all.inRange == 10000);
+    REQUIRE(all.indices.size() == 10000);
+
+    EquityQuery coarse;
+    coarse.maxPoints = 200;
+    auto overview = selectEquityPoints(ts, equity, coarse);
+    REQUIRE(overview.indices.size() <= 200);
+    REQUIRE(overview.indices.front() == 0);
+    REQUIRE(overview.indices.back() == 9999);
+    REQUIRE(std::is_sorted(overview.indices.begin(), overview.indices.end()));
+    REQUIRE(std::find(overview.indices.begin(), overview.indices.end(), size_t{2500}) != overview.indices.end());
+
+    // Zoom: inclusive bounds, full detail when the range fits the budget.
+    EquityQuery zoom;
+    zoom.from = ts[1200];
+    zoom.to = ts[1299];
+    zoom.maxPoints = 200;
+    auto detail = selectEquityPoints(ts, equity, zoom);
+    REQUIRE(detail.inRange == 100);
+    REQUIRE(detail.indices.front() == 1200);
+    REQUIRE(detail.indices.back() == 1299);
+
+    zoom.to = ts[8999];
+    zoom.maxPoints = 50;
+    auto wide = selectEquityPoints(ts, equity, zoom);
+    REQUIRE(wide.inRange == 7800);
+    REQUIRE(wide.indices.size() <= 50);
+    REQUIRE(wide.indices.front() == 1200);
+    REQUIRE(wide.indices.back() == 8999);
+
+    EquityQuery empty;
+    empty.from = ts.back() + std::chrono::hours(1);
+    REQUIRE(selectEquityPoints(ts, equity, empty).indices.empty());
+}
+
+TEST_CASE("Columnar reports map back to the run column by column", "reporter") {
+    const auto candles = test::makeSeries(600, {.base = 80.0, .amplitude = 6.0, .period = 9.0, .spread = 0.4,
+                                                .openOffset = 0.1, .symbol = "COL"});
+    ExecutionConfig exec;
+    exec.commissionBps = 2.0;
+    auto dir = std::filesystem::temp_directory_path() / "fastquant-columnar-test";
+    std::filesystem::create_directories(dir);
+    const auto path = (dir / "run.fqc").string();
+
+    auto requireSameRun = [&](const BacktestResult& result) {
+        writeColumnarReport(result, path);
+        ColumnarReport report(path);
+        REQUIRE(report.initialCapital() == result.initialCapital);
+        REQUIRE(report.finalEquity() == result.portfolio.equity());
+        REQUIRE(report.candlesProcessed() == result.candlesProcessed);
+        for (const auto& column : report.columns()) {
+            REQUIRE(column.offset % 64 == 0);
+        }
+
+        const auto times = report.i64("equity.timestamp");
+        const auto values = report.f64("equity.value");
+        REQUIRE(values.size() == result.equityPointCount());
+        REQUIRE(times.size() == values.size());
+        size_t i = 0;
+        bool same = true;
+        result.forEachEquityPoint([&](std::chrono::system_clock::time_point ts, double e) {
+            same = same && values[i] == e
+                && times[i] == std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+            ++i;
+        });
+        REQUIRE(same);
+
+        REQUIRE(report.f64("trades.price").size() == result.trades.size());
+        const auto fillPnl = result.ledger.fillPnl(result.trades);
+        for (size_t t = 0; t < result.trades.size(); ++t) {
+            const auto& trade = result.trades[t];
+            REQUIRE(report.f64("trades.price")[t] == trade.price);
+            REQUIRE(report.f64("trades.qty")[t] == trade.qty);
+            REQUIRE(report.f64("trades.fee")[t] == trade.fee);
+            REQUIRE(report.f64("trades.pnl")[t] == fillPnl[t]);
+            REQUIRE(static_cast<Side>(report.u8("trades.side")[t]) == trade.side);
+            REQUIRE(report.symbols()[report.u32("trades.symbol")[t]] == trade.symbol);
+        }
+        const auto& trips = result.ledger.roundTrips();
+        REQUIRE(report.f64("round_trips.pnl").size() == trips.size());
+        for (size_t t = 0; t < trips.size(); ++t) {
+            REQUIRE(report.f64("round_trips.pnl")[t] == trips[t].pnl);
+            REQUIRE(report.f64("round_trips.mae")[t] == trips[t].mae);
+            REQUIRE(report.symbols()[report.u32("round_trips.symbol")[t]] == result.ledger.symbolName(trips[t]));
+        }
+        REQUIRE_THROWS_AS(report.i64("equity.value"), std::runtime_error);
+        REQUIRE_THROWS_AS(report.f64("no.such.column"), std::runtime_error);
+    };
+
+    SECTION("in-memory curve") {
+        BacktestEngine engine(exec);
+        MovingAverageStrategy strat(4, 15);
+        auto result = engine.run(candles, strat, 30000.0);
+        REQUIRE_FALSE(result.trades.empty());
+        REQUIRE_FALSE(result.ledger.roundTrips().empty());
+        requireSameRun(result);
+    }
+
+    SECTION("spilled curve") {
+        BacktestEngine engine(exec);
+        EquityRecording rec;
+        rec.policy = EquityPolicy::Spill;
+        rec.spillDir = dir.string();
+        engine.setEquityRecording(rec);
+        MovingAverageStrategy strat(4, 15);
+        auto result = engine.run(candles, strat, 30000.0);
+        REQUIRE(result.equitySpill);
+        requireSameRun(result);
+    }
+
+    SECTION("sibling columns with different row counts are rejected") {
+        BacktestEngine engine(exec);
+        MovingAverageStrategy strat(4, 15);
+        auto result = engine.run(candles, strat, 30000.0);
+        REQUIRE(result.trades.size() > 1);
+        writeColumnarReport(result, path);
+
+        // Drop the last row of trades.qty in the directory (rows and bytes agree).
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        const auto entry = bytes.find(std::string("trades.qty") + '\0');
+        REQUIRE(entry != std::string::npos);
+        uint64_t rows = 0;
+        std::memcpy(&rows, bytes.data() + entry + 48, sizeof(rows));
+        const uint64_t shorter = rows - 1;
+        const uint64_t shorterBytes = shorter * sizeof(double);
+        std::memcpy(bytes.data() + entry + 48, &shorter, sizeof(shorter));
+        std::memcpy(bytes.data() + entry + 64, &shorterBytes, sizeof(shorterBytes));
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+        REQUIRE_THROWS_WITH(ColumnarReport(path), Catch::Contains("Invalid columnar report")
+                                                  && Catch::Contains("trades.qty"));
+    }
+
+    SECTION("row counts whose byte size overflows are rejected") {
+        BacktestEngine engine(exec);
+        MovingAverageStrategy strat(4, 15);
+        auto result = engine.run(candles, strat, 30000.0);
+        writeColumnarReport(result, path);
+
+        // rows + 2^61 doubles wraps to the same 64-bit byte size as rows.
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        const auto entry = bytes.find(std::string("trades.price") + '\0');
+        REQUIRE(entry != std::string::npos);
+        uint64_t rows = 0;
+        std::memcpy(&rows, bytes.data() + entry + 48, sizeof(rows));
+        const uint64_t wrapped = rows + (uint64_t{1} << 61);
+        REQUIRE(wrapped * sizeof(double) == rows * sizeof(double));
+        std::memcpy(bytes.data() + entry + 48, &wrapped, sizeof(wrapped));
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+        REQUIRE_THROWS_WITH(ColumnarReport(path), Catch::Contains("trades.price out of bounds"));
+    }
+
+    SECTION("other files are rejected") {
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << "definitely not a columnar report, just some text padding it out";
+        }
+        REQUIRE_THROWS_AS(ColumnarReport(path), std::runtime_error);
+        REQUIRE_THROWS_AS(ColumnarReport((dir / "missing.fqc").string()), std::runtime_error);
+    }
+
+    std::filesystem::remove_all(dir);
+}
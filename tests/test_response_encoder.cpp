@@ -0,0 +1,149 @@
+#include <catch2/catch.hpp>
+#include "../src/Reporter/ResponseEncoder.h"
+#include <cstring>
+#include <zlib.h>
+
+using namespace fastquant;
+using json = nlohmann::json;
+
+namespace {
+
+// Inflates gzip or zlib data (window bits 15 + 32 detect the wrapper).
+std::string inflateAll(std::string_view in) {
+    z_stream zs{};
+    REQUIRE(inflateInit2(&zs, 15 + 32) == Z_OK);
+    std::string out(in.size() * 20 + 1024, '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    zs.next_out = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = static_cast<uInt>(out.size());
+    REQUIRE(inflate(&zs, Z_FINISH) == Z_STREAM_END);
+    out.resize(zs.total_out);
+    inflateEnd(&zs);
+    return out;
+}
+
+json bigBody() {
+    json curve = json::array();
+    for (int i = 0; i < 5000; ++i) {
+        curve.push_back({{"time", 1700000000 + 60 * i}, {"value", 10000.0 + 0.25 * i}});
+    }
+    return {{"strategy", "MA"}, {"trades", 12}, {"equityCurve", std::move(curve)}};
+}
+
+} // namespace
+
+TEST_CASE("Response negotiation follows Accept, Accept-Encoding and explicit formats", "[encoding]") {
+    REQUIRE(negotiateResponseFormat("") == ResponseFormat::Json);
+    REQUIRE(negotiateResponseFormat("text/html, */*") == ResponseFormat::Json);
+    REQUIRE(negotiateResponseFormat("application/json;q=0.5, application/msgpack") == ResponseFormat::MsgPack);
+    REQUIRE(negotiateResponseFormat("application/cbor;q=0.2, application/json;q=0.9") == ResponseFormat::Json);
+    REQUIRE(negotiateResponseFormat("application/x-fastquant-columns") == ResponseFormat::Columns);
+    REQUIRE(negotiateResponseFormat("application/msgpack", "CBOR") == ResponseFormat::Cbor);
+    REQUIRE_THROWS_AS(negotiateResponseFormat("", "xml"), std::runtime_error);
+
+    REQUIRE(negotiateContentCoding("") == ContentCoding::Identity);
+    REQUIRE(negotiateContentCoding("gzip, deflate, br") == ContentCoding::Gzip);
+    REQUIRE(negotiateContentCoding("deflate") == ContentCoding::Deflate);
+    REQUIRE(negotiateContentCoding("gzip;q=0.4, deflate;q=0.8") == ContentCoding::Deflate);
+    REQUIRE(negotiateContentCoding("gzip;q=0, identity") == ContentCoding::Identity);
+    REQUIRE(negotiateContentCoding("*") == ContentCoding::Gzip);
+    REQUIRE(std::string(contentEncoding(ContentCoding::Deflate)) == "deflate");
+    REQUIRE(contentEncoding(ContentCoding::Identity) == nullptr);
+}
+
+TEST_CASE("Response encoder compresses large bodies and round-trips binary formats", "[encoding]") {
+    ResponseEncoder encoder(1024);
+    const json body = bigBody();
+    const std::string plain = body.dump();
+
+    auto asIs = encoder.encode(body, ResponseFormat::Json, ContentCoding::Identity);
+    REQUIRE(asIs.body == plain);
+    REQUIRE(asIs.contentEncoding == nullptr);
+    REQUIRE(std::string(asIs.contentType) == "application/json");
+    // Serialized in place: the next body of the same size lands in the same buffer.
+    REQUIRE(encoder.encode(body, ResponseFormat::Json, ContentCoding::Identity).body.data() == asIs.body.data());
+
+    // Invalid UTF-8 is replaced rather than rejected.
+    auto replaced = encoder.encode(json{{"symbol", "AB\xff"}}, ResponseFormat::Json, ContentCoding::Identity);
+    REQUIRE(replaced.body == "{\"symbol\":\"AB\xef\xbf\xbd\"}");
+
+    for (auto coding : {ContentCoding::Gzip, ContentCoding::Deflate}) {
+        auto packed = encoder.encode(body, ResponseFormat::Json, coding);
+        REQUIRE(std::string(packed.contentEncoding) == contentEncoding(coding));
+        REQUIRE(packed.body.size() * 4 < plain.size());
+        REQUIRE(inflateAll(packed.body) == plain);
+    }
+    // Gzip streams carry the magic bytes; zlib ones do not.
+    auto gz = encoder.encode(body, ResponseFormat::Json, ContentCoding::Gzip);
+    REQUIRE(static_cast<unsigned char>(gz.body[0]) == 0x1f);
+    REQUIRE(static_cast<unsigned char>(gz.body[1]) == 0x8b);
+
+    // Below the threshold the body is sent as is whatever the client accepts.
+    auto small = encoder.encode(json{{"rows", 3}}, ResponseFormat::Json, ContentCoding::Gzip);
+    REQUIRE(small.contentEncoding == nullptr);
+    REQUIRE(small.body == R"({"rows":3})");
+
+    auto mp = encoder.encode(body, ResponseFormat::MsgPack, ContentCoding::Identity);
+    REQUIRE(std::string(mp.contentType) == "application/msgpack");
+    REQUIRE(mp.body.size() < plain.size());
+    REQUIRE(json::from_msgpack(std::string(mp.body)) == body);
+    auto cbor = encoder.encode(body, ResponseFormat::Cbor, ContentCoding::Identity);
+    REQUIRE(json::from_cbor(std::string(cbor.body)) == body);
+}
+
+TEST_CASE("Columns frames carry typed arrays behind a JSON header", "[encoding]") {
+    ResponseColumns columns;
+    columns.add("equityCurve.time", std::vector<int64_t>{1700000000, 1700000060, 1700000120});
+    columns.add("equityCurve.value", std::vector<double>{100.0, 101.5, 99.25});
+    columns.add("recentTrades.side", std::vector<uint8_t>{0, 1, 0, 1, 1});
+    columns.add("recentTrades.price", std::vector<double>{10.0, 11.0, 12.0, 13.0, 14.0});
+
+    ResponseEncoder encoder(1 << 20);
+    auto frame = encoder.encode(json{{"strategy", "MA"}}, ResponseFormat::Columns, ContentCoding::Gzip, &columns);
+    REQUIRE(frame.contentEncoding == nullptr); // under the threshold
+    REQUIRE(std::string(frame.contentType) == "application/x-fastquant-columns");
+
+    const std::string_view bytes = frame.body;
+    REQUIRE(bytes.substr(0, 4) == "FQRC");
+    uint32_t version = 0, headerBytes = 0;
+    std::memcpy(&version, bytes.data() + 4, 4);
+    std::memcpy(&headerBytes, bytes.data() + 8, 4);
+    REQUIRE(version == ResponseEncoder::kColumnsVersion);
+    const json header = json::parse(bytes.substr(12, headerBytes));
+    REQUIRE(header["strategy"] == "MA");
+    REQUIRE(header["columns"].size() == 4);
+    const size_t dataStart = (12 + headerBytes + 7) / 8 * 8;
+
+    auto column = [&](const std::string& name) -> const json& {
+        for (const auto& c : header["columns"]) {
+            if (c["name"] == name) return c;
+        }
+        FAIL("missing column " << name);
+        return header;
+    };
+    const auto& values = column("equityCurve.value");
+    REQUIRE(values["type"] == "f64");
+    REQUIRE(values["rows"] == 3);
+    REQUIRE(values["offset"].get<size_t>() % 8 == 0);
+    double v[3];
+    std::memcpy(v, bytes.data() + dataStart + values["offset"].get<size_t>(), sizeof v);
+    REQUIRE(v[2] == 99.25);
+
+    const auto& sides = column("recentTrades.side");
+    REQUIRE(sides["type"] == "u8");
+    REQUIRE(sides["bytes"] == 5);
+    REQUIRE(bytes[dataStart + sides["offset"].get<size_t>() + 1] == 1);
+
+    const auto& prices = column("recentTrades.price");
+    REQUIRE(prices["offset"] == sides["offset"].get<size_t>() + 8); // padded after 5 bytes
+    REQUIRE(dataStart + prices["offset"].get<size_t>() + 40 == bytes.size());
+
+    // An empty body still gets a header object; bodies that are not objects do not.
+    auto bare = encoder.encode(json::object(), ResponseFormat::Columns, ContentCoding::Identity, &columns);
+    const std::string bareBytes(bare.body);
+    std::memcpy(&headerBytes, bareBytes.data() + 8, 4);
+    REQUIRE(json::parse(bareBytes.substr(12, headerBytes))["columns"].size() == 4);
+    REQUIRE_THROWS_AS(encoder.encode(json::array(), ResponseFormat::Columns, ContentCoding::Identity, &columns),
+                      std::invalid_argument);
+}
@@ -0,0 +1,247 @@
+#include <catch2/catch.hpp>
+#include "../src/App/ResultCache.h"
+#include "../src/App/RunConfig.h"
+#include "../src/App/StrategyOptimizer.h"
+#include "../src/BacktestEngine/BacktestEngine.h"
+#include "../src/Strategy/MovingAverageStrategy.h"
+#include "TestSeries.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+using namespace fastquant;
+using namespace fastquant::app;
+
+namespace {
+
+const test::SeriesSpec kSeries{.base = 50.0, .amplitude = 4.0, .period = 9.0, .drift = 0.01, .volume = 1.0,
+                               .symbol = "RC"};
+
+std::filesystem::path makeTempDir() {
+    auto base = std::filesystem::temp_directory_path();
+    for (int i = 0; i < 32; ++i) {
+        auto candidate = base / std::filesystem::path("fqbt-cache-" + std::to_string(std::rand()));
+        if (!std::filesystem::exists(candidate)) {
+            std::filesystem::create_directories(candidate);
+            return candidate;
+        }
+    }
+    throw std::runtime_error("Unable to create temp directory for result cache test");
+}
+
+StrategyConfig maConfig(size_t shortWindow, size_t longWindow) {
+    StrategyConfig cfg;
+    cfg.type = "moving_average";
+    cfg.shortWindow = shortWindow;
+    cfg.longWindow = longWindow;
+    return cfg;
+}
+
+BacktestResult runMa(const std::vector<Candle>& candles, size_t shortWindow, size_t longWindow) {
+    BacktestEngine engine;
+    MovingAverageStrategy strategy(shortWindow, longWindow);
+    return engine.run(candles, strategy, 100000.0);
+}
+
+} // namespace
+
+TEST_CASE("Result keys follow data content and every result-relevant input", "[cache]") {
+    auto candles = test::makeSeries(200, kSeries);
+    const auto data = fingerprintCandles(candles);
+    REQUIRE(fingerprintCandles(test::makeSeries(200, kSeries)) == data);
+    auto changed = candles;
+    changed[117].close += 1e-9;
+    REQUIRE_FALSE(fingerprintCandles(changed) == data);
+    changed = candles;
+    changed[50].symbol = "XX";
+    REQUIRE_FALSE(fingerprintCandles(changed) == data);
+
+    const ExecutionConfig exec;
+    const auto key = makeResultKey(data, maConfig(3, 12), exec, 1000.0);
+    auto renamed = maConfig(3, 12);
+    renamed.name = "other";
+    renamed.breakoutLookback = 99; // not used by moving averages
+    REQUIRE(makeResultKey(data, renamed, exec, 1000.0) == key);
+    REQUIRE(key.hex().size() == 32);
+
+    REQUIRE_FALSE(makeResultKey(data, maConfig(4, 12), exec, 1000.0) == key);
+    REQUIRE_FALSE(makeResultKey(data, maConfig(3, 12), exec, 1001.0) == key);
+    ExecutionConfig fees;
+    fees.commissionBps = 1.0;
+    REQUIRE_FALSE(makeResultKey(data, maConfig(3, 12), fees, 1000.0) == key);
+    REQUIRE_FALSE(makeResultKey(fingerprintCandles(changed), maConfig(3, 12), exec, 1000.0) == key);
+    RunVariant variant;
+    variant.summaryOnly = true;
+    REQUIRE_FALSE(makeResultKey(data, maConfig(3, 12), exec, 1000.0, variant) == key);
+    variant.candleLimit = 100;
+    const auto limited = makeResultKey(data, maConfig(3, 12), exec, 1000.0, variant);
+    variant.candleLimit = 0;
+    REQUIRE_FALSE(makeResultKey(data, maConfig(3, 12), exec, 1000.0, variant) == limited);
+
+    auto tmp = makeTempDir();
+    const auto csv = tmp / "data.csv";
+    {
+        std::ofstream ofs(csv);
+        ofs << "timestamp,open,high,low,close,volume,symbol\n";
+        ofs << "2024-01-01T00:00:00Z,1,1,1,1,1,X\n";
+    }
+    CSVDataLoader::Config loaderCfg;
+    const auto file = fingerprintFile(csv.string(), loaderCfg);
+    REQUIRE(fingerprintFile(csv.string(), loaderCfg) == file);
+    loaderCfg.hasHeader = false;
+    REQUIRE_FALSE(fingerprintFile(csv.string(), loaderCfg) == file);
+    REQUIRE_THROWS_AS(fingerprintFile((tmp / "missing.csv").string(), loaderCfg), std::runtime_error);
+    std::error_code ec;
+    std::filesystem::remove_all(tmp, ec);
+}
+
+TEST_CASE("Result cache evicts least recently used entries", "[cache]") {
+    auto candles = test::makeSeries(300, kSeries);
+    const auto data = fingerprintCandles(candles);
+    ResultCacheConfig cfg;
+    cfg.maxEntries = 2;
+    ResultCache cache(cfg);
+    const auto k1 = makeResultKey(data, maConfig(2, 10), {}, 100000.0);
+    const auto k2 = makeResultKey(data, maConfig(3, 10), {}, 100000.0);
+    const auto k3 = makeResultKey(data, maConfig(4, 10), {}, 100000.0);
+
+    REQUIRE(cache.find(k1) == nullptr);
+    int runs = 0;
+    bool hit = true;
+    auto first = cache.getOrRun(k1, [&] { ++runs; return runMa(candles, 2, 10); }, &hit);
+    REQUIRE_FALSE(hit);
+    auto again = cache.getOrRun(k1, [&] { ++runs; return runMa(candles, 2, 10); }, &hit);
+    REQUIRE(hit);
+    REQUIRE(runs == 1);
+    REQUIRE(again == first); // the same immutable result, not a re-run
+
+    cache.insert(k2, runMa(candles, 3, 10));
+    REQUIRE(cache.find(k1) != nullptr); // k1 is now the most recent
+    cache.insert(k3, runMa(candles, 4, 10));
+    REQUIRE(cache.find(k2) == nullptr);
+    REQUIRE(cache.find(k1) != nullptr);
+    REQUIRE(cache.find(k3) != nullptr);
+
+    auto stats = cache.stats();
+    REQUIRE(stats.entries == 2);
+    REQUIRE(stats.evictions == 1);
+    REQUIRE(stats.hits == 4);
+    REQUIRE(stats.misses == 3);
+    REQUIRE(stats.bytes >= ResultCache::entryBytes(*first));
+
+    // Cancelled runs are handed back but never stored.
+    BacktestResult cancelled = runMa(candles, 5, 10);
+    cancelled.cancelled = true;
+    const auto k4 = makeResultKey(data, maConfig(5, 10), {}, 100000.0);
+    REQUIRE(cache.insert(k4, std::move(cancelled))->cancelled);
+    REQUIRE(cache.find(k4) == nullptr);
+
+    ResultCacheConfig tiny = cfg;
+    tiny.maxBytes = 1;
+    cache.configure(tiny);
+    REQUIRE(cache.stats().entries == 0);
+}
+
+TEST_CASE("Result cache persists results across instances on disk", "[cache]") {
+    auto candles = test::makeSeries(500, kSeries);
+    const auto key = makeResultKey(fingerprintCandles(candles), maConfig(3, 15), {}, 100000.0);
+    auto tmp = makeTempDir();
+    ResultCacheConfig cfg;
+    cfg.directory = (tmp / "results").string();
+
+    const auto original = ResultCache(cfg).insert(key, runMa(candles, 3, 15));
+    REQUIRE(original->trades.size() > 0);
+    REQUIRE(std::filesystem::exists(tmp / "results" / (key.hex() + ".fqres")));
+
+    ResultCache restarted(cfg);
+    auto restored = restarted.find(key);
+    REQUIRE(restored);
+    REQUIRE(restarted.stats().diskHits == 1);
+    REQUIRE(restored->equityCurve == original->equityCurve);
+    REQUIRE(restored->equityTimestamps == original->equityTimestamps);
+    REQUIRE(restored->trades.size() == original->trades.size());
+    REQUIRE(restored->ledger.roundTrips().size() == original->ledger.roundTrips().size());
+    const auto a = Reporter().summarize(*original);
+    const auto b = Reporter().summarize(*restored);
+    REQUIRE(a.finalEquity == b.finalEquity);
+    REQUIRE(a.realizedPnl == b.realizedPnl);
+    REQUIRE(a.roundTrips == b.roundTrips);
+    REQUIRE(a.risk.sharpe == b.risk.sharpe);
+
+    // A torn file is a miss, not an error.
+    {
+        std::ofstream ofs(tmp / "results" / (key.hex() + ".fqres"), std::ios::trunc);
+        ofs << "garbage";
+    }
+    REQUIRE(ResultCache(cfg).find(key) == nullptr);
+    std::error_code ec;
+    std::filesystem::remove_all(tmp, ec);
+}
+
+TEST_CASE("Sweeps and executeBacktests reuse cached results", "[cache][optimizer]") {
+    ResultCache::shared().clear();
+    auto candles = test::makeSeries(600, kSeries);
+    RunConfig cfg;
+    SweepConfig sweep;
+    sweep.base.type = "moving_average";
+    sweep.axes.push_back({"short_window", {2, 3, 4}});
+    sweep.axes.push_back({"long_window", {10, 20}});
+    sweep.topK = 3;
+    cfg.sweep = sweep;
+    cfg.cache = ResultCacheConfig{};
+
+    const auto cold = runSweep(cfg, candles);
+    REQUIRE(cold.cacheHits == 0);
+    const auto warm = runSweep(cfg, candles);
+    REQUIRE(warm.cacheHits == warm.evaluated);
+    REQUIRE(warm.candlesEvaluated == 0);
+    REQUIRE(warm.top.size() == cold.top.size());
+    for (size_t i = 0; i < warm.top.size(); ++i) {
+        REQUIRE(warm.top[i].gridIndex == cold.top[i].gridIndex);
+        REQUIRE(warm.top[i].score == cold.top[i].score);
+    }
+
+    auto tmp = makeTempDir();
+    {
+        std::ofstream ofs(tmp / "data.csv");
+        ofs << "timestamp,open,high,low,close,volume,symbol\n";
+        const auto bars = test::makeSeries(60, {.base = 20.0, .amplitude = 2.0, .period = 4.0, .symbol = "CSV"});
+        for (int i = 0; i < 60; ++i) {
+            const double p = bars[i].close;
+            ofs << "2024-01-01T" << (i / 60 < 10 ? "0" : "") << i / 60 << ':' << (i % 60 < 10 ? "0" : "") << i % 60
+                << ":00Z," << p << ',' << p << ',' << p << ',' << p << ",1,CSV\n";
+        }
+    }
+    {
+        std::ofstream ofs(tmp / "config.json");
+        ofs << R"({
+  "data": {"path": "data.csv", "has_header": true},
+  "strategies": [
+    {"name": "fast", "type": "moving_average", "short_window": 2, "long_window": 5},
+    {"name": "slow", "type": "moving_average", "short_window": 3, "long_window": 8}
+  ],
+  "engine": {"cache": {"max_entries": 16, "dir": "cache"}},
+  "reporter": {"print_summary": false}
+})";
+    }
+    auto runCfg = loadRunConfig((tmp / "config.json").string());
+    REQUIRE(runCfg.cache);
+    REQUIRE(runCfg.cache->maxEntries == 16);
+    const auto before = ResultCache::shared().stats();
+    const auto first = executeBacktests(runCfg);
+    const auto second = executeBacktests(runCfg);
+    const auto after = ResultCache::shared().stats();
+    REQUIRE(after.insertions - before.insertions == 2);
+    REQUIRE(after.hits - before.hits == 2);
+    REQUIRE(second.size() == 2);
+    REQUIRE(second[1].config.name == "slow");
+    for (size_t i = 0; i < 2; ++i) {
+        REQUIRE(second[i].result.equityCurve == first[i].result.equityCurve);
+        REQUIRE(second[i].result.trades.size() == first[i].result.trades.size());
+    }
+    REQUIRE(std::filesystem::exists(tmp / "cache"));
+    ResultCache::shared().configure(ResultCacheConfig{});
+    ResultCache::shared().clear();
+    std::error_code ec;
+    std::filesystem::remove_all(tmp, ec);
+}
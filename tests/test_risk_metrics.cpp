@@ -0,0 +1,191 @@
+#include <catch2/catch.hpp>
+#include "../src/Analytics/RiskMetrics.h"
+#include "../src/BacktestEngine/BacktestEngine.h"
+#include "../src/Strategy/MovingAverageStrategy.h"
+#include "../src/Reporter/Reporter.h"
+#include "TestSeries.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace fastquant;
+
+namespace {
+
+using TimePoint = std::chrono::system_clock::time_point;
+
+struct Series {
+    std::vector<double> equity;
+    std::vector<TimePoint> timestamps;
+};
+
+// Random walk with drift and a few crashes, one point per hour.
+Series makeSeries(size_t points, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> noise(0.0002, 0.01);
+    Series s;
+    double equity = 10000.0;
+    for (size_t i = 0; i < points; ++i) {
+        s.equity.push_back(equity);
+        s.timestamps.push_back(TimePoint{std::chrono::hours{static_cast<int64_t>(i)}});
+        double r = noise(rng);
+        if (i % 5000 == 4999) {
+            r -= 0.08;
+        }
+        equity *= 1.0 + r;
+    }
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("Risk metrics match straightforward reference loops", "[risk]") {
+    // Large enough for the sampled tail selection; odd length exercises the kernel tails.
+    const auto s = makeSeries(150001, 7);
+    RiskMetricsConfig cfg;
+    cfg.volatilityWindow = 50;
+    const auto risk = computeRiskMetrics(s.equity, s.timestamps, cfg);
+
+    std::vector<double> r;
+    for (size_t i = 1; i < s.equity.size(); ++i) {
+        r.push_back(s.equity[i] / s.equity[i - 1] - 1.0);
+    }
+    const double n = static_cast<double>(r.size());
+    double mean = 0.0;
+    for (double x : r) mean += x;
+    mean /= n;
+    double m2 = 0.0, m3 = 0.0, m4 = 0.0, down = 0.0;
+    for (double x : r) {
+        const double d = x - mean;
+        m2 += d * d;
+        m3 += d * d * d;
+        m4 += d * d * d * d;
+        down += std::min(x, 0.0) * std::min(x, 0.0);
+    }
+    const double ppy = 365.25 * 24.0;
+    const double vol = std::sqrt(m2 / (n - 1.0));
+
+    REQUIRE(risk.returns == r.size());
+    REQUIRE(risk.periodsPerYear == Approx(ppy));
+    REQUIRE(risk.meanReturn == Approx(mean).epsilon(1e-9));
+    REQUIRE(risk.volatility == Approx(vol).epsilon(1e-9));
+    REQUIRE(risk.sharpe == Approx(mean / vol * std::sqrt(ppy)).epsilon(1e-9));
+    REQUIRE(risk.sortino == Approx(mean / std::sqrt(down / n) * std::sqrt(ppy)).epsilon(1e-9));
+    REQUIRE(risk.skewness == Approx((m3 / n) / std::pow(m2 / n, 1.5)).epsilon(1e-7));
+    REQUIRE(risk.excessKurtosis == Approx((m4 / n) / std::pow(m2 / n, 2.0) - 3.0).epsilon(1e-7));
+    REQUIRE(risk.worstReturn == *std::min_element(r.begin(), r.end()));
+    REQUIRE(risk.bestReturn == *std::max_element(r.begin(), r.end()));
+
+    double peak = s.equity[0], maxDd = 0.0;
+    size_t peakAt = 0, longest = 0;
+    for (size_t i = 0; i < s.equity.size(); ++i) {
+        if (s.equity[i] >= peak) {
+            peak = s.equity[i];
+            peakAt = i;
+        }
+        maxDd = std::max(maxDd, (peak - s.equity[i]) / peak);
+        longest = std::max(longest, i - peakAt);
+    }
+    REQUIRE(risk.maxDrawdown == Approx(maxDd));
+    REQUIRE(risk.maxDrawdownDuration == longest);
+    REQUIRE(risk.maxDrawdownDurationSeconds == Approx(3600.0 * static_cast<double>(longest)));
+    const double years = n / ppy;
+    const double cagr = std::pow(s.equity.back() / s.equity.front(), 1.0 / years) - 1.0;
+    REQUIRE(risk.annualizedReturn == Approx(cagr).epsilon(1e-9));
+    REQUIRE(risk.calmar == Approx(cagr / maxDd).epsilon(1e-9));
+
+    auto sorted = r;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t k = static_cast<size_t>(std::ceil(0.05 * n)) - 1;
+    double tail = 0.0;
+    for (size_t i = 0; i <= k; ++i) tail += sorted[i];
+    REQUIRE(risk.valueAtRisk == -sorted[k]);
+    REQUIRE(risk.expectedShortfall == Approx(-tail / static_cast<double>(k + 1)).epsilon(1e-12));
+
+    const auto rolling = rollingVolatility(r, 50);
+    REQUIRE(rolling.size() == r.size() - 49);
+    auto windowVol = [&](size_t from) {
+        double wm = 0.0;
+        for (size_t i = from; i < from + 50; ++i) wm += r[i];
+        wm /= 50.0;
+        double ss = 0.0;
+        for (size_t i = from; i < from + 50; ++i) ss += (r[i] - wm) * (r[i] - wm);
+        return std::sqrt(ss / 49.0);
+    };
+    REQUIRE(rolling.front() == Approx(windowVol(0)).epsilon(1e-9));
+    REQUIRE(rolling.back() == Approx(windowVol(r.size() - 50)).epsilon(1e-6));
+    REQUIRE(risk.rollingVolatility == Approx(rolling.back() * std::sqrt(ppy)).epsilon(1e-6));
+    REQUIRE(risk.maxRollingVolatility == Approx(*std::max_element(rolling.begin(), rolling.end()) * std::sqrt(ppy)).epsilon(1e-6));
+}
+
+TEST_CASE("Risk kernels agree across SIMD and scalar paths", "[risk]") {
+    const auto s = makeSeries(70003, 11);
+    RiskMetricsConfig scalar;
+    scalar.allowSimd = false;
+    const auto a = computeRiskMetrics(s.equity, s.timestamps, scalar);
+    const auto b = computeRiskMetrics(s.equity, s.timestamps);
+    // Lane-ordered accumulation makes the two paths bitwise identical.
+    REQUIRE(a.meanReturn == b.meanReturn);
+    REQUIRE(a.volatility == b.volatility);
+    REQUIRE(a.downsideDeviation == b.downsideDeviation);
+    REQUIRE(a.skewness == b.skewness);
+    REQUIRE(a.excessKurtosis == b.excessKurtosis);
+    REQUIRE(a.worstReturn == b.worstReturn);
+    REQUIRE(a.valueAtRisk == b.valueAtRisk);
+    REQUIRE(a.rollingVolatility == b.rollingVolatility);
+}
+
+TEST_CASE("Risk metrics handle short series and explicit annualization", "[risk]") {
+    REQUIRE(computeRiskMetrics({}, {}).returns == 0);
+    const std::vector<double> one{100.0};
+    REQUIRE(computeRiskMetrics(one, {}).sharpe == 0.0);
+
+    const std::vector<double> flat(10, 100.0);
+    const auto f = computeRiskMetrics(flat, {});
+    REQUIRE(f.periodsPerYear == 252.0);
+    REQUIRE(f.volatility == 0.0);
+    REQUIRE(f.sharpe == 0.0);
+    REQUIRE(f.maxDrawdown == 0.0);
+    REQUIRE(f.valueAtRisk == 0.0);
+
+    const std::vector<double> equity{100.0, 110.0, 99.0, 105.0, 120.0};
+    RiskMetricsConfig cfg;
+    cfg.periodsPerYear = 12.0;
+    cfg.volatilityWindow = 3;
+    cfg.tailLevel = 0.25;
+    const auto m = computeRiskMetrics(equity, {}, cfg);
+    REQUIRE(m.returns == 4);
+    REQUIRE(m.maxDrawdown == Approx(0.1));
+    REQUIRE(m.maxDrawdownDuration == 2);
+    REQUIRE(m.worstReturn == Approx(-0.1));
+    REQUIRE(m.valueAtRisk == Approx(0.1));
+    REQUIRE(m.expectedShortfall == Approx(0.1));
+    REQUIRE(m.annualizedReturn == Approx(std::pow(1.2, 3.0) - 1.0));
+
+    const std::vector<TimePoint> mismatched(3);
+    REQUIRE_THROWS_AS(computeRiskMetrics(equity, mismatched), std::runtime_error);
+}
+
+TEST_CASE("Report summaries carry risk metrics for full curves only", "[risk][reporter]") {
+    const auto candles = test::makeSeries(3000, {.base = 60.0, .amplitude = 4.0, .period = 25.0, .drift = 0.002,
+                                                 .symbol = "RK", .spacing = std::chrono::hours{24}});
+    BacktestEngine engine;
+    MovingAverageStrategy strat(5, 20);
+    auto result = engine.run(candles, strat, 10000.0);
+    const auto summary = Reporter().summarize(result);
+    REQUIRE(summary.risk.returns == result.equityCurve.size() - 1);
+    REQUIRE(summary.risk.periodsPerYear == Approx(365.25));
+    // The worst absolute drawdown started from a peak no higher than the global one.
+    REQUIRE(summary.risk.maxDrawdown > 0.0);
+    REQUIRE(summary.risk.maxDrawdown >= summary.maxDrawdown / summary.peakEquity - 1e-12);
+
+    RiskMetricsConfig cfg;
+    cfg.periodsPerYear = 252.0;
+    REQUIRE(Reporter(TimestampFormat::Iso8601, cfg).summarize(result).risk.periodsPerYear == 252.0);
+
+    BacktestEngine quick;
+    quick.setSummaryOnly(true);
+    MovingAverageStrategy again(5, 20);
+    auto summaryOnly = quick.run(candles, again, 10000.0);
+    REQUIRE(Reporter().summarize(summaryOnly).risk.returns == 0);
+}
@@ -0,0 +1,178 @@
+#include <catch2/catch.hpp>
+#include "../src/BacktestEngine/BacktestEngine.h"
+#include "../src/Strategy/BreakoutStrategy.h"
+#include "../src/Strategy/MovingAverageStrategy.h"
+#include "../src/Reporter/Reporter.h"
+#include "TestSeries.h"
+#include <cstring>
+
+using namespace fastquant;
+
+namespace {
+
+Trade fillAt(Side side, double price, double qty, int minute, double fee = 0.0) {
+    Trade t;
+    t.side = side;
+    t.price = price;
+    t.qty = qty;
+    t.symbol = "LG";
+    t.timestamp = std::chrono::system_clock::time_point{std::chrono::minutes{minute}};
+    t.fee = fee;
+    return t;
+}
+
+const test::SeriesSpec kSeries{.base = 80.0, .amplitude = 7.0, .period = 6.0, .drift = 0.01, .spread = 0.6,
+                               .openOffset = 0.1, .symbol = "LG"};
+
+} // namespace
+
+TEST_CASE("Ledger matches entry lots FIFO and splits partial closes", "[ledger]") {
+    TradeLedger ledger;
+    ledger.onFill(fillAt(Side::Buy, 100.0, 2.0, 0, 2.0));
+    ledger.onFill(fillAt(Side::Buy, 110.0, 1.0, 5));
+    ledger.onCandle("LG", 115.0, 95.0);
+    ledger.onFill(fillAt(Side::Sell, 120.0, 2.5, 10, 5.0));
+
+    const auto& trips = ledger.roundTrips();
+    REQUIRE(trips.size() == 2);
+    REQUIRE(trips[0].qty == Approx(2.0));
+    REQUIRE(trips[0].entryPrice == Approx(100.0));
+    // 2 * 20 gross, less the whole entry fee and 2 of the 5 exit fee.
+    REQUIRE(trips[0].fees == Approx(2.0 + 4.0));
+    REQUIRE(trips[0].pnl == Approx(40.0 - 6.0));
+    REQUIRE(trips[0].mae == Approx(-10.0));
+    REQUIRE(trips[0].mfe == Approx(40.0));
+    REQUIRE(trips[0].holdingSeconds() == Approx(600.0));
+    REQUIRE(trips[1].qty == Approx(0.5));
+    REQUIRE(trips[1].entryPrice == Approx(110.0));
+    REQUIRE(trips[1].pnl == Approx(5.0 - 1.0));
+    REQUIRE(ledger.hasOpenLots());
+
+    // Closing the rest and flipping short opens a new lot at the fill price.
+    ledger.onFill(fillAt(Side::Sell, 90.0, 1.5, 20));
+    REQUIRE(trips.size() == 3);
+    REQUIRE(trips[2].pnl == Approx(-10.0));
+    REQUIRE(trips[2].mae == Approx(-10.0));
+    ledger.onFill(fillAt(Side::Buy, 85.0, 1.0, 30));
+    REQUIRE(trips.size() == 4);
+    REQUIRE(trips[3].side == Side::Sell);
+    REQUIRE(trips[3].pnl == Approx(5.0));
+    REQUIRE_FALSE(ledger.hasOpenLots());
+
+    const auto& stats = ledger.stats();
+    REQUIRE(stats.roundTrips == 4);
+    REQUIRE(stats.wins == 3);
+    REQUIRE(stats.losses == 1);
+    REQUIRE(stats.profitFactor() == Approx((34.0 + 4.0 + 5.0) / 10.0));
+
+    // Per fill: the two openings realize nothing, the 2.5 sell realizes both
+    // of its round trips and the flip only the closed part.
+    std::vector<Trade> fills{fillAt(Side::Buy, 100.0, 2.0, 0, 2.0), fillAt(Side::Buy, 110.0, 1.0, 5),
+                             fillAt(Side::Sell, 120.0, 2.5, 10, 5.0), fillAt(Side::Sell, 90.0, 1.5, 20),
+                             fillAt(Side::Buy, 85.0, 1.0, 30)};
+    const auto pnl = ledger.fillPnl(fills);
+    REQUIRE(pnl.size() == fills.size());
+    REQUIRE(pnl[0] == 0.0);
+    REQUIRE(pnl[1] == 0.0);
+    REQUIRE(pnl[2] == Approx(34.0 + 4.0));
+    REQUIRE(pnl[3] == Approx(-10.0));
+    REQUIRE(pnl[4] == Approx(5.0));
+}
+
+TEST_CASE("Ledger state survives save and load and rejects unknown symbol ids", "[ledger]") {
+    TradeLedger ledger;
+    ledger.onFill(fillAt(Side::Buy, 100.0, 2.0, 0, 2.0));
+    ledger.onFill(fillAt(Side::Sell, 120.0, 1.0, 10));
+
+    ByteWriter w;
+    ledger.save(w);
+    TradeLedger restored;
+    ByteReader r(w.data());
+    restored.load(r);
+    REQUIRE(r.atEnd());
+    REQUIRE(restored.roundTrips().size() == 1);
+    REQUIRE(restored.roundTrips()[0].pnl == ledger.roundTrips()[0].pnl);
+    REQUIRE(restored.symbolName(restored.roundTrips()[0]) == "LG");
+    REQUIRE(restored.hasOpenLots());
+
+    // The last round trip's symbol id sits before its side byte and the stats.
+    std::string bytes = w.data();
+    const uint32_t unknown = 1;
+    std::memcpy(bytes.data() + bytes.size() - 48 - 1 - sizeof(unknown), &unknown, sizeof(unknown));
+    TradeLedger corrupt;
+    ByteReader bad(bytes);
+    REQUIRE_THROWS_WITH(corrupt.load(bad), "Corrupt ledger");
+}
+
+TEST_CASE("Engine ledger agrees with the portfolio and survives summary-only runs", "[ledger]") {
+    const auto candles = test::makeSeries(600, kSeries);
+    ExecutionConfig exec;
+    exec.commissionBps = 5.0;
+    exec.defaultSlippageBps = 2.0;
+
+    BacktestEngine engine(exec);
+    BreakoutStrategy strat(10, 0.0, 1, true);
+    auto full = engine.run(candles, strat, 10000.0);
+    const auto& ledger = full.ledger;
+    REQUIRE(ledger.stats().roundTrips > 4);
+    REQUIRE(ledger.roundTrips().size() == ledger.stats().roundTrips);
+
+    // Unit lots: FIFO and average cost agree, so gross round-trip PnL adds up
+    // to the portfolio's realized PnL.
+    double gross = 0.0;
+    for (const auto& rt : ledger.roundTrips()) {
+        gross += rt.pnl + rt.fees;
+        REQUIRE(rt.mae <= 0.0);
+        REQUIRE(rt.mfe >= 0.0);
+        REQUIRE(rt.exitTime >= rt.entryTime);
+        REQUIRE(ledger.symbolName(rt) == "LG");
+    }
+    REQUIRE(gross == Approx(full.portfolio.realizedPnl()));
+
+    double net = 0.0;
+    for (const auto& rt : ledger.roundTrips()) {
+        net += rt.pnl;
+    }
+    double perFill = 0.0;
+    for (double p : ledger.fillPnl(full.trades)) {
+        perFill += p;
+    }
+    REQUIRE(perFill == Approx(net));
+
+    auto summary = Reporter().summarize(full);
+    REQUIRE(summary.roundTrips == ledger.stats().roundTrips);
+    REQUIRE(summary.roundTripWinRate == ledger.stats().winRate());
+
+    BacktestEngine light(exec);
+    light.setSummaryOnly(true);
+    BreakoutStrategy again(10, 0.0, 1, true);
+    auto lean = light.run(candles, again, 10000.0);
+    REQUIRE(lean.ledger.roundTrips().empty());
+    REQUIRE(lean.ledger.stats().roundTrips == ledger.stats().roundTrips);
+    REQUIRE(lean.ledger.stats().grossProfit == ledger.stats().grossProfit);
+    REQUIRE(lean.ledger.stats().holdingSeconds == ledger.stats().holdingSeconds);
+}
+
+TEST_CASE("Lane and broadcast runs keep the same ledger as a single run", "[ledger]") {
+    const auto candles = test::makeSeries(400, kSeries);
+    BacktestEngine engine;
+    MovingAverageStrategy reference(4, 15);
+    auto single = engine.run(candles, reference, 10000.0);
+
+    auto lanes = engine.runMovingAverageLanes(candles, {{4, 15}}, 10000.0);
+    std::vector<std::function<std::unique_ptr<Strategy>()>> factories = {
+        [] { return std::make_unique<MovingAverageStrategy>(4, 15); }
+    };
+    auto broadcast = engine.runBroadcast(candles, factories, 10000.0);
+
+    for (const auto* other : {&lanes[0], &broadcast[0]}) {
+        const auto& a = single.ledger.roundTrips();
+        const auto& b = other->ledger.roundTrips();
+        REQUIRE(a.size() == b.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            REQUIRE(a[i].pnl == b[i].pnl);
+            REQUIRE(a[i].mae == b[i].mae);
+            REQUIRE(a[i].mfe == b[i].mfe);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch.hpp>
+#include "../src/BacktestEngine/VectorizedBacktest.h"
+#include "TestSeries.h"
+#include <cstdint>
+
+using namespace fastquant;
+
+namespace {
+
+std::vector<Candle> makeGappedSeries(size_t count) {
+    auto candles = test::makeSeries(count, {.base = 80.0, .amplitude = 6.0, .period = 11.0, .amplitude2 = 1.5,
+                                            .period2 = 2.7, .spread = 0.3, .openOffset = 0.15, .symbol = "VEC"});
+    for (size_t i = 13; i < candles.size(); i += 97) {
+        candles[i].open = 0.0; // exercise the close fallback
+    }
+    return candles;
+}
+
+std::vector<double> makeTargets(size_t count) {
+    std::vector<double> targets(count);
+    uint64_t s = 11;
+    double target = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        s = s * 6364136223846793005ULL + 1442695040888963407ULL;
+        if ((s >> 60) < 3) {
+            target = static_cast<double>(static_cast<int>((s >> 40) % 7) - 3) * 0.5;
+        }
+        targets[i] = target;
+    }
+    return targets;
+}
+
+// Event-driven twin of runVectorized: on candle i it trades toward the
+// target decided on candle i - 1, so the engine fills at candle i's open.
+class TargetReplayStrategy : public Strategy {
+public:
+    explicit TargetReplayStrategy(const std::vector<double>& targets) : targets_(targets) {}
+
+    void onData(const Candle& candle) override {
+        const size_t i = index_++;
+        if (i == 0) {
+            return;
+        }
+        const double q = targets_[i - 1] - held_;
+        if (std::abs(q) < 1e-9) {
+            return;
+        }
+        Order o;
+        o.side = q > 0.0 ? Side::Buy : Side::Sell;
+        o.qty = std::abs(q);
+        o.symbol = candle.symbol;
+        o.timestamp = candle.timestamp;
+        orderSink_->submit(o);
+        held_ += q;
+        if (std::abs(held_) < 1e-9) {
+            held_ = 0.0;
+        }
+    }
+
+private:
+    const std::vector<double>& targets_;
+    size_t index_{0};
+    double held_{0.0};
+};
+
+} // namespace
+
+TEST_CASE("Vectorized backtest agrees with the engine on next-bar-open fills", "[vectorized]") {
+    auto candles = makeGappedSeries(2000);
+    auto targets = makeTargets(candles.size());
+    auto frame = CandleFrame::fromCandles(candles);
+
+    ExecutionConfig exec;
+    exec.defaultSlippageBps = 5.0;
+    exec.commissionPerShare = 0.02;
+    exec.commissionBps = 1.5;
+
+    BacktestEngine engine(exec);
+    TargetReplayStrategy replay(targets);
+    auto expected = engine.run(candles, replay, 25000.0);
+    auto vec = runVectorized(frame, targets, exec, 25000.0);
+
+    REQUIRE(vec.fills == expected.trades.size());
+    REQUIRE(vec.fills > 100);
+    REQUIRE(vec.equity == expected.equityCurve);
+    REQUIRE(vec.totalFees == expected.totalFees);
+    REQUIRE(vec.totalSlippage == expected.totalSlippage);
+    REQUIRE(vec.cash.back() == expected.portfolio.cash());
+    REQUIRE(vec.finalEquity == expected.portfolio.equity());
+
+    size_t k = 0;
+    for (size_t t = 0; t < frame.size(); ++t) {
+        if (vec.fillQty[t] != 0.0) {
+            REQUIRE(expected.trades[k].price == vec.fillPrice[t]);
+            REQUIRE(expected.trades[k].timestamp == frame.timestamps[t]);
+            ++k;
+        }
+    }
+
+    double peak = expected.equityCurve.front();
+    double maxDd = 0.0;
+    for (double e : expected.equityCurve) {
+        peak = std::max(peak, e);
+        maxDd = std::max(maxDd, peak - e);
+    }
+    REQUIRE(vec.maxDrawdown == maxDd);
+
+    // A reused backtester must not carry state between candidates.
+    VectorizedBacktester screener(frame, exec);
+    std::vector<double> flat(frame.size(), 0.0);
+    screener.run(flat, 25000.0);
+    const auto& again = screener.run(targets, 25000.0);
+    REQUIRE(again.equity == vec.equity);
+    REQUIRE(again.fills == vec.fills);
+    REQUIRE(again.totalFees == vec.totalFees);
+}
+
+TEST_CASE("Vectorized backtest validates its inputs", "[vectorized]") {
+    auto candles = makeGappedSeries(10);
+    auto frame = CandleFrame::fromCandles(candles);
+    std::vector<double> shortTargets(9, 1.0);
+    REQUIRE_THROWS_AS(runVectorized(frame, shortTargets, ExecutionConfig{}), std::runtime_error);
+
+    candles[4].symbol = "OTHER";
+    REQUIRE_THROWS_AS(CandleFrame::fromCandles(candles), std::runtime_error);
+
+    std::vector<double> signals{0, 1, 0, -1, -1, 0, 2};
+    REQUIRE(positionsFromSignals(signals) == std::vector<double>{0, 1, 1, 0, -1, -1, 1});
+    REQUIRE(positionsFromSignals(signals, 10.0).back() == 10.0);
+}